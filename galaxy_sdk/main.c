@@ -36,6 +36,7 @@
 #include "board.h"
 #include "osal_task_api.h"
 #include "vpi_error.h"
+#include "vad_task.h"
 #include "main.h"
 
 static void task_sample(void *param)
@@ -64,6 +65,9 @@ static void task_init_app(void *param)
 
     uart_printf("Hello VeriHealthi!\r\n");
 
+    if (vad_task_init() != ALGO_NORMAL)
+        uart_printf("vad init error\r\n");
+
     osal_create_task(task_sample, "task_sample", 512, 4, NULL);
     osal_delete_task(NULL);
 }
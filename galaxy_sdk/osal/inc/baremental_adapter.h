@@ -40,6 +40,18 @@ extern "C" {
 #define osal_enter_critical()
 #define osal_exit_critical()
 
+/* Static allocation, not supported without an RTOS */
+typedef uint32_t OsalStack;
+typedef struct OsalTaskBuffer {
+    void *dummy;
+} OsalTaskBuffer;
+typedef struct OsalSemaphoreBuffer {
+    void *dummy;
+} OsalSemaphoreBuffer;
+typedef struct OsalQueueBuffer {
+    void *dummy;
+} OsalQueueBuffer;
+
 /* Semaphore */
 typedef struct OsalSemaphore {
     void *semaphore;
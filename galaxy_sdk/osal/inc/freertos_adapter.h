@@ -71,6 +71,11 @@ extern "C" {
 /** The maximum priority available to the application tasks */
 #define OSAL_TASK_PRI_HIGHEST (configMAX_PRIORITIES - 1)
 
+/** Stack word of a statically allocated task */
+typedef StackType_t OsalStack;
+/** Task control block storage of a statically allocated task */
+typedef StaticTask_t OsalTaskBuffer;
+
 /** @} */
 
 /** @addtogroup NOTIFY
@@ -109,6 +114,9 @@ typedef struct OsalSemaphore {
     SemaphoreHandle_t semaphore;
 } OsalSemaphore;
 
+/** Storage of a statically allocated semaphore or mutex */
+typedef StaticSemaphore_t OsalSemaphoreBuffer;
+
 /** @} */
 
 /** @addtogroup LOCK
@@ -128,6 +136,9 @@ typedef struct OsalMutex {
  *  @{
  */
 
+/** Storage of a statically allocated queue, the items are kept separately */
+typedef StaticQueue_t OsalQueueBuffer;
+
 /** Definition of true of OSAL */
 #define OSAL_TRUE pdTRUE
 /** Definition of false of OSAL */
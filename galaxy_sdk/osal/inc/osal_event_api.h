@@ -140,6 +140,21 @@ uint32_t osal_get_event_pool_length(void);
  */
 void *osal_create_queue_raw(uint32_t q_size);
 
+/**
+ * @brief Create a operating system raw event queue in caller provided
+ * storage, nothing is allocated from the heap
+ *
+ * @note There is no static variant of osal_create_event_queue: the events of
+ * those queues are taken from the OSAL event pool, which is allocated from the
+ * heap, so a heap free path sends its own buffers through a raw queue
+ * @param q_size The maximum number of items that the queue being created can
+ * hold at any one time
+ * @param items Storage of q_size items of 32 bits, must outlive the queue
+ * @param buf Queue storage, must outlive the queue
+ * @return void* Queue handle is for success, NULL is for failure
+ */
+void *osal_create_queue_raw_static(uint32_t q_size, void **items, OsalQueueBuffer *buf);
+
 /**
  * @brief Delete a operating system raw event queue. Free all the memory
  * allocated for storing of items placed on the queue.
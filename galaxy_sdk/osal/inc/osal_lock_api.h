@@ -56,6 +56,16 @@ extern "C" {
  */
 int osal_create_mutex(OsalMutex *mu);
 
+/**
+ * @brief Create a mutex in caller provided storage, nothing is allocated from
+ * the heap
+ *
+ * @param mu The mutex to be created
+ * @param buf Mutex storage, must outlive the mutex
+ * @return int OSAL_TRUE for success, others for failure
+ */
+int osal_create_mutex_static(OsalMutex *mu, OsalSemaphoreBuffer *buf);
+
 /**
  * @brief Delete a mutex
  *
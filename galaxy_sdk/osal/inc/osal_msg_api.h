@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __OSAL_MSG_H__
+#define __OSAL_MSG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "osal_pool_api.h"
+
+/** @addtogroup MSG
+ *  OSAL zero-copy message API and definitions
+ *  @ingroup OSAL
+ *  @{
+ */
+
+/**
+ * @struct OsalMsgHeader
+ * @brief Header in front of every message payload, private
+ */
+typedef struct OsalMsgHeader {
+    OsalPool *pool; /**< Pool the message returns to */
+    uint32_t ref;   /**< References, the message is freed when it drops to 0 */
+    uint32_t id;    /**< Message id, e.g. an EventId */
+    uint32_t len;   /**< Payload bytes in use */
+} OsalMsgHeader;
+
+/** Bytes in front of the payload, keeps the payload OSAL_POOL_ALIGN aligned */
+#define OSAL_MSG_HEADER_SIZE OSAL_POOL_BLOCK_SIZE(sizeof(OsalMsgHeader))
+/** Pool block size of messages with payload_size bytes of payload */
+#define OSAL_MSG_BLOCK_SIZE(payload_size) (OSAL_MSG_HEADER_SIZE + OSAL_POOL_BLOCK_SIZE(payload_size))
+/** Define the static storage of a pool of num messages of payload_size bytes */
+#define OSAL_MSG_POOL_STORAGE(name, payload_size, num) \
+    OSAL_POOL_STORAGE(name, OSAL_MSG_BLOCK_SIZE(payload_size), num)
+
+/**
+ * @brief Create a pool of messages on static storage
+ *
+ * @note Must not be called from an interrupt service routine. The storage is
+ * defined by OSAL_MSG_POOL_STORAGE.
+ * @param pool The pool to be created
+ * @param name Pool name, kept by reference
+ * @param storage Storage of the messages
+ * @param payload_size Maximum payload of a message in bytes
+ * @param msg_num Number of messages, 1 to OSAL_POOL_MAX_BLOCK
+ * @return int OSAL_TRUE for success, others for failure
+ */
+int osal_msg_pool_create(OsalPool *pool, const char *name, void *storage, uint32_t payload_size,
+                         uint32_t msg_num);
+
+/**
+ * @brief Take a message from a pool, the caller holds its only reference
+ *
+ * @note Lock-free and O(1), can be called from interrupt service routines
+ * @param pool The message pool
+ * @param id Message id
+ * @param len Payload bytes in use, at most the payload size of the pool
+ * @return void* Payload of the message, NULL when the pool is empty
+ */
+void *osal_msg_alloc(OsalPool *pool, uint32_t id, uint32_t len);
+
+/**
+ * @brief Add references to a message before handing it to more receivers
+ *
+ * @note A sender fanning a message out to n receivers, for instance the n
+ * listeners of vpi_event_notify, adds n - 1 references and every receiver
+ * drops one with osal_msg_unref when it is done. Can be called from interrupt
+ * service routines.
+ * @param msg Payload of the message
+ * @param count References to add
+ */
+void osal_msg_ref(void *msg, uint32_t count);
+
+/**
+ * @brief Drop a reference, the message returns to its pool with the last one
+ *
+ * @note Can be called from interrupt service routines
+ * @param msg Payload of the message
+ */
+void osal_msg_unref(void *msg);
+
+/**
+ * @brief Get the id of a message
+ *
+ * @param msg Payload of the message
+ * @return uint32_t Message id
+ */
+uint32_t osal_msg_id(const void *msg);
+
+/**
+ * @brief Get the payload bytes in use of a message
+ *
+ * @param msg Payload of the message
+ * @return uint32_t Payload bytes
+ */
+uint32_t osal_msg_len(const void *msg);
+
+/**
+ * @brief Pass a message to a raw event queue by pointer
+ *
+ * @note The reference of the caller moves to the queue on success and stays
+ * with the caller on failure. The receiver takes it over with
+ * osal_msg_recv.
+ * @param queue Raw event queue handle, see osal_create_queue_raw
+ * @param msg Payload of the message
+ * @return int EVENT_OK is for success, EVENT_ERROR is for failure
+ */
+int osal_msg_send(void *queue, void *msg);
+
+/**
+ * @brief Pass a message to a raw event queue by pointer from ISR
+ *
+ * @note osal_msg_send_from_isr is the interrupt safe version of osal_msg_send
+ * @param queue Raw event queue handle
+ * @param msg Payload of the message
+ * @return int EVENT_OK is for success, EVENT_ERROR is for failure
+ */
+int osal_msg_send_from_isr(void *queue, void *msg);
+
+/**
+ * @brief Wait for a message from a raw event queue, the caller owns the
+ * reference it carried
+ *
+ * @note The task will wait indefinitely until a message is available
+ * @param queue Raw event queue handle
+ * @return void* Payload of the message
+ */
+void *osal_msg_recv(void *queue);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_MSG_H__ */
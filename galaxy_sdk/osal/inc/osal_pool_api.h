@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __OSAL_POOL_H__
+#define __OSAL_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "osal_adapter.h"
+
+/** @addtogroup POOL
+ *  OSAL fixed-block pool API and definitions
+ *  @ingroup OSAL
+ *  @{
+ */
+
+/** Alignment of every block, block sizes are rounded up to it */
+#define OSAL_POOL_ALIGN (8)
+/** Maximum number of blocks in one pool */
+#define OSAL_POOL_MAX_BLOCK (256)
+/** Block size after rounding up to OSAL_POOL_ALIGN */
+#define OSAL_POOL_BLOCK_SIZE(size) \
+    (((uint32_t)(size) + OSAL_POOL_ALIGN - 1) & ~(uint32_t)(OSAL_POOL_ALIGN - 1))
+/** Bytes of storage needed by a pool of num blocks of size bytes */
+#define OSAL_POOL_STORAGE_SIZE(size, num) (OSAL_POOL_BLOCK_SIZE(size) * (uint32_t)(num))
+/** Define the static storage of a pool of num blocks of size bytes */
+#define OSAL_POOL_STORAGE(name, size, num) \
+    static uint8_t name[OSAL_POOL_STORAGE_SIZE(size, num)] __attribute__((aligned(OSAL_POOL_ALIGN)))
+
+/**
+ * @struct OsalPool
+ * @brief Fixed-block pool, the fields are private, see osal_pool_get_stats
+ */
+typedef struct OsalPool {
+    const char *name;           /**< Pool name for osal_dump_pool_state */
+    uint8_t *storage;           /**< Static storage of block_num blocks */
+    uint32_t block_size;        /**< Block size, a multiple of OSAL_POOL_ALIGN */
+    uint32_t block_num;         /**< Number of blocks */
+    uint32_t head;              /**< Free list head, ABA tag << 16 | block index */
+    uint32_t used;              /**< Blocks currently allocated */
+    uint32_t high_water;        /**< Maximum of used since creation or reset */
+    uint32_t alloc_fail;        /**< Allocations that found the pool empty */
+    uint32_t free_fail;         /**< Rejected frees, foreign pointer or double free */
+    uint32_t in_use[OSAL_POOL_MAX_BLOCK / 32]; /**< Allocated blocks bitmap */
+    struct OsalPool *next;      /**< Next pool in the list of created pools */
+} OsalPool;
+
+/**
+ * @struct OsalPoolStats
+ * @brief Snapshot of the usage of a pool
+ */
+typedef struct OsalPoolStats {
+    uint32_t block_size; /**< Block size in bytes */
+    uint32_t block_num;  /**< Number of blocks */
+    uint32_t used;       /**< Blocks currently allocated */
+    uint32_t high_water; /**< Maximum of used since creation or reset */
+    uint32_t alloc_fail; /**< Allocations that found the pool empty */
+    uint32_t free_fail;  /**< Rejected frees */
+} OsalPoolStats;
+
+/**
+ * @brief Create a fixed-block pool on static storage
+ *
+ * @note Must not be called from an interrupt service routine. The storage must
+ * be OSAL_POOL_ALIGN aligned and hold OSAL_POOL_STORAGE_SIZE(block_size,
+ * block_num) bytes, OSAL_POOL_STORAGE defines it. The pool is added to the
+ * list printed by osal_dump_pool_state.
+ * @param pool The pool to be created
+ * @param name Pool name, kept by reference
+ * @param storage Storage of the blocks
+ * @param block_size Block size in bytes, rounded up to OSAL_POOL_ALIGN
+ * @param block_num Number of blocks, 1 to OSAL_POOL_MAX_BLOCK
+ * @return int OSAL_TRUE for success, others for failure
+ */
+int osal_pool_create(OsalPool *pool, const char *name, void *storage, uint32_t block_size,
+                     uint32_t block_num);
+
+/**
+ * @brief Allocate a block from a pool
+ *
+ * @note Lock-free and O(1), can be called from tasks and interrupt service
+ * routines alike. It never blocks and never touches the heap.
+ * @param pool The pool
+ * @return void* Pointer of the block, NULL when the pool is empty
+ */
+void *osal_pool_alloc(OsalPool *pool);
+
+/**
+ * @brief Return a block to its pool
+ *
+ * @note Lock-free and O(1), can be called from tasks and interrupt service
+ * routines alike. Pointers outside the pool, not at a block start or not
+ * allocated are rejected and counted in free_fail.
+ * @param pool The pool the block was allocated from
+ * @param block Pointer of the block
+ * @return int OSAL_TRUE for success, others for failure
+ */
+int osal_pool_free(OsalPool *pool, void *block);
+
+/**
+ * @brief Get a snapshot of the usage of a pool
+ *
+ * @param pool The pool
+ * @param stats Usage of the pool
+ */
+void osal_pool_get_stats(const OsalPool *pool, OsalPoolStats *stats);
+
+/**
+ * @brief Restart the high-water mark from the current usage and clear the
+ * failure counters
+ *
+ * @param pool The pool
+ */
+void osal_pool_reset_stats(OsalPool *pool);
+
+/**
+ * @brief Print the usage of all created pools
+ */
+void osal_dump_pool_state(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OSAL_POOL_H__ */
@@ -56,6 +56,16 @@ extern "C" {
  */
 int osal_create_sem(OsalSemaphore *sem);
 
+/**
+ * @brief Create a binary semaphore in caller provided storage, nothing is
+ * allocated from the heap
+ *
+ * @param sem The semaphore to be created
+ * @param buf Semaphore storage, must outlive the semaphore
+ * @return int OSAL_TRUE for success, others for failure
+ */
+int osal_create_sem_static(OsalSemaphore *sem, OsalSemaphoreBuffer *buf);
+
 /**
  * @brief Delete a binary semaphore
  *
@@ -63,6 +63,24 @@ extern "C" {
 void *osal_create_task(void *func, char *name, uint32_t stack_size, uint32_t task_priority,
                        void *param);
 
+/**
+ * @brief Create a task whose control block and stack are provided by the
+ * caller, nothing is allocated from the heap
+ *
+ * @param func A pointer to the function that implements the task
+ * @param name A descriptive name for the task
+ * @param stack_size The number of words the stack can hold, not the number of
+ * bytes
+ * @param task_priority The priority at which the task will execute
+ * @param param A parameter for task function
+ * @param stack Stack of stack_size words, must outlive the task
+ * @param tcb Task control block storage, must outlive the task
+ * @return void* Task handle for success, NULL for failure
+ */
+void *osal_create_task_static(void *func, char *name, uint32_t stack_size,
+                              uint32_t task_priority, void *param, OsalStack *stack,
+                              OsalTaskBuffer *tcb);
+
 /**
  * @brief Delete the specific task
  *
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stddef.h>
+
+#include "osal_msg_api.h"
+#include "osal_event_api.h"
+#include "vpi_event.h"
+
+#define MSG_HEADER(msg) ((OsalMsgHeader *)((uint8_t *)(msg) - OSAL_MSG_HEADER_SIZE))
+
+int osal_msg_pool_create(OsalPool *pool, const char *name, void *storage, uint32_t payload_size,
+                         uint32_t msg_num)
+{
+    if (!payload_size) {
+        return OSAL_FALSE;
+    }
+
+    return osal_pool_create(pool, name, storage, OSAL_MSG_BLOCK_SIZE(payload_size), msg_num);
+}
+
+void *osal_msg_alloc(OsalPool *pool, uint32_t id, uint32_t len)
+{
+    OsalMsgHeader *header = NULL;
+
+    if (!pool || len > pool->block_size - OSAL_MSG_HEADER_SIZE) {
+        return NULL;
+    }
+
+    header = (OsalMsgHeader *)osal_pool_alloc(pool);
+    if (!header) {
+        return NULL;
+    }
+
+    header->pool = pool;
+    header->id   = id;
+    header->len  = len;
+    __atomic_store_n(&header->ref, 1, __ATOMIC_RELAXED);
+
+    return (uint8_t *)header + OSAL_MSG_HEADER_SIZE;
+}
+
+void osal_msg_ref(void *msg, uint32_t count)
+{
+    if (msg) {
+        __atomic_add_fetch(&MSG_HEADER(msg)->ref, count, __ATOMIC_RELAXED);
+    }
+}
+
+void osal_msg_unref(void *msg)
+{
+    OsalMsgHeader *header = NULL;
+
+    if (!msg) {
+        return;
+    }
+
+    // the last holder must see every write of the others before the block is reused
+    header = MSG_HEADER(msg);
+    if (!__atomic_sub_fetch(&header->ref, 1, __ATOMIC_ACQ_REL)) {
+        osal_pool_free(header->pool, header);
+    }
+}
+
+uint32_t osal_msg_id(const void *msg)
+{
+    return msg ? MSG_HEADER(msg)->id : 0;
+}
+
+uint32_t osal_msg_len(const void *msg)
+{
+    return msg ? MSG_HEADER(msg)->len : 0;
+}
+
+int osal_msg_send(void *queue, void *msg)
+{
+    if (!queue || !msg) {
+        return EVENT_ERROR;
+    }
+
+    // the 32 bit item of a raw queue is the payload pointer itself
+    return osal_send_event_raw(queue, msg);
+}
+
+int osal_msg_send_from_isr(void *queue, void *msg)
+{
+    if (!queue || !msg) {
+        return EVENT_ERROR;
+    }
+
+    return osal_send_event_raw_from_isr(queue, msg);
+}
+
+void *osal_msg_recv(void *queue)
+{
+    void *msg = NULL;
+
+    if (queue) {
+        osal_wait_event_raw(queue, &msg);
+    }
+
+    return msg;
+}
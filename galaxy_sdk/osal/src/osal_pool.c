@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "osal_pool_api.h"
+#include "uart_printf.h"
+
+/*
+ * The free list is a stack of block indices threaded through the first word of
+ * the free blocks. The head packs a 16 bit tag above the index and every pop
+ * or push bumps the tag, so a compare-and-swap on the 32 bit head is enough to
+ * make both ends lock-free without the ABA problem. An interrupt that preempts
+ * a task in the middle of an update just makes the task retry, so the same
+ * calls are safe from tasks and ISRs and never disable interrupts.
+ */
+#define POOL_NIL       (0xFFFFu)
+#define POOL_INDEX(h)  ((h) & 0xFFFFu)
+#define POOL_TAG_STEP  (0x10000u)
+#define POOL_HEAD(h, idx) ((((h) + POOL_TAG_STEP) & ~0xFFFFu) | (idx))
+
+static OsalPool *g_pool_list = NULL;
+
+static inline uint32_t *block_link(const OsalPool *pool, uint32_t idx)
+{
+    return (uint32_t *)(pool->storage + idx * pool->block_size);
+}
+
+static inline void update_high_water(OsalPool *pool, uint32_t used)
+{
+    uint32_t high = __atomic_load_n(&pool->high_water, __ATOMIC_RELAXED);
+
+    while (used > high && !__atomic_compare_exchange_n(&pool->high_water, &high, used, true,
+                                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+int osal_pool_create(OsalPool *pool, const char *name, void *storage, uint32_t block_size,
+                     uint32_t block_num)
+{
+    OsalPool *iter = NULL, *next = NULL;
+    uint8_t *base  = (uint8_t *)storage;
+    uint32_t i, size;
+
+    if (!pool || !storage || ((uintptr_t)storage & (OSAL_POOL_ALIGN - 1)) || !block_size ||
+        !block_num || block_num > OSAL_POOL_MAX_BLOCK) {
+        return OSAL_FALSE;
+    }
+
+    size = OSAL_POOL_BLOCK_SIZE(block_size);
+    for (i = 0; i < block_num; i++) {
+        *(uint32_t *)(base + i * size) = i + 1 < block_num ? i + 1 : POOL_NIL;
+    }
+
+    // a pool created again keeps its place in the list; the reset and the link
+    // are done in one critical section, so osal_dump_pool_state walking the
+    // list never sees the next pointer of a linked pool cleared
+    osal_enter_critical();
+    for (iter = g_pool_list; iter && iter != pool; iter = iter->next) {
+    }
+    next = iter ? pool->next : g_pool_list;
+
+    memset(pool, 0, sizeof(OsalPool));
+    pool->name       = name;
+    pool->storage    = base;
+    pool->block_size = size;
+    pool->block_num  = block_num;
+    pool->head       = 0;
+    pool->next       = next;
+    if (!iter) {
+        g_pool_list = pool;
+    }
+    osal_exit_critical();
+
+    return OSAL_TRUE;
+}
+
+void *osal_pool_alloc(OsalPool *pool)
+{
+    uint32_t head, next, idx;
+
+    if (!pool) {
+        return NULL;
+    }
+
+    head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    do {
+        idx = POOL_INDEX(head);
+        if (idx == POOL_NIL) {
+            __atomic_fetch_add(&pool->alloc_fail, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        // the block may be popped and reused meanwhile, then the tag has
+        // changed and the stale link is discarded by the failed swap
+        next = __atomic_load_n(block_link(pool, idx), __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, POOL_HEAD(head, next), true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    __atomic_fetch_or(&pool->in_use[idx / 32], 1u << (idx % 32), __ATOMIC_RELAXED);
+    update_high_water(pool, __atomic_add_fetch(&pool->used, 1, __ATOMIC_RELAXED));
+
+    return block_link(pool, idx);
+}
+
+int osal_pool_free(OsalPool *pool, void *block)
+{
+    uint32_t head, idx, offset, mask;
+
+    if (!pool || !block) {
+        return OSAL_FALSE;
+    }
+
+    offset = (uint32_t)((uint8_t *)block - pool->storage);
+    idx    = offset / pool->block_size;
+    mask   = 1u << (idx % 32);
+    if ((uint8_t *)block < pool->storage || idx >= pool->block_num ||
+        offset % pool->block_size ||
+        !(__atomic_fetch_and(&pool->in_use[idx / 32], ~mask, __ATOMIC_RELAXED) & mask)) {
+        __atomic_fetch_add(&pool->free_fail, 1, __ATOMIC_RELAXED);
+        return OSAL_FALSE;
+    }
+
+    __atomic_fetch_sub(&pool->used, 1, __ATOMIC_RELAXED);
+    head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(block_link(pool, idx), POOL_INDEX(head), __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, POOL_HEAD(head, idx), true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    return OSAL_TRUE;
+}
+
+void osal_pool_get_stats(const OsalPool *pool, OsalPoolStats *stats)
+{
+    if (!pool || !stats) {
+        return;
+    }
+
+    stats->block_size = pool->block_size;
+    stats->block_num  = pool->block_num;
+    stats->used       = __atomic_load_n(&pool->used, __ATOMIC_RELAXED);
+    stats->high_water = __atomic_load_n(&pool->high_water, __ATOMIC_RELAXED);
+    stats->alloc_fail = __atomic_load_n(&pool->alloc_fail, __ATOMIC_RELAXED);
+    stats->free_fail  = __atomic_load_n(&pool->free_fail, __ATOMIC_RELAXED);
+}
+
+void osal_pool_reset_stats(OsalPool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    __atomic_store_n(&pool->high_water, __atomic_load_n(&pool->used, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->alloc_fail, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->free_fail, 0, __ATOMIC_RELAXED);
+}
+
+void osal_dump_pool_state(void)
+{
+    OsalPoolStats stats;
+    OsalPool *pool;
+
+    uart_printf("pool        block   num  used  high  alloc_fail  free_fail\r\n");
+    for (pool = g_pool_list; pool; pool = pool->next) {
+        osal_pool_get_stats(pool, &stats);
+        uart_printf("%-10s %6u %5u %5u %5u %11u %10u\r\n", pool->name ? pool->name : "-",
+                    (unsigned)stats.block_size, (unsigned)stats.block_num, (unsigned)stats.used,
+                    (unsigned)stats.high_water, (unsigned)stats.alloc_fail,
+                    (unsigned)stats.free_fail);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vs_conf.h"
+#include "osal_task_api.h"
+#include "osal_semaphore_api.h"
+#include "osal_lock_api.h"
+#include "osal_event_api.h"
+
+/*
+ * Static variants of the OSAL object constructors. The objects they return
+ * are ordinary OSAL objects: the osal_delete_* and all other calls of the
+ * prebuilt OSAL library work on them unchanged, deleting one just never frees
+ * the caller's storage.
+ */
+#if CONFIG_FREERTOS
+
+void *osal_create_task_static(void *func, char *name, uint32_t stack_size,
+                              uint32_t task_priority, void *param, OsalStack *stack,
+                              OsalTaskBuffer *tcb)
+{
+    if (!func || !stack || !tcb || !stack_size) {
+        return NULL;
+    }
+
+    return xTaskCreateStatic((TaskFunction_t)func, name, stack_size, param, task_priority, stack,
+                             tcb);
+}
+
+int osal_create_sem_static(OsalSemaphore *sem, OsalSemaphoreBuffer *buf)
+{
+    if (!sem || !buf) {
+        return OSAL_FALSE;
+    }
+
+    sem->semaphore = xSemaphoreCreateBinaryStatic(buf);
+    return sem->semaphore ? OSAL_TRUE : OSAL_FALSE;
+}
+
+int osal_create_mutex_static(OsalMutex *mu, OsalSemaphoreBuffer *buf)
+{
+    if (!mu || !buf) {
+        return OSAL_FALSE;
+    }
+
+    mu->mutex = xSemaphoreCreateMutexStatic(buf);
+    return mu->mutex ? OSAL_TRUE : OSAL_FALSE;
+}
+
+void *osal_create_queue_raw_static(uint32_t q_size, void **items, OsalQueueBuffer *buf)
+{
+    if (!q_size || !items || !buf) {
+        return NULL;
+    }
+
+    // the same 32 bit items as osal_create_queue_raw
+    return xQueueCreateStatic(q_size, sizeof(void *), (uint8_t *)items, buf);
+}
+
+#endif
@@ -0,0 +1,70 @@
+import argparse  # 导入 argparse 模块，用于解析命令行参数
+import struct  # 导入 struct 模块，用于解析 PCM 样点
+import wave  # 导入 wave 模块，用于读取 wav 文件
+
+LICENSE_PATH = "../refence_code/2_VAD_c/vad.h"  # 复制其文件头的许可证
+FS = 8000  # VAD 的采样率，与 OBJ_FS 一致
+PER_LINE = 12  # 每行输出的样点数
+
+def read_clip(wav_path, start, length):
+    """
+    读取 wav 文件第一通道的一段样点
+
+    :param wav_path: wav 文件路径，16 位、8000Hz
+    :param start: 第一个样点
+    :param length: 样点数
+    :return: 样点列表
+    """
+    with wave.open(wav_path, "rb") as f:
+        if f.getsampwidth() != 2 or f.getframerate() != FS:
+            raise ValueError("%s: need 16 bit PCM at %d Hz" % (wav_path, FS))
+        channels = f.getnchannels()
+        if start + length > f.getnframes():
+            raise ValueError("%s: only %d samples" % (wav_path, f.getnframes()))
+        f.setpos(start)
+        raw = f.readframes(length)
+    pcm = struct.unpack("<%dh" % (length * channels), raw)
+    return list(pcm[::channels])
+
+def license_header(path):
+    """
+    返回 C 文件开头的许可证注释
+
+    :param path: 带许可证注释的 C 文件
+    :return: 注释文本，含结尾的 */
+    """
+    with open(path, "r") as f:
+        text = f.read()
+    return text[:text.index("*/") + 2] + "\n"
+
+def write_header(path, pcm, source, start):
+    """
+    将样点写成 qemu 上代替麦克风采集的 PCM 片段头文件
+
+    :param path: 输出的头文件
+    :param pcm: 样点列表
+    :param source: 片段来源的 wav 文件名
+    :param start: 片段在 wav 文件中的第一个样点
+    """
+    with open(path, "w") as f:
+        f.write(license_header(LICENSE_PATH) + "\n")
+        f.write("#ifndef __VAD_CLIP_H__\n#define __VAD_CLIP_H__\n\n#include <stdint.h>\n\n")
+        f.write("// generated by qemu/clip_export.py: samples %d..%d of %s, first channel, %d Hz\n"
+                % (start, start + len(pcm) - 1, source, FS))
+        f.write("#define VAD_CLIP_LEN (%d)\n\n" % len(pcm))
+        f.write("static const int16_t g_vad_clip[VAD_CLIP_LEN] = {\n")
+        for i in range(0, len(pcm), PER_LINE):
+            f.write("    " + " ".join("%d," % v for v in pcm[i:i + PER_LINE]) + "\n")
+        f.write("};\n\n#endif\n")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="export a PCM clip replayed by the VAD capture task on qemu")
+    parser.add_argument("--wav", default="../refence_code/3_data_set/data/data_1.wav", help="8000 Hz 16 bit wav file")
+    parser.add_argument("--start", type=int, default=16800, help="first sample of the clip")
+    parser.add_argument("--length", type=int, default=8000, help="samples of the clip")
+    parser.add_argument("--out", default="user/inc/vad_clip.h", help="header to write")
+    args = parser.parse_args()
+
+    pcm = read_clip(args.wav, args.start, args.length)
+    write_header(args.out, pcm, args.wav.replace("\\", "/").split("/")[-1], args.start)
+    print("%s: %d samples (%.0f ms)" % (args.out, len(pcm), len(pcm) * 1000.0 / FS))
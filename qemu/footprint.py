@@ -0,0 +1,120 @@
+import argparse  # 导入 argparse 模块，用于解析命令行参数
+import re  # 导入正则表达式模块，用于解析 map 文件
+
+# 输入段名前缀到统计类别的映射，按顺序匹配；SDK 自身的 .itext、.nonxip_text 为孤立段，不拷贝到 RAM
+# ram_text（.itext.vad）与 ram_const 链接在 .data 中，存放在 flash，启动时拷贝到 RAM（见 n309_iot_qemu.ld）
+SECTION_CLASS = [
+    (".itext.vad", "ram_text"),
+    (".itext", "text"),
+    (".nonxip_text", "text"),
+    (".vad_ram_const", "ram_const"),
+    (".text", "text"),
+    (".rodata", "rodata"),
+    (".srodata", "rodata"),
+    (".data", "data"),
+    (".sdata", "data"),
+    (".tdata", "data"),
+    (".bss", "bss"),
+    (".sbss", "bss"),
+    (".tbss", "bss"),
+    ("COMMON", "bss"),
+]
+CLASS_NAME = ["text", "ram_text", "rodata", "ram_const", "data", "bss"]
+FLASH_CLASS = ["text", "ram_text", "rodata", "ram_const", "data"]  # 占用 flash 的类别
+RAM_CLASS = ["ram_text", "ram_const", "data", "bss"]  # 占用 RAM 的类别
+
+# VAD 子系统的目标文件：链接进工程的 vad 目录和 vad_task
+DEFAULT_MATCH = r"(^|[/\\])vad[/\\]|vad_task\.o$"
+
+INPUT_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")  # 段名、地址、大小、文件在同一行
+NAME_LINE = re.compile(r"^ ([.\w]\S*)$")  # 段名较长时单独一行
+SIZE_LINE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")  # 紧接段名的地址、大小、文件
+
+def section_class(name):
+    """
+    返回输入段所属的统计类别
+
+    :param name: 输入段名
+    :return: 类别名，不统计的段返回 None
+    """
+    for prefix, cls in SECTION_CLASS:
+        if name == prefix or name.startswith(prefix + "."):
+            return cls
+    return None
+
+def parse_map(map_path):
+    """
+    解析 GNU ld 的 map 文件，统计每个目标文件各类别的字节数
+
+    :param map_path: map 文件路径
+    :return: {目标文件: {类别: 字节数}}
+    """
+    usage = {}
+    pending = None  # 单独一行的段名，等待下一行的地址和大小
+    started = False
+
+    with open(map_path, "r", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not started:
+                # 之前是被丢弃的段和内存配置，不计入
+                started = line.startswith("Linker script and memory map")
+                continue
+
+            name = size = obj = None
+            m = INPUT_LINE.match(line)
+            if m:
+                name, size, obj = m.group(1), int(m.group(3), 16), m.group(4)
+            elif pending:
+                m = SIZE_LINE.match(line)
+                if m:
+                    name, size, obj = pending, int(m.group(2), 16), m.group(3)
+            pending = None
+
+            if name is None:
+                m = NAME_LINE.match(line)
+                if m:
+                    pending = m.group(1)
+                continue
+
+            cls = section_class(name)
+            if cls is None or size == 0:
+                continue
+            obj = obj.strip()
+            usage.setdefault(obj, dict.fromkeys(CLASS_NAME, 0))[cls] += size
+
+    return usage
+
+def total(rows):
+    """
+    按类别求和
+
+    :param rows: 每个目标文件的统计结果
+    :return: {类别: 字节数}
+    """
+    result = dict.fromkeys(CLASS_NAME, 0)
+    for row in rows:
+        for cls in CLASS_NAME:
+            result[cls] += row[cls]
+    return result
+
+def print_row(name, row):
+    flash = sum(row[cls] for cls in FLASH_CLASS)
+    ram = sum(row[cls] for cls in RAM_CLASS)
+    print("%-40s" % name[-40:] + "".join("%10d" % row[cls] for cls in CLASS_NAME) + "%10d%10d" % (flash, ram))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="report the flash and RAM used by the VAD subsystem from a linker map file")
+    parser.add_argument("map", help="map file written by -Wl,-Map")
+    parser.add_argument("--match", default=DEFAULT_MATCH, help="regular expression of the object files to report")
+    args = parser.parse_args()
+
+    usage = parse_map(args.map)
+    match = re.compile(args.match)
+    objs = sorted(obj for obj in usage if match.search(obj))
+
+    print("%-40s" % "object" + "".join("%10s" % cls for cls in CLASS_NAME) + "%10s%10s" % ("flash", "ram"))
+    for obj in objs:
+        print_row(obj, usage[obj])
+    print_row("VAD total", total([usage[obj] for obj in objs]))
+    print_row("image total", total(usage.values()))
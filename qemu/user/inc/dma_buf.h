@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DMA_BUF_H__
+#define __DMA_BUF_H__
+
+#include <stdint.h>
+
+#include "hal_dmac.h"
+
+#define DMA_BUF_LINE_SIZE (64) // alignment when the D-cache line size cannot be read
+
+typedef enum DmaBufType {
+    DMA_BUF_CACHED   = 0, // osal_malloc, cache lines are invalidated on DMA completion
+    DMA_BUF_NONCACHE = 1, // osal_malloc_noncache, no maintenance
+} DmaBufType;
+
+typedef struct DmaBuf {
+    uint8_t *data;      // start, aligned to a cache line
+    uint32_t size;      // bytes, a whole number of cache lines
+    DmaBufType type;    // memory the buffer lives in
+    void *raw;          // block returned by the allocator
+    DmaCbAndParam done; // callback chained by dma_buf_rx_callback
+} DmaBuf;
+
+/**
+ * @brief D-cache line size, DMA_BUF_LINE_SIZE when there is no D-cache
+ *
+ * @return line size in bytes
+ */
+uint32_t dma_buf_line_size(void);
+
+/**
+ * @brief allocate a DMA buffer. The buffer starts on a cache line and covers
+ * whole lines, so no other data shares a line with it and invalidating it
+ * cannot drop a neighbour's writes. A cached buffer is flushed and invalidated
+ * before it is returned.
+ *
+ * @param[in] buf  buffer descriptor
+ * @param[in] size bytes, rounded up to whole cache lines
+ * @param[in] type memory the buffer lives in
+ *
+ * @return VSD_SUCCESS, VSD_ERR_INVALID_POINTER/PARAM or VSD_ERR_NO_MEMORY
+ */
+int dma_buf_alloc(DmaBuf *buf, uint32_t size, DmaBufType type);
+
+/**
+ * @brief free a DMA buffer allocated by dma_buf_alloc
+ *
+ * @param[in] buf buffer descriptor
+ */
+void dma_buf_free(DmaBuf *buf);
+
+/**
+ * @brief make CPU writes to [offset, offset + len) visible to the DMA before a
+ * memory to peripheral transfer, no-op for non-cacheable buffers
+ *
+ * @param[in] buf    buffer descriptor
+ * @param[in] offset first byte
+ * @param[in] len    bytes
+ */
+void dma_buf_sync_for_device(const DmaBuf *buf, uint32_t offset, uint32_t len);
+
+/**
+ * @brief drop stale cache lines of [offset, offset + len) after the DMA has
+ * written it, no-op for non-cacheable buffers. Safe in ISRs.
+ *
+ * @param[in] buf    buffer descriptor
+ * @param[in] offset first byte
+ * @param[in] len    bytes
+ */
+void dma_buf_sync_for_cpu(const DmaBuf *buf, uint32_t offset, uint32_t len);
+
+/**
+ * @brief DMA completion callback for capture into the whole buffer: pass it to
+ * hal_dmac_chan_start with the buffer as the parameter. It invalidates the
+ * buffer and then calls buf->done, so the chained callback always sees the
+ * data the DMA wrote.
+ *
+ * @param[in] param DmaBuf of the transfer
+ */
+void dma_buf_rx_callback(const void *param);
+
+/**
+ * @brief compare the VAD's read bandwidth from cached and non-cacheable
+ * capture buffers and print the faster one per buffer type
+ *
+ * @return VSD_SUCCESS or VSD_ERR_NO_MEMORY
+ */
+int dma_buf_bench(void);
+
+#endif
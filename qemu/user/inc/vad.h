@@ -1,4 +0,0 @@
-#ifndef __VAD__
-#define __VAD__
-
-#endif
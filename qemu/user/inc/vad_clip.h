@@ -0,0 +1,708 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VAD_CLIP_H__
+#define __VAD_CLIP_H__
+
+#include <stdint.h>
+
+// generated by qemu/clip_export.py: samples 16800..24799 of data_1.wav, first channel, 8000 Hz
+#define VAD_CLIP_LEN (8000)
+
+static const int16_t g_vad_clip[VAD_CLIP_LEN] = {
+    -96, 51, 57, 42, 160, 12, 168, 32, -102, 140, -4, 108,
+    -28, -27, -47, 183, 33, 21, 35, 23, 25, -209, -100, -83,
+    49, 144, 119, 97, -60, -69, -93, -76, -67, -59, -58, -47,
+    -36, -35, -21, 28, 34, -125, 46, 44, 43, -105, -228, 31,
+    -78, 40, -224, -98, 59, -201, -41, 77, -66, 98, 105, 214,
+    228, 194, 160, 287, 136, 266, 220, 55, 153, 18, -4, -18,
+    -24, -43, -51, -58, -54, -214, -190, -173, -42, -201, -292, -251,
+    -95, -203, -189, -2, 4, 52, -79, 40, 162, 15, 5, 4,
+    -148, -122, -110, -90, -97, -184, -4, -12, 31, 38, 49, -52,
+    88, -151, -32, -30, -45, -157, 129, 116, -37, 85, -72, 77,
+    58, 36, 172, 252, 87, -101, -94, 16, -15, 122, -177, -185,
+    -173, -168, -17, -154, -29, -259, -230, -61, -72, -66, 29, 164,
+    141, -170, -8, 96, 59, -73, -58, -177, -182, -148, -22, 0,
+    -29, -35, 94, 111, -182, -67, -80, -97, -113, 27, -26, -141,
+    -246, 64, -38, -265, -96, 183, -65, 79, 71, -12, 136, 107,
+    99, 83, 121, -15, -36, 154, -141, 173, 388, 335, 284, 60,
+    299, 123, 46, 172, -117, 113, 16, -23, -44, 167, 8, 68,
+    -104, 123, -24, -318, -36, -168, -176, -18, -42, -88, -69, 56,
+    9, -3, -18, -155, -18, 104, 119, -25, 64, -69, -209, -182,
+    -33, -27, -162, -125, 20, -72, -94, 36, 39, -90, 26, -84,
+    41, 202, 39, 33, 33, 22, 49, 48, 57, 203, 176, 27,
+    10, 133, 127, 142, 131, 242, 330, 68, 199, 48, 260, 214,
+    43, 130, -278, 3, -122, 38, 18, -2, -41, -62, -183, -61,
+    -68, 204, -97, -87, 34, -17, -146, 266, -45, 48, -115, -238,
+    -124, 27, 43, -68, -98, -96, -3, 9, 120, 12, -7, 84,
+    -45, -33, 76, 310, 105, -78, 22, 23, -33, -160, -61, -67,
+    41, -242, -94, -117, -141, -123, -41, -168, 71, 176, 150, -43,
+    60, -79, -220, -226, -295, -141, -298, -243, -116, -114, 13, 16,
+    59, -3, 122, 115, -22, -136, 9, 33, 38, -179, 95, 112,
+    -34, 11, -79, -49, -16, 49, 48, 216, 118, 260, 414, -26,
+    128, 18, 125, 1, 136, 269, 117, 128, 2, 146, 14, 163,
+    2, 158, 37, 39, 157, 29, 45, 181, 30, -133, -139, 40,
+    -84, -109, -71, 73, 26, 24, 38, 31, 10, -109, -116, 22,
+    -73, -187, -58, -63, -54, -40, -152, -111, -89, -46, -162, -28,
+    -30, -132, -1, -13, 114, -9, 104, -51, -196, -57, 79, 157,
+    -3, 12, 14, -148, -134, -96, -225, -195, -183, -161, -148, 15,
+    130, 22, -18, 86, -12, -147, -6, -84, 44, 48, 35, 33,
+    120, 125, 7, -119, 6, 10, -6, -93, -101, -97, -65, 78,
+    -45, 229, -23, -19, -23, -52, 203, 187, 31, 40, 26, -128,
+    37, 248, 122, -76, -50, -68, -37, -9, -24, -16, -262, 22,
+    -89, 40, 52, -121, 35, -80, 13, 153, 121, 106, 91, 321,
+    140, 91, -39, 63, 170, 38, 39, -156, -3, -135, -12, -32,
+    -142, -2, -90, -206, -57, 64, -161, -130, -79, 43, -82, 166,
+    65, -61, -66, 115, 75, 89, -62, 115, 118, -46, -26, 14,
+    127, 136, 379, 207, 142, 251, -22, -32, 96, -34, 89, 75,
+    68, 63, 33, 128, 77, 30, 10, -99, 93, -192, 41, -104,
+    -94, -225, -98, -98, -112, -140, -122, -270, -99, -235, -214, -73,
+    -54, -299, -216, -75, -27, -1, -105, -41, -147, -2, -78, -79,
+    203, 87, 98, 243, 90, 109, 373, 86, 84, 114, -139, 29,
+    40, 16, -30, 129, 248, 84, -100, 26, 11, 11, -231, 38,
+    -96, 23, -111, 39, -185, -167, 68, 86, -155, 97, 219, 68,
+    -28, -179, -28, 80, 95, -68, -179, 107, 79, 71, 57, 16,
+    10, -282, 4, 140, 107, -158, -45, 200, 37, 35, -118, -219,
+    52, -209, -180, -25, -217, -50, -194, -181, -269, -221, -74, -55,
+    -149, 17, -124, 52, 92, 348, -76, 38, 10, 141, -6, -104,
+    -205, -111, -130, -92, 203, 91, -31, -144, 61, 186, -68, 85,
+    69, -71, 228, 70, -50, 94, 193, 182, 244, -48, -72, 196,
+    183, 161, -11, 3, 74, 37, -107, 115, -57, 35, -130, -27,
+    -43, -75, -90, -136, -148, -132, -67, -62, -221, -128, -253, -236,
+    -113, -266, -209, -227, -451, -292, 17, 0, -121, -9, -34, -8,
+    -126, 108, -131, 5, -114, -107, -62, -48, -141, 70, -52, 231,
+    253, 134, 116, 101, 98, -3, -126, 170, 80, 52, -189, -52,
+    -4, 152, 61, 182, 186, 90, 89, 116, 220, -25, 12, 7,
+    60, 102, -13, -2, 161, -77, -54, 199, 153, 275, 154, 127,
+    88, 65, 86, 136, 22, -260, -104, 61, -79, -54, -165, -164,
+    16, -177, -75, 173, 30, -4, -172, 172, 127, -34, 85, -238,
+    -74, -120, -149, -161, -307, -288, 84, -52, -235, -326, -192, -325,
+    -400, -131, 174, 31, 5, -97, -95, -91, -106, -95, 148, 19,
+    -31, -31, -155, -3, -208, -38, -120, -66, -158, -83, 73, 90,
+    -127, -54, 212, -25, 22, 175, 283, 288, 394, 595, 160, 118,
+    355, 226, -58, 70, 153, 25, -86, -169, -50, -4, -5, 125,
+    -139, -270, -115, -109, -70, 180, -48, -215, 0, 160, 244, 158,
+    -140, 32, 0, -20, -52, -111, -237, -52, 113, -106, 74, -32,
+    139, 239, 43, -89, -58, 140, 201, 461, 40, 17, 164, 466,
+    375, 198, -100, -35, 108, -64, 39, 47, -83, 137, 106, 194,
+    -19, -200, -206, 42, -212, -150, -227, -60, -47, -322, -348, -141,
+    -330, -446, -366, -223, -275, -303, -463, -274, -350, -467, -375, -151,
+    -226, -219, -245, -76, -214, -239, -321, -7, -170, -59, -25, -242,
+    127, 251, 101, 496, 456, 443, 705, 749, 958, 1070, 1008, 1337,
+    1117, 1153, 1334, 1131, 1158, 1119, 876, 868, 642, 638, 564, 415,
+    412, 694, 566, 357, 473, 497, 320, 204, 90, 64, -17, -544,
+    -596, -1156, -1340, -1802, -2128, -2959, -3718, -3964, -4680, -5055, -4797, -4663,
+    -4262, -3888, -3256, -2564, -1790, -1105, -572, 211, 821, 1424, 1977, 2466,
+    3051, 3467, 3790, 4048, 4279, 4260, 4208, 4604, 4494, 4284, 4510, 4663,
+    4450, 4299, 3945, 3695, 3331, 3055, 2653, 2570, 2263, 1819, 1357, 767,
+    516, 543, 20, -239, 101, -232, -604, -1261, -2266, -3533, -4508, -6069,
+    -7080, -8073, -8611, -9025, -8962, -9040, -8164, -7651, -6196, -4802, -3173, -1636,
+    186, 1255, 3030, 4480, 5254, 6135, 6559, 6052, 5560, 4980, 4095, 4002,
+    3720, 3068, 2690, 2578, 2471, 2742, 2791, 2893, 3135, 3576, 3705, 3993,
+    3797, 3707, 3093, 2493, 1543, 821, 33, -631, -824, -854, -686, -629,
+    -105, -88, 707, 912, 669, 485, 817, 629, 862, 722, -303, -793,
+    -1420, -3050, -4266, -5686, -7132, -8001, -8225, -9295, -8900, -8993, -8400, -7581,
+    -6094, -5121, -3235, -1966, -534, 987, 2053, 3005, 4073, 4492, 4941, 5004,
+    4832, 4414, 4553, 3606, 3531, 3050, 3033, 2674, 2809, 2613, 2647, 2683,
+    2456, 2598, 2525, 3394, 3511, 3968, 3553, 3293, 2663, 2653, 2197, 1636,
+    1109, 341, -363, -822, -1280, -1072, -1469, -1788, -2474, -1918, -1693, -963,
+    -977, -116, 786, 1260, 956, -303, -626, -2117, -2805, -6610, -8206, -10173,
+    -8909, -9644, -9157, -10806, -8798, -7350, -4070, -2440, 1095, 3637, 6790, 7742,
+    8013, 7020, 7116, 5423, 3210, 264, -1193, -2626, -2034, -2570, -1822, -297,
+    2973, 3271, 5871, 7530, 9180, 9494, 8538, 6318, 4973, 3653, 1621, -213,
+    -867, -1204, -218, 121, 448, 1761, 4391, 4048, 3912, 4759, 4293, 2993,
+    2350, 1218, 615, 501, -179, -249, 1926, 2284, -1440, -6185, -8976, -13477,
+    -11222, -13357, -14558, -14478, -8282, -5645, -1050, 1269, 5214, 9235, 11352, 8808,
+    6287, 5541, 3445, 90, -4584, -6997, -6077, -4807, -3836, -2536, 1258, 5556,
+    8575, 8792, 9962, 9597, 9010, 7927, 4677, 2101, 1463, 723, -1207, -783,
+    474, 1214, 2427, 3299, 4423, 5050, 5700, 4640, 4252, 3653, 3446, 2365,
+    1815, -325, -88, -562, -70, -1082, -501, 223, 491, 782, 1310, 3126,
+    4147, 2173, 1217, 295, -5023, -14079, -17163, -12544, -15693, -14128, -13670, -6977,
+    -648, 6341, 4963, 8328, 12562, 11822, 7145, 1933, -1659, -2700, -4863, -9352,
+    -9067, -4565, -1290, 2336, 4855, 7159, 10549, 12115, 10347, 7501, 5490, 4331,
+    2035, -991, -2192, -256, 848, 1839, 2530, 4156, 6107, 7690, 6502, 5236,
+    5385, 4637, 3880, 2203, 1048, 1396, 3153, 803, 372, -497, 345, -63,
+    -1073, -328, -1053, 883, 2547, 807, 921, 1602, 2968, -2882, -7942, -19037,
+    -14573, -14353, -15600, -15106, -10239, -1166, 3606, 6721, 5034, 11060, 13141, 9169,
+    1554, -2174, -4326, -4314, -7741, -10638, -6793, -1323, 3513, 5184, 7943, 10018,
+    12375, 10700, 6870, 3853, 3007, 1798, -2602, -2599, -1573, 1576, 3332, 4156,
+    4105, 6827, 8662, 7043, 4966, 4576, 5093, 3835, 2373, 1464, 2170, 2221,
+    1908, 856, 655, 1612, 2026, -1522, -3226, -1167, -154, 155, 42, -1095,
+    2977, 1952, 3666, 223, -9423, -18168, -15224, -13118, -15905, -15743, -11726, -2499,
+    5419, 5913, 4086, 11916, 14020, 10208, 3091, -1474, -3612, -4026, -7527, -11438,
+    -7211, -1970, 3001, 6477, 7120, 10020, 13389, 11855, 6458, 5331, 2224, 220,
+    -2745, -3398, -3347, 874, 3045, 3863, 5670, 7325, 7858, 7564, 6703, 4045,
+    4686, 3421, 1372, 1560, 1639, 1503, 2722, 1537, 666, 1415, 536, -453,
+    -2421, -864, 342, 1181, -882, -351, -703, 3519, 2290, 2699, -4202, -16470,
+    -16343, -11239, -16402, -18591, -15564, -6140, 2239, 6657, 3559, 7527, 13922, 12613,
+    6933, 1527, -2098, -3802, -5400, -10052, -10624, -4150, 456, 3153, 4938, 8609,
+    12597, 13988, 8859, 5393, 4875, 1794, -1228, -2997, -3600, -1897, 1782, 1366,
+    4010, 7208, 8515, 7533, 6858, 5552, 5915, 4502, 863, 633, 1357, 1137,
+    1340, 708, 130, 757, 1168, -40, 7, 644, 965, 1031, -697, 1223,
+    1682, 2246, 2065, 958, -3727, -14438, -17198, -10993, -16470, -16214, -14517, -5625,
+    1110, 5081, 2375, 6907, 14488, 12818, 7401, 2037, -553, -3382, -3024, -9247,
+    -11019, -5098, -356, 2187, 4101, 8360, 11809, 13744, 9022, 6249, 5785, 2309,
+    738, -1642, -2897, -3001, 377, 1280, 1492, 4355, 8100, 7361, 6197, 6453,
+    6119, 5501, 2388, 1274, 1450, 1769, 986, 451, -470, -258, 722, 584,
+    321, 1305, 1552, 1592, 322, 1080, -594, 1856, 3394, 682, -5395, -15688,
+    -13906, -13829, -17669, -18237, -14264, -6372, 765, 2983, 1724, 7769, 13982, 13400,
+    8467, 4397, 1238, 1323, -2480, -9104, -9838, -5510, -3440, -1379, 970, 6596,
+    11184, 12533, 9510, 9062, 9035, 6033, 1999, -676, -1271, -1350, -225, -1752,
+    -555, 2040, 4970, 6155, 6368, 5929, 7231, 7116, 4115, 3195, 2849, 2640,
+    966, -26, -1070, -564, -347, -751, -978, 806, 1080, 2755, 1559, -680,
+    2478, 2009, 3756, -1179, -11143, -17848, -9110, -14469, -15306, -18593, -11476, -6288,
+    1784, -109, 3288, 10314, 13653, 12422, 8714, 6931, 4977, 4240, -3322, -8539,
+    -8317, -5538, -5086, -3435, -2330, 2166, 8309, 9606, 8835, 9108, 10789, 9407,
+    5744, 2446, 787, 499, -122, -2421, -2188, 787, 2172, 3094, 4099, 4946,
+    6311, 7704, 5788, 4320, 3632, 3260, 1819, -57, -1419, -1958, -1373, -1519,
+    -1550, -91, 1077, 656, 811, 1844, 3545, 4567, 324, -9091, -13092, -11390,
+    -11238, -15057, -17502, -15180, -9905, -4760, -3421, -566, 4760, 10706, 11909, 11030,
+    9533, 9511, 9225, 4774, -1518, -4364, -4537, -5733, -5746, -7286, -4944, -709,
+    3333, 3351, 6574, 8419, 10421, 9679, 8274, 5067, 5769, 4020, 2698, -117,
+    -1248, -779, 369, 1179, 1658, 2440, 4393, 5273, 5160, 4951, 4468, 3626,
+    2165, 987, -305, -2400, -2474, -2905, -4333, -3168, -2902, -1379, -941, 378,
+    829, 419, -5868, -6171, -8674, -8797, -12261, -13069, -13355, -10255, -8748, -7130,
+    -6002, -1944, 2322, 5612, 6933, 7403, 8010, 9440, 8623, 6954, 3796, 2458,
+    1524, 277, -2180, -3155, -2773, -2200, -1324, 121, 617, 2474, 4786, 5575,
+    5242, 5807, 5440, 5241, 3831, 3128, 1814, 1471, 880, 753, 576, 710,
+    3, 487, 267, 294, -85, 97, -397, -470, -1796, -2327, -2047, -1624,
+    -1764, -1543, -1053, -831, -906, -444, -597, -192, -97, -391, -1054, -1863,
+    -2823, -3056, -3505, -4517, -5189, -4922, -4288, -4183, -3662, -3051, -2161, -1146,
+    -159, 825, 1444, 2018, 2431, 2274, 1830, 1410, 1396, 1477, 1885, 1551,
+    1523, 1314, 1645, 1775, 1659, 1330, 1187, 1232, 1348, 1090, 784, 587,
+    1055, 1359, 1515, 1465, 1756, 1687, 1755, 1409, 1426, 1068, 860, 475,
+    -33, -341, -601, -886, -897, -1008, -969, -758, -624, -330, -111, -24,
+    -6, -90, -114, -402, -541, -864, -1018, -1358, -1557, -1567, -1482, -1415,
+    -1305, -1138, -1049, -1002, -838, -940, -940, -902, -1021, -1074, -1034, -1063,
+    -1037, -972, -629, -450, -310, -160, 152, 515, 860, 993, 1216, 1187,
+    1390, 1427, 1268, 1175, 1127, 1073, 1098, 886, 1035, 1118, 1304, 1419,
+    1429, 1375, 1472, 1331, 1132, 995, 787, 679, 310, 236, 129, -136,
+    -57, -145, -138, -155, -169, -143, -266, -403, -331, -266, -495, -615,
+    -758, -808, -834, -785, -869, -883, -759, -935, -821, -689, -571, -793,
+    -754, -692, -616, -371, -341, -380, -495, -453, -524, -418, -571, -549,
+    -513, -312, -233, -153, -154, 196, 383, 469, 704, 464, 650, 762,
+    636, 419, 612, 687, 461, 459, 440, 533, 461, 474, 520, 603,
+    468, 581, 542, 276, 307, 318, 372, 100, 220, 163, 240, 21,
+    0, 29, -198, -182, -326, -201, -101, -325, -226, -150, -282, -320,
+    -238, -319, -188, -419, -363, -228, -94, -224, -228, 235, -15, -102,
+    60, -54, 103, -51, -159, -448, -570, -463, -339, -519, -570, -411,
+    19, -154, 377, 502, 291, 358, 533, 699, 660, 260, 161, 370,
+    542, 273, 250, 46, -663, -687, -1052, -2939, -1139, 2568, 3313, -748,
+    -1431, 1832, 4001, 2677, 527, -1450, -744, 198, 816, -503, -1320, -772,
+    -985, -240, -482, -1965, -1252, 117, 242, -38, -372, -513, -862, 1263,
+    1037, 174, 369, -195, -152, 426, 450, 3, -655, 137, -397, -26,
+    -142, -660, -477, -1419, -304, 270, -605, -223, -83, 224, -235, 276,
+    723, 365, 74, -3, 1275, 903, -206, 660, -878, -679, -609, 1107,
+    672, 200, -1213, -1291, -546, -202, 509, 188, 1224, 550, 1243, 1471,
+    -257, 253, -895, 700, -278, -572, 213, 1041, -359, 286, 694, -1036,
+    50, -2059, -1344, -759, -553, 4, -447, 25, -300, 291, -358, 2187,
+    1407, -253, 2319, 569, 998, -393, -1003, 2064, 857, 1856, -1606, -3107,
+    65, 200, 2706, 1801, -1858, -1233, -1321, 1550, -21, -593, 1674, -23,
+    58, 54, -1238, 535, 1361, -108, 67, -890, 686, 254, -1013, 467,
+    543, 32, -437, 280, 648, -522, -489, -1062, -57, 423, 1205, -3459,
+    -2782, -721, 1403, 883, 70, 610, -332, 1207, 1691, 1008, 1177, -608,
+    -740, -265, -565, -8, -495, -731, -683, 354, 924, -276, 101, 220,
+    689, 670, 1020, -47, -585, -1818, -1975, 230, 335, 359, 521, -1948,
+    270, -1124, -540, -2205, -824, 123, 1096, 2283, -738, 1040, 2471, -965,
+    -1978, 2700, 2437, -1834, 3510, -1237, -470, -1283, -1420, 3828, -1619, 1742,
+    -2685, -2548, -4322, -2926, -3461, 5451, -1227, 2095, 563, 3296, -98, -2097,
+    359, -1140, 14, -858, -817, 1293, -3854, -453, -7830, -564, 1772, 2676,
+    1072, -1760, -1751, 2567, 1927, -2636, 2026, 3623, 2255, 1694, -2652, 3365,
+    957, -2631, -3818, 1304, 250, 4213, -5929, -3559, -3247, -1822, -3921, -1461,
+    1988, 6011, -2001, 2454, 21, 1837, 2080, 2921, -3913, 322, 2024, 39,
+    -1685, -4227, 87, 1047, -1458, 1330, 3155, 4397, -4029, 446, 1886, 1351,
+    -753, 289, 6778, -1098, -1739, -3342, 4323, 2037, -1370, -4169, -2080, 2940,
+    -1191, -1056, 2682, -246, -3959, 1436, -2966, 1663, 3763, 2071, 3516, 5812,
+    -6904, -4548, 498, -92, 2852, -6720, 1405, -4692, -3494, 832, -4965, 6387,
+    294, -4380, 1187, -1887, -1482, 2677, -3721, 3058, 136, -3712, -593, -4317,
+    -5645, -32, 4260, -537, 2738, 456, 6773, -3756, -2344, 7718, -3757, 5515,
+    3744, -3231, 742, -1999, 1261, 4356, -55, -8175, 3485, 882, 5008, -3442,
+    4583, -3877, -3377, 2550, 541, 668, -2978, -826, -3669, -6726, 888, -3299,
+    -1077, -5999, -1157, -4912, 608, -1706, -2038, 385, -1234, -7340, 3578, -930,
+    1711, 2367, -5356, -509, 3319, -582, 4351, -939, -3882, 4598, -414, -6087,
+    -819, 122, 3909, -5026, -1734, -1650, 3662, 2570, -1518, -195, 3988, -1147,
+    1404, 4873, 1376, -158, 2885, 3580, -1962, -1739, 1504, -73, 521, 920,
+    -563, 412, -6001, -718, 4668, -4457, 580, 775, -2553, -3047, -2912, 3986,
+    -3844, 2540, 3649, -3587, 2620, -3776, 2091, 9523, -5236, 352, -1306, 4748,
+    -2122, -1694, -305, 5985, 1274, -3726, -1013, 3249, -3700, 639, -2863, 4249,
+    5979, 2612, -646, 3775, -1233, -1195, 1321, 2160, 395, -863, 151, 2952,
+    8983, 1263, -2844, 4965, 2992, 5589, -3515, -2365, 251, 1448, 4714, -4294,
+    4694, -6570, 3119, -1580, -517, 1803, -5378, 1697, -2531, -3897, -1369, 140,
+    -73, 1910, -1110, 1025, -794, 2811, 265, 238, -1367, -1332, 1943, -5536,
+    -328, -2525, -1408, -9074, 2557, -3562, -5500, -2531, 1383, 353, -5736, -925,
+    586, 2365, -6733, 2911, -86, -2904, 3546, -3123, -2223, 1113, -4459, 5278,
+    -4151, -791, -2185, 4959, 1615, -8259, -2613, 756, -89, 134, 2002, 4615,
+    1938, -1914, 7904, 6558, -154, 3149, 3054, 2446, -7772, -1660, -439, 584,
+    -2392, 506, -4109, -2132, -160, -6384, -2008, -159, 5040, -6323, 341, -736,
+    1693, -1449, -2444, 5108, 113, -477, -4799, 4855, 438, 267, 3311, -4204,
+    -941, 5110, -1090, -5178, 1157, -5531, -2918, 764, 1566, -2216, -2355, 1950,
+    3047, -389, 3237, 475, 1799, -211, 4056, -2549, 4877, 5187, 3414, 5241,
+    1061, -5918, -1382, 3919, 2468, 2652, 4706, 3426, 1545, 1821, -340, 3463,
+    3973, 4285, -2907, 284, 1660, -2453, 489, -1367, 21, 2258, 5762, -6560,
+    2007, 4222, -1649, 1640, -6356, -9, -2807, 554, 1520, -5318, 4434, -335,
+    4133, 628, 137, 7925, -5420, 1401, -1435, -414, -1635, -500, -547, -2751,
+    -2091, -4354, 6937, -227, -3983, 65, -210, -1215, -2951, -1762, 4794, 4351,
+    -2939, 3234, 1268, 3407, 3416, -285, -2895, -1873, -3980, 7710, -4466, -374,
+    193, -3121, 306, -5934, -708, 4415, 4186, -350, 4124, 2771, 260, 1923,
+    -1011, 5826, 924, -3318, -3107, -817, 3733, -957, -1298, -775, 7840, 1452,
+    691, 3436, -1127, 5149, -7969, 4034, -4611, 5549, -3508, 2312, -5195, 887,
+    1895, -5742, -2996, 1332, -2681, -1665, -1045, 1757, 11558, -7344, -3491, 5941,
+    1497, 4337, -99, 2476, -140, 535, -1925, 2983, -1018, -932, 9268, 1635,
+    -1490, 3032, -4247, -1226, -563, 494, -1945, -4013, -212, 123, 1392, 1367,
+    -4919, 2218, -1251, 830, 5263, -2173, -4330, -2645, 45, 7045, 255, -3082,
+    2546, 2304, -1865, -510, 1368, 3322, -7, -4786, -299, -328, 3114, 2962,
+    -2190, 5213, 865, -387, -5172, -396, 2233, 2203, 517, -2655, -1779, -580,
+    6531, -4562, 6346, -2001, 2270, -3748, 2184, -794, -2472, 3390, -7028, -2155,
+    -611, -1152, -839, -4691, 4595, -714, -440, -3051, -3213, 317, -5180, -4495,
+    3700, -5308, 1839, -33, -3038, 1418, -4312, 3321, 3057, 1508, -2764, -4215,
+    -605, 1815, 4833, 3380, 4524, 3799, 2742, 5408, -361, 1246, -2918, -4764,
+    2525, -49, -4121, -6690, -568, 2780, 5259, -2168, 2267, 8250, 1520, 5974,
+    -3097, 508, -6194, 6542, -5786, -706, 1460, 3410, -6455, 3272, 7417, 1259,
+    -7775, -5470, 2089, 6, -769, -3670, 177, -4721, 2803, 1647, -2271, -149,
+    -1920, -3233, 2070, 1330, 3500, 1541, 4525, 6274, 495, 1213, -5883, 776,
+    155, -5438, -1824, 726, -2518, -4544, -7820, 3627, -6037, 76, -3646, -282,
+    340, -4448, -2144, -5808, -6269, 790, 1899, -2055, -3515, -13071, 2892, 5739,
+    -1282, -1193, 1987, 5969, 469, -1282, -1378, -5279, -12366, -4932, -6135, -327,
+    -6520, -3438, 409, 2156, 879, -8237, 35, 2750, 6508, -982, 244, 6024,
+    547, -1638, -4993, -4308, 1511, 3336, -4134, 2133, -5700, -6828, 1456, 3267,
+    -4653, -2929, -165, 6977, -40, 983, 4759, 5761, 413, 5806, 8867, 1922,
+    6855, 8459, 880, -6044, -6111, 269, -255, -4528, -7046, -12451, -8201, -4802,
+    4861, -414, -32, 3783, 1373, 1640, 7157, 4143, -3233, 544, 2662, 7007,
+    3796, -4290, -12286, -1973, -6753, 1094, -2048, -752, 3204, 1812, 605, -4141,
+    -4993, -9622, -719, 3777, -1851, -6373, 552, -6997, 500, 428, 5879, 2028,
+    -3995, -2468, 3151, -214, -9386, -2052, 9913, -4275, -5596, 2223, 4525, 2755,
+    -714, -170, 1429, -2140, 67, -226, -3941, 1927, -710, -417, 1196, 1356,
+    5638, 8874, 4092, 885, 887, 2531, 1635, 288, 1639, -1186, -150, -1318,
+    -1274, 1845, 174, 799, -2089, 2469, 4157, -724, 2523, -5002, -2121, -3456,
+    1193, 1885, -507, -3884, 327, 1714, 2722, 1060, 4522, 2782, 1597, -3229,
+    -1358, 6285, 2148, -45, 1498, -722, -401, 67, 1647, -130, 1375, -618,
+    -3156, -902, 3737, -87, -6720, 922, 874, -1240, 2662, -41, 9219, -699,
+    -381, -2780, 2077, -281, 1786, 3509, 3433, -2576, -3850, 3278, 1335, 691,
+    2514, 4240, 2992, -1698, -1285, 1983, 3248, -2323, -99, 544, 3093, -408,
+    -2322, -750, 534, -1388, 984, 1419, 219, 128, -153, 1774, 3084, 1055,
+    1051, 1332, -539, -651, -735, 423, -1836, -701, 2345, 1728, -2952, -3980,
+    3462, -255, -1857, 1298, 913, 1279, 699, 265, -715, -1265, -1682, 1038,
+    3158, 213, 1025, -1896, -1142, -1838, 71, -396, 620, 2016, 2559, 90,
+    3320, -650, -187, -372, -690, -554, -421, -1517, -1025, 29, -377, 894,
+    -249, -612, 1288, 56, -292, -76, -341, -506, 457, -883, -172, 749,
+    -1180, -208, 457, 250, 1775, 1494, -280, 573, 899, 236, 707, 442,
+    165, 579, 324, 452, 722, 2281, 2472, 1776, 1565, 1170, 686, -169,
+    1186, 535, 82, 29, 737, 684, -33, 303, 1234, 1039, 1110, 1151,
+    433, -1114, -900, -1336, -2158, -2161, -2635, -2403, -1743, -3205, -1814, -3591,
+    -3810, -4360, -2787, -3915, -2719, -2475, -2542, -809, -628, -468, 600, 1618,
+    2373, 3649, 3218, 3737, 3972, 4583, 5069, 4822, 3937, 3601, 4420, 4191,
+    3965, 4009, 3904, 3126, 4084, 3479, 3549, 1961, 1375, 1412, 2077, 1689,
+    240, -916, -706, 242, 782, 1183, -583, -1022, -3468, -8202, -8769, -11172,
+    -10444, -10143, -9441, -10329, -6811, -4576, -555, 1220, 1979, 2894, 3601, 3334,
+    3355, 2154, 1060, -456, -28, -940, 356, -332, -1158, -90, 161, 555,
+    1664, 2450, 2564, 4796, 5392, 5719, 5253, 3986, 3795, 3098, 2769, 2836,
+    2643, 2888, 3738, 3686, 4266, 3771, 2772, 2805, 3112, 2698, 1562, 428,
+    -613, -64, -1250, 263, -1084, -423, -1390, -710, -5695, -7575, -11328, -11025,
+    -9543, -9665, -10083, -8286, -6089, -2636, 811, 1731, 1295, 2187, 1188, 4670,
+    3371, 2936, 1124, 1157, -1242, 893, -1006, 325, 506, 493, -197, 1033,
+    -609, 1760, 2391, 3067, 3665, 4038, 3904, 4185, 3481, 1143, 1514, 1886,
+    3285, 4011, 3800, 2531, 2647, 2216, 1266, 1739, 1532, 853, 2077, 943,
+    1176, 861, -221, -469, -110, -220, -739, 738, -3843, -6241, -11736, -11959,
+    -11451, -7449, -7871, -5498, -4489, -3154, 451, 2593, 2267, 2651, 1468, 1926,
+    2963, 1387, -1039, 88, -2023, -141, 619, 1547, 2449, 2961, 1025, 2436,
+    1968, 2514, 3273, 3835, 3319, 3529, 3002, 2939, 2940, 861, 2504, 2661,
+    4090, 3601, 4025, 2944, 4331, 3294, 2708, 1414, 624, -279, 727, 29,
+    -221, -1874, -1625, -2068, -861, -2124, -1202, -1386, -1686, -2561, -6660, -8242,
+    -10960, -9599, -9908, -8423, -9001, -5776, -3650, -310, 1388, 1225, 718, 1588,
+    2174, 3260, 2092, 1625, -312, 1102, 399, 1789, 412, 844, -366, 1905,
+    1356, 3244, 2619, 4234, 4374, 5457, 4706, 4579, 3118, 2843, 3148, 3243,
+    3163, 2821, 2596, 2424, 2870, 2374, 1886, 1676, 842, 838, 1154, 635,
+    -133, -317, -1012, -1463, -2000, -2939, -2351, -2012, -872, -644, -1079, -1802,
+    -4063, -5893, -8407, -9446, -10078, -8989, -8404, -7528, -6235, -4234, -466, -233,
+    880, 1359, 2999, 2043, 2752, 2060, 2185, 1447, 1252, 1345, 1813, 149,
+    562, 647, 1961, 2229, 3210, 3623, 4588, 4263, 5192, 5207, 4418, 3372,
+    2880, 2332, 2408, 1819, 1976, 2117, 2422, 2184, 2661, 1640, 1593, 668,
+    378, 51, -73, 242, 53, -584, -1217, -898, -1803, -2538, -2505, -2133,
+    -2864, -2492, -2332, -2316, -1837, -2832, -3733, -3930, -5035, -6450, -5965, -5455,
+    -5571, -4215, -3840, -1843, -1550, -782, -53, 385, 360, 1324, 1396, 1576,
+    1626, 1548, 1263, 1432, 1134, 1436, 2049, 2742, 3174, 3636, 3952, 4523,
+    4432, 4265, 3978, 2949, 2881, 2133, 2519, 2538, 1461, 1347, 2312, 1386,
+    357, -1105, 2218, 857, 620, 177, -275, -38, -1044, -537, -175, -2550,
+    -25, -1409, -1210, -2709, -2811, -2209, -1404, -2788, -1743, -2472, -1381, -1101,
+    -1415, -3123, -1749, -2949, -2353, -3510, -3190, -2297, -2822, -1943, -743, -312,
+    -1916, -992, -447, -96, 952, 456, -470, 1142, 1180, 1144, 1694, 2159,
+    3225, 1823, 2036, 2986, 3917, 3348, 2149, 3137, 2112, 1071, 1093, 1841,
+    1894, -2206, 2742, 2269, 693, 481, 2264, 3766, 1615, -1633, 2908, -1196,
+    514, -863, 489, -951, -3060, -3656, -3752, -1526, -1039, -3521, -788, -969,
+    -1894, -581, -4346, -2177, -1328, -1573, -1771, -1529, -387, -453, -2576, -508,
+    -700, -2877, -3164, -856, -1777, -628, 911, -945, -1085, -270, 261, 2138,
+    689, -883, -1898, 1520, 873, -2763, -2331, 897, 2765, -1685, 590, 1843,
+    391, 938, 2973, 1229, 987, -2080, -198, 1754, 1002, -1987, 1091, 733,
+    1809, -1105, 1964, 2491, -3087, -2759, 1006, 1075, -1882, 41, -454, 2113,
+    2525, -1748, -2970, -3119, 3559, 128, -4719, -1018, -4467, -1365, -2329, 371,
+    -3803, -4035, -1003, -1271, -3826, -1148, -2498, -1164, 2433, -1439, -3107, 2404,
+    1039, -3244, -117, 1765, 1686, -1326, -4005, 12, 1216, -1647, -364, 203,
+    2464, 1837, 1341, 1981, 2677, -3427, 1325, 916, 1153, -1388, -594, 4819,
+    -3034, 1461, 3343, 2808, -49, 1797, 1105, -1971, -4631, -232, -3420, -3630,
+    -596, 57, 2697, -2757, -3288, 822, -1105, -98, 1250, -3698, -917, 1454,
+    3917, -615, -417, 3592, 2079, 551, 2375, 995, 951, -1538, -782, -1256,
+    233, -601, -5016, 3517, 1420, 480, -2903, 2596, -790, -1425, 3806, 1355,
+    2901, 40, -5122, 1273, -431, -2330, -2018, -2805, -284, 92, 219, 535,
+    65, -1376, 2224, 3832, -2688, 7, 2365, 1749, 1824, -7033, 3974, 3808,
+    -3942, -594, 354, 680, 1986, -5678, -489, 1492, -2288, -5977, -1206, -1686,
+    -1292, 1850, -1241, -1772, 918, 293, -2438, 3556, -3060, -2061, -479, 1322,
+    927, -2746, 3064, -2562, -3321, 2801, 2716, -5092, -1509, -2180, -167, 896,
+    1563, 813, -1841, 1428, -945, -2567, 2328, -674, -290, 1986, -1671, -2872,
+    -3641, -1976, -112, 523, 2256, -997, 4206, 2936, 3581, -304, 1231, 2202,
+    1175, 2500, -5117, -763, -3538, 411, -2001, -2694, 3135, -2229, -669, -579,
+    -2021, -289, -1998, -53, 953, 3833, -1618, 383, -4407, 1568, 3757, 963,
+    -23, 1730, -608, 361, 1485, -3589, -4407, -774, -480, 754, -1515, 715,
+    3213, -320, 1848, 619, -2414, -2891, 1783, -769, 2468, -4287, 3509, 3269,
+    -296, -419, -2168, -818, 1862, -1220, -4085, 5538, -274, -789, -2135, 2012,
+    4927, -1332, -4064, 689, 3945, 2607, 378, -2434, -4874, -3681, 337, 692,
+    231, 2066, -179, 3896, 2737, -427, 488, -1873, -2765, -465, 1826, -2202,
+    1593, -2301, 405, -854, -805, 401, 991, 484, 2093, -2970, 672, 19,
+    429, -312, 1738, 5486, 1137, -5158, -3531, 5120, -2242, -1464, -4029, -791,
+    4116, 2783, 280, 1914, -2947, 496, 1074, 5202, -1513, -3712, 1587, 1049,
+    -54, -1988, 4861, 2565, 829, 3654, -1528, 964, 757, 2600, 725, -6374,
+    354, 1789, 2676, -801, 622, -23, 1368, -2380, 290, -3605, 1863, -292,
+    4677, 848, -3619, -6660, 284, 5221, 9430, 944, -1993, 4822, -2110, 3076,
+    3721, 2504, 2364, -1709, 1145, -2152, 1832, 5594, -5533, -1455, 2588, 1057,
+    -2414, -642, 1469, -1757, 3566, 2104, -3582, -1895, 2380, 530, -3951, -2921,
+    -1804, 2388, 4973, -814, -685, 1428, 1810, -4295, -2628, 1736, 3936, -745,
+    -2228, 776, 2902, -1341, -3433, -1704, -654, 1611, -2715, -3421, -2286, -233,
+    4729, -2271, -4374, -4196, -378, -1568, 605, -290, -6572, -499, 1878, 2616,
+    -3299, -3712, 553, -2535, 5903, -2477, -6559, -2183, 2340, 2323, -168, -432,
+    3307, 4412, 4244, 3483, 1448, -2279, -1311, 2009, -1324, 3580, 1944, -3525,
+    993, -5678, 2000, 6174, -731, -3481, -224, 45, 592, -592, -773, 113,
+    4645, -2638, -4042, 382, 1240, 863, 3932, -8231, -1247, -1540, -1636, 1608,
+    -2995, -1659, 161, 1562, 1590, -2767, 3082, -2613, -5380, 2724, 3736, -4309,
+    -2134, -2319, -3455, -4098, 1161, -164, -154, -7522, 3790, 1937, -714, -2393,
+    -1608, -3728, 5237, 3084, -541, -2425, 1156, 3307, 5990, -4324, -2018, 697,
+    4983, -594, 1336, -812, -2158, 3703, 3739, 1020, -3846, 2745, 6326, -3345,
+    1358, -1539, 2960, -2618, -1827, -3123, -2649, 329, -124, 1290, 2004, -4522,
+    -735, -2927, 4952, -1049, 3234, -1926, -2260, -1025, 5416, 2253, 457, 2429,
+    -807, -746, 480, 1247, 4934, 953, -4517, 2608, 2189, -867, 4686, 971,
+    833, 2954, 1165, 872, 2707, -3418, 29, -3059, 1536, 1271, -577, 2767,
+    3858, -2563, -783, -3909, 5125, 2592, 3, 4572, -2946, 136, -1867, -99,
+    2137, -2625, 3818, -1084, -524, 1843, -5819, 1056, -460, 3823, 460, -3010,
+    687, 1902, -200, 786, 4758, 2382, 913, 717, 195, -662, -2136, 292,
+    840, 315, 1336, -2783, 2129, -215, -1863, 2586, 1744, 4690, -4719, -1931,
+    4104, 1021, -3357, -3434, -1361, 4133, 1525, -4257, -5688, -3342, -2649, -2684,
+    1878, 1877, 1077, -2938, 5703, -4092, 3218, 69, 3473, -3895, 586, 2669,
+    726, -3878, 3965, 1481, 415, 1682, -1308, 1496, -1219, 6538, -4432, 4915,
+    -5186, 3380, -3293, -2474, 687, -2547, 4096, -6152, -309, 6786, -493, 5134,
+    -1737, -421, -671, -938, 1855, -3930, -211, -2472, -4904, -241, -2026, 3571,
+    -2352, -1677, -2664, -725, 1002, -221, 2183, 76, 620, 2496, 561, -1222,
+    -5335, -3477, 2038, -429, -6654, 2289, -128, -1297, 650, -1777, 3272, -1812,
+    2964, -839, -4678, 41, -895, 1067, -571, 3342, 3303, 3988, 334, -3685,
+    -92, -2628, 2383, 1409, 2005, -2505, -627, -539, -946, 1556, -1393, -637,
+    884, 2458, 440, 1010, 2713, 671, -496, 2213, 2649, -402, -912, 1435,
+    1047, -1773, -877, 176, 1741, 1231, 992, 625, 795, -663, -1152, 303,
+    680, 665, 848, -1019, 511, 1392, 1279, 345, -648, -840, -806, -1226,
+    267, -1271, -1221, -2180, -109, -474, 1068, -272, -2175, -4345, -1868, -1226,
+    -1068, 1358, -456, -1152, -414, 1616, 1596, -338, -853, 88, 455, -350,
+    -1544, 1331, 171, -831, 431, -196, 2198, -373, 1008, 1337, -621, 530,
+    216, -279, -391, -202, -1285, -844, 245, 1316, -324, -1488, -1284, -252,
+    -1548, -177, -99, -489, -29, 1219, -43, 293, 729, 219, -93, -42,
+    -313, 1164, -89, -398, -369, 710, -61, 549, 366, 229, 176, 192,
+    -999, 213, 550, -500, -4, -198, 355, -365, -188, -279, 90, -392,
+    380, -28, -416, 343, 250, 767, -195, -595, 108, 76, -670, 188,
+    -612, 449, 504, -679, -83, 488, 495, 225, 341, 657, 560, 124,
+    34, 104, -172, 89, 198, 691, 402, 221, -62, -74, 315, 566,
+    245, 404, 600, 672, 214, 277, 374, 235, 425, 341, 8, -82,
+    472, -87, -386, -214, -356, -510, -632, -1097, -1294, -1389, -2013, -2189,
+    -2607, -2280, -2316, -2713, -2152, -1949, -1412, -349, 300, 1353, 1858, 2189,
+    2408, 2518, 2329, 2753, 2685, 2280, 2421, 2452, 2118, 1761, 1984, 1829,
+    2049, 2106, 2571, 2795, 2666, 2849, 3502, 2012, 1949, 913, 1425, 2085,
+    2490, 2427, 144, -5176, -9901, -12564, -14034, -12066, -9612, -6597, -3662, -1625,
+    2431, 6765, 9796, 11054, 10211, 6632, 3196, -212, -2490, -4345, -6121, -6576,
+    -5766, -3320, 419, 4268, 7043, 7617, 7412, 6158, 5081, 3687, 1564, -841,
+    -2355, -3172, -1688, 133, 2172, 3812, 4492, 4579, 4922, 4445, 3799, 2694,
+    1672, 1457, 1443, 1724, 1876, 1284, 1021, 1215, 2032, 3421, 3409, 4385,
+    4156, 723, -5287, -12063, -17838, -16049, -13236, -7581, -3368, 1614, 2611, 7104,
+    9383, 10967, 8838, 4647, -2388, -6834, -9297, -8980, -6582, -4205, -1180, 2412,
+    6069, 9210, 10770, 8154, 4429, 783, -2969, -4593, -4772, -3385, -2194, 79,
+    2102, 3866, 6007, 5979, 4792, 2785, 1276, 160, 477, 1069, 1496, 1635,
+    2108, 3173, 3940, 4559, 3899, 2831, 1820, 1360, 613, 612, 1250, 1794,
+    2634, 4523, 4227, 3852, -3023, -7884, -15120, -15775, -11963, -5837, -349, 3318,
+    3924, 3838, 3124, 2652, 2102, -1042, -4516, -7589, -8371, -6371, -1099, 2298,
+    5161, 4415, 4315, 3112, 3383, 2770, 1682, -886, -2827, -2691, -1879, 1307,
+    3040, 4080, 3676, 2737, 2463, 2644, 750, 94, -921, -1296, 88, 2168,
+    3289, 3545, 3147, 1619, 762, 380, 743, 619, 943, 567, 2136, 2529,
+    3285, 3160, 1718, 1624, 1979, 1995, 3478, 3413, 3670, -90, -6588, -12668,
+    -16636, -14589, -8973, -1660, 3906, 5032, 3712, 1933, 526, -252, 70, -2109,
+    -4247, -5689, -5264, -2380, 1900, 3984, 4738, 3496, 2131, 2209, 2795, 2738,
+    2397, 528, -1487, -1481, -498, 1657, 3443, 3892, 3091, 2410, 1196, 1524,
+    879, -439, -1374, -1162, -140, 2359, 4232, 4237, 3651, 1557, 231, 104,
+    188, 553, 902, 537, 729, 1012, 1718, 1616, 1464, 620, 852, 940,
+    1568, 2655, 2992, 3200, 3767, -1217, -4477, -10975, -15582, -14012, -9721, -2641,
+    2636, 5011, 3834, 1872, -803, -1152, -388, -959, -1462, -3671, -4690, -3534,
+    -944, 1907, 4823, 4688, 3873, 3074, 1989, 1727, 1287, 388, -917, -1404,
+    -1480, 877, 2392, 3882, 3842, 2350, 992, 174, 176, 969, 1126, 1395,
+    1439, 1767, 1944, 2369, 2265, 1444, 1113, 428, 265, 686, 288, 602,
+    347, 457, 900, 1109, 1710, 1473, 645, 142, -114, 17, 635, 1288,
+    1916, 3031, 2197, 29, -3396, -8202, -12485, -12132, -10935, -5246, 17, 3067,
+    3921, 2082, -559, -1396, -1985, -1502, -1066, -2009, -2630, -2459, -1389, 1109,
+    3597, 4303, 4205, 2532, 1031, -54, -333, -274, 426, 225, 1027, 1495,
+    2231, 3265, 3036, 2694, 1567, 282, 397, 401, 1353, 1332, 1613, 1162,
+    1165, 1353, 1653, 2117, 1497, 916, 569, -118, 157, 572, 755, 1020,
+    650, 323, 647, 582, 353, 186, -650, -461, -143, 35, 431, 699,
+    1135, 1563, 854, -34, -2813, -5859, -10020, -10826, -10851, -6836, -2019, 1516,
+    3401, 2363, 651, -1121, -1689, -1218, -443, -138, -824, -1127, -1022, 343,
+    2077, 3950, 4031, 3225, 1337, 5, -639, 84, 795, 1878, 2297, 2164,
+    2068, 1999, 2314, 2004, 1783, 957, 482, 512, 265, 736, 667, 941,
+    949, 1354, 1450, 1586, 1646, 1187, 753, 195, 34, 33, 370, 648,
+    498, 530, 374, 93, -327, -215, -217, -403, -456, -757, -735, -458,
+    6, 652, 1791, 1050, -202, -2313, -5698, -7887, -9924, -9152, -7023, -3844,
+    -557, 1357, 1747, 1222, 563, -395, -247, -652, -508, -968, -941, -531,
+    303, 1524, 2566, 3425, 2857, 1842, 603, 244, 311, 602, 1786, 1853,
+    2051, 2137, 1797, 2135, 1877, 1585, 1341, 1142, 977, 675, 970, 1253,
+    1341, 1660, 1443, 1557, 1286, 1037, 893, 401, -114, -165, -314, -24,
+    68, 209, 410, 222, 113, -15, -389, -691, -783, -887, -903, -191,
+    187, 737, 821, 1017, 43, -1665, -2696, -5155, -6741, -8078, -8352, -7192,
+    -4782, -1857, 545, 1994, 2192, 1072, -228, -865, -965, -933, -707, -506,
+    -102, 84, 943, 2084, 2802, 3150, 2585, 1773, 836, 188, 288, 1178,
+    1457, 2151, 2186, 1995, 1884, 1554, 1725, 1303, 1029, 741, 467, 604,
+    966, 1449, 1549, 1421, 1434, 1226, 906, 973, 401, 186, -474, -787,
+    -519, 40, 666, 653, 697, -31, -368, -642, -519, -123, 272, -15,
+    -785, -1331, -1553, -906, 53, 654, 525, -582, -2811, -4398, -6411, -7136,
+    -7024, -5803, -3613, -1960, -305, -225, 603, 720, 521, 395, 27, -69,
+    -446, -311, 278, 603, 1573, 2035, 2250, 2138, 1355, 1229, 643, 1056,
+    1107, 1520, 1910, 1747, 1801, 1738, 1935, 1855, 1836, 1583, 1320, 1041,
+    1107, 914, 1182, 1319, 1162, 1486, 1236, 1254, 1221, 739, 497, 180,
+    158, 133, 232, 352, 167, 107, 145, -308, -274, -646, -718, -808,
+    -1089, -1267, -1034, -1119, -518, -40, 189, 218, -723, -2035, -4318, -6312,
+    -6902, -6405, -5271, -4386, -2247, -1006, -397, -246, 607, 755, 486, -11,
+    -272, -264, -653, -124, 533, 1420, 1777, 1791, 2031, 1749, 1758, 1569,
+    1703, 1706, 1767, 1906, 1994, 1886, 1734, 1659, 1568, 1787, 1312, 1285,
+    1150, 755, 869, 1036, 1244, 1142, 1439, 1144, 971, 918, 591, 439,
+    217, -6, -187, -143, -147, -62, -173, 125, -9, -190, -102, -612,
+    -801, -988, -846, -644, -477, -496, -225, -276, -110, -160, -1324, -2486,
+    -4238, -4836, -5330, -5425, -4545, -3787, -2903, -2102, -661, -97, 451, 566,
+    194, 68, -226, -608, -462, -32, 282, 819, 1032, 1546, 1441, 1584,
+    1482, 1688, 1246, 1489, 1636, 1409, 2132, 1592, 2114, 1633, 1749, 2002,
+    1559, 1667, 1263, 1288, 1193, 1298, 1400, 1570, 1400, 1206, 714, 566,
+    591, 431, 661, 311, 168, -53, -165, -76, -58, -277, -251, -742,
+    -685, -615, -494, -295, -605, -704, -885, -1033, -1093, -642, -253, -284,
+    -375, -1299, -2075, -3209, -3594, -3877, -3943, -3641, -3427, -2731, -2084, -1266,
+    -864, -435, -2, 125, 19, 161, 118, 86, 195, 335, 500, 638,
+    816, 1382, 1432, 1756, 1734, 1789, 1752, 1574, 1741, 1675, 1517, 1432,
+    1458, 1621, 1378, 1550, 1287, 1618, 1380, 1521, 1333, 1171, 958, 786,
+    819, 715, 704, 716, 438, 160, 81, -27, 34, -135, 34, -133,
+    -337, -274, -350, -233, -378, -677, -713, -885, -914, -1058, -1307, -1089,
+    -1276, -1027, -1069, -1379, -1999, -2476, -2949, -3362, -2971, -2863, -2285, -1948,
+    -1213, -1272, -804, -600, -273, 48, 52, 163, 103, 72, 177, 571,
+    657, 917, 1000, 997, 1166, 1208, 1245, 1439, 1520, 1463, 1397, 1550,
+    1380, 1471, 1368, 1433, 1162, 1331, 1267, 1387, 1368, 1228, 1173, 985,
+    1028, 954, 736, 565, 375, 179, 192, 41, 65, 66, -44, -184,
+    -404, -580, -611, -541, -412, -406, -429, -779, -760, -906, -744, -691,
+    -955, -999, -1131, -1017, -944, -1231, -1110, -1070, -1424, -1942, -2467, -2560,
+    -2185, -1843, -1143, -883, -690, -667, -417, -383, -196, 191, 156, 133,
+    87, -170, 247, 409, 662, 761, 900, 1120, 904, 779, 928, 1041,
+    1168, 1282, 1237, 1209, 1369, 1306, 1511, 1542, 1452, 1442, 1326, 1023,
+    817, 949, 1017, 1097, 1118, 737, 669, 503, 466, 482, 467, 437,
+    468, 371, 90, -278, -135, -136, -482, -689, -946, -1057, -1256, -989,
+    -1008, -931, -935, -1219, -1173, -1194, -1041, -1089, -1315, -1381, -1612, -1648,
+    -1293, -1129, -1174, -1030, -976, -989, -1052, -798, -673, -339, -252, -149,
+    -255, -208, 138, 561, 775, 704, 919, 703, 708, 837, 923, 897,
+    1076, 1030, 1081, 1116, 1129, 1244, 1302, 1308, 1074, 1086, 745, 872,
+    716, 724, 683, 678, 529, 499, 396, 442, 271, 310, 344, 168,
+    -33, -170, -300, -240, -79, -267, -458, -660, -938, -967, -986, -789,
+    -720, -959, -591, -659, -698, -826, -893, -870, -632, -910, -1035, -971,
+    -843, -798, -728, -771, -566, -392, -168, -35, 57, 143, 34, 111,
+    401, 329, 268, 320, 589, 297, 378, 209, 411, 381, 515, 534,
+    556, 553, 674, 676, 530, 635, 597, 428, 494, 324, 269, 254,
+    322, 311, 251, 235, 270, 315, 126, 158, -1, 65, -68, -116,
+    -40, -131, -76, -242, -161, -24, -205, -201, -157, -126, -91, -262,
+    -326, -460, -482, -389, -485, -508, -682, -538, -573, -509, -340, -327,
+    -271, -232, -290, -167, -331, -178, -215, 168, -34, -16, 9, 47,
+    48, 101, 89, 3, -65, 750, -237, 225, -192, 26, 73, -145,
+    -250, -121, -227, -86, 44, -23, 8, 16, 259, 252, 239, 215,
+    190, 257, 256, 115, 275, 235, -13, 136, 50, 36, 21, 11,
+    -100, 13, 4, 2, 64, 55, 10, 72, 142, -49, -72, -95,
+    -142, -48, -158, -168, -172, -156, -43, -245, -120, -115, -13, -226,
+    -122, -59, -140, -135, -18, -34, -175, 39, -80, -170, -30, -117,
+    -216, 24, 149, -147, -30, -4, -98, -84, -171, -23, 21, -21,
+    107, 117, 160, 62, 88, 126, 195, 90, 70, 79, 91, 70,
+    175, 154, 48, 179, 42, 145, 27, 140, 9, 86, 78, 165,
+    65, 128, 97, -51, 69, 35, -14, -133, 63, -69, 30, -87,
+    -19, -130, -146, 292, -23, -628, 79, 583, 390, -857, -898, -468,
+    -705, -745, -1073, -393, 745, 221, -2, 852, 856, 30, -68, -254,
+    -264, -178, 178, -138, 459, 575, 148, 118, 200, 54, 234, -74,
+    -59, 43, -163, -359, -41, 287, -201, -221, -60, 3, 116, 104,
+    122, -69, 59, 39, -57, -50, 472, 585, 43, -350, -95, 10,
+    -278, -317, -458, 170, 356, -308, -228, 241, 123, 94, 112, 140,
+    282, 508, 407, -142, 74, 128, -109, -133, -63, 61, -107, -218,
+    -83, -75, -303, -277, -333, -256, 102, -106, 10, 313, 368, -56,
+    -69, -283, -253, -323, -378, -261, -281, -214, -140, 215, 216, 297,
+    184, 155, 113, 528, 238, -21, -157, 74, -24, -124, 3, 224,
+    -2, -32, -110, -368, -184, -353, -222, -151, 22, 57, 283, 163,
+    339, 386, 344, 93, -14, 18, -72, -46, -23, 296, 139, 309,
+    300, 261, 153, 89, -126, 69, 34, -74, -96, 109, -40, -248,
+    -434, -311, -389, -187, -353, -21, -23, -16, 179, 138, 82, 156,
+    321, -84, -111, -12, -137, -19, -235, -311, -259, -17, -27, 90,
+    148, -95, -180, -132, -9, 29, -165, -59, 163, 37, 29, 102,
+    171, -65, -137, -111, -95, -169, -7, 106, 93, 167, 161, 53,
+    -60, -45, -213, -169, -111, -56, 88, 204, 181, 161, 136, 39,
+    355, 227, 106, 76, 180, 35, 121, 183, 270, 222, 132, 103,
+    -108, -155, -30, -3, -211, -280, -338, -198, -170, -128, -187, -110,
+    -105, -156, -43, 86, 79, 89, 166, 167, 120, 126, 103, 76,
+    -59, -46, -132, -21, -72, -58, 156, 255, 40, -114, -17, 85,
+    64, 24, -40, -124, 206, -116, 136, 122, 85, 159, 236, 182,
+    26, 105, 51, 92, 83, -56, -277, -368, -415, -443, -490, -399,
+    -421, -119, -70, 173, 254, 507, 632, 394, 505, 251, -27, -164,
+    -68, -296, -349, -608, -501, -531, -633, -361, -439, -231, 63, 408,
+    363, 441, 498, 649, 643, 547, 242, 276, 64, 43, 16, 93,
+    55, -261, -537, -529, -729, -480, -148, 107, 424, 476, 782, 635,
+    293, 14, -243, -234, 193, 135, 85, -344, -603, -562, -430, -341,
+    -177, -39, 287, 339, 93, 153, 226, 88, 113, 65, 140, -105,
+    -61, -157, -248, -377, -376, -176, 192, 181, 262, 141, 446, 386,
+    331, 670, 558, 220, 139, -164, -295, -407, -368, -323, -197, -76,
+    1, 102, -65, -80, 12, -191, -252, -227, -195, -232, -305, -15,
+    -16, 177, 551, 545, 520, 377, 169, 70, -115, 67, -209, -728,
+    -921, -864, -565, -541, -312, -174, 313, 414, 596, 945, 609, 501,
+    482, 460, 333, 191, -232, -299, -491, -615, -584, -295, 13, 52,
+    122, 223, 485, 498, 453, 243, 145, -230, -711, -1089, -1178, -1005,
+    -629, -413, 167, 720, 839, 1151, 960, 720, 195, -133, -64, 182,
+    180, 372, 505, 398, 305, 33, -80, -81, -188, -200, -93, -201,
+    130, -216, -117, -952, -720, -551, -506, -247, -33, 50, 94, 413,
+    679, 574, 459, 175, -175, -139, -218, 20, 135, 294, 222, 145,
+    119, -122, -22, -362, -661, -644, -693, -541, -277, 251, 374, 431,
+    456, 360, 320, -53, -321, -162, -138, 24, 4, 330, 302, 288,
+    297, 175, 103, -270, -358, -298, -365, -406, -284, -338, -496, -486,
+    -372, -165, -73, -55, 127, 274, 182, 315, 431, 465, 409, 328,
+    242, -4, -128, -393, -120, -77, -34, 169, 206, 323, 242, 315,
+    108, 140, -230, -112, -187, -232, -523, -210, -172, -17, -17, -126,
+    -85, -60, -9, 237, 335, 315, 261, 131, 252, 307, 416, 309,
+    -118, -142, -42, -227, -110, 103, -45, -2, -142, 36, -2, -208,
+    -329, -174, -48, -42, 50, 32, 22, -121, -47, 48, -239, -217,
+    -164, -49, -158, -228, -190, 99, -19, 82, 103, 112, 213, 367,
+    328, 469, 356, 461, 132, 165, 102, -167, -284, -254, -426, -365,
+    -94, 15, 110, 412, 219, 491, 148, -135, 52, -20, -39, -180,
+    -312, -401, -301, -246, -126, 95, -20, 63, 64, 59, -158, -12,
+    -37, -2, -127, -22, 8, 113, 219, 213, 269, 287, 152, 260,
+    228, 195, 359, 166, 87, -60, 162, 192, -63, -323, -201, -377,
+    -472, -332, -146, -198, -144, 141, 27, 144, 453, 305, 312, 233,
+    61, 46, -308, -365, -184, -146, 54, 265, 117, 70, 39, -107,
+    188, 283, 149, 210, -15, -281, -355, -454, -310, -262, -563, -605,
+    -481, -355, -196, 204, 192, 273, 128, 193, 171, 247, 295, 418,
+    195, 162, 82, -320, -445, -429, -473, -369, -491, -604, -342, -358,
+    -251, -182, 86, 137, 57, 206, 246, 140, 286, 107, 447, 297,
+    59, 147, 61, 192, 160, -45, 211, 89, 43, 242, 6, 175,
+    17, -67, -136, -162, -352, -306, -27, 66, 115, 10, 26, 135,
+    128, 12, 116, -50, -126, 22, -65, -52, 20, -298, -20, -195,
+    -222, -54, 15, 128, 232, 286, 140, -13, 129, -16, -13, 3,
+    -81, -174, -258, -93, 26, 37, 162, 153, 324, 282, 138, -116,
+    -131, -142, -25, -152, -334, -235, -214, -90, -60, 61, 67, -26,
+    3, -102, 28, -212, -37, 75, 8, 185, 50, -173, -73, -124,
+    -220, -161, -61, 9, 21, -358, 255, 753, 207, -515, 378, 527,
+    17, -494, -10, -166, -514, -777, -22, 837, 622, 263, 701, 904,
+    670, 750, 192, 214, 155, 152, 204, 307, 187, 177, 192, 122,
+    12, -132, 54, -116, -743, -716, -535, -741, -669, -408, -498, -355,
+    -424, -496, -199, -268, 96, 43, -98, -112, 94, 44, 128, -45,
+    -78, -211, -186, -136, 7, 123, -11, -14, -122, -308, -316, -346,
+    1, 231, 252, 223, 220, 9, -47, -300, -45, 133, 300, 439,
+    418, 609, 543, 510, 460, 490, 225, 105, -128, -276, -273, -155,
+    58, 83, 318, -10, -151, -111, -32, -93, -130, -142, 83, 377,
+    268, 511, 516, 562, 598, 428, 512, 635, 482, 471, 108, -116,
+    -267, -298, -501, -352, -320, -207, -155, -270, -390, -235, -128, -242,
+    -144, -22, -394, -455, -393, -360, -523, -324, -156, -13, -95, 160,
+    208, 338, 358, 121, 44, -61, -363, -258, -147, -276, -179, -191,
+    -235, -233, -200, -190, -329, -178, -538, -316, -247, -220, -168, 206,
+    147, 195, 177, 131, 89, 289, 13, 201, -7, 69, -157, -20,
+    -54, -166, -116, -103, 17, 54, -32, -38, -24, -4, 136, 229,
+    309, 284, 239, 185, 260, 224, 300, 239, 167, 26, 10, -77,
+    -175, -141, -128, 6, -219, -290, -110, -63, 180, 61, 193, 375,
+    182, 145, 213, 289, 108, 194, 166, 154, 337, 163, 327, 262,
+    180, -239, -105, -333, -407, -457, -367, -163, -112, -185, 8, 127,
+    121, 255, 209, 304, 152, 106, 199, 51, -39, -47, 88, 96,
+    188, 81, 75, 179, 232, 60, -83, 13, 135, -119, 94, -44,
+    -157, 73, -171, -160, -259, -215, -85, -173, -32, -155, -2, 9,
+    19, 118, 324, 120, 213, -81, -70, -190, -48, 63, 8, 118,
+    203, 121, -42, -108, -331, -298, -55, -82, -82, -323, -406, -329,
+    -416, -243, 36, -26, 92, 86, 70, 210, -141, 87, -21, 29,
+    24, 245, 97, 197, 44, 263, 115, 207, -37, 208, 61, -297,
+    -43, -63, -183, -32, -149, 94, -26, 92, -52, -73, -51, -120,
+    31, -218, -66, 205, 88, -22, -23, 7, -96, 28, 43, -79,
+    169, 57, 26, 154, 39, 52, -58, -46, 176, 46, 149, 137,
+    212, 71, 49, 41, 26, -91, -86, -287, 5, 17, 22, -169,
+    -128, 57, 67, 95, 95, 89, -38, -2, 17, 68, -19, -100,
+    -48, -124, -64, -20, 117, 235, 219, 229, 299, 156, 19, 21,
+    121, -10, -5, -24, -13, 4, 3, 27, -115, -83, 44, -47,
+    -68, -165, -9, -130, 57, -149, -3, -96, 70, -42, -7, -79,
+    57, -39, -6, 112, 140, 31, -49, -15, -126, 25, 23, 40,
+    -59, 201, 151, 223, 300, -13, 106, 73, 71, 161, -13, -42,
+    -58, -85, -128, -38, -75, -208, -120, -116, -133, -244, -118, -21,
+    58, 33, 6, -32, -48, 43, -194, -78, -102, -342, -290, -295,
+    -143, -34, -138, 5, 36, -86, 158, 15, 111, -15, 94, -14,
+    88, 176, 36, -84, -96, 37, 27, -91, 58, 15, 237, 48,
+    155, -111, 13, 20, 38, -185, -137, -83, -152, 23, -181, 113,
+    240, 123, 79, 220, 117, 247, 236, 91, 219, 102, -14, -97,
+    -58, -36, 104, 136, 19, 167, 82, 113, 3, 244, 224, -19,
+    116, 139, 116, 135, 266, 29, 30, 21, 145, 338, 268, 226,
+    181, 19, 233, -55, -89, 27, -109, -144, -26, -39, -196, 25,
+    -100, -244, -130, -159, -184, -88, -68, -337, -334, -196, -189, -293,
+    -400, -117, -333, -279, -129, -196, -270, -105, -90, -75, -182, -168,
+    104, -20, -4, 4, 139, 0, 133, 136, 230, 108, 93, -43,
+    188, 40, 153, 153, 271, 341, 170, 30, -12, 2, -40, 57,
+    -51, 39, 33, 26, 44, -100, -313, -55, -63, 64, -35, -30,
+    -39, 74, -168, -271, 111, 333, 78, 40, 148, 131, 22, 41,
+    -83, 32, 27, 4, -21, 117, 96, -18, 112, -5, -117, 132,
+    15, -1, 8, -105, -69, 69, 85, -36, 177, 156, 149, 24,
+    122, -8, 236, 223, -178, -56, -152, -24, -87, 73, 65, 195,
+    -52, 77, 86, -30, -147, 1, 135, -103, -78, 83, 200, -55,
+    83, 96, 207, 41, 14, 136, 13, 21, 26, 126, -13, -27,
+    91, -165, -148, -4, -106, 17, 156, -77, 38, -83, 32, -74,
+    -44, -43, -142, -110, -191, 64, 182, 177, 157, 253, 115, 79,
+    149, 101, 49, -70, -88, 13, -1, 91, -165, -312, -46, -174,
+    -66, -163, -186, -68, -57, -89, -85, -115, -251, -226, -189, -141,
+    -148, -129, -75, -170, -12, 8, 19, 5, 121, -3, -120, 35,
+    130, 167, 108, 22, 135, 5, 83, 233, 208, 165, 46, 154,
+    4, 99, -43, 71, -58, -170, -29, 114, -16, 118, 90, 75,
+    -61, 64, 53, 134, 26, -109, -92, 56, -63, -40, -265, 132,
+    1, 33, 131, 232, 168, 161, 106, 79, 71, -79, 159, 137,
+    -222, -320, -154, 12, 30, 19, -124, 169, 51, 72, 167, 168,
+    32, 105, 186, 25, 0, -27, -144, -132, -112, -91, 37, 57,
+    -160, 86, -124, 0, -1, 34, -54, -173, -4, 9, 47, 70,
+    -160, 94, -13, -3, 28, 27, 11, 131, 125, 240, -25, -7,
+    92, 202, -67, 58, 54, 17, -3, 13, 0, 86, 188, 39,
+    -129, -8, -159, -34, 63, 44, 31, -123, -20, -14, -285, -32,
+    -45, -72, -68, -210, -204, -92, -70, -113, -108, -87, -107, -97,
+    -81, -55, -169, -32, -138, -107, -68, -32, -38, -131, 20, 34,
+    47, 171, 161, 148, 2, 142, 2, 142, -87, 54, 60, -57,
+    69, 68, 68, 193, 164, 42, 8, 145, 133, 112, 100, 68,
+    40, 19, -103, -74, 55, -71, -53, -161, -39, -132, -13, 8,
+    -1, 15, 250, 212, 61, 288, 208, 159, 121, -162, -56, 37,
+    58, -93, -82, -74, 35, -93, -81, -75, -71, -190, -160, -127,
+    -87, 63, 65, -52, 181, 146, 5, 103, 216, 75, 82, 67,
+    -57, -66, -60, -56, 187, -161, -7, 7, 9, 143, 149, 15,
+    -228, 18, 2, 136, 10, 122, 119, 101, 197, 37, 137, 6,
+    89, -147, -30, 74, 176, 162, 138, -24, -49, -81, 22, 16,
+    -160, -169, -167, -188, -199, -195, -199, -41, -166, -264, 8, -302,
+    -294, -93, -82, -49, -34, -50, -153, 146, 163, 36, 69, 99,
+    -12, 12, 46, 170, 284, 268, 235, 316,
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VAD_EVENT_H__
+#define __VAD_EVENT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vpi_event.h"
+
+#define VAD_EVENT_SLOT_NUM   (16) // records in flight before the oldest is overwritten
+#define VAD_EVENT_STATS_HOPS (67) // hops between two stats events, about 1 s
+
+/**
+ * VAD events, numbered after the SDK ones
+ */
+enum VadEventId {
+    EVENT_VAD_VOICE_START = EVENT_SDK_END + 1, // the first voice hop of a segment
+    EVENT_VAD_VOICE_END,                       // the first non-voice hop after a segment
+    EVENT_VAD_STATS,                           // periodic snapshot of the counters
+};
+
+/**
+ * counters of a VAD stream, sent with EVENT_VAD_STATS
+ */
+typedef struct VadEventStats {
+    uint32_t hop_cnt;      // hops decided
+    uint32_t voice_cnt;    // hops decided voice
+    uint32_t skip_cnt;     // hops rejected by the gate
+    uint32_t seg_cnt;      // voice segments started
+    uint32_t notify_fail;  // notifications refused by a listener queue
+    uint32_t notify_cycle; // longest notification, cycles in vpi_event_notify
+} VadEventStats;
+
+/**
+ * event record, listeners get a pointer to it as the event parameter and
+ * copy it with vad_event_read
+ */
+typedef struct VadEvent {
+    uint32_t seq;        // odd while the record is written
+    uint32_t id;         // EVENT_VAD_*
+    uint64_t sample;     // start: first sample of the segment, end: first sample after it,
+                         // stats: first sample of the last hop
+    uint64_t start;      // end: first sample of the segment, else equal to sample
+    double margin;       // margin of the deciding hop, > 0 iff voice
+    double peak;         // end: highest margin of the segment, else equal to margin
+    uint64_t cycle;      // cycle counter at the decision
+    VadEventStats stats; // counters up to this event
+} VadEvent;
+
+typedef struct VadEventConfig {
+    uint32_t stats_hops; // hops between two stats events, 0: none
+    bool from_isr;       // the hops are decided in an ISR
+} VadEventConfig;
+
+/**
+ * publisher of the events of one VAD stream
+ */
+typedef struct VadEventSource {
+    VadEventConfig config;
+    VadEvent slot[VAD_EVENT_SLOT_NUM]; // ring of records
+    uint32_t slot_idx;                 // next record to write
+    uint32_t seq;                      // sequence of the last record
+    uint64_t start;                    // first sample of the open segment
+    double peak;                       // highest margin of the open segment
+    uint32_t stats_hop;                // hops since the last stats event
+    bool in_voice;                     // a segment is open
+    VadEventStats stats;
+} VadEventSource;
+
+/**
+ * notification latency seen by one listener, from the decision to the
+ * listener reading the event
+ */
+typedef struct VadEventLatency {
+    uint32_t cnt;  // events read
+    uint32_t lost; // events overwritten before they were read
+    uint32_t seq;  // sequence of the last event read
+    uint32_t last; // cycles of the last event
+    uint32_t min;  // cycles
+    uint32_t max;  // cycles
+    uint64_t sum;  // cycles
+} VadEventLatency;
+
+/**
+ * @brief default configuration: a stats event every VAD_EVENT_STATS_HOPS hops,
+ * hops decided in a task
+ *
+ * @param[out] config configuration
+ */
+void vad_event_default_config(VadEventConfig *config);
+
+/**
+ * @brief initialize an event source
+ *
+ * @param[out] src    event source
+ * @param[in]  config configuration, NULL: default
+ * @return VSD_SUCCESS or VSD_ERR_INVALID_POINTER
+ */
+int vad_event_init(VadEventSource *src, const VadEventConfig *config);
+
+/**
+ * @brief pass the decision of one hop, notifies the voice start/end and stats
+ * events through vpi_event. Every notification is a few hundred cycles; hops
+ * without an event only update the counters.
+ *
+ * @param[in] src      event source
+ * @param[in] sample   first sample of the frame decided, at OBJ_FS
+ * @param[in] is_voice decision of the hop
+ * @param[in] margin   margin of the hop, -INFINITY when the gate skipped it
+ */
+void vad_event_hop(VadEventSource *src, uint64_t sample, bool is_voice, double margin);
+
+/**
+ * @brief register a listener (event manager or group) to all VAD events, the
+ * listener then sleeps in vpi_event_listen until one is notified
+ *
+ * @param[in] listener event manager or group
+ * @return EVENT_OK or EVENT_ERROR
+ */
+int vad_event_subscribe(void *listener);
+
+/**
+ * @brief copy the record of an event in the listener's handler. Records are
+ * reused after VAD_EVENT_SLOT_NUM events, a listener that far behind gets false.
+ *
+ * @param[in]  param event parameter given to the handler
+ * @param[out] event copy of the record
+ * @return true if the copy is intact
+ */
+bool vad_event_read(const void *param, VadEvent *event);
+
+/**
+ * @brief copy the record of an event and add its latency to the statistics,
+ * call it first in the handler of a listener subscribed by vad_event_subscribe.
+ * Events overwritten before the listener woke up are counted as lost.
+ *
+ * @param[in] lat   latency statistics, zeroed by the caller
+ * @param[in] param event parameter given to the handler
+ * @param[out] event copy of the record, see vad_event_read
+ * @return true if the copy is intact and not read before
+ */
+bool vad_event_receive(VadEventLatency *lat, const void *param, VadEvent *event);
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VAD_TASK_H__
+#define __VAD_TASK_H__
+
+#include <stdint.h>
+
+#include "vad.h"
+#include "qos.h"
+#include "model_swap.h"
+#include "vad_event.h"
+
+#define VAD_MODEL_UART_ID    (0)   // UART the host sends model blobs on
+#define VAD_MODEL_RX_TIMEOUT (200) // ms without a byte before a partial blob is dropped
+#define VAD_MODEL_RX_STACK   (512) // words of the model receive task stack
+#define VAD_MONITOR_STACK    (384) // words of the event monitor task stack
+#define VAD_CAPTURE_STACK    (768) // words of the capture task stack
+#define VAD_CAPTURE_PRIO     (5)   // above the model receiver and the monitor, hops are due every 15 ms
+
+#ifndef VAD_STATIC_ALLOC
+#define VAD_STATIC_ALLOC (1) // 1 creates the VAD tasks and objects without the heap
+#endif
+
+#ifndef VAD_DMA_BENCH
+#define VAD_DMA_BENCH (0) // 1 runs dma_buf_bench once in vad_task_init
+#endif
+
+#ifndef VAD_MSG_BENCH
+#define VAD_MSG_BENCH (0) // 1 runs msg_bench once in vad_task_init
+#endif
+
+#ifndef VAD_CLIP_CAPTURE
+#define VAD_CLIP_CAPTURE (1) // 1 replays the clip of vad_clip.h as the capture path, qemu has no microphone
+#endif
+
+#ifndef VAD_EVENT_MONITOR
+// 1 starts a listener printing the VAD events and their latency; its vpi_event
+// manager and listener are allocated from the heap, so it is off by default
+#define VAD_EVENT_MONITOR (0)
+#endif
+
+/**
+ * @brief initialize the VAD context and its model store, and start the task
+ * receiving model blobs from the UART and, with VAD_CLIP_CAPTURE, the task
+ * feeding the clip to vad_task_process. The built-in model is active. Prints
+ * the time taken and the free heap before and after.
+ *
+ * @return error code
+ */
+int vad_task_init(void);
+
+/**
+ * @brief get the VAD context of the capture path
+ *
+ * @return VAD context
+ */
+VadContext *vad_task_context(void);
+
+/**
+ * @brief hop boundary of the capture path: apply a received model or a
+ * rollback before the next frame, O(1) and without allocation
+ */
+void vad_task_hop(void);
+
+/**
+ * @brief go back to the model used before the last swap at the next hop
+ */
+void vad_task_rollback(void);
+
+/**
+ * @brief decide a hop of the capture path under the QoS controller: applies
+ * a pending model swap, runs vad_qos_process, passes the decision on with
+ * vad_task_decision and accounts the hop against its 15 ms deadline
+ *
+ * @param[in] frame: FRAME_LEN samples, consecutive hops
+ * @param[in] sample: first sample of the frame
+ * @param[in] ready_cycle: __get_rv_cycle() when the hop was captured, e.g. in the DMA callback
+ * @param[out] is_voice: the result of voice detection
+ * @return error code
+ */
+int vad_task_process(Conv2dData *frame, uint64_t sample, uint64_t ready_cycle, bool *is_voice);
+
+/**
+ * @brief get the QoS controller of the capture path, its counters are
+ * written by the capture path and may be read torn from other tasks
+ *
+ * @return QoS controller
+ */
+const VadQos *vad_task_qos(void);
+
+/**
+ * @brief pass the decision of a hop of the capture path to the VAD event
+ * listeners, call it after vad_process with the margin left in the context
+ *
+ * @param[in] sample   first sample of the frame decided
+ * @param[in] is_voice decision of vad_process
+ */
+void vad_task_decision(uint64_t sample, bool is_voice);
+
+#endif
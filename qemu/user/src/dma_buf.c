@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "platform.h"
+#include "osal_heap_api.h"
+#include "soc_sysctl.h"
+#include "uart_printf.h"
+#include "vsd_error.h"
+#include "vad.h"
+#include "dma_buf.h"
+
+#define BENCH_HOP_NUM (32) // hops per capture buffer, 7680 bytes
+#define BENCH_TRIAL   (5)  // the minimum of the trials is reported
+
+static uint32_t g_line_size = 0; // 0 until probed
+static bool g_dcache        = false;
+static volatile double g_bench_energy; // keeps the benchmark reads alive
+
+static void probe_cache(void)
+{
+    CacheInfo_Type info;
+
+    if (g_line_size) {
+        return;
+    }
+
+    g_dcache    = DCachePresent() && !GetDCacheInfo(&info) && info.linesize;
+    g_line_size = g_dcache ? (uint32_t)info.linesize : DMA_BUF_LINE_SIZE;
+}
+
+// cache lines covering [offset, offset + len) of the buffer
+static uint32_t line_range(const DmaBuf *buf, uint32_t offset, uint32_t len, unsigned long *addr)
+{
+    uintptr_t first = ((uintptr_t)buf->data + offset) & ~(uintptr_t)(g_line_size - 1);
+    uintptr_t last  = (uintptr_t)buf->data + offset + len;
+
+    *addr = first;
+    return (uint32_t)((last - first + g_line_size - 1) / g_line_size);
+}
+
+uint32_t dma_buf_line_size(void)
+{
+    probe_cache();
+    return g_line_size;
+}
+
+int dma_buf_alloc(DmaBuf *buf, uint32_t size, DmaBufType type)
+{
+    uintptr_t start = 0;
+
+    if (!buf) {
+        return VSD_ERR_INVALID_POINTER;
+    }
+    if (!size || (type != DMA_BUF_CACHED && type != DMA_BUF_NONCACHE)) {
+        return VSD_ERR_INVALID_PARAM;
+    }
+
+    probe_cache();
+    memset(buf, 0, sizeof(DmaBuf));
+    size     = (size + g_line_size - 1) & ~(g_line_size - 1);
+    buf->raw = type == DMA_BUF_CACHED ? osal_malloc(size + g_line_size - 1)
+                                      : osal_malloc_noncache(size + g_line_size - 1);
+    if (!buf->raw) {
+        return VSD_ERR_NO_MEMORY;
+    }
+
+    start     = ((uintptr_t)buf->raw + g_line_size - 1) & ~(uintptr_t)(g_line_size - 1);
+    buf->data = (uint8_t *)start;
+    buf->size = size;
+    buf->type = type;
+    // a dirty line written back later would overwrite what the DMA put there
+    if (type == DMA_BUF_CACHED && g_dcache) {
+        MFlushInvalDCacheLines(start, size / g_line_size);
+    }
+
+    return VSD_SUCCESS;
+}
+
+void dma_buf_free(DmaBuf *buf)
+{
+    if (!buf || !buf->raw) {
+        return;
+    }
+
+    if (buf->type == DMA_BUF_CACHED) {
+        osal_free(buf->raw);
+    } else {
+        osal_free_noncache(buf->raw);
+    }
+    memset(buf, 0, sizeof(DmaBuf));
+}
+
+void dma_buf_sync_for_device(const DmaBuf *buf, uint32_t offset, uint32_t len)
+{
+    unsigned long addr = 0;
+    uint32_t cnt       = 0;
+
+    if (!buf || buf->type != DMA_BUF_CACHED || !g_dcache || offset >= buf->size || !len) {
+        return;
+    }
+
+    cnt = line_range(buf, offset, len < buf->size - offset ? len : buf->size - offset, &addr);
+    MFlushDCacheLines(addr, cnt);
+}
+
+void dma_buf_sync_for_cpu(const DmaBuf *buf, uint32_t offset, uint32_t len)
+{
+    unsigned long addr = 0;
+    uint32_t cnt       = 0;
+
+    if (!buf || buf->type != DMA_BUF_CACHED || !g_dcache || offset >= buf->size || !len) {
+        return;
+    }
+
+    cnt = line_range(buf, offset, len < buf->size - offset ? len : buf->size - offset, &addr);
+    MInvalDCacheLines(addr, cnt);
+}
+
+void dma_buf_rx_callback(const void *param)
+{
+    const DmaBuf *buf = (const DmaBuf *)param;
+
+    if (!buf) {
+        return;
+    }
+
+    dma_buf_sync_for_cpu(buf, 0, buf->size);
+    if (buf->done.callback) {
+        buf->done.callback(buf->done.param);
+    }
+}
+
+// fill the buffer as the DMA would: in memory, with no line of it cached
+static void bench_capture(DmaBuf *buf)
+{
+    int16_t *pcm = (int16_t *)buf->data;
+    uint32_t i;
+
+    for (i = 0; i < buf->size / sizeof(int16_t); i++) {
+        pcm[i] = (int16_t)(i * 2654435761u >> 20);
+    }
+    dma_buf_sync_for_device(buf, 0, buf->size);
+    dma_buf_sync_for_cpu(buf, 0, buf->size);
+}
+
+// each hop is invalidated as it completes and read once, converted to double
+// like the capture path feeding the VAD
+static uint64_t bench_hop(DmaBuf *buf)
+{
+    const int16_t *pcm = (const int16_t *)buf->data;
+    uint64_t start     = 0, cycle = 0;
+    double energy      = 0.0;
+    uint32_t h, i;
+
+    bench_capture(buf);
+    start = __get_rv_cycle();
+    for (h = 0; h < BENCH_HOP_NUM; h++) {
+        dma_buf_sync_for_cpu(buf, h * FRAME_STEP * sizeof(int16_t), FRAME_STEP * sizeof(int16_t));
+        for (i = 0; i < FRAME_STEP; i++) {
+            energy += (double)pcm[h * FRAME_STEP + i] * pcm[h * FRAME_STEP + i];
+        }
+    }
+    cycle          = __get_rv_cycle() - start;
+    g_bench_energy = energy;
+
+    return cycle;
+}
+
+// frames of FRAME_LEN samples every FRAME_STEP read straight from the buffer,
+// so every sample is read twice
+static uint64_t bench_frame(DmaBuf *buf)
+{
+    const int16_t *pcm = (const int16_t *)buf->data;
+    uint64_t start     = 0, cycle = 0;
+    double energy      = 0.0;
+    uint32_t h, i;
+
+    bench_capture(buf);
+    start = __get_rv_cycle();
+    dma_buf_sync_for_cpu(buf, 0, buf->size);
+    for (h = 0; h + 1 < BENCH_HOP_NUM; h++) {
+        for (i = 0; i < FRAME_LEN; i++) {
+            energy += (double)pcm[h * FRAME_STEP + i] * pcm[h * FRAME_STEP + i];
+        }
+    }
+    cycle          = __get_rv_cycle() - start;
+    g_bench_energy = energy;
+
+    return cycle;
+}
+
+// bandwidth in 0.1 MB/s
+static uint32_t bandwidth(uint32_t bytes, uint64_t cycle)
+{
+    return cycle ? (uint32_t)((uint64_t)bytes * soc_cpu_clock_get_freq() / cycle / 100000) : 0;
+}
+
+int dma_buf_bench(void)
+{
+    static const char *type_name[] = {"cached", "noncache"};
+    static const char *bench_name[] = {"capture hop", "overlapped frame"};
+    uint64_t (*bench[])(DmaBuf *) = {bench_hop, bench_frame};
+    uint32_t bytes[] = {BENCH_HOP_NUM * FRAME_STEP * sizeof(int16_t),
+                        (BENCH_HOP_NUM - 1) * FRAME_LEN * sizeof(int16_t)};
+    uint64_t best[2][2], cycle = 0;
+    uint32_t bw[2];
+    DmaBuf buf;
+    int b, t, k, ret;
+
+    probe_cache();
+    uart_printf("dma buf bench: D-cache %s, line %u bytes\r\n", g_dcache ? "on" : "off",
+                (unsigned)g_line_size);
+    for (t = DMA_BUF_CACHED; t <= DMA_BUF_NONCACHE; t++) {
+        ret = dma_buf_alloc(&buf, BENCH_HOP_NUM * FRAME_STEP * sizeof(int16_t), (DmaBufType)t);
+        if (ret != VSD_SUCCESS) {
+            return ret;
+        }
+        for (b = 0; b < 2; b++) {
+            best[b][t] = UINT64_MAX;
+            for (k = 0; k < BENCH_TRIAL; k++) {
+                cycle      = bench[b](&buf);
+                best[b][t] = cycle < best[b][t] ? cycle : best[b][t];
+            }
+        }
+        dma_buf_free(&buf);
+    }
+
+    for (b = 0; b < 2; b++) {
+        bw[0] = bandwidth(bytes[b], best[b][0]);
+        bw[1] = bandwidth(bytes[b], best[b][1]);
+        uart_printf("%-16s cached %u cycles %u.%u MB/s, noncache %u cycles %u.%u MB/s -> %s\r\n",
+                    bench_name[b], (unsigned)best[b][0], (unsigned)(bw[0] / 10),
+                    (unsigned)(bw[0] % 10), (unsigned)best[b][1], (unsigned)(bw[1] / 10),
+                    (unsigned)(bw[1] % 10),
+                    type_name[best[b][1] < best[b][0] ? DMA_BUF_NONCACHE : DMA_BUF_CACHED]);
+    }
+
+    return VSD_SUCCESS;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+#include "osal_heap_api.h"
+#include "osal_event_api.h"
+#include "osal_msg_api.h"
+#include "uart_printf.h"
+#include "vpi_event.h"
+#include "vsd_error.h"
+#include "vad.h"
+#include "msg_bench.h"
+
+#define BENCH_DEPTH (8) // messages in flight, all sent and then all received
+#define BENCH_ROUND (8) // rounds of BENCH_DEPTH messages per trial
+#define BENCH_TRIAL (5) // the minimum of the trials is reported
+#define BENCH_MSG   (BENCH_DEPTH * BENCH_ROUND)
+#define BENCH_MAX   (4 * FRAME_STEP * sizeof(int16_t)) // largest payload
+
+typedef enum BenchPath {
+    BENCH_COPY  = 0, // payload copied into and out of a FreeRTOS queue
+    BENCH_EVENT = 1, // payload copied to the heap, pointer sent as an OSAL event
+    BENCH_ZERO  = 2, // payload written in a pooled message, pointer sent
+    BENCH_PATH_NUM,
+} BenchPath;
+
+typedef struct BenchCtx {
+    uint32_t size;   // payload bytes
+    void *queue;     // queue of the path
+    OsalPool *pool;  // message pool of BENCH_ZERO
+    uint8_t *src;    // producer buffer of the copying paths
+    uint8_t *dst;    // consumer buffer of BENCH_COPY
+} BenchCtx;
+
+static volatile uint32_t g_bench_sum; // keeps the consumer reads alive
+
+// the producer writes a payload, the consumer reads all of it
+static void produce(uint8_t *payload, uint32_t size, uint32_t seq)
+{
+    memset(payload, (int)seq, size);
+}
+
+static uint32_t consume(const uint8_t *payload, uint32_t size)
+{
+    const uint32_t *word = (const uint32_t *)payload;
+    uint32_t sum = 0, i;
+
+    for (i = 0; i < size / sizeof(uint32_t); i++) {
+        sum += word[i];
+    }
+
+    return sum;
+}
+
+static uint64_t run_copy(BenchCtx *ctx)
+{
+    uint64_t start = __get_rv_cycle();
+    uint32_t sum   = 0, r, k;
+
+    for (r = 0; r < BENCH_ROUND; r++) {
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            produce(ctx->src, ctx->size, k);
+            xQueueSend(ctx->queue, ctx->src, 0);
+        }
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            xQueueReceive(ctx->queue, ctx->dst, 0);
+            sum += consume(ctx->dst, ctx->size);
+        }
+    }
+    g_bench_sum = sum;
+
+    return __get_rv_cycle() - start;
+}
+
+static uint64_t run_event(BenchCtx *ctx)
+{
+    uint64_t start = __get_rv_cycle();
+    uint32_t sum   = 0, r, k;
+    void *data     = NULL;
+
+    for (r = 0; r < BENCH_ROUND; r++) {
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            produce(ctx->src, ctx->size, k);
+            data = osal_malloc(ctx->size);
+            if (data) {
+                memcpy(data, ctx->src, ctx->size);
+                osal_send_event(ctx->queue, EVENT_AUD_PCM_DATA, data, 0);
+            }
+        }
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            if (osal_wait_event(ctx->queue, &data, 0) != EVENT_INVALID && data) {
+                sum += consume(data, ctx->size);
+                osal_free(data);
+            }
+        }
+    }
+    g_bench_sum = sum;
+
+    return __get_rv_cycle() - start;
+}
+
+static uint64_t run_zero(BenchCtx *ctx)
+{
+    uint64_t start = __get_rv_cycle();
+    uint32_t sum   = 0, r, k;
+    void *msg      = NULL;
+
+    for (r = 0; r < BENCH_ROUND; r++) {
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            msg = osal_msg_alloc(ctx->pool, EVENT_AUD_PCM_DATA, ctx->size);
+            if (msg) {
+                produce(msg, ctx->size, k);
+                osal_msg_send(ctx->queue, msg);
+            }
+        }
+        for (k = 0; k < BENCH_DEPTH; k++) {
+            msg = osal_msg_recv(ctx->queue);
+            sum += consume(msg, osal_msg_len(msg));
+            osal_msg_unref(msg);
+        }
+    }
+    g_bench_sum = sum;
+
+    return __get_rv_cycle() - start;
+}
+
+// memcpy alone, twice per message like BENCH_COPY
+static uint64_t run_memcpy(BenchCtx *ctx)
+{
+    uint64_t start = __get_rv_cycle();
+    uint32_t k;
+
+    for (k = 0; k < BENCH_MSG; k++) {
+        memcpy(ctx->dst, ctx->src, ctx->size);
+        memcpy(ctx->src, ctx->dst, ctx->size);
+    }
+
+    return __get_rv_cycle() - start;
+}
+
+static uint64_t best_of(uint64_t (*run)(BenchCtx *), BenchCtx *ctx)
+{
+    uint64_t best = UINT64_MAX, cycle = 0;
+    int k;
+
+    for (k = 0; k < BENCH_TRIAL; k++) {
+        cycle = run(ctx);
+        best  = cycle < best ? cycle : best;
+    }
+
+    return best / BENCH_MSG;
+}
+
+int msg_bench(void)
+{
+    static const uint32_t size[] = {16, FRAME_STEP * sizeof(int16_t), BENCH_MAX};
+    static const char *name[]    = {"result", "pcm hop", "hop batch"};
+    uint64_t cycle[BENCH_PATH_NUM], copy = 0;
+    uint8_t *storage = NULL;
+    OsalPool pool;
+    BenchCtx ctx;
+    uint32_t i;
+    int ret = VSD_SUCCESS;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.src = osal_malloc(BENCH_MAX);
+    ctx.dst = osal_malloc(BENCH_MAX);
+    // the pool needs OSAL_POOL_ALIGN, the heap may give less
+    storage = osal_malloc(OSAL_POOL_STORAGE_SIZE(OSAL_MSG_BLOCK_SIZE(BENCH_MAX), BENCH_DEPTH) +
+                          OSAL_POOL_ALIGN);
+    if (!ctx.src || !ctx.dst || !storage) {
+        ret = VSD_ERR_NO_MEMORY;
+        goto exit;
+    }
+
+    uart_printf("msg bench: cycles per message, %u messages, %u in flight\r\n",
+                (unsigned)BENCH_MSG, (unsigned)BENCH_DEPTH);
+    uart_printf("payload      bytes    copy   event  zerocopy  memcpy\r\n");
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++) {
+        ctx.size = size[i];
+
+        ctx.queue = xQueueCreate(BENCH_DEPTH, ctx.size);
+        if (!ctx.queue) {
+            ret = VSD_ERR_NO_MEMORY;
+            goto exit;
+        }
+        cycle[BENCH_COPY] = best_of(run_copy, &ctx);
+        copy              = best_of(run_memcpy, &ctx);
+        vQueueDelete(ctx.queue);
+
+        // osal_create_event_queue keeps two entries in reserve
+        ctx.queue = osal_create_event_queue(BENCH_DEPTH + 2, sizeof(void *));
+        if (!ctx.queue) {
+            ret = VSD_ERR_NO_MEMORY;
+            goto exit;
+        }
+        cycle[BENCH_EVENT] = best_of(run_event, &ctx);
+        osal_delete_event_queue(ctx.queue);
+
+        ctx.queue = osal_create_queue_raw(BENCH_DEPTH);
+        if (!ctx.queue ||
+            osal_msg_pool_create(&pool, "msg_bench",
+                                 (void *)(((uintptr_t)storage + OSAL_POOL_ALIGN - 1) &
+                                          ~(uintptr_t)(OSAL_POOL_ALIGN - 1)),
+                                 ctx.size, BENCH_DEPTH) != OSAL_TRUE) {
+            ret = VSD_ERR_NO_MEMORY;
+            goto exit;
+        }
+        ctx.pool          = &pool;
+        cycle[BENCH_ZERO] = best_of(run_zero, &ctx);
+        osal_delete_queue_raw(ctx.queue);
+        ctx.queue = NULL;
+
+        uart_printf("%-10s %7u %7u %7u %9u %7u\r\n", name[i], (unsigned)ctx.size,
+                    (unsigned)cycle[BENCH_COPY], (unsigned)cycle[BENCH_EVENT],
+                    (unsigned)cycle[BENCH_ZERO], (unsigned)copy);
+    }
+
+exit:
+    osal_free(storage);
+    osal_free(ctx.dst);
+    osal_free(ctx.src);
+
+    return ret;
+}
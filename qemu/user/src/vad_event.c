@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "platform.h"
+#include "vsd_error.h"
+#include "vad_event.h"
+
+static const uint32_t g_vad_event_id[] = {
+    EVENT_VAD_VOICE_START,
+    EVENT_VAD_VOICE_END,
+    EVENT_VAD_STATS,
+};
+
+void vad_event_default_config(VadEventConfig *config)
+{
+    config->stats_hops = VAD_EVENT_STATS_HOPS;
+    config->from_isr   = false;
+}
+
+int vad_event_init(VadEventSource *src, const VadEventConfig *config)
+{
+    if (!src) {
+        return VSD_ERR_INVALID_POINTER;
+    }
+
+    memset(src, 0, sizeof(*src));
+    if (config) {
+        src->config = *config;
+    } else {
+        vad_event_default_config(&src->config);
+    }
+
+    return VSD_SUCCESS;
+}
+
+/*
+ * The records form a ring written only by the deciding context. The sequence
+ * is odd while a record is written, so a listener can tell a torn copy from
+ * an intact one without a lock; it never waits for the writer, which may be
+ * a lower priority task or the ISR it interrupted.
+ */
+static void notify(VadEventSource *src, uint32_t id, uint64_t sample, uint64_t start,
+                   double margin, double peak, uint64_t cycle)
+{
+    VadEvent *event = &src->slot[src->slot_idx];
+    int ret         = EVENT_OK;
+
+    src->slot_idx = (src->slot_idx + 1) % VAD_EVENT_SLOT_NUM;
+    src->seq += 2;
+
+    __atomic_store_n(&event->seq, src->seq - 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->id     = id;
+    event->sample = sample;
+    event->start  = start;
+    event->margin = margin;
+    event->peak   = peak;
+    event->cycle  = cycle;
+    event->stats  = src->stats;
+    __atomic_store_n(&event->seq, src->seq, __ATOMIC_RELEASE);
+
+    if (src->config.from_isr) {
+        ret = vpi_event_notify_from_isr(id, event);
+    } else {
+        ret = vpi_event_notify(id, event);
+    }
+    if (ret != EVENT_OK) {
+        src->stats.notify_fail++;
+    }
+
+    cycle = __get_rv_cycle() - cycle;
+    if (cycle > src->stats.notify_cycle) {
+        src->stats.notify_cycle = (uint32_t)cycle;
+    }
+}
+
+void vad_event_hop(VadEventSource *src, uint64_t sample, bool is_voice, double margin)
+{
+    uint64_t cycle = __get_rv_cycle();
+
+    src->stats.hop_cnt++;
+    if (margin == -INFINITY) {
+        src->stats.skip_cnt++;
+    }
+
+    if (is_voice) {
+        src->stats.voice_cnt++;
+        if (!src->in_voice) {
+            src->in_voice = true;
+            src->start    = sample;
+            src->peak     = margin;
+            src->stats.seg_cnt++;
+            notify(src, EVENT_VAD_VOICE_START, sample, sample, margin, margin, cycle);
+        } else if (margin > src->peak) {
+            src->peak = margin;
+        }
+    } else if (src->in_voice) {
+        src->in_voice = false;
+        notify(src, EVENT_VAD_VOICE_END, sample, src->start, margin, src->peak, cycle);
+    }
+
+    if (src->config.stats_hops && ++src->stats_hop >= src->config.stats_hops) {
+        src->stats_hop = 0;
+        notify(src, EVENT_VAD_STATS, sample, sample, margin, margin, cycle);
+    }
+}
+
+int vad_event_subscribe(void *listener)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(g_vad_event_id) / sizeof(g_vad_event_id[0]); i++) {
+        if (vpi_event_register(g_vad_event_id[i], listener) != EVENT_OK) {
+            while (i--) {
+                vpi_event_unregister(g_vad_event_id[i], listener);
+            }
+            return EVENT_ERROR;
+        }
+    }
+
+    return EVENT_OK;
+}
+
+bool vad_event_read(const void *param, VadEvent *event)
+{
+    const VadEvent *slot = param;
+    uint32_t seq         = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if (seq & 1) {
+        return false;
+    }
+
+    memcpy(event, slot, sizeof(*event));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return event->seq == seq && __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq;
+}
+
+bool vad_event_receive(VadEventLatency *lat, const void *param, VadEvent *event)
+{
+    uint64_t now = __get_rv_cycle();
+    uint32_t cycle;
+
+    if (!vad_event_read(param, event)) {
+        lat->lost++;
+        return false;
+    }
+
+    // every record is notified to every subscriber, a gap in the sequence is
+    // the events overwritten before this listener woke up. Their slots then
+    // hold newer events already read, which come again here and are dropped.
+    if (lat->seq && event->seq <= lat->seq) {
+        return false;
+    }
+    if (lat->seq) {
+        lat->lost += (event->seq - lat->seq) / 2 - 1;
+    }
+    lat->seq = event->seq;
+
+    cycle     = (uint32_t)(now - event->cycle);
+    lat->last = cycle;
+    if (!lat->cnt || cycle < lat->min) {
+        lat->min = cycle;
+    }
+    if (cycle > lat->max) {
+        lat->max = cycle;
+    }
+    lat->sum += cycle;
+    lat->cnt++;
+
+    return true;
+}
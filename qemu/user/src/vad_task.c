@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "platform.h"
+#include "hal_uart.h"
+#include "vsd_error.h"
+#include "osal_task_api.h"
+#include "osal_semaphore_api.h"
+#include "osal_sys_state_api.h"
+#include "osal_time_api.h"
+#include "uart_printf.h"
+#include "soc_sysctl.h"
+#include "vad_task.h"
+#include "dma_buf.h"
+#include "msg_bench.h"
+#if VAD_CLIP_CAPTURE
+#include "vad_clip.h"
+#endif
+
+#define MODEL_RX_BUF_LEN (64)
+#define MODEL_RX_RING    (512) // power of two, about 44 ms at 115200 baud
+#define MODEL_RX_REPORT  (100) // ms between swap reports while no byte arrives
+
+// the slots take MODEL_SWAP_SLOT_NUM * MODEL_SWAP_SLOT_SIZE bytes, kept out of the heap
+static ModelSwap g_model_swap;
+static VadContext g_vad_ctx;
+static VadEventSource g_vad_event;
+static VadQos g_vad_qos;
+
+// the UART receive callback queues bytes here and wakes task_model_rx
+static uint8_t g_model_rx_ring[MODEL_RX_RING];
+static uint32_t g_model_rx_head, g_model_rx_tail, g_model_rx_lost;
+static char g_model_rx_buf[MODEL_RX_BUF_LEN];
+static UartAyncRecvParam g_model_rx_param;
+static OsalSemaphore g_model_rx_sem;
+
+#if VAD_STATIC_ALLOC
+static OsalStack g_model_rx_stack[VAD_MODEL_RX_STACK];
+static OsalTaskBuffer g_model_rx_tcb;
+static OsalSemaphoreBuffer g_model_rx_sem_buf;
+#if VAD_EVENT_MONITOR
+static OsalStack g_monitor_stack[VAD_MONITOR_STACK];
+static OsalTaskBuffer g_monitor_tcb;
+#endif
+#if VAD_CLIP_CAPTURE
+static OsalStack g_capture_stack[VAD_CAPTURE_STACK];
+static OsalTaskBuffer g_capture_tcb;
+#endif
+#endif
+
+static uint32_t cycle_to_us(uint64_t cycle)
+{
+    return (uint32_t)(cycle * 1000000 / soc_cpu_clock_get_freq());
+}
+
+// bytes of the VAD objects and task storage kept out of the heap
+static uint32_t static_bytes(void)
+{
+    uint32_t bytes = sizeof(g_model_swap) + sizeof(g_vad_ctx) + sizeof(g_vad_event) +
+                     sizeof(g_vad_qos) + sizeof(g_model_rx_ring) + sizeof(g_model_rx_buf);
+
+#if VAD_STATIC_ALLOC
+    bytes += sizeof(g_model_rx_stack) + sizeof(g_model_rx_tcb) + sizeof(g_model_rx_sem_buf);
+#if VAD_EVENT_MONITOR
+    bytes += sizeof(g_monitor_stack) + sizeof(g_monitor_tcb);
+#endif
+#if VAD_CLIP_CAPTURE
+    bytes += sizeof(g_capture_stack) + sizeof(g_capture_tcb);
+#endif
+#endif
+
+    return bytes;
+}
+
+static void report_swap(const ModelSwap *swap, const ModelSwapStats *last)
+{
+    const ModelSwapStats *stats = &swap->stats;
+
+    if (stats->swap_cnt != last->swap_cnt) {
+        uart_printf("model id %u active, wait %u us, switch %u cycles\r\n",
+                    (unsigned)model_swap_model_id(swap, swap->active),
+                    (unsigned)cycle_to_us(stats->wait_cycle), (unsigned)stats->switch_cycle);
+    }
+
+    if (stats->rollback_cnt != last->rollback_cnt) {
+        uart_printf("rollback to model id %u\r\n",
+                    (unsigned)model_swap_model_id(swap, swap->active));
+    }
+}
+
+// UART receive callback, in the ISR: queue the bytes, count those the ring has no room for
+static void model_rx_isr(const void *device, uint32_t len, char *data)
+{
+    uint32_t i    = 0;
+    uint32_t head = g_model_rx_head;
+    uint32_t tail = __atomic_load_n(&g_model_rx_tail, __ATOMIC_ACQUIRE);
+
+    (void)device;
+    for (i = 0; i < len && head - tail < MODEL_RX_RING; i++) {
+        g_model_rx_ring[head++ & (MODEL_RX_RING - 1)] = (uint8_t)data[i];
+    }
+    g_model_rx_lost += len - i;
+    __atomic_store_n(&g_model_rx_head, head, __ATOMIC_RELEASE);
+    osal_sem_post_isr(&g_model_rx_sem);
+}
+
+// feed the queued bytes to the model store, returns the number fed
+static uint32_t model_rx_drain(void)
+{
+    int ret       = ALGO_NORMAL;
+    uint32_t tail = g_model_rx_tail, head = 0, len = 0, i = 0, fed = 0;
+    bool ready    = false;
+    uint8_t buf[MODEL_RX_BUF_LEN];
+
+    head = __atomic_load_n(&g_model_rx_head, __ATOMIC_ACQUIRE);
+    while (tail != head) {
+        len = head - tail < sizeof(buf) ? head - tail : sizeof(buf);
+        for (i = 0; i < len; i++) {
+            buf[i] = g_model_rx_ring[tail++ & (MODEL_RX_RING - 1)];
+        }
+        __atomic_store_n(&g_model_rx_tail, tail, __ATOMIC_RELEASE);
+        fed += len;
+
+        ret = model_swap_feed(&g_model_swap, buf, len, &ready);
+        if (ret != ALGO_NORMAL) {
+            uart_printf("model rx: blob refused, ret = %d\r\n", ret);
+        } else if (ready) {
+            uart_printf("model rx: blob verified, swap at the next hop\r\n");
+        }
+        head = __atomic_load_n(&g_model_rx_head, __ATOMIC_ACQUIRE);
+    }
+
+    return fed;
+}
+
+// the UART interrupt fills the ring, the task sleeps on the semaphore until bytes
+// arrive, a partial blob times out or the next swap report is due
+static void task_model_rx(void *param)
+{
+    uint32_t wait = 0, lost = 0, idle_ms = 0;
+    uint32_t tick_ms    = 1000 / osal_ms_to_tick(1000);
+    uint64_t last_us    = 0;
+    ModelSwapStats last = g_model_swap.stats;
+    UartDevice *uart    = hal_uart_get_device(VAD_MODEL_UART_ID);
+
+    (void)param;
+    g_model_rx_param = (UartAyncRecvParam){.buff_len = sizeof(g_model_rx_buf),
+                                           .buffer   = g_model_rx_buf,
+                                           .trig_len = 1,
+                                           .callback = model_rx_isr,
+                                           .use_dma  = false};
+    if (!uart || hal_uart_async_recv_data(uart, &g_model_rx_param) != VSD_SUCCESS) {
+        uart_printf("model rx: no async receive on uart %d\r\n", VAD_MODEL_UART_ID);
+        osal_delete_task(NULL);
+        return;
+    }
+
+    last_us = osal_get_uptime_us();
+    while (1) {
+        wait = MODEL_RX_REPORT;
+        if (g_model_swap.rx_pos || g_model_swap.rx_skip) {
+            // a stalled transfer must not hold the slot, the wait is rounded up to a tick
+            idle_ms = (uint32_t)((osal_get_uptime_us() - last_us) / 1000);
+            if (idle_ms >= VAD_MODEL_RX_TIMEOUT) {
+                model_swap_rx_reset(&g_model_swap);
+                uart_printf("model rx: timeout\r\n");
+            } else {
+                wait = (VAD_MODEL_RX_TIMEOUT - idle_ms + tick_ms - 1) / tick_ms * tick_ms;
+            }
+        }
+
+        osal_sem_wait(&g_model_rx_sem, wait);
+        if (model_rx_drain()) {
+            last_us = osal_get_uptime_us();
+        }
+        if (g_model_rx_lost != lost) {
+            lost = g_model_rx_lost;
+            uart_printf("model rx: %u bytes lost, ring full\r\n", (unsigned)lost);
+        }
+        report_swap(&g_model_swap, &last);
+        last = g_model_swap.stats;
+    }
+}
+
+#if VAD_EVENT_MONITOR
+static VadEventLatency g_monitor_lat;
+
+static uint32_t sample_to_ms(uint64_t sample)
+{
+    return (uint32_t)(sample * 1000 / OBJ_FS);
+}
+
+static uint32_t hop_to_ms(uint64_t hop)
+{
+    return (uint32_t)(hop * FRAME_STEP * 1000 / OBJ_FS);
+}
+
+static int monitor_handler(void *cobj, uint32_t event_id, void *param)
+{
+    VadEvent event;
+    const VadEventStats *stats = &event.stats;
+    const VadQos *qos          = &g_vad_qos;
+
+    (void)cobj;
+    if (!vad_event_receive(&g_monitor_lat, param, &event)) {
+        return EVENT_OK;
+    }
+
+    switch (event_id) {
+    case EVENT_VAD_VOICE_START:
+        uart_printf("vad: voice start at %u ms, margin %d/1000, latency %u us\r\n",
+                    (unsigned)sample_to_ms(event.sample), (int)(event.margin * 1000),
+                    (unsigned)cycle_to_us(g_monitor_lat.last));
+        break;
+    case EVENT_VAD_VOICE_END:
+        uart_printf("vad: voice %u - %u ms, peak margin %d/1000\r\n",
+                    (unsigned)sample_to_ms(event.start), (unsigned)sample_to_ms(event.sample),
+                    (int)(event.peak * 1000));
+        break;
+    case EVENT_VAD_STATS:
+        uart_printf("vad: %u hops, %u voice, %u skipped, %u segments, notify max %u cycles, "
+                    "%u failed\r\n",
+                    (unsigned)stats->hop_cnt, (unsigned)stats->voice_cnt,
+                    (unsigned)stats->skip_cnt, (unsigned)stats->seg_cnt,
+                    (unsigned)stats->notify_cycle, (unsigned)stats->notify_fail);
+        uart_printf("vad: latency %u events, min %u avg %u max %u us, %u lost\r\n",
+                    (unsigned)g_monitor_lat.cnt, (unsigned)cycle_to_us(g_monitor_lat.min),
+                    (unsigned)cycle_to_us(g_monitor_lat.sum / g_monitor_lat.cnt),
+                    (unsigned)cycle_to_us(g_monitor_lat.max), (unsigned)g_monitor_lat.lost);
+        uart_printf("vad qos: level %d, full/gate/half %u/%u/%u ms, %u missed, worst %u us\r\n",
+                    (int)qos->level, (unsigned)hop_to_ms(qos->hop_cnt[VAD_QOS_FULL]),
+                    (unsigned)hop_to_ms(qos->hop_cnt[VAD_QOS_GATE]),
+                    (unsigned)hop_to_ms(qos->hop_cnt[VAD_QOS_HALF]), (unsigned)qos->miss_cnt,
+                    (unsigned)cycle_to_us(qos->max_elapsed));
+        break;
+    default:
+        break;
+    }
+
+    return EVENT_OK;
+}
+
+static void task_monitor(void *param)
+{
+    void *manager = vpi_event_new_manager(COBJ_CUSTOM_MGR, monitor_handler);
+
+    (void)param;
+    if (!manager || vad_event_subscribe(manager) != EVENT_OK) {
+        uart_printf("vad monitor: subscribe failed\r\n");
+        osal_delete_task(NULL);
+        return;
+    }
+
+    // sleeps until a VAD event arrives
+    vpi_event_listen(manager);
+}
+#endif
+
+#if VAD_CLIP_CAPTURE
+#define CAPTURE_HOP_US ((uint64_t)FRAME_STEP * 1000000 / OBJ_FS)
+
+static double g_capture_frame[FRAME_LEN];
+static uint32_t g_capture_drop; // hops skipped because the task fell a whole hop behind
+
+// next FRAME_STEP samples of the clip, replayed in a loop
+static uint32_t capture_read(uint32_t pos, double *out, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        out[i] = g_vad_clip[pos];
+        pos    = pos + 1 < VAD_CLIP_LEN ? pos + 1 : 0;
+    }
+
+    return pos;
+}
+
+// stands in for the microphone and its DMA: a hop of the clip every 15 ms on
+// average, ready when the task wakes, the tick being 10 ms. A whole hop behind,
+// the hops already past are dropped as the DMA would overwrite them, and the
+// task yields at least a tick per hop so the lower priority tasks still run
+static void task_capture(void *param)
+{
+    int ret          = ALGO_NORMAL;
+    uint64_t sample  = 0, due = 0, now = 0, ready = 0;
+    uint32_t pos     = 0, drop = 0;
+    bool is_voice    = false;
+    Conv2dData frame = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = g_capture_frame};
+
+    (void)param;
+    pos = capture_read(pos, g_capture_frame + FRAME_STEP, FRAME_LEN - FRAME_STEP);
+    due = osal_get_uptime_us();
+
+    while (1) {
+        due += CAPTURE_HOP_US;
+        now = osal_get_uptime_us();
+        if (now >= due + CAPTURE_HOP_US) {
+            drop = (uint32_t)((now - due) / CAPTURE_HOP_US);
+            due += drop * CAPTURE_HOP_US;
+            pos = (uint32_t)((pos + (uint64_t)drop * FRAME_STEP) % VAD_CLIP_LEN);
+            sample += (uint64_t)drop * FRAME_STEP;
+            g_capture_drop += drop;
+            uart_printf("vad capture: %u hops behind, %u dropped\r\n", (unsigned)drop,
+                        (unsigned)g_capture_drop);
+        }
+        osal_sleep(due > now + 1000 ? (int32_t)((due - now) / 1000) : 1);
+
+        memmove(g_capture_frame, g_capture_frame + FRAME_STEP,
+                sizeof(double) * (FRAME_LEN - FRAME_STEP));
+        pos = capture_read(pos, g_capture_frame + FRAME_LEN - FRAME_STEP, FRAME_STEP);
+
+        ready = __get_rv_cycle();
+        ret   = vad_task_process(&frame, sample, ready, &is_voice);
+        if (ret != ALGO_NORMAL) {
+            uart_printf("vad capture: process failed, ret = %d\r\n", ret);
+            osal_delete_task(NULL);
+            return;
+        }
+        sample += FRAME_STEP;
+    }
+}
+#endif
+
+int vad_task_init(void)
+{
+    int ret        = ALGO_NORMAL;
+    uint32_t heap  = 0;
+    uint64_t cycle = 0;
+    void *task     = NULL;
+    VadQosConfig qos;
+
+#if VAD_DMA_BENCH
+    dma_buf_bench();
+#endif
+#if VAD_MSG_BENCH
+    msg_bench();
+#endif
+
+    heap  = osal_get_free_heap();
+    cycle = __get_rv_cycle();
+    ret   = vad_init(&g_vad_ctx);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    model_swap_init(&g_model_swap);
+    vad_event_init(&g_vad_event, NULL);
+
+    // the budget of a hop is its period, 15 ms
+    vad_qos_default_config(&qos,
+                           (uint32_t)((uint64_t)soc_cpu_clock_get_freq() * FRAME_STEP / OBJ_FS));
+    ret = vad_qos_init(&g_vad_qos, &qos, NULL);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+#if VAD_STATIC_ALLOC
+    ret = osal_create_sem_static(&g_model_rx_sem, &g_model_rx_sem_buf);
+#else
+    ret = osal_create_sem(&g_model_rx_sem);
+#endif
+    if (ret != OSAL_TRUE) {
+        return ALGO_ERR_GENERIC;
+    }
+
+#if VAD_STATIC_ALLOC
+    task = osal_create_task_static(task_model_rx, "model_rx", VAD_MODEL_RX_STACK, 2, NULL,
+                                   g_model_rx_stack, &g_model_rx_tcb);
+#else
+    task = osal_create_task(task_model_rx, "model_rx", VAD_MODEL_RX_STACK, 2, NULL);
+#endif
+    if (!task) {
+        return ALGO_ERR_GENERIC;
+    }
+
+#if VAD_EVENT_MONITOR
+#if VAD_STATIC_ALLOC
+    task = osal_create_task_static(task_monitor, "vad_monitor", VAD_MONITOR_STACK, 3, NULL,
+                                   g_monitor_stack, &g_monitor_tcb);
+#else
+    task = osal_create_task(task_monitor, "vad_monitor", VAD_MONITOR_STACK, 3, NULL);
+#endif
+    if (!task) {
+        return ALGO_ERR_GENERIC;
+    }
+#endif
+
+#if VAD_CLIP_CAPTURE
+#if VAD_STATIC_ALLOC
+    task = osal_create_task_static(task_capture, "vad_capture", VAD_CAPTURE_STACK,
+                                   VAD_CAPTURE_PRIO, NULL, g_capture_stack, &g_capture_tcb);
+#else
+    task = osal_create_task(task_capture, "vad_capture", VAD_CAPTURE_STACK, VAD_CAPTURE_PRIO,
+                            NULL);
+#endif
+    if (!task) {
+        return ALGO_ERR_GENERIC;
+    }
+#endif
+
+    cycle = __get_rv_cycle() - cycle;
+    // the monitor outranks this task, its heap manager is already counted below
+    uart_printf("vad init: %s, %u us, heap free %u -> %u bytes, %u bytes static%s\r\n",
+                VAD_STATIC_ALLOC ? "static" : "dynamic", (unsigned)cycle_to_us(cycle),
+                (unsigned)heap, (unsigned)osal_get_free_heap(), (unsigned)static_bytes(),
+                VAD_EVENT_MONITOR ? ", event monitor on the heap" : "");
+
+    return ALGO_NORMAL;
+}
+
+VadContext *vad_task_context(void)
+{
+    return &g_vad_ctx;
+}
+
+void vad_task_hop(void)
+{
+    model_swap_apply(&g_model_swap, &g_vad_ctx);
+}
+
+void vad_task_rollback(void)
+{
+    model_swap_rollback(&g_model_swap);
+}
+
+int vad_task_process(Conv2dData *frame, uint64_t sample, uint64_t ready_cycle, bool *is_voice)
+{
+    int ret        = ALGO_NORMAL;
+    uint64_t start = 0, done = 0;
+
+    vad_task_hop();
+
+    start = __get_rv_cycle();
+    ret   = vad_qos_process(&g_vad_qos, &g_vad_ctx, frame, is_voice);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    vad_task_decision(sample, *is_voice);
+    done = __get_rv_cycle();
+
+    vad_qos_update(&g_vad_qos, done - ready_cycle < UINT32_MAX ? (uint32_t)(done - ready_cycle)
+                                                               : UINT32_MAX,
+                   (uint32_t)(done - start));
+
+    return ret;
+}
+
+const VadQos *vad_task_qos(void)
+{
+    return &g_vad_qos;
+}
+
+void vad_task_decision(uint64_t sample, bool is_voice)
+{
+    vad_event_hop(&g_vad_event, sample, is_voice, g_vad_ctx.margin);
+}
@@ -0,0 +1,120 @@
+import argparse  # 导入 argparse 模块，用于解析命令行参数
+import torch  # 导入 PyTorch 深度学习框架
+
+from model import StreamCNN  # 导入流式 VAD 模型类
+from util import read_wav, sample_rate_to_8K  # 导入读取 wav 文件和降采样的函数
+
+FS = 8000  # 采样率为 8000 Hz
+FRAME_LEN = 240  # 帧长为 30 毫秒
+FRAME_STEP = 120  # 帧移为 15 毫秒
+VALUE_PER_LINE = 4  # 头文件中每行的数值个数
+
+def load_model(model_path, seed):
+    """
+    加载流式 VAD 模型。如果模型文件是 CNN 的参数，只加载其前端（卷积和 BN），其余层随机初始化，
+    此时导出的模型未经训练，只能用于验证 C 代码与 PyTorch 的一致性
+
+    :param model_path: 模型文件路径，StreamCNN 或 CNN 的 state_dict
+    :param seed: 随机初始化的种子
+    :return: 加载后的模型
+    """
+    state = torch.load(model_path)
+    torch.manual_seed(seed)
+    model = StreamCNN()
+
+    if "proj.weight" in state:
+        model.load_state_dict(state)
+    else:
+        front = {name: value for name, value in state.items() if name.startswith("model.")}
+        model.load_state_dict(front, strict=False)
+        print("%s is a CNN, only the front end is loaded, the temporal layers are untrained" % model_path)
+
+    model.eval()
+    return model
+
+def c_array(name, tensor):
+    """
+    将张量写为 C 的 double 数组，命名方式与 model_parameters.h 相同（state_dict 的名字中的 . 换成 _）
+
+    :param name: state_dict 中的名字
+    :param tensor: 参数张量
+    :return: C 代码
+    """
+    values = [repr(float(v)) for v in tensor.detach().double().flatten().tolist()]
+    lines = [", ".join(values[i:i + VALUE_PER_LINE]) for i in range(0, len(values), VALUE_PER_LINE)]
+    return "static const double temporal_%s[] = {\n    %s};\n" % (name.replace(".", "_"), ",\n    ".join(lines))
+
+def export_header(model, header_path):
+    """
+    导出 2_VAD_c/temporal_parameters.h，以 -DVAD_TEMPORAL_MODEL=1 编译 C 代码时使用
+
+    :param model: 流式 VAD 模型
+    :param header_path: 头文件路径
+    """
+    n_feat = model.proj.out_features
+    hidden_size = model.gru.hidden_size
+    negative_slope = model.act.negative_slope
+
+    with open(header_path, "w") as file:
+        file.write("#ifndef __TEMPORAL_PARAMETERS_H__\n#define __TEMPORAL_PARAMETERS_H__\n\n")
+        file.write("// generated by 1_VAD_python/export.py\n")
+        file.write("#define TEMPORAL_FEAT_NUM    (%d)\n" % n_feat)
+        file.write("#define TEMPORAL_HIDDEN_SIZE (%d)\n" % hidden_size)
+        file.write("#define TEMPORAL_CONV_NUM    (%d)\n" % len(model.tcn))
+        file.write("#define TEMPORAL_NEG_SLOPE   (%s)\n\n" % repr(negative_slope))
+
+        for name, value in model.state_dict().items():
+            if name.endswith("num_batches_tracked"):
+                continue
+            file.write(c_array(name, value))
+        file.write("\n")
+
+        # 因果卷积层的描述表：输入通道、输出通道、卷积核、扩张率、权重、偏置、负斜率
+        file.write("#define TEMPORAL_CONV_LAYERS \\\n    { \\\n")
+        for i, layer in enumerate(model.tcn):
+            conv = layer.conv
+            file.write("        {%d, %d, %d, %d, temporal_tcn_%d_conv_weight, temporal_tcn_%d_conv_bias, %s}, \\\n"
+                       % (conv.in_channels, conv.out_channels, conv.kernel_size[0], conv.dilation[0],
+                          i, i, repr(layer.act.negative_slope)))
+        file.write("    }\n\n#endif\n")
+
+    receptive = 1 + sum((layer.conv.kernel_size[0] - 1) * layer.conv.dilation[0] for layer in model.tcn)
+    print("written %s, receptive field of the causal convs = %d hops (%d ms)"
+          % (header_path, receptive, ((receptive - 1) * FRAME_STEP + FRAME_LEN) * 1000 // FS))
+
+def export_margin(model, wav_path, margin_path):
+    """
+    用 PyTorch 一次处理整段 wav 文件，将每个帧移的 margin（语音与非语音 logit 之差）逐行写入文本文件，
+    用于和 ./vad_c temporal run 的逐帧移结果比较
+
+    :param model: 流式 VAD 模型
+    :param wav_path: wav 文件路径
+    :param margin_path: margin 文件路径
+    """
+    signal, signal_len, sample_rate = read_wav(wav_path)
+    signal, signal_len = sample_rate_to_8K(signal, sample_rate)
+
+    frames = [signal[i:i + FRAME_LEN] for i in range(0, signal_len - FRAME_LEN + 1, FRAME_STEP)]
+    x = torch.tensor([list(frame) for frame in frames], dtype=torch.float64).unsqueeze(0)
+
+    with torch.no_grad():
+        logit = model.double()(x)[0]
+
+    with open(margin_path, "w") as file:
+        for value in (logit[:, 1] - logit[:, 0]).tolist():
+            file.write("%.17g\n" % value)
+    print("written %d margins to %s" % (len(frames), margin_path))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="export the streaming VAD model to C")
+    parser.add_argument("model_path", help="StreamCNN state_dict, or a CNN one such as model/model_microphone.pth")
+    parser.add_argument("header_path", help="output header, ../2_VAD_c/temporal_parameters.h")
+    parser.add_argument("--wav", help="also write the PyTorch margins of this wav file")
+    parser.add_argument("--margin", help="margin file of --wav")
+    parser.add_argument("--seed", type=int, default=0, help="seed of the untrained layers")
+    args = parser.parse_args()
+
+    model = load_model(args.model_path, args.seed)
+    export_header(model, args.header_path)
+    if args.wav and args.margin:
+        export_margin(model, args.wav, args.margin)
@@ -38,6 +38,76 @@ class CNN(nn.Module):  # 声明一个 CNN（卷积神经网络）模型类，继
         output = self.output(x)  # 全连接输出
         return output  # 返回模型输出
 
+class CausalConv1d(nn.Module):  # 声明一个因果扩张一维卷积层，沿帧移（hop）方向计算
+    def __init__(self, in_channels, out_channels, kernel_size=3, dilation=1, negative_slope=0.01) -> None:
+        """
+        初始化因果卷积层，只在左侧补 (kernel_size - 1) * dilation 个零，输出不依赖未来的帧
+
+        :param in_channels: 输入通道数
+        :param out_channels: 输出通道数
+        :param kernel_size: 卷积核大小，默认为 3
+        :param dilation: 卷积扩张率，默认为 1
+        :param negative_slope: 卷积后 LeakyReLU 的负斜率，默认为 0.01
+        """
+        super(CausalConv1d,self).__init__()
+
+        self.left_pad = (kernel_size - 1) * dilation  # 左侧补零的长度
+        self.conv = nn.Conv1d(in_channels=in_channels,out_channels=out_channels,
+                              kernel_size=kernel_size,dilation=dilation)  # 一维卷积层
+        self.act = nn.LeakyReLU(negative_slope=negative_slope)  # 激活函数层
+
+    def forward(self,x):
+        """
+        因果卷积前向传播
+
+        :param x: 输入数据，形状为 (batch, channel, hop_N)
+        :return: 输出数据，形状为 (batch, out_channel, hop_N)
+        """
+        x = nn.functional.pad(x,(self.left_pad,0))  # 只在左侧补零
+        return self.act(self.conv(x))
+
+class StreamCNN(nn.Module):  # 声明一个流式 VAD 模型类，在 CNN 的基础上增加帧间的时序建模
+    def __init__(self, n_feat=8, hidden_size=8, kernel_size=3, dilations=(1,2,4)) -> None:
+        """
+        初始化流式 VAD 模型：每帧先经过与 CNN 相同的卷积、BN 和 LeakyReLU，投影为一个时间步的特征，
+        再经过沿帧移方向的因果扩张卷积和 GRU，最后由全连接层输出。C 代码中每个帧移只计算新的时间步，
+        感受野为 1 + (kernel_size - 1) * sum(dilations) 个帧移
+
+        :param n_feat: 每个时间步的特征数，默认为 8
+        :param hidden_size: GRU 隐状态大小，默认为 8
+        :param kernel_size: 因果卷积核大小，默认为 3
+        :param dilations: 各因果卷积层的扩张率，默认为 (1,2,4)
+        """
+        super(StreamCNN,self).__init__()
+
+        self.fc_size = 120 * 2  # 卷积输出大小
+        self.model = nn.Sequential(  # 与 CNN 相同的前端，可以直接加载 CNN 的参数
+            nn.Conv2d(in_channels=1,out_channels=2,kernel_size=(1,2),stride=2,padding="valid",bias=False),
+            nn.BatchNorm2d(num_features=2),
+            nn.LeakyReLU(inplace=True),
+        )
+        self.proj = nn.Linear(in_features=self.fc_size,out_features=n_feat)  # 投影为一个时间步的特征
+        self.act = nn.LeakyReLU()
+        self.tcn = nn.ModuleList([CausalConv1d(n_feat,n_feat,kernel_size,d) for d in dilations])  # 因果扩张卷积
+        self.gru = nn.GRU(input_size=n_feat,hidden_size=hidden_size,batch_first=True)  # GRU
+        self.output = nn.Linear(in_features=hidden_size,out_features=2)  # 全连接输出层
+
+    def forward(self,x):
+        """
+        流式 VAD 模型前向传播，一次处理整段帧序列，与 C 代码逐帧移处理的结果相同
+
+        :param x: 输入数据，形状为 (batch, hop_N, frame_len)
+        :return: 模型输出，形状为 (batch, hop_N, 2)
+        """
+        batch, hop_n = x.size(0), x.size(1)
+        x = self.model(x.reshape(batch * hop_n,1,1,-1))  # 每帧单独经过前端
+        x = self.act(self.proj(x.reshape(batch * hop_n,-1)))  # 投影为时间步特征
+        x = x.reshape(batch,hop_n,-1).transpose(1,2)  # (batch, n_feat, hop_N)
+        for layer in self.tcn:
+            x = layer(x)
+        x, _ = self.gru(x.transpose(1,2))  # 初始隐状态为零
+        return self.output(x)
+
 # import torch
 # import torch.nn as nn
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "adpcm.h"
+#include "vad_section.h"
+
+// IMA step sizes, about 1.1x apart
+static const int16_t g_adpcm_step[ADPCM_INDEX_MAX + 1] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+// step index change for the magnitude bits of a nibble
+static const int8_t g_adpcm_index[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+void adpcm_init(AdpcmState *st)
+{
+    st->predictor = 0;
+    st->index     = 0;
+}
+
+// common to both sides: apply a nibble to the predictor and the step index
+VAD_RAM_TEXT static inline int32_t adpcm_update(int32_t pred, int32_t *index, uint8_t nibble)
+{
+    int32_t step   = g_adpcm_step[*index];
+    int32_t vpdiff = step >> 3;
+
+    if (nibble & 4) {
+        vpdiff += step;
+    }
+    if (nibble & 2) {
+        vpdiff += step >> 1;
+    }
+    if (nibble & 1) {
+        vpdiff += step >> 2;
+    }
+
+    pred += (nibble & 8) ? -vpdiff : vpdiff;
+    pred = pred > INT16_MAX ? INT16_MAX : (pred < INT16_MIN ? INT16_MIN : pred);
+
+    *index += g_adpcm_index[nibble & 7];
+    *index = *index < 0 ? 0 : (*index > ADPCM_INDEX_MAX ? ADPCM_INDEX_MAX : *index);
+
+    return pred;
+}
+
+VAD_RAM_TEXT uint32_t adpcm_encode(AdpcmState *st, const int16_t *pcm, uint32_t len, uint8_t *out)
+{
+    int32_t pred = st->predictor, index = st->index;
+    int32_t diff = 0, step = 0, bit = 0;
+    uint8_t nibble = 0;
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        // quantize the difference to the predictor with the bits of the decoder,
+        // without branches: the bits of speech are close to random
+        diff   = pcm[i] - pred;
+        nibble = diff < 0 ? 8 : 0;
+        diff   = diff < 0 ? -diff : diff;
+        step   = g_adpcm_step[index];
+        bit    = diff >= step;
+        nibble |= (uint8_t)(bit << 2);
+        diff -= step & -bit;
+        step >>= 1;
+        bit = diff >= step;
+        nibble |= (uint8_t)(bit << 1);
+        diff -= step & -bit;
+        step >>= 1;
+        nibble |= (uint8_t)(diff >= step);
+
+        pred = adpcm_update(pred, &index, nibble);
+        if (i & 1) {
+            out[i >> 1] |= (uint8_t)(nibble << 4);
+        } else {
+            out[i >> 1] = nibble;
+        }
+    }
+
+    st->predictor = (int16_t)pred;
+    st->index     = (uint8_t)index;
+
+    return (len + 1) / 2;
+}
+
+void adpcm_decode(AdpcmState *st, const uint8_t *in, uint32_t len, int16_t *pcm)
+{
+    int32_t pred = st->predictor, index = st->index;
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        pred   = adpcm_update(pred, &index, (i & 1) ? in[i >> 1] >> 4 : in[i >> 1] & 0xf);
+        pcm[i] = (int16_t)pred;
+    }
+
+    st->predictor = (int16_t)pred;
+    st->index     = (uint8_t)index;
+}
+
+uint32_t adpcm_encode_packet(AdpcmState *st, const int16_t *pcm, uint32_t len, uint8_t *packet)
+{
+    packet[0] = (uint8_t)((uint16_t)st->predictor & 0xff);
+    packet[1] = (uint8_t)((uint16_t)st->predictor >> 8);
+    packet[2] = st->index;
+    packet[3] = (uint8_t)(len & 1);
+
+    return ADPCM_HEADER_SIZE + adpcm_encode(st, pcm, len, packet + ADPCM_HEADER_SIZE);
+}
+
+int adpcm_decode_packet(const uint8_t *packet, uint32_t size, int16_t *pcm, uint32_t *len)
+{
+    AdpcmState st;
+
+    if (size < ADPCM_HEADER_SIZE || packet[2] > ADPCM_INDEX_MAX || packet[3] > 1 ||
+        (packet[3] && size == ADPCM_HEADER_SIZE)) {
+        return ALGO_DATA_INVALID;
+    }
+
+    st.predictor = (int16_t)(uint16_t)(packet[0] | (packet[1] << 8));
+    st.index     = packet[2];
+    *len         = 2 * (size - ADPCM_HEADER_SIZE) - packet[3];
+    adpcm_decode(&st, packet + ADPCM_HEADER_SIZE, *len, pcm);
+
+    return ALGO_NORMAL;
+}
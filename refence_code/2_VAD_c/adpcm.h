@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ADPCM_H__
+#define __ADPCM_H__
+
+#include <stdint.h>
+
+#include "algo_error_code.h"
+
+#define ADPCM_INDEX_MAX   (88) // last entry of the step size table
+#define ADPCM_HEADER_SIZE (4)  // predictor (int16, little endian), step index, padding nibbles
+
+/** bytes of a packet carrying num samples */
+#define ADPCM_PACKET_SIZE(num) (ADPCM_HEADER_SIZE + ((num) + 1) / 2)
+
+/**
+ * IMA-ADPCM coder state, 4 bits per sample. Encoder and decoder hold the
+ * same state as long as they see the same nibbles.
+ */
+typedef struct _AdpcmState {
+    int16_t predictor; // last reconstructed sample
+    uint8_t index;     // step size index, 0..ADPCM_INDEX_MAX
+} AdpcmState;
+
+/**
+ * @brief reset a coder state
+ *
+ * @param[out] st: state
+ */
+void adpcm_init(AdpcmState *st);
+
+/**
+ * @brief encode samples, two per byte, the first one in the low nibble
+ *
+ * @param[in,out] st: encoder state
+ * @param[in] pcm: samples
+ * @param[in] len: number of samples, an odd last one leaves the high nibble 0
+ * @param[out] out: (len + 1) / 2 bytes
+ * @return number of bytes written
+ */
+uint32_t adpcm_encode(AdpcmState *st, const int16_t *pcm, uint32_t len, uint8_t *out);
+
+/**
+ * @brief decode samples written by adpcm_encode
+ *
+ * @param[in,out] st: decoder state
+ * @param[in] in: (len + 1) / 2 bytes
+ * @param[in] len: number of samples
+ * @param[out] pcm: samples
+ */
+void adpcm_decode(AdpcmState *st, const uint8_t *in, uint32_t len, int16_t *pcm);
+
+/**
+ * @brief encode samples into a self-contained packet: the header holds the
+ * encoder state before the samples, so packets can be decoded after a gap or
+ * a lost packet
+ *
+ * @param[in,out] st: encoder state
+ * @param[in] pcm: samples
+ * @param[in] len: number of samples
+ * @param[out] packet: ADPCM_PACKET_SIZE(len) bytes
+ * @return packet size in bytes
+ */
+uint32_t adpcm_encode_packet(AdpcmState *st, const int16_t *pcm, uint32_t len, uint8_t *packet);
+
+/**
+ * @brief decode a packet written by adpcm_encode_packet
+ *
+ * @param[in] packet: packet
+ * @param[in] size: packet size in bytes
+ * @param[out] pcm: up to 2 * (size - ADPCM_HEADER_SIZE) samples
+ * @param[out] len: number of samples given to the encoder, the padding
+ *             nibble of an odd number is not decoded
+ * @return error code
+ */
+int adpcm_decode_packet(const uint8_t *packet, uint32_t size, int16_t *pcm, uint32_t *len);
+
+#endif
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+
+#include "vad.h"
+#include "wav.h"
+#include "runner.h"
+#include "adpcm.h"
+#include "adpcm_tool.h"
+
+#define ADPCM_HOP_BYTES ADPCM_PACKET_SIZE(FRAME_STEP)
+#define ADPCM_MAX_FILE  (256)
+#define ADPCM_NAME_LEN  (256)
+
+/**
+ * totals of one file or of the data set
+ */
+typedef struct _AdpcmTotal {
+    uint64_t sample_num; // samples of the audio
+    uint64_t hop_num;    // hops decided
+    uint64_t voice_num;  // hops sent
+    uint64_t bytes;      // bytes of the packets
+    double signal;       // energy of the samples sent
+    double noise;        // energy of the coding error
+    uint64_t vad_cycle;  // cycles of vad_process
+    uint64_t enc_cycle;  // cycles of adpcm_encode_packet
+    uint64_t dec_cycle;  // cycles of adpcm_decode_packet
+} AdpcmTotal;
+
+static void adpcm_total_add(AdpcmTotal *sum, const AdpcmTotal *add)
+{
+    sum->sample_num += add->sample_num;
+    sum->hop_num += add->hop_num;
+    sum->voice_num += add->voice_num;
+    sum->bytes += add->bytes;
+    sum->signal += add->signal;
+    sum->noise += add->noise;
+    sum->vad_cycle += add->vad_cycle;
+    sum->enc_cycle += add->enc_cycle;
+    sum->dec_cycle += add->dec_cycle;
+}
+
+static void adpcm_total_print(const char *name, const AdpcmTotal *total)
+{
+    double sec = (double)total->sample_num / OBJ_FS;
+
+    printf("%-12s %8.1f %7.1f%% %10llu %8.2f %7.1f\n", name, sec,
+           total->hop_num ? 100.0 * total->voice_num / total->hop_num : 0.0,
+           (unsigned long long)total->bytes, sec > 0 ? total->bytes * 8 / sec / 1e3 : 0.0,
+           total->noise > 0 ? 10 * log10(total->signal / total->noise) : INFINITY);
+}
+
+// every packet length up to a hop and one more decodes to the samples given
+// to the encoder, and to the same ones as the streaming decoder
+static int adpcm_check_packet(void)
+{
+    uint32_t n = 0, len = 0, k;
+    int16_t pcm[FRAME_STEP + 1], dec[FRAME_STEP + 2], ref[FRAME_STEP + 1];
+    uint8_t packet[ADPCM_PACKET_SIZE(FRAME_STEP + 1)];
+    AdpcmState enc, ref_st;
+
+    for (k = 0; k <= FRAME_STEP; k++) {
+        pcm[k] = (int16_t)(8000 * sin(0.3 * k) + 300 * ((k * 7) % 5));
+    }
+
+    adpcm_init(&enc);
+    for (n = 1; n <= FRAME_STEP + 1; n++) {
+        ref_st = enc;
+        if (adpcm_encode_packet(&enc, pcm, n, packet) != ADPCM_PACKET_SIZE(n)) {
+            printf("packet of %u samples: wrong size\n", n);
+            return ALGO_ERR_GENERIC;
+        }
+        dec[n] = 0x5a5a; // guard against a padding sample
+        if (adpcm_decode_packet(packet, ADPCM_PACKET_SIZE(n), dec, &len) != ALGO_NORMAL ||
+            len != n || dec[n] != 0x5a5a) {
+            printf("packet of %u samples: decoded %u\n", n, len);
+            return ALGO_ERR_GENERIC;
+        }
+        adpcm_decode(&ref_st, packet + ADPCM_HEADER_SIZE, n, ref);
+        if (memcmp(dec, ref, n * sizeof(int16_t))) {
+            printf("packet of %u samples: differs from adpcm_decode\n", n);
+            return ALGO_ERR_GENERIC;
+        }
+    }
+    printf("packet check: 1..%d samples ok\n", FRAME_STEP + 1);
+
+    return ALGO_NORMAL;
+}
+
+static int adpcm_file(VadContext *ctx, const char *wav_dir, AdpcmTotal *total)
+{
+    int ret        = ALGO_NORMAL;
+    uint64_t i     = 0, start = 0;
+    uint32_t size  = 0, len = 0, k;
+    bool vad_out   = false;
+    double v       = 0.0, e = 0.0;
+    double frame[FRAME_LEN];
+    int16_t pcm[FRAME_STEP], dec[FRAME_STEP + 1];
+    uint8_t packet[ADPCM_HOP_BYTES];
+    AdpcmState st;
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    memset(total, 0, sizeof(AdpcmTotal));
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    adpcm_init(&st);
+    total->sample_num = wav.frames;
+    total->hop_num    = cal_frame_num(wav.frames);
+    for (i = 0; i < total->hop_num; i++) {
+        load_frame(&wav, i * FRAME_STEP, i == 0, frame);
+
+        start = get_cycle();
+        ret   = vad_process(ctx, &vad_inp, &vad_out);
+        total->vad_cycle += get_cycle() - start;
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+        if (!vad_out) {
+            continue;
+        }
+
+        // the hop of a voice frame is sent, the hops of a segment join up
+        for (k = 0; k < FRAME_STEP; k++) {
+            v      = frame[k] < 0 ? frame[k] - 0.5 : frame[k] + 0.5;
+            v      = v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v);
+            pcm[k] = (int16_t)v;
+        }
+
+        start = get_cycle();
+        size  = adpcm_encode_packet(&st, pcm, FRAME_STEP, packet);
+        total->enc_cycle += get_cycle() - start;
+
+        start = get_cycle();
+        adpcm_decode_packet(packet, size, dec, &len);
+        total->dec_cycle += get_cycle() - start;
+
+        for (k = 0; k < FRAME_STEP; k++) {
+            e = (double)pcm[k] - dec[k];
+            total->signal += (double)pcm[k] * pcm[k];
+            total->noise += e * e;
+        }
+        total->voice_num++;
+        total->bytes += size;
+    }
+
+exit:
+    wav_close(&wav);
+
+    return ret;
+}
+
+static int cmp_name(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+int run_adpcm_dataset(const char *wav_dir)
+{
+    int ret              = ALGO_NORMAL;
+    uint32_t file_num    = 0, f = 0;
+    size_t len           = 0;
+    double sec = 0.0, peak = 0.0, uart = 0.0;
+    char path[ADPCM_NAME_LEN * 2];
+    char (*name)[ADPCM_NAME_LEN] = NULL;
+    DIR *dir             = NULL;
+    struct dirent *entry = NULL;
+    AdpcmTotal file, total;
+    VadContext ctx;
+
+    name = (char(*)[ADPCM_NAME_LEN])malloc(ADPCM_MAX_FILE * ADPCM_NAME_LEN);
+    if (!name) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    dir = opendir(wav_dir);
+    if (!dir) {
+        free(name);
+        return ALGO_IO_EXCEPTION;
+    }
+    while ((entry = readdir(dir)) != NULL && file_num < ADPCM_MAX_FILE) {
+        len = strlen(entry->d_name);
+        if (len <= 4 || len >= ADPCM_NAME_LEN || strcmp(entry->d_name + len - 4, ".wav")) {
+            continue;
+        }
+        memcpy(name[file_num++], entry->d_name, len + 1);
+    }
+    closedir(dir);
+    qsort(name, file_num, ADPCM_NAME_LEN, cmp_name);
+
+    ret = adpcm_check_packet();
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    memset(&total, 0, sizeof(AdpcmTotal));
+    printf("%-12s %8s %8s %10s %8s %7s\n", "file", "sec", "voice", "bytes", "kbit/s", "SNR dB");
+    for (f = 0; f < file_num; f++) {
+        snprintf(path, sizeof(path), "%s/%s", wav_dir, name[f]);
+        vad_init(&ctx);
+        ret = adpcm_file(&ctx, path, &file);
+        if (ret != ALGO_NORMAL) {
+            printf("%s: error %d\n", name[f], ret);
+            goto exit;
+        }
+        name[f][strlen(name[f]) - 4] = '\0';
+        adpcm_total_print(name[f], &file);
+        adpcm_total_add(&total, &file);
+    }
+    if (!total.voice_num) {
+        printf("no voice hop in %s\n", wav_dir);
+        ret = ALGO_DATA_NULL;
+        goto exit;
+    }
+    adpcm_total_print("total", &total);
+
+    // raw PCM would be 16 bits per sample on every voice hop
+    sec  = (double)total.sample_num / OBJ_FS;
+    peak = ADPCM_HOP_BYTES * 8.0 * OBJ_FS / FRAME_STEP / 1e3;
+    uart = ADPCM_UART_BAUD / 10 * 8 / 1e3;
+    printf("raw PCM: %.1f kbit/s while speaking, %.2f kbit/s on average\n", OBJ_FS * 16 / 1e3,
+           total.voice_num * FRAME_STEP * 16.0 / sec / 1e3);
+    printf("ADPCM: %.1f kbit/s while speaking (%u bytes per hop), %.2f kbit/s on average, "
+           "UART at %d baud carries %.1f kbit/s\n",
+           peak, (unsigned)ADPCM_HOP_BYTES, total.bytes * 8 / sec / 1e3, ADPCM_UART_BAUD, uart);
+    printf("cycles per sample: encode %.1f, decode %.1f; per hop: VAD %.0f, encode %.0f (%.2f%% of "
+           "the VAD)\n",
+           (double)total.enc_cycle / (total.voice_num * FRAME_STEP),
+           (double)total.dec_cycle / (total.voice_num * FRAME_STEP),
+           (double)total.vad_cycle / total.hop_num, (double)total.enc_cycle / total.voice_num,
+           100.0 * total.enc_cycle / total.voice_num / ((double)total.vad_cycle / total.hop_num));
+
+exit:
+    free(name);
+
+    return ret;
+}
@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <dirent.h>
+
+#include "cascade_eval.h"
+#include "vad.h"
+#include "wav.h"
+#include "segment.h"
+#include "evaluate.h"
+#include "runner.h"
+
+#define CASCADE_PATH_LEN (1024)
+#define CASCADE_MAX_FILE (1024)
+
+// fraction of hops sent to the CNN for the swept bands
+static const double g_stage2_ratio[] = {0.0, 0.05, 0.1, 0.2, 0.3, 0.5, 0.7, 1.0};
+
+typedef struct _CascadeFile {
+    char name[256];
+    uint64_t frames;    // samples after resampling
+    uint64_t hop_start; // index of the first hop in the hop arrays
+    uint64_t hop_num;   // number of hops
+    uint64_t *label;    // label segments
+    uint64_t label_size;
+} CascadeFile;
+
+typedef struct _CascadeData {
+    CascadeFile files[CASCADE_MAX_FILE];
+    uint64_t file_num;
+    uint64_t hop_num;
+    uint64_t hop_cap;
+    double *fea;   // VAD_STAGE1_FEA_NUM features per hop
+    double *m1;    // stage 1 margin per hop
+    double *m2;    // CNN margin per hop
+    uint64_t *c2;  // CNN cycles per hop
+    uint64_t c1;   // stage 1 cycles of all hops
+} CascadeData;
+
+typedef struct _SegmentBuffer {
+    uint64_t *data;
+    uint64_t size;
+} SegmentBuffer;
+
+static void segment_store(void *param, uint64_t start, uint64_t end)
+{
+    SegmentBuffer *buf = (SegmentBuffer *)param;
+
+    buf->data[buf->size++] = start;
+    buf->data[buf->size++] = end;
+}
+
+static int cmp_name(const void *a, const void *b)
+{
+    return strcmp(((const CascadeFile *)a)->name, ((const CascadeFile *)b)->name);
+}
+
+static int grow_hops(CascadeData *data, uint64_t need)
+{
+    uint64_t cap = data->hop_cap;
+    void *p      = NULL;
+
+    if (need <= cap) {
+        return ALGO_NORMAL;
+    }
+
+    while (cap < need) {
+        cap = cap ? cap * 2 : 4096;
+    }
+
+    p = realloc(data->fea, sizeof(double) * VAD_STAGE1_FEA_NUM * cap);
+    if (!p) {
+        return ALGO_MALLOC_FAIL;
+    }
+    data->fea = (double *)p;
+
+    p = realloc(data->m1, sizeof(double) * cap);
+    if (!p) {
+        return ALGO_MALLOC_FAIL;
+    }
+    data->m1 = (double *)p;
+
+    p = realloc(data->m2, sizeof(double) * cap);
+    if (!p) {
+        return ALGO_MALLOC_FAIL;
+    }
+    data->m2 = (double *)p;
+
+    p = realloc(data->c2, sizeof(uint64_t) * cap);
+    if (!p) {
+        return ALGO_MALLOC_FAIL;
+    }
+    data->c2 = (uint64_t *)p;
+
+    data->hop_cap = cap;
+
+    return ALGO_NORMAL;
+}
+
+// run both stages on every hop of a file and keep the margins
+static int collect_file(CascadeData *data, CascadeFile *file, const char *wav_dir,
+                        const char *label_dir, VadContext *ctx)
+{
+    char path[CASCADE_PATH_LEN];
+    int ret          = ALGO_NORMAL;
+    uint64_t i       = 0, n = 0, hop = 0, start = 0;
+    double frame[FRAME_LEN];
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    snprintf(path, sizeof(path), "%s/%s.txt", label_dir, file->name);
+    ret = load_voice_segment(path, &file->label, &file->label_size);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s.wav", wav_dir, file->name);
+    ret = wav_open(path, &wav);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    n             = cal_frame_num(wav.frames);
+    file->frames  = wav.frames;
+    file->hop_num = n;
+    file->hop_start = data->hop_num;
+
+    ret = grow_hops(data, data->hop_num + n);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    for (i = 0; i < n; i++) {
+        load_frame(&wav, i * FRAME_STEP, i == 0, frame);
+        hop = data->hop_num + i;
+
+        start = get_cycle();
+        vad_stage1_feature(&vad_inp, data->fea + hop * VAD_STAGE1_FEA_NUM);
+        data->m1[hop] = vad_stage1_margin(vad_stage1_default(),
+                                          data->fea + hop * VAD_STAGE1_FEA_NUM);
+        data->c1 += get_cycle() - start;
+
+        start = get_cycle();
+        ret   = vad_margin(ctx, &vad_inp, &data->m2[hop]);
+        data->c2[hop] = get_cycle() - start;
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+    }
+    data->hop_num += n;
+
+exit:
+    wav_close(&wav);
+
+    return ret;
+}
+
+// solve a * x = b in place by Gaussian elimination with partial pivoting
+static int solve(double *a, double *b, uint32_t n)
+{
+    uint32_t i = 0, j = 0, k = 0, p = 0;
+    double t = 0.0;
+
+    for (k = 0; k < n; k++) {
+        p = k;
+        for (i = k + 1; i < n; i++) {
+            if (fabs(a[i * n + k]) > fabs(a[p * n + k])) {
+                p = i;
+            }
+        }
+        if (a[p * n + k] == 0.0) {
+            return ALGO_DATA_EXCEPTION;
+        }
+        if (p != k) {
+            for (j = 0; j < n; j++) {
+                t            = a[k * n + j];
+                a[k * n + j] = a[p * n + j];
+                a[p * n + j] = t;
+            }
+            t    = b[k];
+            b[k] = b[p];
+            b[p] = t;
+        }
+        for (i = k + 1; i < n; i++) {
+            t = a[i * n + k] / a[k * n + k];
+            for (j = k; j < n; j++) {
+                a[i * n + j] -= t * a[k * n + j];
+            }
+            b[i] -= t * b[k];
+        }
+    }
+
+    for (k = n; k-- > 0;) {
+        for (j = k + 1; j < n; j++) {
+            b[k] -= a[k * n + j] * b[j];
+        }
+        b[k] /= a[k * n + k];
+    }
+
+    return ALGO_NORMAL;
+}
+
+// ridge least squares of the CNN margin on the stage 1 features and a bias
+static int fit_stage1(const CascadeData *data, double *weight, double *bias)
+{
+    const uint32_t n = VAD_STAGE1_FEA_NUM + 1;
+    double a[(VAD_STAGE1_FEA_NUM + 1) * (VAD_STAGE1_FEA_NUM + 1)];
+    double b[VAD_STAGE1_FEA_NUM + 1], x[VAD_STAGE1_FEA_NUM + 1];
+    double trace = 0.0;
+    uint64_t h = 0;
+    uint32_t i = 0, j = 0;
+    int ret    = ALGO_NORMAL;
+
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+
+    for (h = 0; h < data->hop_num; h++) {
+        memcpy(x, data->fea + h * VAD_STAGE1_FEA_NUM, sizeof(double) * VAD_STAGE1_FEA_NUM);
+        x[VAD_STAGE1_FEA_NUM] = 1.0;
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n; j++) {
+                a[i * n + j] += x[i] * x[j];
+            }
+            b[i] += x[i] * data->m2[h];
+        }
+    }
+
+    for (i = 0; i < VAD_STAGE1_FEA_NUM; i++) {
+        trace += a[i * n + i];
+    }
+    for (i = 0; i < VAD_STAGE1_FEA_NUM; i++) {
+        a[i * n + i] += CASCADE_RIDGE * trace / VAD_STAGE1_FEA_NUM;
+    }
+
+    ret = solve(a, b, n);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    memcpy(weight, b, sizeof(double) * VAD_STAGE1_FEA_NUM);
+    *bias = b[VAD_STAGE1_FEA_NUM];
+
+    return ALGO_NORMAL;
+}
+
+static int export_stage1(const char *export_dir, const double *weight, double bias)
+{
+    FILE *fp   = fopen(export_dir, "w");
+    uint32_t i = 0;
+
+    if (!fp) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    fprintf(fp, "/*\n"
+                " * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved\n"
+                " *\n"
+                " * Redistribution and use in source and binary forms, with or without\n"
+                " * modification, are permitted provided that the following conditions are met:\n"
+                " *\n"
+                " * 1. Redistributions of source code must retain the above copyright notice,\n"
+                " * this list of conditions and the following disclaimer.\n"
+                " *\n"
+                " * 2. Redistributions in binary form must reproduce the above copyright notice,\n"
+                " * this list of conditions and the following disclaimer in the documentation\n"
+                " * and/or other materials provided with the distribution.\n"
+                " *\n"
+                " * 3. Neither the name of the copyright holder nor the names of its contributors\n"
+                " * may be used to endorse or promote products derived from this software without\n"
+                " * specific prior written permission.\n"
+                " *\n"
+                " * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS \"AS IS\"\n"
+                " * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE\n"
+                " * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE\n"
+                " * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE\n"
+                " * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL\n"
+                " * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR\n"
+                " * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER\n"
+                " * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,\n"
+                " * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE\n"
+                " * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.\n"
+                " */\n\n");
+    fprintf(fp, "#ifndef __STAGE1_PARAMETERS_H__\n#define __STAGE1_PARAMETERS_H__\n\n"
+                "#include \"vad_section.h\"\n\n");
+    fprintf(fp, "// generated by ./vad_c cascade, fitted to the CNN margin\n");
+    fprintf(fp, "VAD_STAGE1_WEIGHT const double stage1_weight[] = {\n");
+    for (i = 0; i < VAD_STAGE1_FEA_NUM; i++) {
+        fprintf(fp, "%s%.17g,%s", i % 4 ? " " : "    ", weight[i],
+                i % 4 == 3 || i == VAD_STAGE1_FEA_NUM - 1 ? "\n" : "");
+    }
+    fprintf(fp, "};\nVAD_STAGE1_WEIGHT const double stage1_bias[] = {%.17g};\n\n#endif\n", bias);
+
+    return fclose(fp) ? ALGO_IO_EXCEPTION : ALGO_NORMAL;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+// sweep symmetric bands [-t, t] sending the given shares of hops to the CNN
+static int sweep_band(const CascadeData *data)
+{
+    int ret          = ALGO_NORMAL;
+    uint64_t h       = 0, f = 0, idx = 0, stage2 = 0, agree = 0, c2_all = 0, c2_run = 0,
+             max_hop = 0;
+    uint32_t r       = 0;
+    double t         = 0.0, m = 0.0;
+    double *abs_m1   = NULL;
+    const CascadeFile *file = NULL;
+    SegmentBuffer seg = {NULL, 0};
+    SegmentEmitter emitter;
+    EvalCount total, cnt;
+    EvalMetrics metrics;
+    bool voice = false;
+
+    abs_m1 = (double *)malloc(sizeof(double) * data->hop_num);
+    for (f = 0; f < data->file_num; f++) {
+        max_hop = data->files[f].hop_num > max_hop ? data->files[f].hop_num : max_hop;
+    }
+    seg.data = (uint64_t *)malloc(sizeof(uint64_t) * (max_hop + 2));
+    if (!abs_m1 || !seg.data) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    for (h = 0; h < data->hop_num; h++) {
+        abs_m1[h] = fabs(data->m1[h]);
+        c2_all += data->c2[h];
+    }
+    qsort(abs_m1, data->hop_num, sizeof(double), cmp_double);
+
+    printf("\n%10s %9s %8s %9s %8s %8s %8s %8s\n", "band", "cnn(%)", "cpu(%)", "agree(%)", "f1",
+           "acc", "recall", "prec");
+    for (r = 0; r < sizeof(g_stage2_ratio) / sizeof(g_stage2_ratio[0]); r++) {
+        // the band holding the wanted share of the smallest stage 1 margins
+        idx = (uint64_t)(g_stage2_ratio[r] * data->hop_num);
+        t   = idx == 0 ? -1.0 : idx >= data->hop_num ? INFINITY : abs_m1[idx - 1];
+
+        memset(&total, 0, sizeof(EvalCount));
+        stage2 = agree = c2_run = 0;
+
+        for (f = 0; f < data->file_num; f++) {
+            file     = &data->files[f];
+            seg.size = 0;
+            segment_emitter_init(&emitter, segment_store, &seg);
+
+            for (h = file->hop_start; h < file->hop_start + file->hop_num; h++) {
+                m = data->m1[h];
+                if (fabs(m) <= t) {
+                    m = data->m2[h];
+                    stage2++;
+                    c2_run += data->c2[h];
+                }
+                voice = m > 0;
+                agree += voice == (data->m2[h] > 0);
+                segment_emitter_push(&emitter, (int8_t)voice, (h - file->hop_start) * FRAME_STEP);
+            }
+            segment_emitter_finish(&emitter, file->frames);
+
+            ret = eval_count(file->frames, file->label, file->label_size, seg.data, seg.size,
+                             &cnt);
+            if (ret != ALGO_NORMAL) {
+                goto exit;
+            }
+            eval_merge(&total, &cnt);
+        }
+
+        eval_metrics(&total, &metrics);
+        if (isinf(t)) {
+            printf("%10s ", "all");
+        } else if (t < 0) {
+            printf("%10s ", "none");
+        } else {
+            printf("%10.4f ", t);
+        }
+        printf("%9.2f %8.2f %9.2f %8.4f %8.4f %8.4f %8.4f\n", 100.0 * stage2 / data->hop_num,
+               c2_all ? 100.0 * (data->c1 + c2_run) / c2_all : 0.0, 100.0 * agree / data->hop_num,
+               metrics.f1_score, metrics.accuracy, metrics.recall, metrics.precision);
+    }
+
+exit:
+    free(abs_m1);
+    free(seg.data);
+
+    return ret;
+}
+
+int run_cascade_eval(const char *wav_dir, const char *label_dir, const char *export_dir)
+{
+    int ret              = ALGO_NORMAL;
+    uint64_t h           = 0, f = 0, sign = 0;
+    double weight[VAD_STAGE1_FEA_NUM], bias[1] = {0.0};
+    double err = 0.0, power = 0.0;
+    size_t len           = 0;
+    DIR *dir             = NULL;
+    struct dirent *entry = NULL;
+    CascadeData *data    = NULL;
+    VadStage1Model model = {.weight = weight, .bias = bias};
+    VadContext ctx;
+
+    data = (CascadeData *)calloc(1, sizeof(CascadeData));
+    if (!data) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    dir = opendir(wav_dir);
+    if (!dir) {
+        free(data);
+        return ALGO_IO_EXCEPTION;
+    }
+    while ((entry = readdir(dir)) != NULL && data->file_num < CASCADE_MAX_FILE) {
+        len = strlen(entry->d_name);
+        if (len <= 4 || len - 4 >= sizeof(data->files[0].name) ||
+            strcmp(entry->d_name + len - 4, ".wav")) {
+            continue;
+        }
+        memcpy(data->files[data->file_num++].name, entry->d_name, len - 4);
+    }
+    closedir(dir);
+    qsort(data->files, data->file_num, sizeof(CascadeFile), cmp_name);
+
+    vad_init(&ctx);
+    for (f = 0; f < data->file_num; f++) {
+        ret = collect_file(data, &data->files[f], wav_dir, label_dir, &ctx);
+        if (ret != ALGO_NORMAL) {
+            printf("%s: error %d\n", data->files[f].name, ret);
+            goto exit;
+        }
+    }
+    if (data->hop_num == 0) {
+        printf("no hop in %s\n", wav_dir);
+        ret = ALGO_DATA_NULL;
+        goto exit;
+    }
+
+    if (export_dir) {
+        ret = fit_stage1(data, weight, bias);
+        if (ret == ALGO_NORMAL) {
+            ret = export_stage1(export_dir, weight, bias[0]);
+        }
+        if (ret != ALGO_NORMAL) {
+            printf("fit/export of %s fail, ret = %d\n", export_dir, ret);
+            goto exit;
+        }
+        printf("stage 1 weights written to %s\n", export_dir);
+
+        for (h = 0; h < data->hop_num; h++) {
+            data->m1[h] = vad_stage1_margin(&model, data->fea + h * VAD_STAGE1_FEA_NUM);
+        }
+    }
+
+    for (h = 0; h < data->hop_num; h++) {
+        err += (data->m1[h] - data->m2[h]) * (data->m1[h] - data->m2[h]);
+        power += data->m2[h] * data->m2[h];
+        sign += (data->m1[h] > 0) == (data->m2[h] > 0);
+    }
+
+    printf("files: %" PRIu64 ", hops: %" PRIu64 ", stage 1 features: %d, MACs stage 1 / CNN: %d / %d\n",
+           data->file_num, data->hop_num, VAD_STAGE1_FEA_NUM, VAD_STAGE1_FEA_NUM * 3,
+           VAD_CONV_OUT_LEN * VAD_FILTER_NUM * 3 + VAD_CONV_OUT_LEN * VAD_FILTER_NUM * 2);
+    printf("stage 1 vs CNN margin: relative error %.4f, same sign on %.2f %% of hops\n",
+           power > 0 ? sqrt(err / power) : 0.0, 100.0 * sign / data->hop_num);
+
+    ret = sweep_band(data);
+
+exit:
+    for (f = 0; f < data->file_num; f++) {
+        free(data->files[f].label);
+    }
+    free(data->fea);
+    free(data->m1);
+    free(data->m2);
+    free(data->c2);
+    free(data);
+
+    return ret;
+}
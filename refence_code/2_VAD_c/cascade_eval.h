@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CASCADE_EVAL_H__
+#define __CASCADE_EVAL_H__
+
+#include "algo_error_code.h"
+
+#define CASCADE_RIDGE (1e-6) // ridge regularization of the stage 1 fit, relative to the feature power
+
+/**
+ * @brief evaluate the two stage cascade on every wav file of a directory.
+ * The stage 1 margin and the CNN margin are computed once per hop, then the
+ * uncertainty band is swept and the share of hops running the CNN, the CPU
+ * cost and the metrics against the labels are printed for every band.
+ * With export_dir the stage 1 weights are first fitted to the CNN margin by
+ * least squares, written as a stage1_parameters.h header and used for the
+ * sweep instead of the built-in ones.
+ *
+ * @param[in] wav_dir: directory of the wav files
+ * @param[in] label_dir: directory of the label files
+ * @param[in] export_dir: stage 1 header to be written, NULL to keep the built-in model
+ * @return error code
+ */
+int run_cascade_eval(const char *wav_dir, const char *label_dir, const char *export_dir);
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "chunk.h"
+#include "vad.h"
+#include "runner.h"
+#include "segment.h"
+
+#define CHUNK_REPEAT (3) // runs per thread number, the fastest one is reported
+
+typedef struct _ChunkJob {
+    const WavFile *wav;
+    uint64_t frame_start; // first frame owned by the chunk
+    uint64_t frame_end;   // one past the last frame owned by the chunk
+    uint64_t *edge_idx;   // start index of the frames where the prediction flips
+    int8_t *edge_diff;    // 1: unvoice -> voice, -1: voice -> unvoice
+    uint64_t edge_num;
+    int ret;
+} ChunkJob;
+
+static void *chunk_worker(void *param)
+{
+    ChunkJob *job  = (ChunkJob *)param;
+    uint64_t begin = job->frame_start ? job->frame_start - 1 : 0;
+    uint64_t i     = 0;
+    int8_t pred = 0, last_pred = 0;
+    bool vad_out = false;
+    double frame[FRAME_LEN];
+    VadContext ctx;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    vad_init(&ctx);
+    job->edge_num = 0;
+
+    // frame "begin" is the overlap with the previous chunk, only its prediction is kept
+    for (i = begin; i < job->frame_end; i++) {
+        load_frame(job->wav, i * FRAME_STEP, i == begin, frame);
+
+        job->ret = vad_process(&ctx, &vad_inp, &vad_out);
+        if (job->ret != ALGO_NORMAL) {
+            break;
+        }
+
+        pred = (int8_t)vad_out;
+        if (i > begin && pred != last_pred) {
+            job->edge_idx[job->edge_num]  = i * FRAME_STEP;
+            job->edge_diff[job->edge_num] = pred - last_pred;
+            job->edge_num++;
+        }
+        last_pred = pred;
+    }
+
+    return NULL;
+}
+
+/**
+ * replay the transitions of all chunks in order, with the same rules as
+ * cal_voice_segment()
+ */
+static void stitch_chunk(const ChunkJob *jobs, int job_num, uint64_t raw_data_size,
+                         uint64_t *voice_segment, uint64_t *voice_segment_size)
+{
+    uint64_t i = 0, voice_segment_cnt = 0;
+    bool is_start = true;
+    int j         = 0;
+
+    for (j = 0; j < job_num; j++) {
+        for (i = 0; i < jobs[j].edge_num; i++) {
+            if (jobs[j].edge_diff[i] == 1) {
+                voice_segment[voice_segment_cnt++] = jobs[j].edge_idx[i];
+                is_start                           = false;
+            } else {
+                if (is_start) {
+                    voice_segment[voice_segment_cnt++] = 0;
+                }
+                voice_segment[voice_segment_cnt++] = jobs[j].edge_idx[i];
+                is_start                           = true;
+            }
+        }
+    }
+
+    if (!is_start) {
+        voice_segment[voice_segment_cnt++] = raw_data_size - 1;
+    }
+
+    *voice_segment_size = voice_segment_cnt;
+}
+
+int detect_voice_segment_chunked(const WavFile *wav, int thread_num, uint64_t **voice_segment,
+                                 uint64_t *voice_segment_size)
+{
+    int ret = ALGO_NORMAL, i = 0;
+    uint64_t frame_num = cal_frame_num(wav->frames), per_chunk = 0;
+    uint64_t *all_voice_segment = NULL;
+    ChunkJob *jobs              = NULL;
+    pthread_t *threads          = NULL;
+    bool *started               = NULL;
+
+    *voice_segment      = NULL;
+    *voice_segment_size = 0;
+
+    if (thread_num < 1) {
+        thread_num = 1;
+    }
+    if ((uint64_t)thread_num > frame_num) {
+        thread_num = frame_num ? (int)frame_num : 1;
+    }
+
+    jobs              = (ChunkJob *)calloc(thread_num, sizeof(ChunkJob));
+    threads           = (pthread_t *)calloc(thread_num, sizeof(pthread_t));
+    started           = (bool *)calloc(thread_num, sizeof(bool));
+    all_voice_segment = (uint64_t *)malloc(sizeof(uint64_t) * (frame_num + 2));
+    if (!jobs || !threads || !started || !all_voice_segment) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    per_chunk = (frame_num + thread_num - 1) / thread_num;
+    for (i = 0; i < thread_num; i++) {
+        jobs[i].wav         = wav;
+        jobs[i].frame_start = per_chunk * i < frame_num ? per_chunk * i : frame_num;
+        jobs[i].frame_end   = per_chunk * (i + 1) < frame_num ? per_chunk * (i + 1) : frame_num;
+        jobs[i].edge_idx    = (uint64_t *)malloc(sizeof(uint64_t) * (per_chunk + 1));
+        jobs[i].edge_diff   = (int8_t *)malloc(sizeof(int8_t) * (per_chunk + 1));
+        if (!jobs[i].edge_idx || !jobs[i].edge_diff) {
+            ret = ALGO_MALLOC_FAIL;
+            goto exit;
+        }
+    }
+
+    // chunk 0 runs on the calling thread
+    for (i = 1; i < thread_num; i++) {
+        started[i] = !pthread_create(&threads[i], NULL, chunk_worker, &jobs[i]);
+    }
+    chunk_worker(&jobs[0]);
+    for (i = 1; i < thread_num; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            chunk_worker(&jobs[i]);
+        }
+    }
+
+    for (i = 0; i < thread_num; i++) {
+        if (jobs[i].ret != ALGO_NORMAL) {
+            ret = jobs[i].ret;
+            goto exit;
+        }
+    }
+
+    stitch_chunk(jobs, thread_num, wav->frames, all_voice_segment, voice_segment_size);
+    *voice_segment    = all_voice_segment;
+    all_voice_segment = NULL;
+
+exit:
+    if (jobs) {
+        for (i = 0; i < thread_num; i++) {
+            free(jobs[i].edge_idx);
+            free(jobs[i].edge_diff);
+        }
+    }
+    free(jobs);
+    free(threads);
+    free(started);
+    free(all_voice_segment);
+
+    return ret;
+}
+
+int run_chunk_scaling(const char *wav_file, const char *pred_file, int max_thread)
+{
+    int ret = ALGO_NORMAL, i = 0, j = 0;
+    uint64_t *ref = NULL, *seg = NULL;
+    uint64_t ref_size = 0, seg_size = 0;
+    double start = 0.0, cost = 0.0, best = 0.0, base = 0.0;
+    bool same = true;
+    VadContext ctx;
+    WavFile wav;
+
+    ret = wav_open(wav_file, &wav);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    if (max_thread <= 0) {
+        max_thread = get_core_num();
+    }
+
+    // serial reference
+    vad_init(&ctx);
+    for (j = 0; j < CHUNK_REPEAT; j++) {
+        free(ref);
+        start = get_time_sec();
+        ret   = detect_voice_segment(&ctx, &wav, NULL, &ref, &ref_size);
+        cost  = get_time_sec() - start;
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+        base = (j == 0 || cost < base) ? cost : base;
+    }
+
+    printf("samples: %" PRIu64 ", frames: %" PRIu64 ", segments: %" PRIu64 "\n", wav.frames,
+           cal_frame_num(wav.frames), ref_size / 2);
+    printf("%8s %10s %8s %10s\n", "threads", "time(ms)", "speedup", "identical");
+    printf("%8s %10.2f %8.2f %10s\n", "serial", base * 1e3, 1.0, "-");
+
+    for (i = 1; i <= max_thread; i++) {
+        for (j = 0; j < CHUNK_REPEAT; j++) {
+            free(seg);
+            start = get_time_sec();
+            ret   = detect_voice_segment_chunked(&wav, i, &seg, &seg_size);
+            cost  = get_time_sec() - start;
+            if (ret != ALGO_NORMAL) {
+                goto exit;
+            }
+            best = (j == 0 || cost < best) ? cost : best;
+        }
+
+        same = seg_size == ref_size && !memcmp(seg, ref, sizeof(uint64_t) * ref_size);
+        printf("%8d %10.2f %8.2f %10s\n", i, best * 1e3, best > 0 ? base / best : 0.0,
+               same ? "yes" : "NO");
+        if (!same) {
+            ret = ALGO_DATA_EXCEPTION;
+        }
+    }
+
+    if (pred_file && seg) {
+        if (save_voice_segment(pred_file, seg, seg_size) != ALGO_NORMAL) {
+            ret = ALGO_IO_EXCEPTION;
+        }
+    }
+
+exit:
+    free(ref);
+    free(seg);
+    wav_close(&wav);
+
+    return ret;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CHUNK_H__
+#define __CHUNK_H__
+
+#include <stdint.h>
+
+#include "wav.h"
+#include "algo_error_code.h"
+
+/**
+ * @brief run the VAD over one wav file with the frames split into thread_num
+ * hop aligned chunks processed concurrently. Every chunk also evaluates the
+ * last frame of the previous chunk, so the per-chunk transitions can be
+ * stitched into the same segments as a serial cal_voice_segment() run.
+ *
+ * @param[in] wav: opened wav file
+ * @param[in] thread_num: number of chunks and worker threads
+ * @param[out] voice_segment: allocated array, 2n: start index, 2n+1: end index.
+ *             Must be released with free()
+ * @param[out] voice_segment_size: number of indices in voice_segment
+ * @return error code
+ */
+int detect_voice_segment_chunked(const WavFile *wav, int thread_num, uint64_t **voice_segment,
+                                 uint64_t *voice_segment_size);
+
+/**
+ * @brief process one wav file with 1..max_thread threads, check the result
+ * against the serial run, print the scaling and save the prediction
+ *
+ * @param[in] wav_file: wav file
+ * @param[in] pred_file: prediction file
+ * @param[in] max_thread: maximum number of threads, <= 0: all online cores
+ * @return error code
+ */
+int run_chunk_scaling(const char *wav_file, const char *pred_file, int max_thread);
+
+#endif
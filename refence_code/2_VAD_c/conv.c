@@ -1,8 +1,6 @@
 // 包含头文件
 #include "conv.h"
-
-// 定义批量归一化中的小常数
-#define BN_EPS (1e-5)
+#include "vad_section.h"
 
 // 定义一个静态函数，用于在输入数据周围填充值
 static void padding_value(const Conv2dData *raw_data, uint16_t pad_len, double pad_value,
@@ -38,10 +36,148 @@ uint16_t cal_conv_out_len(uint16_t raw_len, uint16_t pad_len, uint16_t filter_le
     return (raw_len + 2 * pad_len - filter_len) / stride + 1;
 }
 
+// 输出位置中卷积窗口完全落在输入内部的区间[lo, hi)
+VAD_RAM_TEXT static void interior_range(uint16_t len, uint16_t pad, uint16_t kernel, uint16_t stride,
+                                        uint16_t out_len, uint16_t *lo, uint16_t *hi) {
+    int32_t last = (int32_t)len + pad - kernel;
+
+    *lo = (uint16_t)((pad + stride - 1) / stride);
+    *hi = last < 0 ? 0 : (uint16_t)(last / stride + 1);
+    *lo = *lo < out_len ? *lo : out_len;
+    *hi = *hi < out_len ? *hi : out_len;
+    *hi = *hi > *lo ? *hi : *lo;
+}
+
+// 计算窗口完全在输入内部的一个输出位置，权重按顺序连续读取
+VAD_RAM_TEXT static inline double conv_interior(const Conv2dData *input_feat, const double *weight,
+                                                const Conv2dFilter *filter, const double *x) {
+    uint16_t ch = 0, kr = 0, kc = 0;
+    uint32_t plane = (uint32_t)input_feat->row * input_feat->col;
+    const double *xr = NULL;
+    double tmp = 0.0;
+
+    for (ch = 0; ch < filter->channel; ch++, x += plane) {
+        for (kr = 0, xr = x; kr < filter->row; kr++, xr += input_feat->col) {
+            for (kc = 0; kc < filter->col; kc++) {
+                tmp += *weight++ * xr[kc];
+            }
+        }
+    }
+
+    return tmp;
+}
+
+// 计算边缘的一个输出位置，窗口已裁剪到输入内部，内层循环不做边界判断
+VAD_RAM_TEXT static inline double conv_window(const Conv2dData *input_feat, const double *weight,
+                                       const Conv2dFilter *filter, int32_t row_start, int32_t col_start,
+                                       uint16_t kr0, uint16_t kr1, uint16_t kc0, uint16_t kc1) {
+    uint16_t ch = 0, kr = 0, kc = 0;
+    const double *w = NULL, *x = NULL;
+    double tmp = 0.0;
+
+    for (ch = 0; ch < filter->channel; ch++) {
+        for (kr = kr0; kr < kr1; kr++) {
+            w = weight + ((uint32_t)ch * filter->row + kr) * filter->col;
+            x = input_feat->data +
+                ((uint32_t)ch * input_feat->row + row_start + kr) * input_feat->col + col_start;
+            for (kc = kc0; kc < kc1; kc++) {
+                tmp += w[kc] * x[kc];
+            }
+        }
+    }
+
+    return tmp;
+}
+
 // 实现卷积层和批量归一化操作，不包括偏置
-int conv2d_bn_no_bias(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *output_feat) {
+// 不拷贝补零后的输入：输出分为卷积窗口完全在输入内部的区域（不做边界判断）和边缘区域
+// （窗口裁剪到输入内部，补零的部分不参与计算），不需要额外的内存；
+// 单行输入视为一维信号，只在列方向补零
+VAD_RAM_TEXT int conv2d_bn_no_bias(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *output_feat) {
+    uint16_t i = 0, j = 0, k = 0;
+    uint16_t out_row = 0, out_col = 0, out_chan = 0, pad_row = 0;
+    uint16_t row_lo = 0, row_hi = 0, col_lo = 0, col_hi = 0;
+    uint16_t kr0 = 0, kr1 = 0, kc0 = 0, kc1 = 0, lo = 0, hi = 0;
+    int32_t row_start = 0, col_start = 0;
+    uint32_t patch = 0;
+    const double *weight = NULL, *x = NULL;
+    BatchNorm2d *bn = NULL;
+    Conv2dFilter *filter = NULL;
+    double tmp = 0.0, bn_scale = 0.0;
+    double *out = NULL;
+
+    // 检查输入参数是否为空，如果为空则返回错误代码
+    if (!input_feat || !input_feat->data || !param || !param->bn || !param->bn->mean ||
+        !param->bn->var || !param->bn->gamma || !param->bn->beta || !param->filter ||
+        !param->filter->data || !output_feat || !output_feat->data) {
+        return ALGO_POINTER_NULL;
+    }
+
+    bn = param->bn;
+    filter = param->filter;
+    pad_row = input_feat->row == 1 ? 0 : param->pad;
+
+    // 检查输入参数是否合法，如果不合法则返回错误代码
+    if (param->stride < 1 || input_feat->channel != filter->channel ||
+        filter->filter_num != bn->size || filter->row > 2 * pad_row + input_feat->row ||
+        filter->col > 2 * param->pad + input_feat->col) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    out_row = cal_conv_out_len(input_feat->row, pad_row, filter->row, param->stride);
+    out_col = cal_conv_out_len(input_feat->col, param->pad, filter->col, param->stride);
+    out_chan = filter->filter_num;
+    patch = (uint32_t)filter->channel * filter->row * filter->col;
+
+    interior_range(input_feat->row, pad_row, filter->row, param->stride, out_row, &row_lo, &row_hi);
+    interior_range(input_feat->col, param->pad, filter->col, param->stride, out_col, &col_lo,
+                   &col_hi);
+
+    // 每行分为左边缘、内部、右边缘三段，内部不裁剪窗口；不在内部的行整行按边缘处理
+    for (i = 0; i < out_chan; i++) {
+        weight = filter->data + i * patch;
+        bn_scale = sqrt(bn->var[i] + BN_EPS);
+        out = output_feat->data + (uint32_t)i * out_row * out_col;
+        for (j = 0; j < out_row; j++, out += out_col) {
+            row_start = (int32_t)j * param->stride - pad_row;
+            conv_clip_window(row_start, filter->row, input_feat->row, &kr0, &kr1);
+            lo = j >= row_lo && j < row_hi ? col_lo : out_col;
+            hi = j >= row_lo && j < row_hi ? col_hi : out_col;
+            for (k = 0; k < out_col; k++) {
+                if (k == lo) {
+                    x = input_feat->data + row_start * input_feat->col;
+                    for (; k < hi; k++) {
+                        tmp = conv_interior(input_feat, weight, filter,
+                                            x + (int32_t)k * param->stride - param->pad);
+                        out[k] = bn->gamma[i] * (tmp - bn->mean[i]) / bn_scale + bn->beta[i];
+                    }
+                    if (k == out_col) {
+                        break;
+                    }
+                }
+                col_start = (int32_t)k * param->stride - param->pad;
+                conv_clip_window(col_start, filter->col, input_feat->col, &kc0, &kc1);
+                tmp = conv_window(input_feat, weight, filter, row_start, col_start, kr0, kr1, kc0,
+                                  kc1);
+
+                // 执行批量归一化操作，与补零实现的表达式相同，结果逐位一致
+                out[k] = bn->gamma[i] * (tmp - bn->mean[i]) / bn_scale + bn->beta[i];
+            }
+        }
+    }
+
+    // 设置输出特征图的大小
+    output_feat->row = out_row;
+    output_feat->col = out_col;
+    output_feat->channel = out_chan;
+
+    return ALGO_NORMAL;
+}
+
+// 先拷贝出补零后的输入再卷积的实现，保留用于对比
+int conv2d_bn_no_bias_padded(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *output_feat) {
     // 一些局部变量的定义和初始化
-    uint16_t i = 0, j = 0, k = 0, ii = 0, jj = 0, kk = 0, group_cnt = 0;
+    uint16_t i = 0, j = 0, k = 0, ii = 0, jj = 0, kk = 0;
     uint16_t out_row = 0, out_col = 0, out_chan = 0;
     uint16_t paded_row = 0, paded_col = 0, paded_feat_size = 0;
     uint16_t row_start = 0, col_start = 0, filter_idx = 0, feat_idx = 0, output_feat_idx = 0;
@@ -136,7 +272,7 @@ int conv2d_bn_no_bias(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *o
     return ALGO_NORMAL;
 }
 
-int leaky_relu(double neg_slope, double *inp, uint16_t inp_size, double *out)
+VAD_RAM_TEXT int leaky_relu(double neg_slope, double *inp, uint16_t inp_size, double *out)
 {
     uint16_t i = 0;
 
@@ -155,7 +291,7 @@ int leaky_relu(double neg_slope, double *inp, uint16_t inp_size, double *out)
     return ALGO_NORMAL;
 }
 
-int linear_layer(double *inp, LinearParam *linear_config, double *out)
+VAD_RAM_TEXT int linear_layer(double *inp, LinearParam *linear_config, double *out)
 {
     uint16_t i, j;
 
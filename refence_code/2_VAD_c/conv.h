@@ -10,6 +10,9 @@
 
 #include "algo_error_code.h" // 包含算法错误代码的头文件
 
+// 定义批量归一化中的小常数
+#define BN_EPS (1e-5)
+
 // 定义卷积层输入和输出数据的结构体
 typedef struct _Conv2dData {
     uint16_t row; // 行数
@@ -55,6 +58,9 @@ typedef struct _LinearConfig {
 // 定义卷积层函数，包括卷积操作和批量归一化，不包括偏置
 int conv2d_bn_no_bias(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *output_feat);
 
+// 先分配并拷贝补零后的输入再卷积的实现，仅用于与conv2d_bn_no_bias对比耗时和内存
+int conv2d_bn_no_bias_padded(Conv2dData *input_feat, Conv2dConfig *param, Conv2dData *output_feat);
+
 // 定义Leaky ReLU激活函数
 int leaky_relu(double neg_slope, double *inp, uint16_t inp_size, double *out);
 
@@ -64,6 +70,20 @@ int linear_layer(double *inp, LinearParam *linear_config, double *out);
 // 计算卷积层输出特征图的不同维度的长度
 uint16_t cal_conv_out_len(uint16_t raw_len, uint16_t pad_len, uint16_t filter_len, uint16_t stride);
 
+// 窗口起点为start时，落在[0, len)内的卷积核下标区间[first, last)，conv.c与conv_gemm.c共用；
+// 按有符号数计算并限制在[0, kernel]内，窗口完全落在补零区域（pad >= kernel时可能出现）时区间为空
+static inline void conv_clip_window(int32_t start, uint16_t kernel, uint16_t len, uint16_t *first,
+                                    uint16_t *last) {
+    int32_t lo = start < 0 ? -start : 0;
+    int32_t hi = (int32_t)len - start;
+
+    lo = lo < kernel ? lo : kernel;
+    hi = hi < kernel ? hi : kernel;
+    hi = hi > lo ? hi : lo;
+    *first = (uint16_t)lo;
+    *last = (uint16_t)hi;
+}
+
 // 结束宏定义
 #endif
 
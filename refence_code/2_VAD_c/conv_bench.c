@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "conv_bench.h"
+#include "conv_gemm.h"
+#include "runner.h"
+
+#define BENCH_TILE      (32)          // tile of the forced tiled column
+#define BENCH_MAC       (1000000)     // MACs timed per trial
+#define BENCH_TRIAL     (7)           // trials per backend and shape, the fastest is kept
+#define BENCH_SCRATCH   (1 << 20)     // enough for every forced algorithm
+#define BENCH_TOL       (1e-9)        // largest error of the double conv2d paths
+#define BENCH_TOL_F32   (1e-5)        // largest error of the float backends
+#define BENCH_TOL_Q15   (1e-2)        // largest error of the Q15 backend
+
+typedef struct _BenchShape {
+    uint16_t channel;
+    uint16_t row;
+    uint16_t col;
+    uint16_t filter_num;
+    uint16_t kernel_row;
+    uint16_t kernel_col;
+    uint16_t stride;
+    uint16_t pad;
+} BenchShape;
+
+static const BenchShape g_bench_shape[] = {
+    {1, 1, 240, 2, 1, 2, 2, 0}, // the VAD layer
+    {1, 1, 240, 8, 1, 3, 1, 1},    {1, 1, 240, 16, 1, 5, 2, 2},  {1, 1, 240, 16, 1, 9, 1, 4},
+    {4, 1, 120, 8, 1, 3, 1, 1},    {8, 1, 120, 16, 1, 3, 2, 1},  {16, 1, 60, 32, 1, 3, 1, 1},
+    {16, 1, 60, 32, 1, 5, 2, 2},   {1, 16, 16, 8, 3, 3, 1, 1},   {8, 16, 16, 16, 3, 3, 1, 1},
+    {8, 16, 16, 16, 3, 3, 2, 1},   {16, 8, 8, 32, 3, 3, 1, 1},
+    // pad >= kernel, the first and last windows lie wholly in the padding
+    {1, 1, 4, 2, 1, 2, 1, 3},      {2, 4, 4, 4, 2, 2, 1, 3},     {2, 5, 6, 4, 2, 3, 2, 3},
+    {4, 3, 3, 4, 1, 1, 1, 2},
+};
+
+static const char *const g_algo_name[] = {"auto", "direct", "im2col", "tiled"};
+
+static uint32_t g_seed = 1;
+
+// uniform in [-1, 1)
+static double bench_rand(void)
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+
+    return (double)(g_seed >> 8) / (1 << 23) - 1.0;
+}
+
+// double reference, zero padding like conv_gemm, rows padded only for 2-D inputs
+static void conv_ref(const ConvGemmShape *s, const double *w, const double *b, const double *inp,
+                     double *out)
+{
+    uint16_t f = 0, r = 0, c = 0, ch = 0, kr = 0, kc = 0;
+    uint16_t pr = s->row > 1 ? s->pad : 0;
+    int32_t ir = 0, ic = 0;
+    double acc = 0.0;
+
+    for (f = 0; f < s->filter_num; f++) {
+        for (r = 0; r < s->out_row; r++) {
+            for (c = 0; c < s->out_col; c++) {
+                acc = b[f];
+                for (ch = 0; ch < s->channel; ch++) {
+                    for (kr = 0; kr < s->kernel_row; kr++) {
+                        for (kc = 0; kc < s->kernel_col; kc++) {
+                            ir = (int32_t)r * s->stride + kr - pr;
+                            ic = (int32_t)c * s->stride + kc - s->pad;
+                            if (ir >= 0 && ir < s->row && ic >= 0 && ic < s->col) {
+                                acc += w[((f * s->channel + ch) * s->kernel_row + kr) *
+                                             s->kernel_col + kc] *
+                                       inp[(ch * s->row + ir) * s->col + ic];
+                            }
+                        }
+                    }
+                }
+                *out++ = acc;
+            }
+        }
+    }
+}
+
+// largest error relative to the largest reference output
+static double max_rel_err(const double *ref, const float *out, uint32_t size)
+{
+    uint32_t i = 0;
+    double err = 0.0, peak = 0.0;
+
+    for (i = 0; i < size; i++) {
+        err  = fabs(ref[i] - out[i]) > err ? fabs(ref[i] - out[i]) : err;
+        peak = fabs(ref[i]) > peak ? fabs(ref[i]) : peak;
+    }
+
+    return peak > 0.0 ? err / peak : err;
+}
+
+// largest difference of the two conv2d paths, in units of the largest output
+static double max_rel_diff(const double *ref, const double *out, uint32_t size)
+{
+    uint32_t i = 0;
+    double err = 0.0, peak = 0.0;
+
+    for (i = 0; i < size; i++) {
+        err  = fabs(ref[i] - out[i]) > err ? fabs(ref[i] - out[i]) : err;
+        peak = fabs(ref[i]) > peak ? fabs(ref[i]) : peak;
+    }
+
+    return peak > 0.0 ? err / peak : err;
+}
+
+typedef struct _BenchData {
+    ConvGemmF32 f32;
+    ConvGemmQ15 q15;
+    const int16_t *inp_q15;
+    float inp_scale;
+    const float *inp;
+    float *out;
+    void *scratch;
+    Conv2dData conv_inp;
+    Conv2dData conv_out;
+    Conv2dConfig conv;
+} BenchData;
+
+// cycles per MAC of one backend, -1 for conv2d_bn_no_bias, -2 for its padded copy variant
+static double time_backend(BenchData *d, int backend, ConvGemmAlgo algo, size_t scratch_size,
+                           uint32_t rep)
+{
+    uint32_t i = 0, t = 0;
+    uint64_t start = 0, best = UINT64_MAX;
+    const ConvGemmShape *s = &d->f32.shape;
+    double mac = (double)s->filter_num * s->out_row * s->out_col * s->channel * s->kernel_row *
+                 s->kernel_col;
+
+    // the fastest of a few trials, the others include preemption
+    for (t = 0; t < BENCH_TRIAL; t++) {
+        start = get_cycle();
+        for (i = 0; i < rep; i++) {
+            if (backend == -2) {
+                conv2d_bn_no_bias_padded(&d->conv_inp, &d->conv, &d->conv_out);
+            } else if (backend < 0) {
+                conv2d_bn_no_bias(&d->conv_inp, &d->conv, &d->conv_out);
+            } else if (backend == 0) {
+                conv_gemm_f32(&d->f32, algo, d->inp, d->out, d->scratch, scratch_size);
+            } else {
+                conv_gemm_q15(&d->q15, algo, d->inp_q15, d->inp_scale, d->out, d->scratch,
+                              scratch_size);
+            }
+        }
+        best = get_cycle() - start < best ? get_cycle() - start : best;
+    }
+
+    return (double)best / (rep * mac);
+}
+
+static int bench_shape(const BenchShape *b, size_t scratch_size, bool border)
+{
+    int ret = ALGO_NORMAL;
+    ConvGemmShape s = {b->channel, b->row, b->col, b->filter_num, b->kernel_row, b->kernel_col,
+                       b->stride, b->pad, 0, 0};
+    uint32_t k = 0, n = 0, inp_size = 0, i = 0, rep = 0, tile = 0, tiled_tile = 0;
+    double *w = NULL, *bias = NULL, *mean = NULL, *var = NULL, *gamma = NULL, *beta = NULL;
+    double *inp = NULL, *ref = NULL, *fold_bias = NULL, *conv_out = NULL;
+    double scale = 0.0, err_f32 = 0.0, err_q15 = 0.0, naive = 0.0, cost[4] = {0};
+    double padded = 0.0, err_padded = 0.0;
+    float *w_f32 = NULL, *b_f32 = NULL, *inp_f32 = NULL, *out = NULL;
+    int16_t *w_q15 = NULL, *inp_q15 = NULL;
+    void *scratch = NULL;
+    ConvGemmAlgo algo = CONV_ALGO_AUTO;
+    Conv2dFilter filter;
+    BatchNorm2d bn;
+    BenchData d;
+
+    ret = conv_gemm_shape(&s);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    k        = (uint32_t)s.channel * s.kernel_row * s.kernel_col;
+    n        = (uint32_t)s.out_row * s.out_col;
+    inp_size = (uint32_t)s.channel * s.row * s.col;
+
+    w         = (double *)malloc(sizeof(double) * s.filter_num * k);
+    bias      = (double *)malloc(sizeof(double) * s.filter_num * 6);
+    inp       = (double *)malloc(sizeof(double) * inp_size);
+    ref       = (double *)malloc(sizeof(double) * s.filter_num * n);
+    conv_out  = (double *)malloc(sizeof(double) * s.filter_num * n * 4);
+    w_f32     = (float *)malloc(sizeof(float) * s.filter_num * (k + 1));
+    inp_f32   = (float *)malloc(sizeof(float) * inp_size);
+    out       = (float *)malloc(sizeof(float) * s.filter_num * n);
+    w_q15     = (int16_t *)malloc(sizeof(int16_t) * s.filter_num * k);
+    inp_q15   = (int16_t *)malloc(sizeof(int16_t) * inp_size);
+    scratch   = malloc(BENCH_SCRATCH);
+    if (!w || !bias || !inp || !ref || !conv_out || !w_f32 || !inp_f32 || !out || !w_q15 ||
+        !inp_q15 || !scratch) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    mean      = bias + s.filter_num;
+    var       = mean + s.filter_num;
+    gamma     = var + s.filter_num;
+    beta      = gamma + s.filter_num;
+    fold_bias = beta + s.filter_num;
+    b_f32     = w_f32 + s.filter_num * k;
+
+    for (i = 0; i < s.filter_num * k; i++) {
+        w[i] = bench_rand() / sqrt(k);
+    }
+    for (i = 0; i < s.filter_num; i++) {
+        mean[i]  = 0.1 * bench_rand();
+        var[i]   = 0.5 + 0.25 * bench_rand();
+        gamma[i] = 1.0 + 0.5 * bench_rand();
+        beta[i]  = 0.1 * bench_rand();
+    }
+    for (i = 0; i < inp_size; i++) {
+        inp[i]     = bench_rand();
+        inp_f32[i] = (float)inp[i];
+    }
+
+    filter = (Conv2dFilter){.row = s.kernel_row, .col = s.kernel_col, .channel = s.channel,
+                            .filter_num = s.filter_num, .data = w};
+    bn     = (BatchNorm2d){.size = s.filter_num, .mean = mean, .var = var, .gamma = gamma,
+                           .beta = beta};
+    memset(&d, 0, sizeof(BenchData));
+    d.conv = (Conv2dConfig){.stride = s.stride, .pad = s.pad, .filter = &filter, .bn = &bn};
+    ret    = conv_gemm_fold_bn(&d.conv, w_f32, b_f32);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    // both conv2d paths with the unscaled weights, the second output follows the first
+    d.conv_inp = (Conv2dData){.row = s.row, .col = s.col, .channel = s.channel, .data = inp};
+    d.conv_out = (Conv2dData){.data = conv_out};
+    ret        = conv2d_bn_no_bias(&d.conv_inp, &d.conv, &d.conv_out);
+    if (ret == ALGO_NORMAL) {
+        d.conv_out.data = conv_out + s.filter_num * n;
+        ret             = conv2d_bn_no_bias_padded(&d.conv_inp, &d.conv, &d.conv_out);
+    }
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    // the double reference of the folded layer
+    for (i = 0; i < s.filter_num; i++) {
+        scale        = gamma[i] / sqrt(var[i] + BN_EPS);
+        fold_bias[i] = beta[i] - mean[i] * scale;
+    }
+    for (i = 0; i < s.filter_num * k; i++) {
+        w[i] *= gamma[i / k] / sqrt(var[i / k] + BN_EPS);
+    }
+    conv_ref(&s, w, fold_bias, inp, ref);
+
+    d.f32       = (ConvGemmF32){.shape = s, .weight = w_f32, .bias = b_f32};
+    d.q15       = (ConvGemmQ15){.shape = s, .weight = w_q15, .bias = b_f32};
+    d.inp       = inp_f32;
+    d.inp_q15   = inp_q15;
+    d.out       = out;
+    d.scratch   = scratch;
+    d.conv_out.data = conv_out + s.filter_num * n * 2;
+    d.inp_scale = conv_gemm_quantize(inp_f32, inp_size, inp_q15);
+    conv_gemm_quantize_weight(w_f32, s.filter_num, k, w_q15, &d.q15.weight_scale);
+
+    rep = BENCH_MAC / (s.filter_num * n * k) + 1;
+
+    // from here the conv2d paths convolve the BN-scaled weights, only their time matters
+    naive = time_backend(&d, -1, CONV_ALGO_AUTO, 0, rep);
+    if (border) {
+        padded = time_backend(&d, -2, CONV_ALGO_AUTO, 0, rep);
+        err_f32 = max_rel_diff(ref, conv_out, s.filter_num * n);
+
+        // a single row input is padded along col only, the padded copy also pads its rows
+        // and convolves the zero row above it, so only the 2-D and unpadded shapes compare
+        err_padded = max_rel_diff(conv_out + s.filter_num * n, conv_out, s.filter_num * n);
+        printf("%2u x %2u x %3u -> %2u x %2u x %3u k %ux%u/%u pad %u %6.2f %6.2f %5.2fx %7zu",
+               s.channel, s.row, s.col, s.filter_num, s.out_row, s.out_col, s.kernel_row,
+               s.kernel_col, s.stride, s.pad, padded, naive, padded / naive,
+               s.pad ? sizeof(double) * (s.row + 2 * s.pad) * (s.col + 2 * s.pad) * s.channel : 0);
+        if (s.row > 1 || !s.pad) {
+            printf("  %.1e  %.1e\n", err_f32, err_padded);
+        } else {
+            printf("  %.1e  -\n", err_f32);
+            err_padded = 0.0;
+        }
+        if (err_f32 > BENCH_TOL || err_padded > BENCH_TOL) {
+            ret = ALGO_DATA_EXCEPTION;
+        }
+        goto exit;
+    }
+
+    // each forced backend leaves its output in d.out, the worst error of all of them is kept
+    cost[CONV_ALGO_DIRECT] = time_backend(&d, 0, CONV_ALGO_DIRECT, 0, rep);
+    err_f32                = max_rel_err(ref, out, s.filter_num * n);
+    cost[CONV_ALGO_IM2COL] = time_backend(&d, 0, CONV_ALGO_IM2COL, BENCH_SCRATCH, rep);
+    err_f32                = fmax(err_f32, max_rel_err(ref, out, s.filter_num * n));
+    tiled_tile             = BENCH_TILE < n ? BENCH_TILE : n;
+    cost[CONV_ALGO_TILED]  = time_backend(
+        &d, 0, CONV_ALGO_TILED,
+        conv_gemm_scratch_size(&s, CONV_ALGO_TILED, sizeof(float), tiled_tile), rep);
+    err_f32 = fmax(err_f32, max_rel_err(ref, out, s.filter_num * n));
+
+    algo = conv_gemm_select(&s, sizeof(float), scratch_size, &tile);
+    ret  = conv_gemm_f32(&d.f32, CONV_ALGO_AUTO, inp_f32, out, scratch, scratch_size);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+    err_f32 = fmax(err_f32, max_rel_err(ref, out, s.filter_num * n));
+
+    cost[CONV_ALGO_AUTO] = time_backend(&d, 1, CONV_ALGO_AUTO, scratch_size, rep);
+    ret = conv_gemm_q15(&d.q15, CONV_ALGO_AUTO, inp_q15, d.inp_scale, out, scratch, scratch_size);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+    err_q15 = max_rel_err(ref, out, s.filter_num * n);
+
+    printf("%2u x %2u x %3u -> %2u x %2u x %3u k %ux%u/%u %6.2f %6.2f %6.2f %6.2f %6.2f  %-6s %4u"
+           "  %.1e  %.1e\n",
+           s.channel, s.row, s.col, s.filter_num, s.out_row, s.out_col, s.kernel_row, s.kernel_col,
+           s.stride, naive, cost[CONV_ALGO_DIRECT], cost[CONV_ALGO_IM2COL], cost[CONV_ALGO_TILED],
+           cost[CONV_ALGO_AUTO], g_algo_name[algo], tile, err_f32, err_q15);
+    if (err_f32 > BENCH_TOL_F32 || err_q15 > BENCH_TOL_Q15) {
+        ret = ALGO_DATA_EXCEPTION;
+    }
+
+exit:
+    free(w);
+    free(bias);
+    free(inp);
+    free(ref);
+    free(conv_out);
+    free(w_f32);
+    free(inp_f32);
+    free(out);
+    free(w_q15);
+    free(inp_q15);
+    free(scratch);
+
+    return ret;
+}
+
+int run_conv_bench(size_t scratch_size)
+{
+    int ret    = ALGO_NORMAL;
+    uint32_t i = 0;
+
+    printf("cycles per MAC, scratch = %zu bytes, tiled column with %u positions per tile\n",
+           scratch_size, BENCH_TILE);
+    printf("%-40s %6s %6s %6s %6s %6s  %-6s %4s  %-7s  %-7s\n", "shape", "naive", "direct",
+           "im2col", "tiled", "q15", "auto", "tile", "err f32", "err q15");
+    for (i = 0; i < sizeof(g_bench_shape) / sizeof(g_bench_shape[0]); i++) {
+        ret = bench_shape(&g_bench_shape[i], scratch_size, false);
+        if (ret != ALGO_NORMAL) {
+            printf("shape %u fail, ret = %d\n", i, ret);
+            return ret;
+        }
+    }
+
+    printf("\nconv2d_bn_no_bias, cycles per MAC of the padded copy and the border aware loop,\n"
+           "heap bytes of the padded copy (the border aware loop allocates nothing), error of\n"
+           "the border aware loop against the double reference and against the padded copy\n");
+    printf("%-48s %6s %6s %6s %7s  %-7s  %-7s\n", "shape", "padded", "border", "speed", "heap",
+           "err ref", "err pad");
+    for (i = 0; i < sizeof(g_bench_shape) / sizeof(g_bench_shape[0]); i++) {
+        ret = bench_shape(&g_bench_shape[i], scratch_size, true);
+        if (ret != ALGO_NORMAL) {
+            printf("shape %u fail, ret = %d\n", i, ret);
+            return ret;
+        }
+    }
+
+    return ALGO_NORMAL;
+}
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "conv_gemm.h"
+
+#define CONV_Q15_MAX (32767)
+
+static uint32_t patch_size(const ConvGemmShape *s)
+{
+    return (uint32_t)s->channel * s->kernel_row * s->kernel_col;
+}
+
+static uint32_t out_size(const ConvGemmShape *s)
+{
+    return (uint32_t)s->out_row * s->out_col;
+}
+
+// a single row input is a 1-D signal, it is padded along col only
+static uint16_t pad_row(const ConvGemmShape *s)
+{
+    return s->row > 1 ? s->pad : 0;
+}
+
+int conv_gemm_shape(ConvGemmShape *shape)
+{
+    uint16_t pr = 0;
+
+    if (!shape) {
+        return ALGO_POINTER_NULL;
+    }
+
+    pr = pad_row(shape);
+    if (!shape->channel || !shape->row || !shape->col || !shape->filter_num ||
+        !shape->kernel_row || !shape->kernel_col || !shape->stride ||
+        shape->row + 2 * pr < shape->kernel_row || shape->col + 2 * shape->pad < shape->kernel_col) {
+        return ALGO_DATA_INVALID;
+    }
+
+    shape->out_row = (uint16_t)((shape->row + 2 * pr - shape->kernel_row) / shape->stride + 1);
+    shape->out_col = (uint16_t)((shape->col + 2 * shape->pad - shape->kernel_col) / shape->stride + 1);
+
+    // matrix dimensions of the NMSIS-DSP are uint16_t, the Q15 scale needs headroom
+    if (patch_size(shape) >= CONV_Q15_MAX / 2 || out_size(shape) > UINT16_MAX) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    return ALGO_NORMAL;
+}
+
+// scratch bytes per output position: im2col column, plus the transposed copy
+// of the Q15 GEMM, plus the GEMM output when it cannot be written in place
+static size_t column_bytes(const ConvGemmShape *shape, size_t elem_size, bool tiled)
+{
+    uint32_t k = patch_size(shape);
+
+    if (elem_size == sizeof(int16_t)) {
+        return (2 * k + shape->filter_num) * elem_size;
+    }
+
+    return (k + (tiled ? shape->filter_num : 0)) * elem_size;
+}
+
+size_t conv_gemm_scratch_size(const ConvGemmShape *shape, ConvGemmAlgo algo, size_t elem_size,
+                              uint32_t tile)
+{
+    switch (algo) {
+    case CONV_ALGO_IM2COL:
+        return column_bytes(shape, elem_size, false) * out_size(shape);
+    case CONV_ALGO_TILED:
+        return column_bytes(shape, elem_size, true) * tile;
+    default:
+        return 0;
+    }
+}
+
+ConvGemmAlgo conv_gemm_select(const ConvGemmShape *shape, size_t elem_size, size_t scratch_size,
+                              uint32_t *tile)
+{
+    uint32_t n = out_size(shape);
+
+    *tile = 0;
+
+    // a single tap has nothing to reuse, the im2col copy would cost as much as the MACs
+    if (patch_size(shape) <= CONV_GEMM_DIRECT_MAX_K) {
+        return CONV_ALGO_DIRECT;
+    }
+
+    if (conv_gemm_scratch_size(shape, CONV_ALGO_IM2COL, elem_size, 0) <= scratch_size) {
+        *tile = n;
+        return CONV_ALGO_IM2COL;
+    }
+
+    *tile = (uint32_t)(scratch_size / column_bytes(shape, elem_size, true));
+    if (*tile >= CONV_GEMM_MIN_TILE) {
+        *tile = *tile < n ? *tile : n;
+        return CONV_ALGO_TILED;
+    }
+
+    *tile = 0;
+
+    return CONV_ALGO_DIRECT;
+}
+
+int conv_gemm_fold_bn(const Conv2dConfig *conv, float *weight, float *bias)
+{
+    const Conv2dFilter *filter = NULL;
+    const BatchNorm2d *bn      = NULL;
+    uint32_t i = 0, k = 0, patch = 0;
+    double scale = 0.0;
+
+    if (!conv || !conv->filter || !conv->bn || !conv->filter->data || !conv->bn->gamma ||
+        !conv->bn->beta || !conv->bn->mean || !conv->bn->var || !weight || !bias) {
+        return ALGO_POINTER_NULL;
+    }
+
+    filter = conv->filter;
+    bn     = conv->bn;
+    if (bn->size != filter->filter_num) {
+        return ALGO_DATA_INVALID;
+    }
+
+    patch = (uint32_t)filter->channel * filter->row * filter->col;
+    for (i = 0; i < filter->filter_num; i++) {
+        scale = bn->gamma[i] / sqrt(bn->var[i] + BN_EPS);
+        for (k = 0; k < patch; k++) {
+            weight[i * patch + k] = (float)(filter->data[i * patch + k] * scale);
+        }
+        bias[i] = (float)(bn->beta[i] - bn->mean[i] * scale);
+    }
+
+    return ALGO_NORMAL;
+}
+
+static int16_t to_q15(float value, float scale)
+{
+    float q = roundf(value / scale);
+
+    return (int16_t)(q > CONV_Q15_MAX ? CONV_Q15_MAX : (q < -CONV_Q15_MAX ? -CONV_Q15_MAX : q));
+}
+
+void conv_gemm_quantize_weight(const float *weight, uint16_t filter_num, uint32_t patch_size,
+                               int16_t *weight_q15, float *scale)
+{
+    uint32_t i = 0, k = 0;
+    float l1 = 0.0f, max_l1 = 0.0f;
+
+    // |sum(x_q * w_q)| <= 32767 * sum(|w_q|) < 32767 * 32768, so the >> 15 of
+    // the Q15 GEMM stays in range, the rounding of every weight is kept aside
+    for (i = 0; i < filter_num; i++) {
+        l1 = 0.0f;
+        for (k = 0; k < patch_size; k++) {
+            l1 += fabsf(weight[i * patch_size + k]);
+        }
+        max_l1 = l1 > max_l1 ? l1 : max_l1;
+    }
+
+    *scale = max_l1 > 0.0f ? max_l1 / (float)(CONV_Q15_MAX - patch_size) : 1.0f;
+    for (i = 0; i < (uint32_t)filter_num * patch_size; i++) {
+        weight_q15[i] = to_q15(weight[i], *scale);
+    }
+}
+
+float conv_gemm_quantize(const float *inp, uint32_t size, int16_t *out)
+{
+    uint32_t i  = 0;
+    float max   = 0.0f;
+    float scale = 1.0f;
+
+    for (i = 0; i < size; i++) {
+        max = fabsf(inp[i]) > max ? fabsf(inp[i]) : max;
+    }
+
+    if (max > 0.0f) {
+        scale = max / CONV_Q15_MAX;
+    }
+
+    for (i = 0; i < size; i++) {
+        out[i] = to_q15(inp[i], scale);
+    }
+
+    return scale;
+}
+
+/**
+ * im2col of the output positions [first, first + num): row k of x holds
+ * the input value under kernel tap k for every position, zero in the padding,
+ * so x is a patch_size x num matrix and out = weight * x
+ */
+#define DEFINE_IM2COL(name, type)                                                                  \
+    static void name(const ConvGemmShape *s, const type *inp, uint32_t first, uint32_t num,     \
+                     type *x)                                                                      \
+    {                                                                                              \
+        uint16_t ch = 0, kr = 0, kc = 0, r = 0, c = 0;                                            \
+        int32_t ir = 0, ic = 0;                                                                    \
+        uint32_t j = 0;                                                                            \
+        const type *plane = NULL;                                                                  \
+                                                                                                   \
+        for (ch = 0; ch < s->channel; ch++) {                                                      \
+            plane = inp + (uint32_t)ch * s->row * s->col;                                          \
+            for (kr = 0; kr < s->kernel_row; kr++) {                                               \
+                for (kc = 0; kc < s->kernel_col; kc++, x += num) {                                 \
+                    r = (uint16_t)(first / s->out_col);                                            \
+                    c = (uint16_t)(first % s->out_col);                                            \
+                    for (j = 0; j < num; j++) {                                                    \
+                        ir   = (int32_t)r * s->stride + kr - pad_row(s);                           \
+                        ic   = (int32_t)c * s->stride + kc - s->pad;                               \
+                        x[j] = (ir >= 0 && ir < s->row && ic >= 0 && ic < s->col)                  \
+                                   ? plane[ir * s->col + ic]                                       \
+                                   : 0;                                                            \
+                        if (++c == s->out_col) {                                                   \
+                            c = 0;                                                                 \
+                            r++;                                                                   \
+                        }                                                                          \
+                    }                                                                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+DEFINE_IM2COL(im2col_f32, float)
+DEFINE_IM2COL(im2col_q15, int16_t)
+
+// c (m x n) = a (m x k) * b (k x n), row major
+static void gemm_f32(const float *a, uint16_t m, uint16_t k, const float *b, uint16_t n, float *c)
+{
+#if VAD_USE_NMSIS
+    riscv_matrix_instance_f32 ma, mb, mc;
+
+    riscv_mat_init_f32(&ma, m, k, (float32_t *)a);
+    riscv_mat_init_f32(&mb, k, n, (float32_t *)b);
+    riscv_mat_init_f32(&mc, m, n, c);
+    riscv_mat_mult_f32(&ma, &mb, &mc);
+#else
+    uint32_t i = 0, kk = 0, j = 0;
+    const float *brow = NULL;
+    float *crow       = NULL;
+    float aik         = 0.0f;
+
+    // i-k-j order: the inner loop streams one row of b and one row of c
+    for (i = 0; i < m; i++) {
+        crow = c + i * n;
+        memset(crow, 0, sizeof(float) * n);
+        for (kk = 0; kk < k; kk++) {
+            aik  = a[i * k + kk];
+            brow = b + kk * n;
+            for (j = 0; j < n; j++) {
+                crow[j] += aik * brow[j];
+            }
+        }
+    }
+#endif
+}
+
+// same result as riscv_mat_mult_q15: 64-bit sums, >> 15, saturated
+static void gemm_q15(const int16_t *a, uint16_t m, uint16_t k, const int16_t *b, uint16_t n,
+                     int16_t *c, int16_t *state)
+{
+#if VAD_USE_NMSIS
+    riscv_matrix_instance_q15 ma, mb, mc;
+
+    riscv_mat_init_q15(&ma, m, k, (q15_t *)a);
+    riscv_mat_init_q15(&mb, k, n, (q15_t *)b);
+    riscv_mat_init_q15(&mc, m, n, c);
+    riscv_mat_mult_q15(&ma, &mb, &mc, state);
+#else
+    uint32_t i = 0, kk = 0, j = 0;
+    const int16_t *arow = NULL, *bcol = NULL;
+    int64_t acc = 0;
+
+    // b is transposed into state like the NMSIS-DSP does, the dot products are contiguous
+    for (kk = 0; kk < k; kk++) {
+        for (j = 0; j < n; j++) {
+            state[j * k + kk] = b[kk * n + j];
+        }
+    }
+
+    for (i = 0; i < m; i++) {
+        arow = a + i * k;
+        for (j = 0; j < n; j++) {
+            bcol = state + j * k;
+            acc  = 0;
+            for (kk = 0; kk < k; kk++) {
+                acc += (int32_t)arow[kk] * bcol[kk];
+            }
+            acc >>= 15;
+            c[i * n + j] = (int16_t)(acc > CONV_Q15_MAX ? CONV_Q15_MAX : (acc < -CONV_Q15_MAX - 1 ? -CONV_Q15_MAX - 1 : acc));
+        }
+    }
+#endif
+}
+
+/**
+ * direct loop, the kernel is clipped to the input once per output position with
+ * conv_clip_window so the inner loop has no border test
+ */
+#define DEFINE_DIRECT(name, layer_type, type, acc_type, store)                                    \
+    static void name(const layer_type *layer, const type *inp, float scale, float *out)          \
+    {                                                                                              \
+        const ConvGemmShape *s = &layer->shape;                                                    \
+        const type *w = NULL, *x = NULL;                                                           \
+        uint16_t f = 0, r = 0, c = 0, ch = 0, kr = 0, kc = 0;                                     \
+        uint16_t kr0 = 0, kr1 = 0, kc0 = 0, kc1 = 0;                                               \
+        int32_t ir = 0, ic = 0;                                                                    \
+        acc_type acc = 0;                                                                          \
+                                                                                                   \
+        (void)scale;                                                                               \
+        for (f = 0; f < s->filter_num; f++) {                                                      \
+            for (r = 0; r < s->out_row; r++) {                                                     \
+                ir = (int32_t)r * s->stride - pad_row(s);                                          \
+                conv_clip_window(ir, s->kernel_row, s->row, &kr0, &kr1);                            \
+                for (c = 0; c < s->out_col; c++) {                                                 \
+                    ic = (int32_t)c * s->stride - s->pad;                                          \
+                    conv_clip_window(ic, s->kernel_col, s->col, &kc0, &kc1);                        \
+                    acc = 0;                                                                       \
+                    for (ch = 0; ch < s->channel; ch++) {                                          \
+                        for (kr = kr0; kr < kr1; kr++) {                                           \
+                            w = layer->weight + f * patch_size(s) +                                \
+                                ((uint32_t)ch * s->kernel_row + kr) * s->kernel_col;               \
+                            x = inp + ((uint32_t)ch * s->row + ir + kr) * s->col + ic;             \
+                            for (kc = kc0; kc < kc1; kc++) {                                       \
+                                acc += (acc_type)w[kc] * x[kc];                                    \
+                            }                                                                      \
+                        }                                                                          \
+                    }                                                                              \
+                    *out++ = (store) + layer->bias[f];                                             \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+DEFINE_DIRECT(direct_f32, ConvGemmF32, float, float, acc)
+// same rounding as the Q15 GEMM
+DEFINE_DIRECT(direct_q15, ConvGemmQ15, int16_t, int64_t, (float)(acc >> 15) * scale)
+
+static int prepare(const ConvGemmShape *shape, ConvGemmAlgo *algo, size_t elem_size,
+                   size_t scratch_size, uint32_t *tile)
+{
+    uint32_t n = out_size(shape);
+
+    if (!shape->out_row || !shape->out_col) {
+        return ALGO_DATA_INVALID;
+    }
+
+    if (*algo == CONV_ALGO_AUTO) {
+        *algo = conv_gemm_select(shape, elem_size, scratch_size, tile);
+        return ALGO_NORMAL;
+    }
+
+    *tile = n;
+    if (*algo == CONV_ALGO_TILED) {
+        *tile = (uint32_t)(scratch_size / column_bytes(shape, elem_size, true));
+        *tile = *tile < n ? *tile : n;
+        if (!*tile) {
+            return ALGO_DATA_TOO_MANY;
+        }
+    }
+
+    if (conv_gemm_scratch_size(shape, *algo, elem_size, *tile) > scratch_size) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    return ALGO_NORMAL;
+}
+
+int conv_gemm_f32(const ConvGemmF32 *layer, ConvGemmAlgo algo, const float *inp, float *out,
+                  void *scratch, size_t scratch_size)
+{
+    int ret = ALGO_NORMAL;
+    const ConvGemmShape *s = NULL;
+    uint32_t tile = 0, first = 0, num = 0, k = 0, n = 0, f = 0, j = 0;
+    float *x = (float *)scratch, *y = NULL;
+
+    if (!layer || !layer->weight || !layer->bias || !inp || !out || (!scratch && scratch_size)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    s   = &layer->shape;
+    ret = prepare(s, &algo, sizeof(float), scratch_size, &tile);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    if (algo == CONV_ALGO_DIRECT) {
+        direct_f32(layer, inp, 1.0f, out);
+        return ALGO_NORMAL;
+    }
+
+    k = patch_size(s);
+    n = out_size(s);
+
+    // the whole GEMM output is the channel major output, no copy
+    if (algo == CONV_ALGO_IM2COL) {
+        im2col_f32(s, inp, 0, n, x);
+        gemm_f32(layer->weight, s->filter_num, (uint16_t)k, x, (uint16_t)n, out);
+        for (f = 0; f < s->filter_num; f++) {
+            for (j = 0; j < n; j++) {
+                out[f * n + j] += layer->bias[f];
+            }
+        }
+        return ALGO_NORMAL;
+    }
+
+    y = x + k * tile;
+    for (first = 0; first < n; first += num) {
+        num = n - first < tile ? n - first : tile;
+        im2col_f32(s, inp, first, num, x);
+        gemm_f32(layer->weight, s->filter_num, (uint16_t)k, x, (uint16_t)num, y);
+        for (f = 0; f < s->filter_num; f++) {
+            for (j = 0; j < num; j++) {
+                out[f * n + first + j] = y[f * num + j] + layer->bias[f];
+            }
+        }
+    }
+
+    return ALGO_NORMAL;
+}
+
+int conv_gemm_q15(const ConvGemmQ15 *layer, ConvGemmAlgo algo, const int16_t *inp,
+                  float inp_scale, float *out, void *scratch, size_t scratch_size)
+{
+    int ret = ALGO_NORMAL;
+    const ConvGemmShape *s = NULL;
+    uint32_t tile = 0, first = 0, num = 0, k = 0, n = 0, f = 0, j = 0;
+    int16_t *x = (int16_t *)scratch, *state = NULL, *y = NULL;
+    float scale = 0.0f;
+
+    if (!layer || !layer->weight || !layer->bias || !inp || !out || (!scratch && scratch_size)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    s   = &layer->shape;
+    ret = prepare(s, &algo, sizeof(int16_t), scratch_size, &tile);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    // sum(x_q * w_q) >> 15 back to the float domain
+    scale = inp_scale * layer->weight_scale * 32768.0f;
+    if (algo == CONV_ALGO_DIRECT) {
+        direct_q15(layer, inp, scale, out);
+        return ALGO_NORMAL;
+    }
+
+    k     = patch_size(s);
+    n     = out_size(s);
+    state = x + k * tile;
+    y     = state + k * tile;
+    for (first = 0; first < n; first += num) {
+        num = n - first < tile ? n - first : tile;
+        im2col_q15(s, inp, first, num, x);
+        gemm_q15(layer->weight, s->filter_num, (uint16_t)k, x, (uint16_t)num, y, state);
+        for (f = 0; f < s->filter_num; f++) {
+            for (j = 0; j < num; j++) {
+                out[f * n + first + j] = y[f * num + j] * scale + layer->bias[f];
+            }
+        }
+    }
+
+    return ALGO_NORMAL;
+}
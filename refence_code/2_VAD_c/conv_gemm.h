@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CONV_GEMM_H__
+#define __CONV_GEMM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "conv.h"
+#include "vad_dsp.h"
+#include "algo_error_code.h"
+
+#define CONV_GEMM_DIRECT_MAX_K (1)    // patches up to this size run the direct loop
+#define CONV_GEMM_MIN_TILE     (8)    // fewer output positions per tile do not pay the GEMM call
+#define CONV_GEMM_SCRATCH      (8192) // default scratch budget in bytes
+
+typedef enum _ConvGemmAlgo {
+    CONV_ALGO_AUTO = 0, // chosen by conv_gemm_select
+    CONV_ALGO_DIRECT,   // loop over the kernel, no scratch
+    CONV_ALGO_IM2COL,   // one im2col matrix of all output positions, one GEMM
+    CONV_ALGO_TILED,    // im2col and GEMM on tiles of output positions, bounded scratch
+} ConvGemmAlgo;
+
+/**
+ * shape of a conv layer, channel major tensors like Conv2dData
+ */
+typedef struct _ConvGemmShape {
+    uint16_t channel;    // input
+    uint16_t row;
+    uint16_t col;
+    uint16_t filter_num; // output channels
+    uint16_t kernel_row;
+    uint16_t kernel_col;
+    uint16_t stride;
+    uint16_t pad;        // zeros on every side, rows only if row > 1
+    uint16_t out_row;    // set by conv_gemm_shape
+    uint16_t out_col;
+} ConvGemmShape;
+
+/**
+ * float conv layer, the BN is folded into weight and bias
+ */
+typedef struct _ConvGemmF32 {
+    ConvGemmShape shape;
+    const float *weight; // filter_num x (channel * kernel_row * kernel_col)
+    const float *bias;   // filter_num
+} ConvGemmF32;
+
+/**
+ * Q15 conv layer, weight = q * weight_scale. The scale leaves room for the
+ * largest dot product of a filter, so the Q15 GEMM never saturates.
+ */
+typedef struct _ConvGemmQ15 {
+    ConvGemmShape shape;
+    const int16_t *weight; // same layout as ConvGemmF32
+    float weight_scale;
+    const float *bias; // filter_num
+} ConvGemmQ15;
+
+/**
+ * @brief check a shape and compute the output size
+ *
+ * @param[in,out] shape: conv shape, out_row and out_col are written
+ * @return error code
+ */
+int conv_gemm_shape(ConvGemmShape *shape);
+
+/**
+ * @brief choose the algorithm of a layer: the direct loop for patches of at
+ * most CONV_GEMM_DIRECT_MAX_K values, one im2col GEMM when its matrix fits
+ * the scratch, otherwise tiles of as many output positions as fit
+ *
+ * @param[in] shape: checked shape
+ * @param[in] elem_size: bytes per value, sizeof(float) or sizeof(int16_t)
+ * @param[in] scratch_size: scratch bytes available
+ * @param[out] tile: output positions per GEMM call
+ * @return algorithm
+ */
+ConvGemmAlgo conv_gemm_select(const ConvGemmShape *shape, size_t elem_size, size_t scratch_size,
+                              uint32_t *tile);
+
+/**
+ * @brief scratch bytes needed by an algorithm
+ *
+ * @param[in] shape: checked shape
+ * @param[in] algo: algorithm, not CONV_ALGO_AUTO
+ * @param[in] elem_size: bytes per value, sizeof(float) or sizeof(int16_t)
+ * @param[in] tile: output positions per GEMM call, used by CONV_ALGO_TILED
+ * @return bytes
+ */
+size_t conv_gemm_scratch_size(const ConvGemmShape *shape, ConvGemmAlgo algo, size_t elem_size,
+                              uint32_t tile);
+
+/**
+ * @brief fold conv weights and BN of a Conv2dConfig into a float layer
+ *
+ * @param[in] conv: conv config, bias free, with BN
+ * @param[out] weight: filter_num * channel * row * col values
+ * @param[out] bias: filter_num values
+ * @return error code
+ */
+int conv_gemm_fold_bn(const Conv2dConfig *conv, float *weight, float *bias);
+
+/**
+ * @brief quantize the weights of a float layer to Q15
+ *
+ * @param[in] weight: filter_num x patch_size float weights
+ * @param[in] filter_num: rows
+ * @param[in] patch_size: values per filter
+ * @param[out] weight_q15: quantized weights
+ * @param[out] scale: weight = q * scale
+ */
+void conv_gemm_quantize_weight(const float *weight, uint16_t filter_num, uint32_t patch_size,
+                               int16_t *weight_q15, float *scale);
+
+/**
+ * @brief quantize an input tensor to Q15 with one scale
+ *
+ * @param[in] inp: float values
+ * @param[in] size: number of values
+ * @param[out] out: quantized values
+ * @return scale, value = q * scale
+ */
+float conv_gemm_quantize(const float *inp, uint32_t size, int16_t *out);
+
+/**
+ * @brief float conv through im2col + riscv_mat_mult_f32 (a portable GEMM on
+ * the host), nothing is allocated
+ *
+ * @param[in] layer: conv layer with checked shape
+ * @param[in] algo: algorithm, CONV_ALGO_AUTO to select it from the shape
+ * @param[in] inp: channel x row x col input
+ * @param[out] out: filter_num x out_row x out_col output
+ * @param[in] scratch: scratch memory, 4 byte aligned
+ * @param[in] scratch_size: bytes of scratch
+ * @return error code, ALGO_DATA_TOO_MANY if the scratch is too small
+ */
+int conv_gemm_f32(const ConvGemmF32 *layer, ConvGemmAlgo algo, const float *inp, float *out,
+                  void *scratch, size_t scratch_size);
+
+/**
+ * @brief Q15 conv through im2col + riscv_mat_mult_q15, the result is scaled
+ * back to float and the bias added
+ *
+ * @param[in] layer: conv layer with checked shape
+ * @param[in] algo: algorithm, CONV_ALGO_AUTO to select it from the shape
+ * @param[in] inp: channel x row x col quantized input
+ * @param[in] inp_scale: value = q * inp_scale
+ * @param[out] out: filter_num x out_row x out_col output
+ * @param[in] scratch: scratch memory, 4 byte aligned
+ * @param[in] scratch_size: bytes of scratch
+ * @return error code, ALGO_DATA_TOO_MANY if the scratch is too small
+ */
+int conv_gemm_q15(const ConvGemmQ15 *layer, ConvGemmAlgo algo, const int16_t *inp,
+                  float inp_scale, float *out, void *scratch, size_t scratch_size);
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "wav.h"
+#include "runner.h"
+#include "segment.h"
+#include "evaluate.h"
+#include "decimate_tool.h"
+
+#define DECIMATE_MAX_FILE (256)
+#define DECIMATE_NAME_LEN (256)
+
+/**
+ * totals of one file or of the data set, run 0 is full rate, run 1 decimated
+ */
+typedef struct _DecimateTotal {
+    uint64_t sample_num;  // samples of the audio
+    uint64_t hop_num;     // hops of each run
+    uint64_t cnn_num[2];  // CNN invocations
+    uint64_t cycle[2];    // cycles of vad_process
+    uint64_t snap_num;    // returns of the decimated run to full rate
+    uint64_t onset_num;   // reference onsets
+    uint64_t found[2];    // onsets overlapped by a predicted segment
+    uint64_t both;        // onsets found by both runs
+    uint64_t late_num;    // onsets found by both runs, later in the decimated one
+    int64_t delay[2];     // sum of the onset delays, in samples, of the onsets found by both
+    int64_t late_max;     // largest extra delay of the decimated run
+    uint64_t labeled;     // files scored against a label
+    EvalCount cnt[2];     // sample level counters of the labeled files
+} DecimateTotal;
+
+typedef struct _DecimateSegment {
+    uint64_t *data;
+    uint64_t size;
+} DecimateSegment;
+
+static void segment_store(void *param, uint64_t start, uint64_t end)
+{
+    DecimateSegment *seg = (DecimateSegment *)param;
+
+    seg->data[seg->size++] = start;
+    seg->data[seg->size++] = end;
+}
+
+// start of the first predicted segment overlapping [start, end), the cursor
+// only moves forward since the reference segments are sorted
+static bool first_overlap(const DecimateSegment *pred, uint64_t *cursor, uint64_t start,
+                          uint64_t end, uint64_t *onset)
+{
+    while (*cursor < pred->size && pred->data[*cursor + 1] <= start) {
+        *cursor += 2;
+    }
+
+    if (*cursor >= pred->size || pred->data[*cursor] >= end) {
+        return false;
+    }
+    *onset = pred->data[*cursor];
+
+    return true;
+}
+
+static void count_onsets(const uint64_t *ref, uint64_t ref_size, const DecimateSegment *pred,
+                         DecimateTotal *total)
+{
+    uint64_t k = 0, cursor[2] = {0, 0}, onset[2] = {0, 0};
+    bool found[2];
+    int64_t late = 0;
+    int r = 0;
+
+    for (k = 0; k + 1 < ref_size; k += 2) {
+        total->onset_num++;
+        for (r = 0; r < 2; r++) {
+            found[r] = first_overlap(&pred[r], &cursor[r], ref[k], ref[k + 1], &onset[r]);
+            total->found[r] += found[r];
+        }
+        if (!found[0] || !found[1]) {
+            continue;
+        }
+
+        // a predicted segment may start before the labeled onset, delays are signed
+        total->both++;
+        for (r = 0; r < 2; r++) {
+            total->delay[r] += (int64_t)onset[r] - (int64_t)ref[k];
+        }
+        late = (int64_t)onset[1] - (int64_t)onset[0];
+        total->late_num += late > 0;
+        if (late > total->late_max) {
+            total->late_max = late;
+        }
+    }
+}
+
+static void decimate_total_add(DecimateTotal *sum, const DecimateTotal *add)
+{
+    int r = 0;
+
+    sum->sample_num += add->sample_num;
+    sum->hop_num += add->hop_num;
+    sum->snap_num += add->snap_num;
+    sum->onset_num += add->onset_num;
+    sum->both += add->both;
+    sum->late_num += add->late_num;
+    sum->labeled += add->labeled;
+    if (add->late_max > sum->late_max) {
+        sum->late_max = add->late_max;
+    }
+    for (r = 0; r < 2; r++) {
+        sum->cnn_num[r] += add->cnn_num[r];
+        sum->cycle[r] += add->cycle[r];
+        sum->found[r] += add->found[r];
+        sum->delay[r] += add->delay[r];
+        eval_merge(&sum->cnt[r], &add->cnt[r]);
+    }
+}
+
+static void decimate_total_print(const char *name, const DecimateTotal *total)
+{
+    double sec = (double)total->sample_num / OBJ_FS;
+    uint64_t both = total->both;
+    EvalMetrics metrics[2];
+
+    printf("%-12s %7.1f %8.1f %8.1f %7.1f %6" PRIu64 " ", name, sec,
+           sec > 0 ? total->cnn_num[0] / sec : 0.0, sec > 0 ? total->cnn_num[1] / sec : 0.0,
+           total->cycle[0] ? 100.0 * total->cycle[1] / total->cycle[0] : 0.0, total->snap_num);
+    if (total->labeled) {
+        eval_metrics(&total->cnt[0], &metrics[0]);
+        eval_metrics(&total->cnt[1], &metrics[1]);
+        printf("%7.4f %7.4f ", metrics[0].f1_score, metrics[1].f1_score);
+    } else {
+        printf("%7s %7s ", "-", "-");
+    }
+
+    printf("%4" PRIu64 "/%-4" PRIu64 " %8.1f %8.1f %5" PRIu64 " %8.1f\n", total->found[1],
+           total->onset_num, both ? total->delay[0] * 1e3 / OBJ_FS / both : 0.0,
+           both ? total->delay[1] * 1e3 / OBJ_FS / both : 0.0, total->late_num,
+           total->late_max * 1e3 / OBJ_FS);
+}
+
+static int decimate_file(const char *wav_dir, const char *label_dir, const char *name,
+                         const VadDecimateConfig *config, const VadSmoothConfig *smooth,
+                         DecimateTotal *total)
+{
+    char path[DECIMATE_NAME_LEN * 4];
+    int ret          = ALGO_NORMAL, r = 0, k = 0;
+    uint64_t i       = 0, start = 0, label_size = 0;
+    uint64_t *label  = NULL;
+    bool vad_out     = false;
+    double frame[FRAME_LEN];
+    VadContext ctx[2];
+    VadSmoother smoother[2];
+    DecimateSegment seg[2] = {{NULL, 0}, {NULL, 0}};
+    VadSmoothSegment sink[2] = {{segment_store, &seg[0], 0}, {segment_store, &seg[1], 0}};
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    memset(total, 0, sizeof(DecimateTotal));
+    snprintf(path, sizeof(path), "%s/%s.wav", wav_dir, name);
+    ret = wav_open(path, &wav);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    total->sample_num = wav.frames;
+    total->hop_num    = cal_frame_num(wav.frames);
+    for (r = 0; r < 2 && ret == ALGO_NORMAL; r++) {
+        seg[r].data = (uint64_t *)malloc(sizeof(uint64_t) * (total->hop_num + 2));
+        ret         = seg[r].data ? vad_init(&ctx[r]) : ALGO_MALLOC_FAIL;
+        if (ret == ALGO_NORMAL) {
+            ret = vad_smooth_init(&smoother[r], smooth, vad_smooth_segment, &sink[r]);
+        }
+    }
+    if (ret == ALGO_NORMAL) {
+        ret = vad_enable_decimate(&ctx[1], config);
+    }
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    for (i = 0; i < total->hop_num; i++) {
+        load_frame(&wav, i * FRAME_STEP, i == 0, frame);
+
+        // the run going first pays for the cold frame, it alternates
+        for (k = 0; k < 2; k++) {
+            r     = (int)((i + k) & 1);
+            start = get_cycle();
+            ret   = vad_process(&ctx[r], &vad_inp, &vad_out);
+            total->cycle[r] += get_cycle() - start;
+            if (ret != ALGO_NORMAL) {
+                goto exit;
+            }
+            vad_smooth_push(&smoother[r], ctx[r].margin, i * FRAME_STEP);
+        }
+    }
+    for (r = 0; r < 2; r++) {
+        vad_smooth_finish(&smoother[r], wav.frames);
+    }
+
+    total->cnn_num[0] = total->hop_num;
+    total->cnn_num[1] = ctx[1].decimate.hop_cnt - ctx[1].decimate.skip_cnt;
+    total->snap_num   = ctx[1].decimate.snap_cnt;
+
+    snprintf(path, sizeof(path), "%s/%s.txt", label_dir, name);
+    if (access(path, R_OK) == 0) {
+        ret = load_voice_segment(path, &label, &label_size);
+        for (r = 0; r < 2 && ret == ALGO_NORMAL; r++) {
+            ret = eval_count_sorted(wav.frames, label, label_size, seg[r].data, seg[r].size,
+                                    &total->cnt[r]);
+        }
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+        total->labeled = 1;
+        count_onsets(label, label_size, seg, total);
+    } else {
+        count_onsets(seg[0].data, seg[0].size, seg, total);
+    }
+
+exit:
+    free(label);
+    free(seg[0].data);
+    free(seg[1].data);
+    wav_close(&wav);
+
+    return ret;
+}
+
+static int cmp_name(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+int run_decimate_eval(const char *wav_dir, const char *label_dir, const VadDecimateConfig *config,
+                      const VadSmoothConfig *smooth)
+{
+    int ret              = ALGO_NORMAL;
+    uint32_t file_num    = 0, f = 0;
+    size_t len           = 0;
+    char (*name)[DECIMATE_NAME_LEN] = NULL;
+    DIR *dir             = NULL;
+    struct dirent *entry = NULL;
+    DecimateTotal file, total;
+    VadContext probe;
+
+    // the configuration is checked once, before any file is read
+    vad_init(&probe);
+    ret = vad_enable_decimate(&probe, config);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    name = (char(*)[DECIMATE_NAME_LEN])malloc(DECIMATE_MAX_FILE * DECIMATE_NAME_LEN);
+    if (!name) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    dir = opendir(wav_dir);
+    if (!dir) {
+        free(name);
+        return ALGO_IO_EXCEPTION;
+    }
+    while ((entry = readdir(dir)) != NULL && file_num < DECIMATE_MAX_FILE) {
+        len = strlen(entry->d_name);
+        if (len <= 4 || len >= DECIMATE_NAME_LEN || strcmp(entry->d_name + len - 4, ".wav")) {
+            continue;
+        }
+        memcpy(name[file_num], entry->d_name, len - 4);
+        name[file_num++][len - 4] = '\0';
+    }
+    closedir(dir);
+    qsort(name, file_num, DECIMATE_NAME_LEN, cmp_name);
+
+    printf("silence_hops %u, max_stride %u\n", probe.decimate.config.silence_hops,
+           probe.decimate.config.max_stride);
+    printf("%-12s %7s %8s %8s %7s %6s %7s %7s %9s %8s %8s %5s %8s\n", "file", "sec", "cnn/s",
+           "cnn/s_d", "cpu(%)", "snaps", "f1", "f1_d", "onsets", "delay", "delay_d", "late",
+           "late_max");
+    memset(&total, 0, sizeof(DecimateTotal));
+    for (f = 0; f < file_num; f++) {
+        ret = decimate_file(wav_dir, label_dir, name[f], config, smooth, &file);
+        if (ret != ALGO_NORMAL) {
+            printf("%s: error %d\n", name[f], ret);
+            goto exit;
+        }
+        decimate_total_print(name[f], &file);
+        decimate_total_add(&total, &file);
+    }
+    if (!total.hop_num) {
+        printf("no hop in %s\n", wav_dir);
+        ret = ALGO_DATA_NULL;
+        goto exit;
+    }
+    decimate_total_print("total", &total);
+
+    // cpu: vad_process of the decimated run, energy statistics included, relative to full rate
+    printf("CNN invocations: %.1f /s at full rate, %.1f /s decimated (%.2f %%), %" PRIu64
+           " returns to full rate\n",
+           total.cnn_num[0] * (double)OBJ_FS / total.sample_num,
+           total.cnn_num[1] * (double)OBJ_FS / total.sample_num,
+           100.0 * total.cnn_num[1] / total.cnn_num[0], total.snap_num);
+    printf("onsets: %" PRIu64 " of %" PRIu64 " labeled files and %u full rate runs, found %" PRIu64
+           " at full rate, %" PRIu64 " decimated, %" PRIu64 " later by up to %.1f ms\n",
+           total.onset_num, total.labeled, file_num - (uint32_t)total.labeled, total.found[0],
+           total.found[1], total.late_num, total.late_max * 1e3 / OBJ_FS);
+
+exit:
+    free(name);
+
+    return ret;
+}
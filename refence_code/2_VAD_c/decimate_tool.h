@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DECIMATE_TOOL_H__
+#define __DECIMATE_TOOL_H__
+
+#include "vad.h"
+#include "smooth.h"
+#include "algo_error_code.h"
+
+/**
+ * @brief run every wav file of a directory at full rate and with the
+ * adaptive hop rate side by side, print the CNN invocations per second, the
+ * CPU share, the metrics against the labels and the onset latency of the
+ * decimated run. The onsets are the label segments, or the segments of the
+ * full rate run for the files without a label file.
+ *
+ * @param[in] wav_dir: directory of the wav files
+ * @param[in] label_dir: directory of the label files
+ * @param[in] config: adaptive hop rate, NULL for the default one
+ * @param[in] smooth: decision smoothing of both runs, NULL: pass-through
+ * @return error code
+ */
+int run_decimate_eval(const char *wav_dir, const char *label_dir, const VadDecimateConfig *config,
+                      const VadSmoothConfig *smooth);
+
+#endif
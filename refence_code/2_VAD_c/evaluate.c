@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "evaluate.h"
+
+static uint64_t mark_segment(uint8_t *flag, uint64_t data_length, const uint64_t *seg,
+                             uint64_t seg_size, uint8_t bit)
+{
+    uint64_t i = 0, j = 0, length = 0;
+
+    for (i = 0; i + 1 < seg_size; i += 2) {
+        for (j = seg[i]; j <= seg[i + 1] && j < data_length; j++) {
+            flag[j] |= bit;
+        }
+        length += seg[i + 1] - seg[i];
+    }
+
+    return length;
+}
+
+int eval_count(uint64_t data_length, const uint64_t *label, uint64_t label_size,
+               const uint64_t *pred, uint64_t pred_size, EvalCount *cnt)
+{
+    uint64_t i    = 0;
+    uint8_t *flag = NULL;
+
+    if (!cnt || (label_size && !label) || (pred_size && !pred)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(cnt, 0, sizeof(EvalCount));
+
+    // bit 0: label, bit 1: prediction
+    flag = (uint8_t *)calloc(data_length ? data_length : 1, sizeof(uint8_t));
+    if (!flag) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    cnt->data_length          = data_length;
+    cnt->voice_length         = mark_segment(flag, data_length, label, label_size, 1);
+    cnt->predict_voice_length = mark_segment(flag, data_length, pred, pred_size, 2);
+
+    for (i = 0; i < data_length; i++) {
+        switch (flag[i]) {
+        case 0:
+            cnt->acc++;
+            break;
+        case 1:
+            cnt->miss_detection++;
+            break;
+        case 2:
+            cnt->false_detection++;
+            break;
+        default:
+            cnt->acc++;
+            cnt->tp++;
+            break;
+        }
+    }
+
+    free(flag);
+
+    return ALGO_NORMAL;
+}
+
+// samples of the inclusive segment [start, end] below data_length
+static uint64_t clip_length(uint64_t start, uint64_t end, uint64_t data_length)
+{
+    if (start >= data_length || end < start) {
+        return 0;
+    }
+
+    return (end < data_length ? end : data_length - 1) - start + 1;
+}
+
+static uint64_t overlap(const uint64_t *a, const uint64_t *b, uint64_t data_length)
+{
+    uint64_t start = a[0] > b[0] ? a[0] : b[0];
+    uint64_t end   = a[1] < b[1] ? a[1] : b[1];
+
+    return clip_length(start, end, data_length);
+}
+
+int eval_count_sorted(uint64_t data_length, const uint64_t *label, uint64_t label_size,
+                      const uint64_t *pred, uint64_t pred_size, EvalCount *cnt)
+{
+    uint64_t i = 0, j = 0, label_samples = 0, pred_samples = 0;
+
+    if (!cnt || (label_size && !label) || (pred_size && !pred)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(cnt, 0, sizeof(EvalCount));
+    cnt->data_length = data_length;
+
+    for (i = 0; i + 1 < label_size; i += 2) {
+        cnt->voice_length += label[i + 1] - label[i];
+        label_samples += clip_length(label[i], label[i + 1], data_length);
+    }
+    for (j = 0; j + 1 < pred_size; j += 2) {
+        cnt->predict_voice_length += pred[j + 1] - pred[j];
+        pred_samples += clip_length(pred[j], pred[j + 1], data_length);
+    }
+
+    // both lists are sorted, advance the one ending first
+    for (i = 0, j = 0; i + 1 < label_size && j + 1 < pred_size;) {
+        cnt->tp += overlap(label + i, pred + j, data_length);
+        if (label[i + 1] < pred[j + 1]) {
+            i += 2;
+        } else {
+            j += 2;
+        }
+    }
+
+    cnt->miss_detection  = label_samples - cnt->tp;
+    cnt->false_detection = pred_samples - cnt->tp;
+    cnt->acc = data_length - cnt->miss_detection - cnt->false_detection;
+
+    return ALGO_NORMAL;
+}
+
+void eval_event_count(const uint64_t *label, uint64_t label_size, const uint64_t *pred,
+                      uint64_t pred_size, EvalEventCount *cnt)
+{
+    uint64_t i = 0, j = 0, inter = 0, uni = 0;
+
+    cnt->label_num = label_size / 2;
+    cnt->pred_num  = pred_size / 2;
+    cnt->hit       = 0;
+
+    for (i = 0, j = 0; i + 1 < label_size && j + 1 < pred_size;) {
+        inter = overlap(label + i, pred + j, UINT64_MAX);
+        uni   = (label[i + 1] - label[i] + 1) + (pred[j + 1] - pred[j] + 1) - inter;
+        if (inter > EVAL_EVENT_IOU * uni) {
+            cnt->hit++;
+        }
+        if (label[i + 1] < pred[j + 1]) {
+            i += 2;
+        } else {
+            j += 2;
+        }
+    }
+}
+
+void eval_merge(EvalCount *total, const EvalCount *cnt)
+{
+    total->data_length += cnt->data_length;
+    total->voice_length += cnt->voice_length;
+    total->predict_voice_length += cnt->predict_voice_length;
+    total->acc += cnt->acc;
+    total->tp += cnt->tp;
+    total->false_detection += cnt->false_detection;
+    total->miss_detection += cnt->miss_detection;
+}
+
+void eval_metrics(const EvalCount *cnt, EvalMetrics *metrics)
+{
+    memset(metrics, 0, sizeof(EvalMetrics));
+
+    if (cnt->data_length) {
+        metrics->accuracy = (double)cnt->acc / cnt->data_length;
+    }
+    if (cnt->voice_length) {
+        metrics->recall = (double)cnt->tp / cnt->voice_length;
+    }
+    if (cnt->predict_voice_length) {
+        metrics->precision = (double)cnt->tp / cnt->predict_voice_length;
+    }
+    if (metrics->precision + metrics->recall > 0) {
+        metrics->f1_score = (2 * metrics->precision * metrics->recall) /
+                            (metrics->precision + metrics->recall);
+    }
+}
+
+void eval_event_metrics(const EvalEventCount *cnt, EvalMetrics *metrics)
+{
+    memset(metrics, 0, sizeof(EvalMetrics));
+
+    if (cnt->label_num) {
+        metrics->recall = (double)cnt->hit / cnt->label_num;
+    }
+    if (cnt->pred_num) {
+        metrics->precision = (double)cnt->hit / cnt->pred_num;
+    }
+    if (cnt->label_num + cnt->pred_num > cnt->hit) {
+        metrics->accuracy = (double)cnt->hit / (cnt->label_num + cnt->pred_num - cnt->hit);
+    }
+    if (metrics->precision + metrics->recall > 0) {
+        metrics->f1_score = (2 * metrics->precision * metrics->recall) /
+                            (metrics->precision + metrics->recall);
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __EVALUATE_H__
+#define __EVALUATE_H__
+
+#include <stdint.h>
+
+#include "algo_error_code.h"
+
+/**
+ * Sample level counters of one or more audio files, same definition as
+ * refence_code/4_evaluation/evaluate.py
+ */
+typedef struct _EvalCount {
+    uint64_t data_length;          // number of samples
+    uint64_t voice_length;         // sum of (end - start) of the labels
+    uint64_t predict_voice_length; // sum of (end - start) of the predictions
+    uint64_t acc;                  // samples where prediction equals label
+    uint64_t tp;                   // voice samples predicted as voice
+    uint64_t false_detection;      // unvoice samples predicted as voice
+    uint64_t miss_detection;       // voice samples predicted as unvoice
+} EvalCount;
+
+#define EVAL_EVENT_IOU (0.5) // a label and a predicted segment match above this IoU
+
+/**
+ * Segment level counters, a label segment is detected when a predicted
+ * segment overlaps it with an IoU above EVAL_EVENT_IOU. Segments of one list
+ * are disjoint, so every segment has at most one match.
+ */
+typedef struct _EvalEventCount {
+    uint64_t label_num; // label segments
+    uint64_t pred_num;  // predicted segments
+    uint64_t hit;       // matched pairs
+} EvalEventCount;
+
+/**
+ * Metrics calculated from EvalCount
+ */
+typedef struct _EvalMetrics {
+    double f1_score;
+    double accuracy;
+    double recall;
+    double precision;
+} EvalMetrics;
+
+/**
+ * @brief count the sample level hits of one audio file
+ *
+ * @param[in] data_length: the data length of the audio file
+ * @param[in] label: label segments, 2n: start index, 2n+1: end index
+ * @param[in] label_size: number of indices in label
+ * @param[in] pred: predicted segments, same format as label
+ * @param[in] pred_size: number of indices in pred
+ * @param[out] cnt: counters of the file
+ * @return error code
+ */
+int eval_count(uint64_t data_length, const uint64_t *label, uint64_t label_size,
+               const uint64_t *pred, uint64_t pred_size, EvalCount *cnt);
+
+/**
+ * @brief same as eval_count for sorted, disjoint segments, in
+ * O(label_size + pred_size) without a per-sample buffer
+ *
+ * @param[in] data_length: the data length of the audio file
+ * @param[in] label: sorted label segments, 2n: start index, 2n+1: end index
+ * @param[in] label_size: number of indices in label
+ * @param[in] pred: sorted predicted segments, same format as label
+ * @param[in] pred_size: number of indices in pred
+ * @param[out] cnt: counters of the file
+ * @return error code
+ */
+int eval_count_sorted(uint64_t data_length, const uint64_t *label, uint64_t label_size,
+                      const uint64_t *pred, uint64_t pred_size, EvalCount *cnt);
+
+/**
+ * @brief count the segment level matches of one audio file
+ *
+ * @param[in] label: sorted label segments, 2n: start index, 2n+1: end index
+ * @param[in] label_size: number of indices in label
+ * @param[in] pred: sorted predicted segments, same format as label
+ * @param[in] pred_size: number of indices in pred
+ * @param[out] cnt: counters of the file
+ */
+void eval_event_count(const uint64_t *label, uint64_t label_size, const uint64_t *pred,
+                      uint64_t pred_size, EvalEventCount *cnt);
+
+/**
+ * @brief accumulate the counters of a file into a total
+ *
+ * @param[in,out] total: accumulated counters
+ * @param[in] cnt: counters to be added
+ */
+void eval_merge(EvalCount *total, const EvalCount *cnt);
+
+/**
+ * @brief calculate f1_score, accuracy, recall and precision
+ *
+ * @param[in] cnt: counters
+ * @param[out] metrics: metrics, 0 where the denominator is 0
+ */
+void eval_metrics(const EvalCount *cnt, EvalMetrics *metrics);
+
+/**
+ * @brief calculate the segment level f1_score, recall and precision,
+ * accuracy is the share of matched segments in the union of both lists
+ *
+ * @param[in] cnt: segment level counters
+ * @param[out] metrics: metrics, 0 where the denominator is 0
+ */
+void eval_event_metrics(const EvalEventCount *cnt, EvalMetrics *metrics);
+
+#endif
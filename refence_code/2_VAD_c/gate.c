@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+
+#include "gate.h"
+#include "vad_dsp.h"
+#include "vad_section.h"
+
+void vad_gate_default_config(VadGateConfig *config)
+{
+    config->energy_ratio = 4.0; // 6 dB
+    config->zcr_ratio    = 2.0; // 3 dB
+    config->zcr_min      = 0.5;
+    config->max_energy   = 1e6; // RMS 1000
+    config->min_floor    = 100.0; // RMS 10, keeps digital silence from freezing the floor
+    config->hangover     = 8;   // 120 ms
+    config->warmup       = 10;  // 150 ms
+}
+
+int vad_gate_init(VadGate *gate, const VadGateConfig *config)
+{
+    if (!gate) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(gate, 0, sizeof(VadGate));
+    if (config) {
+        gate->config = *config;
+    } else {
+        vad_gate_default_config(&gate->config);
+    }
+
+    return ALGO_NORMAL;
+}
+
+VAD_RAM_TEXT static double hop_energy(const double *hop, uint32_t len)
+{
+    double power = 0.0;
+
+#if VAD_USE_NMSIS
+    riscv_power_f64(hop, len, &power);
+#else
+    uint32_t i = 0;
+
+    for (i = 0; i < len; i++) {
+        power += hop[i] * hop[i];
+    }
+#endif
+
+    return power / len;
+}
+
+VAD_RAM_TEXT static double hop_zcr(const double *hop, uint32_t len)
+{
+    uint32_t i = 0, cross = 0;
+
+    for (i = 1; i < len; i++) {
+        cross += (hop[i] >= 0.0) != (hop[i - 1] >= 0.0);
+    }
+
+    return len > 1 ? (double)cross / (len - 1) : 0.0;
+}
+
+VAD_RAM_TEXT bool vad_gate_update(VadGate *gate, const double *hop, uint32_t len)
+{
+    const VadGateConfig *cfg = &gate->config;
+    double floor             = 0.0;
+    bool active              = false;
+
+    if (len == 0) {
+        return true;
+    }
+
+    gate->energy = hop_energy(hop, len);
+    gate->zcr    = hop_zcr(hop, len);
+
+    if (gate->hop_cnt == 0 || gate->noise_floor < cfg->min_floor) {
+        gate->noise_floor = gate->energy > cfg->min_floor ? gate->energy : cfg->min_floor;
+    }
+    floor = gate->noise_floor;
+
+    // the decision uses the floor before this hop, onsets never raise their own threshold
+    active = gate->hop_cnt < cfg->warmup || gate->energy >= cfg->max_energy ||
+             gate->energy >= floor * cfg->energy_ratio ||
+             (gate->zcr >= cfg->zcr_min && gate->energy >= floor * cfg->zcr_ratio);
+
+    // minimum tracking: falls quickly, rises slowly and never above the hop energy
+    if (gate->energy < floor) {
+        gate->noise_floor += VAD_GATE_FLOOR_DOWN * (gate->energy - floor);
+    } else if (floor * (1.0 + VAD_GATE_FLOOR_UP) < gate->energy) {
+        gate->noise_floor = floor * (1.0 + VAD_GATE_FLOOR_UP);
+    } else {
+        gate->noise_floor = gate->energy;
+    }
+    gate->hop_cnt++;
+
+    if (active) {
+        gate->hang = cfg->hangover;
+        return true;
+    }
+
+    if (gate->hang) {
+        gate->hang--;
+        return true;
+    }
+
+    gate->skip_cnt++;
+
+    return false;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __GATE_H__
+#define __GATE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "algo_error_code.h"
+
+#define VAD_GATE_FLOOR_DOWN (0.2)   // floor smoothing when the hop energy is below the floor
+#define VAD_GATE_FLOOR_UP   (0.01)  // relative rise of the floor per hop otherwise, ~2.9 dB/s
+
+/**
+ * configuration of the energy/ZCR pre-gate, energies are mean squares of
+ * the samples of one hop in the units of the VAD input (int16 scale)
+ */
+typedef struct _VadGateConfig {
+    double energy_ratio; // hops above noise floor * energy_ratio are active
+    double zcr_ratio;    // hops above noise floor * zcr_ratio with a high ZCR are active
+    double zcr_min;      // zero-crossing rate of unvoiced speech onsets
+    double max_energy;   // hops above this energy are always active
+    double min_floor;    // lower bound of the noise floor
+    uint32_t hangover;   // hops the CNN keeps running after the last active hop
+    uint32_t warmup;     // hops the CNN always runs while the floor settles
+} VadGateConfig;
+
+/**
+ * state of the pre-gate of one stream, the CNN runs on active hops and during
+ * the hangover after them, the other hops are non-voice without inference
+ */
+typedef struct _VadGate {
+    VadGateConfig config;
+    double noise_floor; // adaptive noise floor, tracks the minimum hop energy
+    double energy;      // energy of the last hop
+    double zcr;         // zero-crossing rate of the last hop
+    uint32_t hang;      // hangover hops left
+    uint64_t hop_cnt;   // hops seen
+    uint64_t skip_cnt;  // hops where the CNN was skipped
+} VadGate;
+
+/**
+ * @brief get the default configuration of the pre-gate
+ *
+ * @param[out] config: default configuration
+ */
+void vad_gate_default_config(VadGateConfig *config);
+
+/**
+ * @brief initialize the pre-gate of a stream
+ *
+ * @param[out] gate: gate to be initialized
+ * @param[in] config: configuration, NULL for the default one
+ * @return error code
+ */
+int vad_gate_init(VadGate *gate, const VadGateConfig *config);
+
+/**
+ * @brief update the gate with the new samples of a hop
+ *
+ * @param[in] gate: initialized gate
+ * @param[in] hop: new samples
+ * @param[in] len: number of new samples
+ * @return true: run the CNN, false: the hop is non-voice
+ */
+bool vad_gate_update(VadGate *gate, const double *hop, uint32_t len);
+
+#endif
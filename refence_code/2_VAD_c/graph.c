@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "graph.h"
+
+// lifetime end of the output tensor: alive after the last layer
+#define GRAPH_END(layer_num) (layer_num)
+#define GRAPH_UNUSED         (0xffff) // def of a tensor no layer writes
+
+static uint32_t tensor_size(const GraphTensor *tensor)
+{
+    return (uint32_t)tensor->channel * tensor->row * tensor->col;
+}
+
+static bool is_elementwise(uint8_t type)
+{
+    return type == GRAPH_OP_BATCHNORM || type == GRAPH_OP_LEAKY_RELU;
+}
+
+static uint16_t out_len(uint16_t len, uint16_t pad, uint16_t kernel, uint16_t stride)
+{
+    return (uint16_t)((len + 2 * pad - kernel) / stride + 1);
+}
+
+// shape of the output of a layer, the offset is left to the planner
+static int layer_shape(const GraphLayer *layer, const GraphTensor *inp, GraphTensor *out)
+{
+    const uint16_t *p = layer->param;
+
+    out->channel = inp->channel;
+    out->row     = inp->row;
+    out->col     = inp->col;
+
+    switch (layer->type) {
+    case GRAPH_OP_CONV2D:
+        if (!layer->tensor[0]) {
+            return ALGO_POINTER_NULL;
+        }
+        if (!p[0] || !p[1] || !p[2] || !p[3] || inp->row + 2 * p[4] < p[1] ||
+            inp->col + 2 * p[5] < p[2]) {
+            return ALGO_DATA_INVALID;
+        }
+        out->channel = p[0];
+        out->row     = out_len(inp->row, p[4], p[1], p[3]);
+        out->col     = out_len(inp->col, p[5], p[2], p[3]);
+        break;
+    case GRAPH_OP_BATCHNORM:
+        if (!layer->tensor[0] || !layer->tensor[1] || !layer->tensor[2] || !layer->tensor[3]) {
+            return ALGO_POINTER_NULL;
+        }
+        break;
+    case GRAPH_OP_LEAKY_RELU:
+        break;
+    case GRAPH_OP_LINEAR:
+        if (!layer->tensor[0] || !layer->tensor[1]) {
+            return ALGO_POINTER_NULL;
+        }
+        if (!p[0]) {
+            return ALGO_DATA_INVALID;
+        }
+        out->channel = 1;
+        out->row     = 1;
+        out->col     = p[0];
+        break;
+    case GRAPH_OP_POOL1D:
+        if (p[0] > GRAPH_POOL_AVG || !p[1] || !p[2] || inp->col < p[1]) {
+            return ALGO_DATA_INVALID;
+        }
+        out->col = out_len(inp->col, 0, p[1], p[2]);
+        break;
+    case GRAPH_OP_DWCONV1D:
+        if (!layer->tensor[0]) {
+            return ALGO_POINTER_NULL;
+        }
+        if (!p[0] || !p[1] || inp->col + 2 * p[2] < p[0]) {
+            return ALGO_DATA_INVALID;
+        }
+        out->col = out_len(inp->col, p[2], p[0], p[1]);
+        break;
+    default:
+        return ALGO_DATA_INVALID;
+    }
+
+    return tensor_size(out) ? ALGO_NORMAL : ALGO_DATA_INVALID;
+}
+
+// last layer reading every tensor, GRAPH_END for the output
+static int tensor_lifetime(const GraphLayer *layers, uint16_t layer_num, uint16_t tensor_num,
+                           uint8_t input, uint8_t output, uint16_t *def, uint16_t *last)
+{
+    bool defined[GRAPH_MAX_TENSOR] = {false};
+    uint16_t l = 0;
+
+    if (tensor_num > GRAPH_MAX_TENSOR || input >= tensor_num || output >= tensor_num ||
+        input == output) {
+        return ALGO_DATA_INVALID;
+    }
+
+    for (l = 0; l < tensor_num; l++) {
+        def[l]  = GRAPH_UNUSED;
+        last[l] = 0;
+    }
+
+    defined[input] = true;
+    def[input]     = 0;
+    last[input]    = 0;
+    for (l = 0; l < layer_num; l++) {
+        // every tensor is written once, by a layer after the ones it reads
+        if (layers[l].inp >= tensor_num || layers[l].out >= tensor_num ||
+            !defined[layers[l].inp] || defined[layers[l].out]) {
+            return ALGO_DATA_INVALID;
+        }
+        defined[layers[l].out] = true;
+        def[layers[l].out]     = l;
+        last[layers[l].out]    = l;
+        last[layers[l].inp]    = l;
+    }
+
+    if (!defined[output]) {
+        return ALGO_DATA_INVALID;
+    }
+    last[output] = GRAPH_END(layer_num);
+
+    return ALGO_NORMAL;
+}
+
+static bool overlap(uint32_t a, uint32_t a_size, uint32_t b, uint32_t b_size)
+{
+    return a < b + b_size && b < a + a_size;
+}
+
+int graph_plan(const GraphLayer *layers, uint16_t layer_num, GraphTensor *tensors,
+               uint16_t tensor_num, uint8_t input, uint8_t output, GraphPlanInfo *info)
+{
+    int ret = ALGO_NORMAL;
+    uint16_t def[GRAPH_MAX_TENSOR], last[GRAPH_MAX_TENSOR];
+    uint8_t root[GRAPH_MAX_TENSOR], order[GRAPH_MAX_TENSOR];
+    uint32_t size[GRAPH_MAX_TENSOR];
+    uint16_t i = 0, j = 0, l = 0, buf_num = 0;
+    uint32_t offset = 0;
+    uint8_t t = 0, r = 0;
+    bool moved = false;
+
+    if (!layers || !tensors || !info) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(info, 0, sizeof(GraphPlanInfo));
+    ret = tensor_lifetime(layers, layer_num, tensor_num, input, output, def, last);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    tensors[input].offset = GRAPH_OFFSET_EXTERNAL;
+    for (i = 0; i < tensor_num; i++) {
+        root[i] = (uint8_t)i;
+    }
+
+    for (l = 0; l < layer_num; l++) {
+        ret = layer_shape(&layers[l], &tensors[layers[l].inp], &tensors[layers[l].out]);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+
+        // an element-wise layer overwrites its input when nothing reads it later
+        t = layers[l].inp;
+        r = root[t];
+        if (is_elementwise(layers[l].type) && t != input && last[r] == l) {
+            root[layers[l].out] = r;
+            last[r]             = last[layers[l].out];
+            info->inplace_num++;
+        }
+    }
+
+    for (i = 0; i < tensor_num; i++) {
+        if (i == input || def[i] == GRAPH_UNUSED) {
+            continue;
+        }
+        size[i] = tensor_size(&tensors[i]);
+        info->naive_size += size[i];
+        if (root[i] == i) {
+            order[buf_num++] = (uint8_t)i;
+        }
+    }
+
+    // largest buffers first, they are the hardest to fit into holes
+    for (i = 1; i < buf_num; i++) {
+        t = order[i];
+        for (j = i; j > 0 && size[order[j - 1]] < size[t]; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = t;
+    }
+
+    for (i = 0; i < buf_num; i++) {
+        t      = order[i];
+        offset = 0;
+        do {
+            moved = false;
+            for (j = 0; j < i; j++) {
+                r = order[j];
+                if (def[t] <= last[r] && def[r] <= last[t] &&
+                    overlap(offset, size[t], tensors[r].offset, size[r])) {
+                    offset = tensors[r].offset + size[r];
+                    moved  = true;
+                }
+            }
+        } while (moved);
+
+        tensors[t].offset = offset;
+        if (offset + size[t] > info->arena_size) {
+            info->arena_size = offset + size[t];
+        }
+    }
+
+    for (i = 0; i < tensor_num; i++) {
+        if (i != input && def[i] != GRAPH_UNUSED) {
+            tensors[i].offset = tensors[root[i]].offset;
+        }
+    }
+
+    return ALGO_NORMAL;
+}
+
+int graph_check(const Graph *graph)
+{
+    int ret = ALGO_NORMAL;
+    uint16_t def[GRAPH_MAX_TENSOR], last[GRAPH_MAX_TENSOR];
+    uint16_t l = 0, i = 0;
+    const GraphTensor *out = NULL, *t = NULL;
+    const GraphLayer *layer = NULL;
+    GraphTensor shape;
+
+    if (!graph || !graph->layers || !graph->tensors) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = tensor_lifetime(graph->layers, graph->layer_num, graph->tensor_num, graph->input,
+                          graph->output, def, last);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    if (graph->tensors[graph->input].offset != GRAPH_OFFSET_EXTERNAL) {
+        return ALGO_DATA_INVALID;
+    }
+
+    for (l = 0; l < graph->layer_num; l++) {
+        layer = &graph->layers[l];
+        out   = &graph->tensors[layer->out];
+
+        ret = layer_shape(layer, &graph->tensors[layer->inp], &shape);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+        if (shape.channel != out->channel || shape.row != out->row || shape.col != out->col ||
+            out->offset > graph->arena_size || tensor_size(out) > graph->arena_size - out->offset) {
+            return ALGO_DATA_INVALID;
+        }
+
+        // the output must not clobber a tensor still needed, except the input
+        // of an element-wise layer run in place
+        for (i = 0; i < graph->tensor_num; i++) {
+            t = &graph->tensors[i];
+            if (i == layer->out || i == graph->input || def[i] >= l || last[i] < l ||
+                !overlap(out->offset, tensor_size(out), t->offset, tensor_size(t))) {
+                continue;
+            }
+            if (i == layer->inp && is_elementwise(layer->type) && last[i] == l &&
+                t->offset == out->offset) {
+                continue;
+            }
+            return ALGO_DATA_EXCEPTION;
+        }
+    }
+
+    return ALGO_NORMAL;
+}
+
+static void run_conv2d(const GraphLayer *layer, const GraphTensor *ti, const double *inp,
+                       const GraphTensor *to, double *out)
+{
+    const uint16_t *p = layer->param;
+    const double *w   = layer->tensor[0];
+    const double *b   = layer->tensor[1];
+    uint16_t f = 0, r = 0, c = 0, ch = 0, kr = 0, kc = 0;
+    int32_t ir = 0, ic = 0;
+    double tmp = 0.0;
+
+    for (f = 0; f < to->channel; f++) {
+        for (r = 0; r < to->row; r++) {
+            for (c = 0; c < to->col; c++) {
+                tmp = 0.0;
+                for (ch = 0; ch < ti->channel; ch++) {
+                    for (kr = 0; kr < p[1]; kr++) {
+                        ir = (int32_t)r * p[3] + kr - p[4];
+                        if (ir < 0 || ir >= ti->row) {
+                            continue;
+                        }
+                        for (kc = 0; kc < p[2]; kc++) {
+                            ic = (int32_t)c * p[3] + kc - p[5];
+                            if (ic < 0 || ic >= ti->col) {
+                                continue;
+                            }
+                            tmp += w[((f * ti->channel + ch) * p[1] + kr) * p[2] + kc] *
+                                   inp[(ch * ti->row + ir) * ti->col + ic];
+                        }
+                    }
+                }
+                out[(f * to->row + r) * to->col + c] = b ? tmp + b[f] : tmp;
+            }
+        }
+    }
+}
+
+static void run_batchnorm(const GraphLayer *layer, const GraphTensor *t, const double *inp,
+                          double *out)
+{
+    const double *gamma = layer->tensor[0], *beta = layer->tensor[1];
+    const double *mean = layer->tensor[2], *var = layer->tensor[3];
+    uint32_t plane = (uint32_t)t->row * t->col, i = 0;
+    uint16_t ch    = 0;
+    double scale   = 0.0;
+
+    // same expression as conv2d_bn_no_bias, results are bit exact
+    for (ch = 0; ch < t->channel; ch++) {
+        scale = sqrt(var[ch] + BN_EPS);
+        for (i = ch * plane; i < (ch + 1) * plane; i++) {
+            out[i] = gamma[ch] * (inp[i] - mean[ch]) / scale + beta[ch];
+        }
+    }
+}
+
+static void run_leaky_relu(double alpha, uint32_t size, const double *inp, double *out)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < size; i++) {
+        out[i] = inp[i] < 0 ? alpha * inp[i] : inp[i];
+    }
+}
+
+static void run_linear(const GraphLayer *layer, uint32_t inp_size, const double *inp,
+                       double *out)
+{
+    const double *w = layer->tensor[0];
+    const double *b = layer->tensor[1];
+    uint32_t i = 0, j = 0;
+
+    for (i = 0; i < layer->param[0]; i++) {
+        out[i] = b[i];
+        for (j = 0; j < inp_size; j++) {
+            out[i] += inp[j] * w[i * inp_size + j];
+        }
+    }
+}
+
+static void run_pool1d(const GraphLayer *layer, const GraphTensor *ti, const double *inp,
+                       const GraphTensor *to, double *out)
+{
+    const uint16_t *p = layer->param;
+    uint32_t line = 0, line_num = (uint32_t)ti->channel * ti->row;
+    uint16_t c = 0, k = 0;
+    const double *x = NULL;
+    double acc      = 0.0;
+
+    for (line = 0; line < line_num; line++) {
+        for (c = 0; c < to->col; c++) {
+            x   = inp + line * ti->col + c * p[2];
+            acc = x[0];
+            for (k = 1; k < p[1]; k++) {
+                if (p[0] == GRAPH_POOL_MAX) {
+                    acc = x[k] > acc ? x[k] : acc;
+                } else {
+                    acc += x[k];
+                }
+            }
+            out[line * to->col + c] = p[0] == GRAPH_POOL_MAX ? acc : acc / p[1];
+        }
+    }
+}
+
+static void run_dwconv1d(const GraphLayer *layer, const GraphTensor *ti, const double *inp,
+                         const GraphTensor *to, double *out)
+{
+    const uint16_t *p = layer->param;
+    const double *w   = layer->tensor[0];
+    const double *b   = layer->tensor[1];
+    uint32_t line = 0, line_num = (uint32_t)ti->channel * ti->row;
+    uint16_t c = 0, k = 0, ch = 0;
+    int32_t ic = 0;
+    double tmp = 0.0;
+
+    for (line = 0; line < line_num; line++) {
+        ch = (uint16_t)(line / ti->row);
+        for (c = 0; c < to->col; c++) {
+            tmp = 0.0;
+            for (k = 0; k < p[0]; k++) {
+                ic = (int32_t)c * p[1] + k - p[2];
+                if (ic >= 0 && ic < ti->col) {
+                    tmp += w[ch * p[0] + k] * inp[line * ti->col + ic];
+                }
+            }
+            out[line * to->col + c] = b ? tmp + b[ch] : tmp;
+        }
+    }
+}
+
+int graph_run(const Graph *graph, double *arena, const double *input, const double **output)
+{
+    const GraphLayer *layer = NULL;
+    const GraphTensor *ti = NULL, *to = NULL;
+    const double *inp = NULL;
+    double *out       = NULL;
+    uint16_t l        = 0;
+
+    if (!graph || !arena || !input || !output) {
+        return ALGO_POINTER_NULL;
+    }
+
+    for (l = 0; l < graph->layer_num; l++) {
+        layer = &graph->layers[l];
+        ti    = &graph->tensors[layer->inp];
+        to    = &graph->tensors[layer->out];
+        inp   = ti->offset == GRAPH_OFFSET_EXTERNAL ? input : arena + ti->offset;
+        out   = arena + to->offset;
+
+        switch (layer->type) {
+        case GRAPH_OP_CONV2D:
+            run_conv2d(layer, ti, inp, to, out);
+            break;
+        case GRAPH_OP_BATCHNORM:
+            run_batchnorm(layer, ti, inp, out);
+            break;
+        case GRAPH_OP_LEAKY_RELU:
+            run_leaky_relu(layer->alpha, tensor_size(ti), inp, out);
+            break;
+        case GRAPH_OP_LINEAR:
+            run_linear(layer, tensor_size(ti), inp, out);
+            break;
+        case GRAPH_OP_POOL1D:
+            run_pool1d(layer, ti, inp, to, out);
+            break;
+        case GRAPH_OP_DWCONV1D:
+            run_dwconv1d(layer, ti, inp, to, out);
+            break;
+        default:
+            return ALGO_DATA_INVALID;
+        }
+    }
+
+    *output = arena + graph->tensors[graph->output].offset;
+
+    return ALGO_NORMAL;
+}
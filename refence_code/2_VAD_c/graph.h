@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __GRAPH_H__
+#define __GRAPH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "conv.h"
+#include "algo_error_code.h"
+
+#define GRAPH_MAX_TENSOR      (32)         // tensors of one graph, bounds the planner
+#define GRAPH_TENSOR_REF      (4)          // weight tensors of one layer
+#define GRAPH_LAYER_PARAM     (6)          // integer parameters of one layer
+#define GRAPH_OFFSET_EXTERNAL (0xffffffff) // tensor offset of the graph input, not in the arena
+
+typedef enum _GraphOpType {
+    GRAPH_OP_CONV2D = 1, // tensor: weight, bias or NULL, param: filter_num, kernel_row,
+                         // kernel_col, stride, pad_row, pad_col
+    GRAPH_OP_BATCHNORM,  // tensor: gamma, beta, mean, var, per channel
+    GRAPH_OP_LEAKY_RELU, // alpha: negative slope, 0 for ReLU
+    GRAPH_OP_LINEAR,     // tensor: weight, bias, param: fea_size, the input is flattened
+    GRAPH_OP_POOL1D,     // param: GraphPoolType, kernel, stride, along col
+    GRAPH_OP_DWCONV1D,   // tensor: weight (channel x kernel), bias or NULL, param: kernel,
+                         // stride, pad, depthwise along col
+} GraphOpType;
+
+typedef enum _GraphPoolType {
+    GRAPH_POOL_MAX = 0,
+    GRAPH_POOL_AVG,
+} GraphPoolType;
+
+/**
+ * tensor of the graph, channel x row x col doubles stored channel major
+ */
+typedef struct _GraphTensor {
+    uint16_t channel;
+    uint16_t row;
+    uint16_t col;
+    uint32_t offset; // in doubles from the start of the arena, see graph_plan
+} GraphTensor;
+
+/**
+ * layer descriptor, layers run in table order, every layer has one input
+ * and one output tensor
+ */
+typedef struct _GraphLayer {
+    uint8_t type;                           // GraphOpType
+    uint8_t inp;                            // index of the input tensor
+    uint8_t out;                            // index of the output tensor
+    uint16_t param[GRAPH_LAYER_PARAM];      // integer parameters, see GraphOpType
+    double alpha;                           // float parameter, see GraphOpType
+    const double *tensor[GRAPH_TENSOR_REF]; // weights, see GraphOpType
+} GraphLayer;
+
+/**
+ * planned graph: shapes and arena offsets of all tensors are fixed
+ */
+typedef struct _Graph {
+    const GraphLayer *layers;
+    const GraphTensor *tensors;
+    uint16_t layer_num;
+    uint16_t tensor_num;
+    uint8_t input;       // tensor fed by the caller, GRAPH_OFFSET_EXTERNAL
+    uint8_t output;      // tensor returned by graph_run
+    uint32_t arena_size; // doubles needed by graph_run
+} Graph;
+
+/**
+ * summary of a plan
+ */
+typedef struct _GraphPlanInfo {
+    uint32_t arena_size;  // doubles of the planned arena
+    uint32_t naive_size;  // doubles if every intermediate had its own buffer
+    uint16_t inplace_num; // layers running in place
+} GraphPlanInfo;
+
+/**
+ * @brief offline planner: infer the shapes from the input shape, compute the
+ * lifetime of every intermediate tensor, run element-wise layers in place
+ * when their input dies there, and give every buffer the lowest offset of
+ * the arena not used by a buffer alive at the same time, largest first
+ *
+ * @param[in] layers: layer table
+ * @param[in] layer_num: number of layers
+ * @param[in,out] tensors: tensor_num tensors, the input shape is read, all
+ * shapes and offsets are written
+ * @param[in] tensor_num: number of tensors, at most GRAPH_MAX_TENSOR
+ * @param[in] input: index of the input tensor
+ * @param[in] output: index of the output tensor
+ * @param[out] info: summary of the plan
+ * @return error code
+ */
+int graph_plan(const GraphLayer *layers, uint16_t layer_num, GraphTensor *tensors,
+               uint16_t tensor_num, uint8_t input, uint8_t output, GraphPlanInfo *info);
+
+/**
+ * @brief check a planned graph: shapes of every layer, offsets inside the
+ * arena, and that no tensor is overwritten while it is still needed
+ *
+ * @param[in] graph: planned graph
+ * @return error code
+ */
+int graph_check(const Graph *graph);
+
+/**
+ * @brief run the whole graph on one input, nothing is allocated
+ *
+ * @param[in] graph: checked graph, see graph_check
+ * @param[in] arena: graph->arena_size doubles
+ * @param[in] input: input tensor
+ * @param[out] output: output tensor inside the arena, valid until the next run
+ * @return error code
+ */
+int graph_run(const Graph *graph, double *arena, const double *input, const double **output);
+
+#endif
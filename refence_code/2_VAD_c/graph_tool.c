@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "graph_tool.h"
+#include "vad.h"
+#include "runner.h"
+#include "segment.h"
+#include "smooth.h"
+#include "wav.h"
+
+// larger graph using pooling and depthwise conv, only planned and run once
+#define EXAMPLE_FILTER_NUM (8)
+#define EXAMPLE_TENSOR_NUM (11)
+
+static const double g_example_zero[EXAMPLE_FILTER_NUM * 4] = {0};
+
+static const GraphLayer g_example_layers[] = {
+    {.type = GRAPH_OP_CONV2D, .inp = 0, .out = 1, .param = {EXAMPLE_FILTER_NUM, 1, 4, 2, 0, 0},
+     .tensor = {g_example_zero, NULL}},
+    {.type = GRAPH_OP_BATCHNORM, .inp = 1, .out = 2,
+     .tensor = {g_example_zero, g_example_zero, g_example_zero, g_example_zero}},
+    {.type = GRAPH_OP_LEAKY_RELU, .inp = 2, .out = 3, .alpha = 0.01},
+    {.type = GRAPH_OP_DWCONV1D, .inp = 3, .out = 4, .param = {3, 1, 1},
+     .tensor = {g_example_zero, g_example_zero}},
+    {.type = GRAPH_OP_BATCHNORM, .inp = 4, .out = 5,
+     .tensor = {g_example_zero, g_example_zero, g_example_zero, g_example_zero}},
+    {.type = GRAPH_OP_LEAKY_RELU, .inp = 5, .out = 6, .alpha = 0.0},
+    {.type = GRAPH_OP_POOL1D, .inp = 6, .out = 7, .param = {GRAPH_POOL_MAX, 2, 2}},
+    {.type = GRAPH_OP_DWCONV1D, .inp = 7, .out = 8, .param = {3, 2, 1},
+     .tensor = {g_example_zero, NULL}},
+    {.type = GRAPH_OP_POOL1D, .inp = 8, .out = 9, .param = {GRAPH_POOL_AVG, 30, 30}},
+    {.type = GRAPH_OP_LINEAR, .inp = 9, .out = 10, .param = {2},
+     .tensor = {g_example_zero, g_example_zero}},
+};
+
+static const char *const g_op_name[] = {"",       "conv2d", "batchnorm", "leaky_relu",
+                                        "linear", "pool1d", "dwconv1d"};
+
+static void print_plan(const GraphLayer *layers, uint16_t layer_num, const GraphTensor *tensors,
+                       const GraphPlanInfo *info)
+{
+    uint16_t l          = 0;
+    const GraphTensor *t = NULL;
+
+    for (l = 0; l < layer_num; l++) {
+        t = &tensors[layers[l].out];
+        printf("  %-10s t%u -> t%u: %3u x %u x %3u at %5u%s\n", g_op_name[layers[l].type],
+               layers[l].inp, layers[l].out, t->channel, t->row, t->col, t->offset,
+               tensors[layers[l].inp].offset == t->offset ? " (in place)" : "");
+    }
+    printf("  arena = %u doubles (%zu bytes), without reuse = %u doubles, %u layers in place\n",
+           info->arena_size, info->arena_size * sizeof(double), info->naive_size,
+           info->inplace_num);
+}
+
+static int write_plan(const char *header_dir, const GraphTensor *tensors, uint16_t tensor_num,
+                      const GraphPlanInfo *info)
+{
+    FILE *fp   = fopen(header_dir, "w");
+    uint16_t i = 0;
+
+    if (!fp) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    fprintf(fp, "/*\n"
+                " * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved\n"
+                " *\n"
+                " * Redistribution and use in source and binary forms, with or without\n"
+                " * modification, are permitted provided that the following conditions are met:\n"
+                " *\n"
+                " * 1. Redistributions of source code must retain the above copyright notice,\n"
+                " * this list of conditions and the following disclaimer.\n"
+                " *\n"
+                " * 2. Redistributions in binary form must reproduce the above copyright notice,\n"
+                " * this list of conditions and the following disclaimer in the documentation\n"
+                " * and/or other materials provided with the distribution.\n"
+                " *\n"
+                " * 3. Neither the name of the copyright holder nor the names of its contributors\n"
+                " * may be used to endorse or promote products derived from this software without\n"
+                " * specific prior written permission.\n"
+                " *\n"
+                " * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS \"AS IS\"\n"
+                " * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE\n"
+                " * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE\n"
+                " * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE\n"
+                " * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL\n"
+                " * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR\n"
+                " * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER\n"
+                " * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,\n"
+                " * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE\n"
+                " * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.\n"
+                " */\n\n");
+    fprintf(fp, "#ifndef __VAD_GRAPH_PLAN_H__\n#define __VAD_GRAPH_PLAN_H__\n\n");
+    fprintf(fp, "// generated by ./vad_c graph plan from the layer table of vad.c\n");
+    fprintf(fp, "#define VAD_GRAPH_TENSOR_NUM  (%u)\n", tensor_num);
+    fprintf(fp, "#define VAD_GRAPH_ARENA_SIZE  (%u)\n", info->arena_size);
+    fprintf(fp, "#define VAD_GRAPH_ARENA_BYTES (%zu)\n\n", info->arena_size * sizeof(double));
+    fprintf(fp, "// channel, row, col, offset in doubles\n");
+    fprintf(fp, "#define VAD_GRAPH_TENSORS \\\n    { \\\n");
+    for (i = 0; i < tensor_num; i++) {
+        if (tensors[i].offset == GRAPH_OFFSET_EXTERNAL) {
+            fprintf(fp, "        {%u, %u, %u, GRAPH_OFFSET_EXTERNAL}, \\\n", tensors[i].channel,
+                    tensors[i].row, tensors[i].col);
+        } else {
+            fprintf(fp, "        {%u, %u, %u, %u}, \\\n", tensors[i].channel, tensors[i].row,
+                    tensors[i].col, tensors[i].offset);
+        }
+    }
+    fprintf(fp, "    }\n\n#endif\n");
+
+    return fclose(fp) ? ALGO_IO_EXCEPTION : ALGO_NORMAL;
+}
+
+static int plan_example(void)
+{
+    int ret = ALGO_NORMAL;
+    static double arena[EXAMPLE_FILTER_NUM * FRAME_LEN];
+    double frame[FRAME_LEN] = {0};
+    const double *out       = NULL;
+    GraphTensor tensors[EXAMPLE_TENSOR_NUM];
+    GraphPlanInfo info;
+    Graph graph;
+
+    memset(tensors, 0, sizeof(tensors));
+    tensors[0].channel = 1;
+    tensors[0].row     = 1;
+    tensors[0].col     = FRAME_LEN;
+
+    graph.layers     = g_example_layers;
+    graph.tensors    = tensors;
+    graph.layer_num  = sizeof(g_example_layers) / sizeof(GraphLayer);
+    graph.tensor_num = EXAMPLE_TENSOR_NUM;
+    graph.input      = 0;
+    graph.output     = EXAMPLE_TENSOR_NUM - 1;
+
+    ret = graph_plan(graph.layers, graph.layer_num, tensors, graph.tensor_num, graph.input,
+                     graph.output, &info);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    graph.arena_size = info.arena_size;
+
+    printf("example graph with pooling and depthwise conv:\n");
+    print_plan(graph.layers, graph.layer_num, tensors, &info);
+
+    if (info.arena_size > sizeof(arena) / sizeof(double)) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    ret = graph_check(&graph);
+    if (ret == ALGO_NORMAL) {
+        ret = graph_run(&graph, arena, frame, &out);
+    }
+
+    return ret;
+}
+
+static int plan_vad(const char *header_dir)
+{
+    int ret             = ALGO_NORMAL;
+    uint16_t layer_num  = 0, tensor_num = 0;
+    const GraphLayer *layers = vad_graph_layers(&layer_num, &tensor_num);
+    GraphTensor tensors[GRAPH_MAX_TENSOR];
+    GraphPlanInfo info;
+
+    if (tensor_num > GRAPH_MAX_TENSOR) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    memset(tensors, 0, sizeof(tensors));
+    tensors[0].channel = 1;
+    tensors[0].row     = 1;
+    tensors[0].col     = FRAME_LEN;
+
+    ret = graph_plan(layers, layer_num, tensors, tensor_num, 0, tensor_num - 1, &info);
+    if (ret != ALGO_NORMAL) {
+        printf("plan fail, ret = %d\n", ret);
+        return ret;
+    }
+
+    printf("VAD graph:\n");
+    print_plan(layers, layer_num, tensors, &info);
+    printf("  budget = %d bytes\n", VAD_GRAPH_ARENA_BUDGET);
+    if (info.arena_size * sizeof(double) > VAD_GRAPH_ARENA_BUDGET) {
+        printf("arena over budget, raise VAD_GRAPH_ARENA_BUDGET or shrink the graph\n");
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    ret = write_plan(header_dir, tensors, tensor_num, &info);
+    if (ret != ALGO_NORMAL) {
+        printf("write %s fail\n", header_dir);
+        return ret;
+    }
+    printf("plan written to %s, rebuild to use it\n", header_dir);
+
+    ret = plan_example();
+    if (ret != ALGO_NORMAL) {
+        printf("example graph fail, ret = %d\n", ret);
+    }
+
+    return ret;
+}
+
+static int run_graph_file(const char *wav_dir, const char *pred_dir)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t hop = 0, frame_num = 0, offset = 0, mismatch = 0;
+    uint64_t c0 = 0, c1 = 0, c2 = 0, graph_cycle = 0, cnn_cycle = 0;
+    double margin = 0.0, ref = 0.0;
+    double frame[FRAME_LEN];
+    double arena[VAD_GRAPH_ARENA_SIZE];
+    const Graph *graph    = vad_graph_default();
+    FILE *fp              = NULL;
+    VadSmoothSegment sink = {segment_write_file, NULL, 0};
+    VadSmoother smoother;
+    VadContext ctx;
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    ret = graph_check(graph);
+    if (ret != ALGO_NORMAL) {
+        printf("invalid graph plan, ret = %d, run ./vad_c graph plan vad_graph_plan.h\n", ret);
+        return ret;
+    }
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        return ret;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    fp = fopen(pred_dir, "w");
+    if (!fp) {
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+
+    vad_init(&ctx);
+    sink.param = fp;
+    vad_smooth_init(&smoother, NULL, vad_smooth_segment, &sink);
+    frame_num = cal_frame_num(wav.frames);
+
+    for (hop = 0; hop < frame_num; hop++, offset += FRAME_STEP) {
+        load_frame(&wav, offset, hop == 0, frame);
+
+        c0  = get_cycle();
+        ret = vad_graph_margin(graph, arena, &vad_inp, &margin);
+        c1  = get_cycle();
+        if (ret == ALGO_NORMAL) {
+            ret = vad_margin(&ctx, &vad_inp, &ref);
+        }
+        c2 = get_cycle();
+        if (ret != ALGO_NORMAL) {
+            printf("ret = %d\n", ret);
+            goto exit;
+        }
+
+        graph_cycle += c1 - c0;
+        cnn_cycle += c2 - c1;
+        mismatch += margin != ref;
+        vad_smooth_push(&smoother, margin, offset);
+    }
+    vad_smooth_finish(&smoother, wav.frames);
+
+    printf("hops = %" PRIu64 ", segments = %" PRIu64 ", margins different from vad_margin = %" PRIu64
+           "\n", frame_num, smoother.seg_num, mismatch);
+    printf("arena = %u doubles (%d bytes), graph = %.0f cycles/hop, vad_margin = %.0f cycles/hop\n",
+           graph->arena_size, VAD_GRAPH_ARENA_BYTES,
+           frame_num ? (double)graph_cycle / frame_num : 0.0,
+           frame_num ? (double)cnn_cycle / frame_num : 0.0);
+
+exit:
+    if (fp) {
+        fclose(fp);
+    }
+    wav_close(&wav);
+
+    return ret;
+}
+
+int run_graph_tool(const char *cmd, const char *arg0, const char *arg1)
+{
+    if (!strcmp(cmd, "plan") && arg0) {
+        return plan_vad(arg0);
+    }
+
+    if (!strcmp(cmd, "run") && arg0 && arg1) {
+        return run_graph_file(arg0, arg1);
+    }
+
+    return ALGO_DATA_INVALID;
+}
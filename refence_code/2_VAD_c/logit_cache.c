@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logit_cache.h"
+#include "vad.h"
+
+typedef struct _SegmentBuffer {
+    uint64_t *data;
+    uint64_t size;
+} SegmentBuffer;
+
+int logit_cache_save(const char *file_dir, const LogitCache *cache)
+{
+    FILE *fp = NULL;
+    LogitCacheHeader header;
+
+    if (!file_dir || !cache || (cache->hop_num && !cache->margin)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(&header, 0, sizeof(LogitCacheHeader));
+    header.magic       = LOGIT_CACHE_MAGIC;
+    header.version     = LOGIT_CACHE_VERSION;
+    header.header_size = sizeof(LogitCacheHeader);
+    header.sample_rate = OBJ_FS;
+    header.frame_step  = FRAME_STEP;
+    header.frame_len   = FRAME_LEN;
+    header.data_size   = cache->data_size;
+    header.hop_num     = cache->hop_num;
+
+    fp = fopen(file_dir, "wb");
+    if (!fp) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    if (fwrite(&header, sizeof(LogitCacheHeader), 1, fp) != 1 ||
+        fwrite(cache->margin, sizeof(float), cache->hop_num, fp) != cache->hop_num) {
+        fclose(fp);
+        return ALGO_IO_EXCEPTION;
+    }
+
+    return fclose(fp) ? ALGO_IO_EXCEPTION : ALGO_NORMAL;
+}
+
+int logit_cache_load(const char *file_dir, LogitCache *cache)
+{
+    int ret  = ALGO_NORMAL;
+    FILE *fp = NULL;
+    LogitCacheHeader header;
+
+    if (!file_dir || !cache) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(cache, 0, sizeof(LogitCache));
+
+    fp = fopen(file_dir, "rb");
+    if (!fp) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    if (fread(&header, sizeof(LogitCacheHeader), 1, fp) != 1) {
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+
+    // margins of another model geometry cannot be replayed
+    if (header.magic != LOGIT_CACHE_MAGIC || header.version != LOGIT_CACHE_VERSION ||
+        header.header_size != sizeof(LogitCacheHeader) || header.sample_rate != OBJ_FS ||
+        header.frame_step != FRAME_STEP || header.frame_len != FRAME_LEN) {
+        ret = ALGO_DATA_EXCEPTION;
+        goto exit;
+    }
+
+    cache->margin = (float *)malloc(sizeof(float) * (header.hop_num ? header.hop_num : 1));
+    if (!cache->margin) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    if (fread(cache->margin, sizeof(float), header.hop_num, fp) != header.hop_num) {
+        logit_cache_free(cache);
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+
+    cache->data_size = header.data_size;
+    cache->hop_num   = header.hop_num;
+
+exit:
+    fclose(fp);
+
+    return ret;
+}
+
+void logit_cache_free(LogitCache *cache)
+{
+    free(cache->margin);
+    memset(cache, 0, sizeof(LogitCache));
+}
+
+static void segment_store(void *param, uint64_t start, uint64_t end)
+{
+    SegmentBuffer *buf = (SegmentBuffer *)param;
+
+    buf->data[buf->size++] = start;
+    buf->data[buf->size++] = end;
+}
+
+int logit_cache_replay(const LogitCache *cache, const VadSmoothConfig *smooth,
+                       uint64_t *voice_segment, uint64_t *voice_segment_size)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t i         = 0;
+    SegmentBuffer buf  = {voice_segment, 0};
+    VadSmoothSegment sink = {segment_store, &buf, 0};
+    VadSmoother smoother;
+
+    if (!cache || !voice_segment || !voice_segment_size) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = vad_smooth_init(&smoother, smooth, vad_smooth_segment, &sink);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    for (i = 0; i < cache->hop_num; i++) {
+        vad_smooth_push(&smoother, cache->margin[i], i * FRAME_STEP);
+    }
+    vad_smooth_finish(&smoother, cache->data_size);
+
+    *voice_segment_size = buf.size;
+
+    return ALGO_NORMAL;
+}
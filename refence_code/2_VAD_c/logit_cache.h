@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOGIT_CACHE_H__
+#define __LOGIT_CACHE_H__
+
+#include <stdint.h>
+
+#include "smooth.h"
+#include "algo_error_code.h"
+
+#define LOGIT_CACHE_MAGIC   (0x4c444156) // "VADL" in a little-endian file
+#define LOGIT_CACHE_VERSION (1)
+
+/**
+ * header of a logit cache file, followed by hop_num float32 margins, the
+ * margin of hop i belongs to the frame starting at i * frame_step
+ */
+typedef struct _LogitCacheHeader {
+    uint32_t magic;       // LOGIT_CACHE_MAGIC
+    uint16_t version;     // LOGIT_CACHE_VERSION
+    uint16_t header_size; // sizeof(LogitCacheHeader)
+    uint32_t sample_rate; // OBJ_FS
+    uint32_t frame_step;  // FRAME_STEP
+    uint32_t frame_len;   // FRAME_LEN
+    uint32_t reserved;    // 0
+    uint64_t data_size;   // number of samples of the recording
+    uint64_t hop_num;     // number of margins
+} LogitCacheHeader;
+
+/**
+ * per-hop margins of one recording
+ */
+typedef struct _LogitCache {
+    uint64_t data_size; // number of samples of the recording
+    uint64_t hop_num;   // number of margins
+    float *margin;      // margins, see VadContext.margin
+} LogitCache;
+
+/**
+ * @brief write the margins of a recording to a cache file
+ *
+ * @param[in] file_dir: cache file
+ * @param[in] cache: margins to be written
+ * @return error code
+ */
+int logit_cache_save(const char *file_dir, const LogitCache *cache);
+
+/**
+ * @brief load and validate a cache file
+ *
+ * @param[in] file_dir: cache file
+ * @param[out] cache: loaded margins, release with logit_cache_free
+ * @return error code
+ */
+int logit_cache_load(const char *file_dir, LogitCache *cache);
+
+/**
+ * @brief release the margins of a cache
+ *
+ * @param[in] cache: cache to be released
+ */
+void logit_cache_free(LogitCache *cache);
+
+/**
+ * @brief replay cached margins through the smoother, the segments are the
+ * same as running the VAD with this smoothing configuration
+ *
+ * @param[in] cache: margins of a recording
+ * @param[in] smooth: decision smoothing, NULL: pass-through
+ * @param[out] voice_segment: at least hop_num + 2 entries, 2n: start index,
+ *             2n+1: end index
+ * @param[out] voice_segment_size: number of indices written to voice_segment
+ * @return error code
+ */
+int logit_cache_replay(const LogitCache *cache, const VadSmoothConfig *smooth,
+                       uint64_t *voice_segment, uint64_t *voice_segment_size);
+
+#endif
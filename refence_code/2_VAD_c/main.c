@@ -29,180 +29,313 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/resource.h>
 
 #include "vad.h"
+#include "segment.h"
+#include "runner.h"
+#include "chunk.h"
+#include "stream.h"
+#include "cascade_eval.h"
+#include "sweep.h"
+#include "model_file.h"
+#include "graph_tool.h"
+#include "conv_bench.h"
+#include "temporal_tool.h"
+#include "conv_gemm.h"
+#include "adpcm_tool.h"
+#include "decimate_tool.h"
+#include "qos_tool.h"
+#include "wav.h"
 #include "algo_error_code.h"
 
-#define RAW_FS     (8000)
-#define OBJ_FS     (8000)
-#define FRAME_STEP (120) // 0.015 * 8000
-#define FRAME_LEN  (240) // 0.03 * 8000
+static void usage(const char *prog)
+{
+    printf("usage:\n");
+    printf("  %s file <wav_file> <pred_file> [smooth]\n", prog);
+    printf("      process one wav file and write the voice segments to pred_file\n");
+    printf("  %s stream <wav_file> <pred_file> [smooth]\n", prog);
+    printf("      same as file, in constant memory, segments are written as soon as they close\n");
+    printf("  %s preroll <wav_file> [lookback_ms] [ring_ms] [keep|overwrite] [smooth]\n", prog);
+    printf("      capture the file into a pre-roll ring (default 300 ms, 2048 ms, keep, %s) and\n"
+           "      read every voice segment in place, report the ring counters\n",
+           PREROLL_DEMO_SMOOTH);
+    printf("  %s adpcm <wav_dir>\n", prog);
+    printf("      IMA-ADPCM encode the voice hops of every wav file as uplink packets, report the\n"
+           "      bandwidth, the SNR of the decoded speech and the coder cycles next to the VAD\n");
+    printf("  %s resample <wav_file>\n", prog);
+    printf("      measure the cost per output sample of resampling the file to %d Hz\n", OBJ_FS);
+    printf("  %s dataset <wav_dir> <label_dir> <pred_dir> [thread_num] [smooth]\n", prog);
+    printf("      process all wav files of wav_dir on thread_num workers (default: all cores)\n");
+    printf("  %s gate <wav_dir> <label_dir> <pred_dir> [thread_num] [energy_ratio]\n", prog);
+    printf("      same as dataset with the energy/ZCR pre-gate, report the skip ratio and the\n"
+           "      disagreement with the CNN, energy_ratio sets the gate threshold (default 4)\n");
+    printf("  %s cascade <wav_dir> <label_dir> [stage1_header]\n", prog);
+    printf("      sweep the uncertainty band of the stage 1 / CNN cascade, report CNN share, CPU\n"
+           "      and metrics; with stage1_header fit the stage 1 weights and export them first\n");
+    printf("  %s decimate <wav_dir> <label_dir> [silence_hops] [max_stride] [smooth]\n", prog);
+    printf("      run the VAD at full rate and with the adaptive hop rate (default %d, %d), report\n"
+           "      CNN invocations per second, metrics and onset latency degradation\n",
+           VAD_DECIMATE_SILENCE, VAD_DECIMATE_STRIDE);
+    printf("  %s qos <wav_file> [cpu_pct] [load_pct]\n", prog);
+    printf("      process one wav file under load bursts with and without the QoS controller, the\n"
+           "      VAD takes cpu_pct (default 30) and the bursts load_pct (default 80) of a hop\n");
+    printf("  %s cache <wav_dir> <label_dir> <pred_dir> <cache_dir> [thread_num]\n", prog);
+    printf("      same as dataset, the per-hop margins are also written to cache_dir/<name>.bin\n");
+    printf("  %s sweep <cache_dir> <label_dir> [thread_num] [result_csv]\n", prog);
+    printf("      replay the cached margins through a grid of smoothing configurations and print\n"
+           "      the best ones by segment level F1, result_csv receives every configuration\n");
+    printf("  %s model export <blob_file> [model_id]\n", prog);
+    printf("      write the built-in model to a versioned model blob\n");
+    printf("  %s model run <blob_file> <wav_file> <pred_file>\n", prog);
+    printf("      map the blob, validate it and process one wav file with its model\n");
+    printf("  %s model swap <blob_file> <wav_file> <pred_file>\n", prog);
+    printf("      process one wav file while the blob is received as over the UART, swapped in at\n"
+           "      a hop boundary and rolled back, report the swap latency\n");
+    printf("  %s graph plan <header_file>\n", prog);
+    printf("      plan the arena of the built-in graph and write it to header_file (vad_graph_plan.h)\n");
+    printf("  %s graph run <wav_file> <pred_file>\n", prog);
+    printf("      process one wav file with the graph runtime and compare it with vad_margin\n");
+    printf("  %s convbench [scratch_bytes]\n", prog);
+    printf("      time the direct, im2col + GEMM and tiled conv backends on a set of layer shapes,\n"
+           "      scratch_bytes bounds the automatic selection (default %d)\n", CONV_GEMM_SCRATCH);
+    printf("  %s temporal bench\n", prog);
+    printf("      stream causal dilated convs and a GRU hop by hop, compare them with recomputing\n"
+           "      the whole receptive field every hop\n");
+    printf("  %s temporal run <wav_file> <pred_file> [margin_file]\n", prog);
+    printf("      process one wav file with the streaming model of temporal_parameters.h (build with\n"
+           "      -DVAD_TEMPORAL_MODEL=1), margin_file from 1_VAD_python/export.py is compared\n");
+    printf("  %s chunk <wav_file> <pred_file> [max_thread]\n", prog);
+    printf("      process one wav file split into chunks, report scaling for 1..max_thread\n");
+    printf("  smooth: filter_len,min_speech,min_gap[,on_margin[,off_margin]], durations in hops,\n"
+           "      e.g. 5,4,8,0.5,0.2 (default 1,1,1,0,0: no smoothing)\n");
+}
 
-uint64_t get_rows(char *file_dir)
+static int process_file(const char *wav_file, const char *pred_file, const VadSmoothConfig *smooth)
 {
-    char line[1024];
-    uint64_t i = 0;
-    // FILE *stream = NULL;
-    // fopen_s(&stream, file_dir, "r");
-    FILE *stream = fopen(file_dir, "r");
-    if (stream) {
-        while (fgets(line, 1024, stream)) {
-            i++;
-        }
+    int ret                     = ALGO_NORMAL;
+    uint64_t voice_seg_size     = 0, i = 0;
+    uint64_t *all_voice_segment = NULL;
+    double start = 0.0, startup = 0.0, cost = 0.0;
+    struct rusage usage;
+    VadContext vad_ctx;
+    WavFile wav;
 
-        fclose(stream);
+    // the file is mapped, samples are converted hop by hop while streaming
+    start = get_time_sec();
+    ret   = wav_open(wav_file, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_file, ret);
+        return ret;
     }
-    return i;
-}
 
-void get_data(char *file_dir, double *data_buf)
-{
-    char line[1024];
-    uint64_t i = 0;
-    // FILE *stream = NULL;
-    // fopen_s(&stream, file_dir, "r");
-    FILE *stream = fopen(file_dir, "r");
-    if (stream) {
-        while (fgets(line, 1024, stream)) {
-            data_buf[i] = strtod(line, NULL);
-
-            i++;
-        }
-        fclose(stream);
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+    startup = get_time_sec() - start;
+
+    printf("format = %s, channels = %u, sample rate = %u\n",
+           wav.format == WAV_FORMAT_PCM ? "int16" : "float32", wav.channels, wav.sample_rate);
+    printf("data_size = %" PRIu64 "\n", wav.raw_frames);
+    printf("down_size = %" PRIu64 "\n", wav.frames);
+
+    vad_init(&vad_ctx);
+    start = get_time_sec();
+    ret   = detect_voice_segment(&vad_ctx, &wav, smooth, &all_voice_segment, &voice_seg_size);
+    cost  = get_time_sec() - start;
+    if (ret != ALGO_NORMAL) {
+        printf("ret = %d\n", ret);
+        goto exit;
+    }
+
+    for (i = 0; i < voice_seg_size; i += 2) {
+        printf("%" PRIu64 ", %" PRIu64 "\n", all_voice_segment[i], all_voice_segment[i + 1]);
     }
+
+    ret = save_voice_segment(pred_file, all_voice_segment, voice_seg_size);
+    if (ret != ALGO_NORMAL) {
+        printf("save %s fail\n", pred_file);
+        goto exit;
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf("startup = %.3f ms, process = %.3f ms, peak RSS = %ld KB\n", startup * 1e3,
+           cost * 1e3, usage.ru_maxrss);
+
+exit:
+    free(all_voice_segment);
+    wav_close(&wav);
+
+    return ret;
 }
 
-void downsample(double *raw_data, uint64_t raw_size, uint16_t raw_fs, uint16_t obj_fs, double *out,
-                uint64_t *out_size)
+static int parse_smooth(const char *spec, VadSmoothConfig *smooth)
 {
-    uint16_t interval = raw_fs / obj_fs;
-    uint64_t i        = 0;
-
-    *out_size = 0;
-    for (i = 0; i < raw_size; i += interval) {
-        out[(*out_size)++] = raw_data[i];
+    if (vad_smooth_parse(spec, smooth) != ALGO_NORMAL) {
+        printf("invalid smoothing configuration %s\n", spec);
+        return ALGO_DATA_EXCEPTION;
     }
+
+    return ALGO_NORMAL;
 }
 
-/**
- * voice_segment: 2n: start index, 2n+1:end index
- */
-void cal_voice_segment(int8_t *pred_class, const uint64_t *pred_idx_in_data,
-                       uint64_t pred_class_size, uint64_t raw_data_size, uint64_t *voice_segment,
-                       uint64_t *voice_segment_size)
+int main(int argc, char *argv[])
 {
-    uint64_t i = 0, voice_segment_cnt = 0;
-    int8_t diff_vaule = 0;
-    bool is_start     = true;
+    RunnerConfig config;
+    VadGateConfig gate;
+    VadDecimateConfig decimate;
+    VadSmoothConfig smooth;
 
-    *voice_segment_size = 0;
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
 
-    for (i = 1; i < pred_class_size; i++) {
-        diff_vaule = pred_class[i] - pred_class[i - 1];
+    if (!strcmp(argv[1], "file") && (argc == 4 || argc == 5)) {
+        if (argc == 5 && parse_smooth(argv[4], &smooth) != ALGO_NORMAL) {
+            return 1;
+        }
+        return process_file(argv[2], argv[3], argc == 5 ? &smooth : NULL) == ALGO_NORMAL ? 0 : 1;
+    }
 
-        if (diff_vaule == 1) {
-            voice_segment[voice_segment_cnt++] = pred_idx_in_data[i];
-            is_start                           = false;
+    if (!strcmp(argv[1], "stream") && (argc == 4 || argc == 5)) {
+        if (argc == 5 && parse_smooth(argv[4], &smooth) != ALGO_NORMAL) {
+            return 1;
         }
+        return run_stream_file(argv[2], argv[3], argc == 5 ? &smooth : NULL) == ALGO_NORMAL ? 0
+                                                                                          : 1;
+    }
 
-        if (diff_vaule == -1) {
-            if (is_start) {
-                voice_segment[voice_segment_cnt++] = 0;
-            }
-            voice_segment[voice_segment_cnt++] = pred_idx_in_data[i];
-            is_start                           = true;
+    if (!strcmp(argv[1], "preroll") && argc >= 3 && argc <= 7) {
+        if (parse_smooth(argc == 7 ? argv[6] : PREROLL_DEMO_SMOOTH, &smooth) != ALGO_NORMAL) {
+            return 1;
         }
+        return run_preroll_file(argv[2], &smooth,
+                                argc >= 4 ? (uint32_t)atoi(argv[3]) : 300,
+                                argc >= 5 ? (uint32_t)atoi(argv[4]) : 2048,
+                                argc >= 6 && !strcmp(argv[5], "overwrite") ? PREROLL_OVERWRITE
+                                                                         : PREROLL_KEEP_SEGMENTS) ==
+                       ALGO_NORMAL
+                   ? 0
+                   : 1;
     }
 
-    if (!is_start) {
-        voice_segment[voice_segment_cnt++] = raw_data_size - 1;
+    if (!strcmp(argv[1], "adpcm") && argc == 3) {
+        return run_adpcm_dataset(argv[2]) == ALGO_NORMAL ? 0 : 1;
     }
 
-    *voice_segment_size = voice_segment_cnt;
-}
+    if (!strcmp(argv[1], "resample") && argc == 3) {
+        return run_resample_bench(argv[2]) == ALGO_NORMAL ? 0 : 1;
+    }
 
-int main()
-{
-    char file_dir[] = "./data.txt";
-    FILE *file      = fopen("./pred.txt", "w");
+    if (!strcmp(argv[1], "dataset") && argc >= 5 && argc <= 7) {
+        if (argc == 7 && parse_smooth(argv[6], &smooth) != ALGO_NORMAL) {
+            return 1;
+        }
 
-    int ret            = ALGO_NORMAL;
-    uint64_t data_size = 0, down_size = 0, pred_cnt = 0, i = 0, voice_seg_size = 0;
-    double *total_data       = NULL;
-    bool vad_out             = false;
-    int8_t *total_pred       = NULL;
-    uint64_t *total_pred_idx = NULL, *all_voice_segment = NULL;
+        memset(&config, 0, sizeof(RunnerConfig));
+        config.wav_dir    = argv[2];
+        config.label_dir  = argv[3];
+        config.pred_dir   = argv[4];
+        config.thread_num = argc >= 6 ? atoi(argv[5]) : 0;
+        config.smooth     = argc == 7 ? &smooth : NULL;
 
-    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = NULL};
+        return run_dataset(&config) == ALGO_NORMAL ? 0 : 1;
+    }
 
-    data_size = get_rows(file_dir);
-    printf("data_size = %llu\n", data_size);
+    if (!strcmp(argv[1], "gate") && argc >= 5 && argc <= 7) {
+        vad_gate_default_config(&gate);
+        if (argc == 7) {
+            gate.energy_ratio = atof(argv[6]);
+        }
+
+        memset(&config, 0, sizeof(RunnerConfig));
+        config.wav_dir    = argv[2];
+        config.label_dir  = argv[3];
+        config.pred_dir   = argv[4];
+        config.thread_num = argc >= 6 ? atoi(argv[5]) : 0;
+        config.gate       = &gate;
 
-    total_data = (double *)malloc(sizeof(double) * data_size);
-    if (!total_data) {
-        printf("malloc fail\n");
-        return 0;
+        return run_dataset(&config) == ALGO_NORMAL ? 0 : 1;
     }
 
-    // get data and downsample
-    get_data(file_dir, total_data);
-    downsample(total_data, data_size, RAW_FS, OBJ_FS, total_data, &down_size);
-    printf("down_size = %llu\n", down_size);
+    if (!strcmp(argv[1], "cache") && (argc == 6 || argc == 7)) {
+        memset(&config, 0, sizeof(RunnerConfig));
+        config.wav_dir    = argv[2];
+        config.label_dir  = argv[3];
+        config.pred_dir   = argv[4];
+        config.cache_dir  = argv[5];
+        config.thread_num = argc == 7 ? atoi(argv[6]) : 0;
 
-    total_pred = (int8_t *)malloc(sizeof(int8_t) * ((down_size - FRAME_LEN) / FRAME_STEP + 1));
-    if (!total_pred) {
-        printf("malloc fail\n");
-        goto exit;
+        return run_dataset(&config) == ALGO_NORMAL ? 0 : 1;
     }
-    total_pred_idx =
-        (uint64_t *)malloc(sizeof(uint64_t) * ((down_size - FRAME_LEN) / FRAME_STEP + 1));
-    if (!total_pred_idx) {
-        printf("malloc fail\n");
-        goto exit;
+
+    if (!strcmp(argv[1], "sweep") && argc >= 4 && argc <= 6) {
+        return run_smooth_sweep(argv[2], argv[3], argc >= 5 ? atoi(argv[4]) : 0,
+                                argc == 6 ? argv[5] : NULL) == ALGO_NORMAL
+                   ? 0
+                   : 1;
     }
-    all_voice_segment =
-        (uint64_t *)malloc(sizeof(uint64_t) * ((down_size - FRAME_LEN) / FRAME_STEP + 1));
-    if (!all_voice_segment) {
-        printf("malloc fail\n");
-        goto exit;
+
+    if (!strcmp(argv[1], "model") && argc >= 4 && argc <= 6) {
+        return run_model_tool(argv[2], argv[3], argc >= 5 ? argv[4] : NULL,
+                              argc == 6 ? argv[5] : NULL) == ALGO_NORMAL
+                   ? 0
+                   : 1;
     }
 
-    // streaming audio data, frame by frame
-    for (i = 0; i < down_size; i += FRAME_STEP) {
-        if (i + FRAME_LEN - 1 > down_size) {
-            break;
-        }
+    if (!strcmp(argv[1], "graph") && (argc == 4 || argc == 5)) {
+        return run_graph_tool(argv[2], argv[3], argc == 5 ? argv[4] : NULL) == ALGO_NORMAL ? 0 : 1;
+    }
 
-        vad_inp.data = total_data + i;
+    if (!strcmp(argv[1], "convbench") && (argc == 2 || argc == 3)) {
+        return run_conv_bench(argc == 3 ? (size_t)atol(argv[2]) : CONV_GEMM_SCRATCH) == ALGO_NORMAL
+                   ? 0
+                   : 1;
+    }
+
+    if (!strcmp(argv[1], "temporal") && argc >= 3 && argc <= 6) {
+        return run_temporal_tool(argv[2], argc >= 4 ? argv[3] : NULL, argc >= 5 ? argv[4] : NULL,
+                                 argc == 6 ? argv[5] : NULL) == ALGO_NORMAL
+                   ? 0
+                   : 1;
+    }
 
-        ret = vad(&vad_inp, &vad_out);
-        if (ret != ALGO_NORMAL) {
-            printf("ret = %d\n", ret);
-            goto exit;
+    if (!strcmp(argv[1], "decimate") && argc >= 4 && argc <= 7) {
+        if (argc == 7 && parse_smooth(argv[6], &smooth) != ALGO_NORMAL) {
+            return 1;
         }
+        decimate.silence_hops = argc >= 5 ? (uint32_t)atoi(argv[4]) : VAD_DECIMATE_SILENCE;
+        decimate.max_stride   = argc >= 6 ? (uint32_t)atoi(argv[5]) : VAD_DECIMATE_STRIDE;
 
-        total_pred[pred_cnt]       = (int8_t)vad_out;
-        total_pred_idx[pred_cnt++] = i;
+        return run_decimate_eval(argv[2], argv[3], &decimate, argc == 7 ? &smooth : NULL) ==
+                       ALGO_NORMAL
+                   ? 0
+                   : 1;
     }
 
-    // calaulate voice segments
-    cal_voice_segment(total_pred, total_pred_idx, pred_cnt, down_size, all_voice_segment,
-                      &voice_seg_size);
+    if (!strcmp(argv[1], "qos") && argc >= 3 && argc <= 5) {
+        return run_qos_sim(argv[2], argc >= 4 ? (uint32_t)atoi(argv[3]) : 30,
+                           argc == 5 ? (uint32_t)atoi(argv[4]) : 80) == ALGO_NORMAL
+                   ? 0
+                   : 1;
+    }
 
-    // save the results to a file
-    if (file) {
-        for (i = 0; i < voice_seg_size; i += 2) {
-            printf("%llu, %llu\n", all_voice_segment[i],all_voice_segment[i+1]);
-            fprintf(file, "%llu, %llu\n", all_voice_segment[i], all_voice_segment[i + 1]);
-        }
+    if (!strcmp(argv[1], "cascade") && (argc == 4 || argc == 5)) {
+        return run_cascade_eval(argv[2], argv[3], argc == 5 ? argv[4] : NULL) == ALGO_NORMAL ? 0 : 1;
     }
-    fclose(file);
 
-exit:
-    free(total_data);
-    free(total_pred);
-    free(total_pred_idx);
-    free(all_voice_segment);
+    if (!strcmp(argv[1], "chunk") && (argc == 4 || argc == 5)) {
+        return run_chunk_scaling(argv[2], argv[3], argc == 5 ? atoi(argv[4]) : 0) == ALGO_NORMAL
+                   ? 0
+                   : 1;
+    }
+
+    usage(argv[0]);
 
-    return 0;
+    return 1;
 }
\ No newline at end of file
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+
+#include "model_blob.h"
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) / (a) * (a))
+
+// conv2d weight, BN gamma/beta/mean/var, linear weight/bias
+#define VAD_BLOB_TENSOR_NUM (7)
+#define VAD_BLOB_LAYER_NUM  (4)
+
+static const uint32_t g_crc_nibble[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4,
+    0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+static const uint8_t g_dtype_size[] = {8, 4, 2, 1};
+
+uint32_t model_blob_crc(uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    size_t i         = 0;
+
+    // 16 entry table, small enough for the flash and fast enough for a few KB
+    crc = ~crc;
+    for (i = 0; i < size; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ g_crc_nibble[crc & 0xf];
+        crc = (crc >> 4) ^ g_crc_nibble[crc & 0xf];
+    }
+
+    return ~crc;
+}
+
+// CRC of the blob with the crc field of the header read as 0
+static uint32_t blob_crc(const uint8_t *base, uint32_t blob_size)
+{
+    const uint32_t zero = 0;
+    const size_t pos    = offsetof(ModelBlobHeader, crc);
+    uint32_t crc        = 0;
+
+    crc = model_blob_crc(crc, base, pos);
+    crc = model_blob_crc(crc, &zero, sizeof(zero));
+    crc = model_blob_crc(crc, base + pos + sizeof(zero), blob_size - pos - sizeof(zero));
+
+    return crc;
+}
+
+static int check_table(uint32_t offset, uint32_t num, uint32_t entry_size, uint32_t blob_size)
+{
+    if (offset % 4 || offset < sizeof(ModelBlobHeader) || offset > blob_size ||
+        (uint64_t)num * entry_size > blob_size - offset) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+int model_blob_load(const void *data, size_t size, ModelBlob *blob)
+{
+    const ModelBlobHeader *header = (const ModelBlobHeader *)data;
+    const ModelBlobTensor *tensor = NULL;
+    const ModelBlobLayer *layer   = NULL;
+    uint32_t i = 0, j = 0;
+    uint64_t end = 0;
+
+    if (!data || !blob) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(blob, 0, sizeof(ModelBlob));
+
+    if ((uintptr_t)data % MODEL_BLOB_ALIGN) {
+        return ALGO_DATA_INVALID;
+    }
+
+    if (size < sizeof(ModelBlobHeader) || header->magic != MODEL_BLOB_MAGIC) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    if (header->version_major != MODEL_BLOB_VERSION_MAJOR ||
+        header->header_size != sizeof(ModelBlobHeader) || header->blob_size > size ||
+        header->blob_size < sizeof(ModelBlobHeader)) {
+        return ALGO_DATA_INVALID;
+    }
+
+    if (blob_crc((const uint8_t *)data, header->blob_size) != header->crc) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    if (check_table(header->layer_offset, header->layer_num, sizeof(ModelBlobLayer),
+                    header->blob_size) != ALGO_NORMAL ||
+        check_table(header->tensor_offset, header->tensor_num, sizeof(ModelBlobTensor),
+                    header->blob_size) != ALGO_NORMAL) {
+        return ALGO_DATA_INVALID;
+    }
+
+    blob->base    = (const uint8_t *)data;
+    blob->header  = header;
+    blob->layers  = (const ModelBlobLayer *)(blob->base + header->layer_offset);
+    blob->tensors = (const ModelBlobTensor *)(blob->base + header->tensor_offset);
+
+    for (i = 0; i < header->tensor_num; i++) {
+        tensor = &blob->tensors[i];
+        if (tensor->dtype >= sizeof(g_dtype_size) || tensor->offset % MODEL_BLOB_ALIGN) {
+            return ALGO_DATA_INVALID;
+        }
+        end = tensor->offset + (uint64_t)tensor->count * g_dtype_size[tensor->dtype];
+        if (tensor->offset < sizeof(ModelBlobHeader) || end > header->blob_size) {
+            return ALGO_DATA_INVALID;
+        }
+    }
+
+    for (i = 0; i < header->layer_num; i++) {
+        layer = &blob->layers[i];
+        if (layer->tensor_num > MODEL_BLOB_TENSOR_REF) {
+            return ALGO_DATA_INVALID;
+        }
+        for (j = 0; j < layer->tensor_num; j++) {
+            if (layer->tensor[j] >= header->tensor_num) {
+                return ALGO_DATA_INVALID;
+            }
+        }
+    }
+
+    return ALGO_NORMAL;
+}
+
+const void *model_blob_tensor(const ModelBlob *blob, uint16_t idx)
+{
+    return blob->base + blob->tensors[idx].offset;
+}
+
+static void add_tensor(uint8_t *data, ModelBlobTensor *tensor, uint32_t *offset,
+                       const double *value, uint32_t count)
+{
+    tensor->offset = *offset;
+    tensor->count  = count;
+    tensor->dtype  = MODEL_DTYPE_F64;
+    tensor->scale  = 1.0f;
+    if (data) {
+        memcpy(data + *offset, value, sizeof(double) * count);
+    }
+    *offset = ALIGN_UP(*offset + sizeof(double) * count, MODEL_BLOB_ALIGN);
+}
+
+int model_blob_write(const VadModel *model, uint32_t model_id, void *data, size_t size,
+                     uint32_t *blob_size)
+{
+    int ret          = ALGO_NORMAL;
+    uint8_t *base    = (uint8_t *)data;
+    uint32_t offset  = 0;
+    uint32_t out_len = 0;
+    ModelBlobHeader header;
+    ModelBlobLayer layers[VAD_BLOB_LAYER_NUM];
+    ModelBlobTensor tensors[VAD_BLOB_TENSOR_NUM];
+
+    if (!model || !blob_size) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = vad_model_check(model);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memset(layers, 0, sizeof(layers));
+    memset(tensors, 0, sizeof(tensors));
+
+    header.layer_offset  = sizeof(ModelBlobHeader);
+    header.tensor_offset = header.layer_offset + sizeof(layers);
+    offset               = ALIGN_UP(header.tensor_offset + sizeof(tensors), MODEL_BLOB_ALIGN);
+
+    out_len = model->linear.inp_size;
+    if (data) {
+        // the size is known before anything is written
+        model_blob_write(model, model_id, NULL, 0, blob_size);
+        if (size < *blob_size || (uintptr_t)data % MODEL_BLOB_ALIGN) {
+            return ALGO_DATA_TOO_MANY;
+        }
+        memset(data, 0, *blob_size);
+    }
+
+    add_tensor(base, &tensors[0], &offset, model->filter.data,
+               model->filter.filter_num * model->filter.channel * model->filter.row *
+                   model->filter.col);
+    add_tensor(base, &tensors[1], &offset, model->bn.gamma, model->bn.size);
+    add_tensor(base, &tensors[2], &offset, model->bn.beta, model->bn.size);
+    add_tensor(base, &tensors[3], &offset, model->bn.mean, model->bn.size);
+    add_tensor(base, &tensors[4], &offset, model->bn.var, model->bn.size);
+    add_tensor(base, &tensors[5], &offset, model->linear.weight, out_len * model->linear.fea_size);
+    add_tensor(base, &tensors[6], &offset, model->linear.bias, model->linear.fea_size);
+
+    layers[0].type       = MODEL_LAYER_CONV2D;
+    layers[0].tensor_num = 1;
+    layers[0].tensor[0]  = 0;
+    layers[0].param[0]   = model->filter.channel;
+    layers[0].param[1]   = model->filter.row;
+    layers[0].param[2]   = model->filter.col;
+    layers[0].param[3]   = model->filter.filter_num;
+    layers[0].param[4]   = model->conv.stride;
+    layers[0].param[5]   = model->conv.pad;
+
+    layers[1].type       = MODEL_LAYER_BATCHNORM;
+    layers[1].tensor_num = 4;
+    layers[1].tensor[0]  = 1;
+    layers[1].tensor[1]  = 2;
+    layers[1].tensor[2]  = 3;
+    layers[1].tensor[3]  = 4;
+    layers[1].param[0]   = model->bn.size;
+
+    layers[2].type  = MODEL_LAYER_LEAKY_RELU;
+    layers[2].alpha = model->neg_slope;
+
+    layers[3].type       = MODEL_LAYER_LINEAR;
+    layers[3].tensor_num = 2;
+    layers[3].tensor[0]  = 5;
+    layers[3].tensor[1]  = 6;
+    layers[3].param[0]   = model->linear.inp_size;
+    layers[3].param[1]   = model->linear.fea_size;
+
+    header.magic         = MODEL_BLOB_MAGIC;
+    header.version_major = MODEL_BLOB_VERSION_MAJOR;
+    header.version_minor = MODEL_BLOB_VERSION_MINOR;
+    header.header_size   = sizeof(ModelBlobHeader);
+    header.blob_size     = offset;
+    header.model_id      = model_id;
+    header.layer_num     = VAD_BLOB_LAYER_NUM;
+    header.tensor_num    = VAD_BLOB_TENSOR_NUM;
+    header.sample_rate   = OBJ_FS;
+    header.frame_len     = model->frame_len;
+    header.frame_step    = FRAME_STEP;
+    header.output_num    = model->linear.fea_size;
+
+    *blob_size = offset;
+    if (!data) {
+        return ALGO_NORMAL;
+    }
+
+    memcpy(base + header.layer_offset, layers, sizeof(layers));
+    memcpy(base + header.tensor_offset, tensors, sizeof(tensors));
+    memcpy(base, &header, sizeof(header));
+    header.crc = blob_crc(base, header.blob_size);
+    memcpy(base, &header, sizeof(header));
+
+    return ALGO_NORMAL;
+}
+
+// tensor idx of the layer as float64 with count elements
+static double *layer_tensor(const ModelBlob *blob, const ModelBlobLayer *layer, uint16_t idx,
+                            uint32_t count)
+{
+    const ModelBlobTensor *tensor = NULL;
+
+    if (idx >= layer->tensor_num) {
+        return NULL;
+    }
+
+    tensor = &blob->tensors[layer->tensor[idx]];
+    if (tensor->dtype != MODEL_DTYPE_F64 || tensor->count != count) {
+        return NULL;
+    }
+
+    // the runtime works on double, the data is only read
+    return (double *)model_blob_tensor(blob, layer->tensor[idx]);
+}
+
+int vad_model_from_blob(VadModel *model, const ModelBlob *blob)
+{
+    static const uint16_t topology[VAD_BLOB_LAYER_NUM] = {
+        MODEL_LAYER_CONV2D, MODEL_LAYER_BATCHNORM, MODEL_LAYER_LEAKY_RELU, MODEL_LAYER_LINEAR};
+    const ModelBlobLayer *layers = NULL;
+    uint32_t i = 0, filter_size = 0;
+
+    if (!model || !blob || !blob->header) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(model, 0, sizeof(VadModel));
+
+    if (blob->header->layer_num != VAD_BLOB_LAYER_NUM || blob->header->sample_rate != OBJ_FS ||
+        blob->header->frame_step != FRAME_STEP || blob->header->output_num != 2) {
+        return ALGO_DATA_INVALID;
+    }
+
+    layers = blob->layers;
+    for (i = 0; i < VAD_BLOB_LAYER_NUM; i++) {
+        if (layers[i].type != topology[i]) {
+            return ALGO_DATA_INVALID;
+        }
+    }
+
+    model->filter.channel    = layers[0].param[0];
+    model->filter.row        = layers[0].param[1];
+    model->filter.col        = layers[0].param[2];
+    model->filter.filter_num = layers[0].param[3];
+    model->conv.stride       = layers[0].param[4];
+    model->conv.pad          = layers[0].param[5];
+    filter_size = (uint32_t)model->filter.channel * model->filter.row * model->filter.col *
+                  model->filter.filter_num;
+    model->filter.data = layer_tensor(blob, &layers[0], 0, filter_size);
+
+    model->bn.size  = layers[1].param[0];
+    model->bn.gamma = layer_tensor(blob, &layers[1], 0, model->bn.size);
+    model->bn.beta  = layer_tensor(blob, &layers[1], 1, model->bn.size);
+    model->bn.mean  = layer_tensor(blob, &layers[1], 2, model->bn.size);
+    model->bn.var   = layer_tensor(blob, &layers[1], 3, model->bn.size);
+
+    model->neg_slope = layers[2].alpha;
+
+    model->linear.inp_size = layers[3].param[0];
+    model->linear.fea_size = layers[3].param[1];
+    model->linear.weight   = layer_tensor(blob, &layers[3], 0,
+                                          (uint32_t)model->linear.inp_size * model->linear.fea_size);
+    model->linear.bias     = layer_tensor(blob, &layers[3], 1, model->linear.fea_size);
+
+    model->conv.filter = &model->filter;
+    model->conv.bn     = &model->bn;
+    model->frame_len   = blob->header->frame_len;
+    model->model_id    = blob->header->model_id;
+
+    return vad_model_check(model);
+}
+
+#if defined(__riscv)
+extern const uint8_t __vad_model_start[];
+extern const uint8_t __vad_model_size[];
+
+void model_blob_partition(const void **data, size_t *size)
+{
+    *data = __vad_model_start;
+    *size = (size_t)__vad_model_size;
+}
+#endif
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MODEL_BLOB_H__
+#define __MODEL_BLOB_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "vad.h"
+#include "algo_error_code.h"
+
+#define MODEL_BLOB_MAGIC         (0x4d444156) // "VADM" in a little-endian blob
+#define MODEL_BLOB_VERSION_MAJOR (1)          // readers reject other major versions
+#define MODEL_BLOB_VERSION_MINOR (0)          // compatible additions
+#define MODEL_BLOB_ALIGN         (16)         // alignment of the blob and of every tensor
+#define MODEL_BLOB_TENSOR_REF    (4)          // tensors referenced by one layer
+#define MODEL_BLOB_LAYER_PARAM   (6)          // integer parameters of one layer
+
+/**
+ * Layout of a model blob, all fields little-endian:
+ *
+ *   ModelBlobHeader
+ *   ModelBlobLayer[layer_num]   at layer_offset
+ *   ModelBlobTensor[tensor_num] at tensor_offset
+ *   tensor data, every tensor at a MODEL_BLOB_ALIGN aligned offset
+ *
+ * The CRC-32 covers the whole blob with the crc field set to 0. The loader
+ * only validates and points into the blob, so the blob must stay mapped as
+ * long as a model bound to it is used.
+ */
+typedef struct _ModelBlobHeader {
+    uint32_t magic;         // MODEL_BLOB_MAGIC
+    uint16_t version_major; // MODEL_BLOB_VERSION_MAJOR
+    uint16_t version_minor; // MODEL_BLOB_VERSION_MINOR
+    uint32_t header_size;   // sizeof(ModelBlobHeader)
+    uint32_t blob_size;     // total size in bytes
+    uint32_t crc;           // CRC-32 (IEEE 802.3) of the blob with this field 0
+    uint32_t model_id;      // version of the weights, chosen by the exporter
+    uint16_t layer_num;     // entries of the layer table
+    uint16_t tensor_num;    // entries of the tensor table
+    uint32_t layer_offset;  // offset of the layer table
+    uint32_t tensor_offset; // offset of the tensor table
+    uint32_t sample_rate;   // sample rate of the input
+    uint16_t frame_len;     // samples per frame
+    uint16_t frame_step;    // samples per hop
+    uint16_t output_num;    // number of output logits
+    uint16_t reserved;      // 0
+} ModelBlobHeader;
+
+typedef enum _ModelDtype {
+    MODEL_DTYPE_F64 = 0, // double
+    MODEL_DTYPE_F32,     // float
+    MODEL_DTYPE_Q15,     // int16, value = q * scale
+    MODEL_DTYPE_Q7,      // int8, value = q * scale
+} ModelDtype;
+
+typedef enum _ModelLayerType {
+    MODEL_LAYER_CONV2D = 1, // tensor: weight, param: channel, row, col, filter_num, stride, pad
+    MODEL_LAYER_BATCHNORM,  // tensor: gamma, beta, mean, var, param: size
+    MODEL_LAYER_LEAKY_RELU, // alpha: negative slope
+    MODEL_LAYER_LINEAR,     // tensor: weight, bias, param: inp_size, fea_size
+} ModelLayerType;
+
+/**
+ * entry of the tensor table
+ */
+typedef struct _ModelBlobTensor {
+    uint32_t offset;   // offset of the data, multiple of MODEL_BLOB_ALIGN
+    uint32_t count;    // number of elements
+    uint8_t dtype;     // ModelDtype
+    int8_t frac_bits;  // fractional bits of the fixed-point types, 0 otherwise
+    uint16_t reserved; // 0
+    float scale;       // dequantization scale, 1 for the float types
+} ModelBlobTensor;
+
+/**
+ * entry of the layer table, layers run in table order
+ */
+typedef struct _ModelBlobLayer {
+    uint16_t type;                           // ModelLayerType
+    uint16_t tensor_num;                     // tensors used in tensor
+    uint16_t tensor[MODEL_BLOB_TENSOR_REF];  // indices in the tensor table
+    uint16_t param[MODEL_BLOB_LAYER_PARAM];  // integer parameters, see ModelLayerType
+    double alpha;                            // float parameter, see ModelLayerType
+} ModelBlobLayer;
+
+/**
+ * validated view of a blob, all pointers point into the blob
+ */
+typedef struct _ModelBlob {
+    const uint8_t *base;
+    const ModelBlobHeader *header;
+    const ModelBlobLayer *layers;
+    const ModelBlobTensor *tensors;
+} ModelBlob;
+
+/**
+ * @brief calculate the CRC-32 (IEEE 802.3, reflected, init and xorout
+ * 0xffffffff) of a buffer, crc chains several buffers starting from 0
+ *
+ * @param[in] crc: CRC of the previous buffers, 0 for the first one
+ * @param[in] data: buffer
+ * @param[in] size: size of the buffer
+ * @return CRC of all buffers so far
+ */
+uint32_t model_blob_crc(uint32_t crc, const void *data, size_t size);
+
+/**
+ * @brief validate a blob in place: magic, version, sizes, CRC, table and
+ * tensor bounds, alignment and layer references. Nothing is copied.
+ *
+ * @param[in] data: blob, MODEL_BLOB_ALIGN aligned
+ * @param[in] size: bytes available at data, at least the blob size
+ * @param[out] blob: view of the blob
+ * @return error code
+ */
+int model_blob_load(const void *data, size_t size, ModelBlob *blob);
+
+/**
+ * @brief get the data of a tensor
+ *
+ * @param[in] blob: loaded blob
+ * @param[in] idx: index in the tensor table
+ * @return data inside the blob
+ */
+const void *model_blob_tensor(const ModelBlob *blob, uint16_t idx);
+
+/**
+ * @brief serialize a VAD model into a blob
+ *
+ * @param[in] model: model to be serialized
+ * @param[in] model_id: version of the weights stored in the header
+ * @param[out] data: MODEL_BLOB_ALIGN aligned buffer, NULL to get the size only
+ * @param[in] size: size of the buffer
+ * @param[out] blob_size: size of the blob
+ * @return error code
+ */
+int model_blob_write(const VadModel *model, uint32_t model_id, void *data, size_t size,
+                     uint32_t *blob_size);
+
+/**
+ * @brief bind a VAD model to the tensors of a loaded blob, the layer table
+ * must hold conv2d, batchnorm, leaky_relu and linear with float64 tensors,
+ * and the shapes must fit the VAD context
+ *
+ * @param[out] model: model pointing into the blob, must not be copied
+ * @param[in] blob: loaded blob
+ * @return error code
+ */
+int vad_model_from_blob(VadModel *model, const ModelBlob *blob);
+
+#if defined(__riscv)
+/**
+ * @brief get the model partition of the flash, reserved by the linker script
+ * as __vad_model_start / __vad_model_size and written separately from the
+ * firmware image
+ *
+ * @param[out] data: start of the partition, memory mapped
+ * @param[out] size: size of the partition
+ */
+void model_blob_partition(const void **data, size_t *size);
+#endif
+
+#endif
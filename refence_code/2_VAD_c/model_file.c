@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "model_file.h"
+#include "model_swap.h"
+#include "runner.h"
+#include "segment.h"
+#include "smooth.h"
+
+int model_file_open(const char *file_dir, ModelFile *file)
+{
+    int ret = ALGO_NORMAL, fd = -1;
+    struct stat st;
+
+    memset(file, 0, sizeof(ModelFile));
+
+    fd = open(file_dir, O_RDONLY);
+    if (fd < 0) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return ALGO_IO_EXCEPTION;
+    }
+
+    // page aligned, so the tensors keep their alignment
+    file->map_size = (size_t)st.st_size;
+    file->map      = mmap(NULL, file->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file->map == MAP_FAILED) {
+        file->map = NULL;
+        return ALGO_IO_EXCEPTION;
+    }
+
+    ret = model_blob_load(file->map, file->map_size, &file->blob);
+    if (ret == ALGO_NORMAL) {
+        ret = vad_model_from_blob(&file->model, &file->blob);
+    }
+    if (ret != ALGO_NORMAL) {
+        model_file_close(file);
+    }
+
+    return ret;
+}
+
+void model_file_close(ModelFile *file)
+{
+    if (file->map) {
+        munmap(file->map, file->map_size);
+    }
+    memset(file, 0, sizeof(ModelFile));
+}
+
+int model_file_save(const char *file_dir, const VadModel *model, uint32_t model_id)
+{
+    int ret            = ALGO_NORMAL;
+    uint32_t blob_size = 0;
+    void *data         = NULL;
+    FILE *fp           = NULL;
+
+    ret = model_blob_write(model, model_id, NULL, 0, &blob_size);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    data = aligned_alloc(MODEL_BLOB_ALIGN, blob_size);
+    if (!data) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    ret = model_blob_write(model, model_id, data, blob_size, &blob_size);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    fp = fopen(file_dir, "wb");
+    if (!fp) {
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+    if (fwrite(data, 1, blob_size, fp) != blob_size) {
+        ret = ALGO_IO_EXCEPTION;
+    }
+    if (fclose(fp)) {
+        ret = ALGO_IO_EXCEPTION;
+    }
+
+exit:
+    free(data);
+
+    return ret;
+}
+
+static int run_blob_file(const char *blob_dir, const char *wav_dir, const char *pred_dir)
+{
+    int ret           = ALGO_NORMAL;
+    uint64_t seg_size = 0;
+    uint64_t *seg     = NULL;
+    double start = 0.0, load = 0.0, cost = 0.0;
+    ModelFile file;
+    VadContext ctx;
+    WavFile wav;
+
+    start = get_time_sec();
+    ret   = model_file_open(blob_dir, &file);
+    load  = get_time_sec() - start;
+    if (ret != ALGO_NORMAL) {
+        printf("load %s fail, ret = %d\n", blob_dir, ret);
+        return ret;
+    }
+
+    printf("blob: %u bytes, version %u.%u, model id %u, %u layers, %u tensors, crc %08x\n",
+           file.blob.header->blob_size, file.blob.header->version_major,
+           file.blob.header->version_minor, file.blob.header->model_id,
+           file.blob.header->layer_num, file.blob.header->tensor_num, file.blob.header->crc);
+    printf("frame_len = %u, filters = %u, kernel = %ux%u, stride = %u, linear = %u -> %u\n",
+           file.model.frame_len, file.model.filter.filter_num, file.model.filter.row,
+           file.model.filter.col, file.model.conv.stride, file.model.linear.inp_size,
+           file.model.linear.fea_size);
+    printf("zero-copy: weights at %p inside the mapping %p, load = %.3f us\n",
+           (void *)file.model.linear.weight, file.map, load * 1e6);
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        goto close_model;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    vad_init(&ctx);
+    ret = vad_set_model(&ctx, &file.model);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    start = get_time_sec();
+    ret   = detect_voice_segment(&ctx, &wav, NULL, &seg, &seg_size);
+    cost  = get_time_sec() - start;
+    if (ret != ALGO_NORMAL) {
+        printf("ret = %d\n", ret);
+        goto exit;
+    }
+
+    ret = save_voice_segment(pred_dir, seg, seg_size);
+    printf("segments = %" PRIu64 ", process = %.3f ms\n", seg_size / 2, cost * 1e3);
+
+exit:
+    free(seg);
+    wav_close(&wav);
+close_model:
+    model_file_close(&file);
+
+    return ret;
+}
+
+// bytes a 115200 baud 8N1 UART delivers during one hop
+#define SWAP_UART_BAUD     (115200)
+#define SWAP_BYTES_PER_HOP (SWAP_UART_BAUD / 10 * FRAME_STEP / OBJ_FS)
+
+/**
+ * simulated host sending blobs over the UART while the VAD runs, the
+ * schedule is relative to the number of hops of the file
+ */
+typedef struct _SwapSender {
+    const uint8_t *data; // blob being sent
+    uint32_t left;       // bytes still to be sent
+    uint64_t start_hop;  // hop where the transfer started
+} SwapSender;
+
+static void swap_print_hop(const ModelSwap *swap, uint64_t hop, const char *what)
+{
+    printf("hop %6" PRIu64 ": %s, active model id %u (slot %u), rollback model id %u\n", hop, what,
+           model_swap_model_id(swap, swap->active), swap->active,
+           model_swap_model_id(swap, swap->previous));
+}
+
+static int run_blob_swap(const char *blob_dir, const char *wav_dir, const char *pred_dir)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t hop = 0, frame_num = 0, offset = 0, c0 = 0, poll_cycle = 0;
+    uint32_t blob_size = 0, n = 0, rollback_cnt = 0;
+    bool ready = false, is_voice = false;
+    uint8_t *corrupt   = NULL;
+    double frame[FRAME_LEN];
+    FILE *fp              = NULL;
+    ModelSwap *swap       = NULL;
+    VadSmoothSegment sink = {segment_write_file, NULL, 0};
+    SwapSender tx         = {NULL, 0, 0};
+    VadSmoother smoother;
+    ModelFile file;
+    VadContext ctx;
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    ret = model_file_open(blob_dir, &file);
+    if (ret != ALGO_NORMAL) {
+        printf("load %s fail, ret = %d\n", blob_dir, ret);
+        return ret;
+    }
+    blob_size = file.blob.header->blob_size;
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        goto close_model;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    // the store is static on the target, its size is what the firmware reserves
+    swap    = (ModelSwap *)aligned_alloc(MODEL_BLOB_ALIGN, sizeof(ModelSwap));
+    corrupt = (uint8_t *)malloc(blob_size);
+    fp      = fopen(pred_dir, "w");
+    if (!swap || !corrupt || !fp) {
+        ret = !fp ? ALGO_IO_EXCEPTION : ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    // same blob with one weight bit flipped, must be refused by the CRC
+    memcpy(corrupt, file.map, blob_size);
+    corrupt[blob_size - 1] ^= 0x10;
+
+    model_swap_init(swap);
+    vad_init(&ctx);
+    sink.param = fp;
+    vad_smooth_init(&smoother, NULL, vad_smooth_segment, &sink);
+    frame_num = cal_frame_num(wav.frames);
+    printf("model store: %zu bytes, %d slots of %d bytes, blob %u bytes, UART %d baud: %d bytes/hop\n",
+           sizeof(ModelSwap), MODEL_SWAP_SLOT_NUM, MODEL_SWAP_SLOT_SIZE, blob_size, SWAP_UART_BAUD,
+           SWAP_BYTES_PER_HOP);
+
+    for (hop = 0; hop < frame_num; hop++, offset += FRAME_STEP) {
+        // schedule: corrupted blob, blob, rollback, blob again
+        if (!tx.left && (hop == frame_num / 8 || hop == frame_num / 4 || hop == frame_num * 3 / 4)) {
+            tx.data      = hop == frame_num / 8 ? corrupt : (const uint8_t *)file.map;
+            tx.left      = blob_size;
+            tx.start_hop = hop;
+        }
+
+        // UART task: bytes received during the previous hop
+        if (tx.left) {
+            n   = tx.left < SWAP_BYTES_PER_HOP ? tx.left : SWAP_BYTES_PER_HOP;
+            ret = model_swap_feed(swap, tx.data + (blob_size - tx.left), n, &ready);
+            tx.left -= n;
+            if (ret != ALGO_NORMAL) {
+                printf("hop %6" PRIu64 ": blob refused after %" PRIu64 " hops, ret = %d\n", hop,
+                       hop - tx.start_hop + 1, ret);
+            } else if (ready) {
+                printf("hop %6" PRIu64 ": blob verified after %" PRIu64 " hops\n", hop,
+                       hop - tx.start_hop + 1);
+            }
+        }
+
+        if (hop == frame_num / 2) {
+            model_swap_rollback(swap);
+        }
+
+        // VAD task: hop boundary
+        rollback_cnt = swap->stats.rollback_cnt;
+        c0           = get_cycle();
+        if (model_swap_apply(swap, &ctx)) {
+            poll_cycle += get_cycle() - c0;
+            swap_print_hop(swap, hop, swap->stats.rollback_cnt != rollback_cnt ? "rollback" : "swap");
+        } else {
+            poll_cycle += get_cycle() - c0;
+        }
+
+        load_frame(&wav, offset, hop == 0, frame);
+        ret = vad_process(&ctx, &vad_inp, &is_voice);
+        if (ret != ALGO_NORMAL) {
+            printf("ret = %d\n", ret);
+            goto exit;
+        }
+        vad_smooth_push(&smoother, ctx.margin, offset);
+    }
+    vad_smooth_finish(&smoother, wav.frames);
+
+    printf("hops = %" PRIu64 " / %" PRIu64 ", segments = %" PRIu64 "\n", hop, frame_num,
+           smoother.seg_num);
+    printf("rx: ok %u, rejected %u, corrupt %u, busy %u; swaps %u, rollbacks %u\n",
+           swap->stats.rx_ok, swap->stats.rx_reject, swap->stats.rx_corrupt, swap->stats.rx_busy,
+           swap->stats.swap_cnt, swap->stats.rollback_cnt);
+    printf("swap latency: %" PRIu64 " cycles queued -> applied, switch %" PRIu64
+           " cycles (max %" PRIu64 "), hop boundary poll %.1f cycles/hop\n",
+           swap->stats.wait_cycle, swap->stats.switch_cycle, swap->stats.max_switch_cycle,
+           frame_num ? (double)poll_cycle / frame_num : 0.0);
+
+exit:
+    if (fp) {
+        fclose(fp);
+    }
+    free(corrupt);
+    free(swap);
+    wav_close(&wav);
+close_model:
+    model_file_close(&file);
+
+    return ret;
+}
+
+int run_model_tool(const char *cmd, const char *blob_dir, const char *arg0, const char *arg1)
+{
+    int ret           = ALGO_NORMAL;
+    uint32_t model_id = arg0 ? (uint32_t)strtoul(arg0, NULL, 0) : 1;
+
+    if (!strcmp(cmd, "export")) {
+        ret = model_file_save(blob_dir, vad_model_default(), model_id);
+        if (ret != ALGO_NORMAL) {
+            printf("export %s fail, ret = %d\n", blob_dir, ret);
+        } else {
+            printf("built-in model written to %s, model id %u\n", blob_dir, model_id);
+        }
+        return ret;
+    }
+
+    if (!strcmp(cmd, "run") && arg0 && arg1) {
+        return run_blob_file(blob_dir, arg0, arg1);
+    }
+
+    if (!strcmp(cmd, "swap") && arg0 && arg1) {
+        return run_blob_swap(blob_dir, arg0, arg1);
+    }
+
+    return ALGO_DATA_INVALID;
+}
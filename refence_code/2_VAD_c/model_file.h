@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MODEL_FILE_H__
+#define __MODEL_FILE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "model_blob.h"
+#include "algo_error_code.h"
+
+/**
+ * model blob mapped from a file on the host, the model points into the mapping
+ */
+typedef struct _ModelFile {
+    void *map;       // read-only mapping of the file
+    size_t map_size; // size of the mapping
+    ModelBlob blob;  // validated view of the mapping
+    VadModel model;  // bound to the tensors of the mapping
+} ModelFile;
+
+/**
+ * @brief map a model blob file, validate it and bind the VAD model to it
+ * without copying the weights
+ *
+ * @param[in] file_dir: blob file
+ * @param[out] file: mapped model, release with model_file_close
+ * @return error code
+ */
+int model_file_open(const char *file_dir, ModelFile *file);
+
+/**
+ * @brief unmap a model blob file, the model must not be used any more
+ *
+ * @param[in] file: mapped model
+ */
+void model_file_close(ModelFile *file);
+
+/**
+ * @brief write a VAD model to a blob file
+ *
+ * @param[in] file_dir: blob file
+ * @param[in] model: model to be written
+ * @param[in] model_id: version of the weights stored in the header
+ * @return error code
+ */
+int model_file_save(const char *file_dir, const VadModel *model, uint32_t model_id);
+
+/**
+ * @brief export the built-in model to a blob, process a wav file with
+ * the model of a blob and report the load time, or process a wav file
+ * while the blob is sent to a model store as over the UART and swapped in
+ *
+ * @param[in] cmd: "export", "run" or "swap"
+ * @param[in] blob_dir: blob file
+ * @param[in] arg0: export: model id, NULL for 1; run, swap: wav file
+ * @param[in] arg1: run, swap: prediction file
+ * @return error code
+ */
+int run_model_tool(const char *cmd, const char *blob_dir, const char *arg0, const char *arg1);
+
+#endif
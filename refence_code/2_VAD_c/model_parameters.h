@@ -30,13 +30,15 @@
 #ifndef __MODEL_PARAMTERS_H__
 #define __MODEL_PARAMTERS_H__
 
-double model_0_weight[]       = {-0.4110013544559479, 0.4321620762348175, 0.46948981285095215,
-                                 0.07727497816085815};
-double model_1_weight[]       = {1.010745882987976, 1.0044375658035278};
-double model_1_bias[]         = {-0.03729663044214249, -0.02120954357087612};
-double model_1_running_mean[] = {0.36687085032463074, 37.16026306152344};
-double model_1_running_var[]  = {342638.96875, 2683335.5};
-double output_weight[]        = {
+#include "vad_section.h"
+
+VAD_CONV_WEIGHT const double model_0_weight[]     = {-0.4110013544559479, 0.4321620762348175, 0.46948981285095215,
+                                                     0.07727497816085815};
+VAD_BN_WEIGHT const double model_1_weight[]       = {1.010745882987976, 1.0044375658035278};
+VAD_BN_WEIGHT const double model_1_bias[]         = {-0.03729663044214249, -0.02120954357087612};
+VAD_BN_WEIGHT const double model_1_running_mean[] = {0.36687085032463074, 37.16026306152344};
+VAD_BN_WEIGHT const double model_1_running_var[]  = {342638.96875, 2683335.5};
+VAD_LINEAR_WEIGHT const double output_weight[]    = {
     -0.034273210912942886, -0.03562238812446594,   0.0023779855109751225,  -0.03877288103103638,
     0.012178100645542145,  0.046531084924936295,   0.016453346237540245,   0.012718947604298592,
     -0.061607725918293,    0.002857519779354334,   -0.021006649360060692,  0.03292247653007507,
@@ -157,6 +159,6 @@ double output_weight[]        = {
     0.009398171678185463,  0.029665034264326096,   0.03046344220638275,    -0.02347378246486187,
     -0.017339598387479782, -0.006043325178325176,  0.020301302894949913,   -0.006983851082623005,
     -0.000492327322717756, -0.020886868238449097,  0.005699229426681995,   -0.015321595594286919};
-double output_bias[] = {0.02413875423371792, -0.06324564665555954};
+VAD_LINEAR_WEIGHT const double output_bias[] = {0.02413875423371792, -0.06324564665555954};
 
 #endif
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "model_swap.h"
+
+#define SLOT_STATE(swap, idx) (&(swap)->slot[idx].state)
+
+// the RISC-V firmware runs in machine mode, the host build uses the TSC
+static uint64_t swap_cycle(void)
+{
+#if defined(__riscv) && __riscv_xlen == 32
+    uint32_t hi = 0, lo = 0, hi2 = 0;
+
+    do {
+        __asm__ volatile("csrr %0, mcycleh" : "=r"(hi));
+        __asm__ volatile("csrr %0, mcycle" : "=r"(lo));
+        __asm__ volatile("csrr %0, mcycleh" : "=r"(hi2));
+    } while (hi != hi2);
+
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__riscv)
+    uint64_t cycle = 0;
+
+    __asm__ volatile("rdcycle %0" : "=r"(cycle));
+
+    return cycle;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)clock();
+#endif
+}
+
+static bool slot_cas(ModelSwap *swap, uint8_t idx, uint32_t from, uint32_t to)
+{
+    return __atomic_compare_exchange_n(SLOT_STATE(swap, idx), &from, to, false, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+}
+
+void model_swap_init(ModelSwap *swap)
+{
+    uint8_t i = 0;
+
+    memset(&swap->rx_header, 0, sizeof(ModelBlobHeader));
+    memset(&swap->stats, 0, sizeof(ModelSwapStats));
+    for (i = 0; i < MODEL_SWAP_SLOT_NUM; i++) {
+        swap->slot[i].state = MODEL_SLOT_FREE;
+    }
+
+    swap->rx_pos      = 0;
+    swap->rx_skip     = 0;
+    swap->rx_slot     = MODEL_SWAP_NONE;
+    swap->pending     = MODEL_SWAP_NONE;
+    swap->rollback    = 0;
+    swap->active      = MODEL_SWAP_BUILTIN;
+    swap->previous    = MODEL_SWAP_NONE;
+    swap->ready_cycle = 0;
+}
+
+// reject early what cannot run in this VAD context, before any slot is taken
+static int check_header(const ModelBlobHeader *header)
+{
+    if (header->version_major != MODEL_BLOB_VERSION_MAJOR ||
+        header->header_size != sizeof(ModelBlobHeader) ||
+        header->blob_size < sizeof(ModelBlobHeader)) {
+        return ALGO_DATA_INVALID;
+    }
+
+    if (header->blob_size > MODEL_SWAP_SLOT_SIZE) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    if (header->sample_rate != OBJ_FS || header->frame_len != FRAME_LEN ||
+        header->frame_step != FRAME_STEP || header->output_num != 2) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+// a free slot first, the rollback target only if there is none
+static uint8_t claim_slot(ModelSwap *swap)
+{
+    uint8_t i = 0;
+
+    // one swap at a time: the queued slot must reach the context first
+    if (__atomic_load_n(&swap->pending, __ATOMIC_ACQUIRE) != MODEL_SWAP_NONE) {
+        return MODEL_SWAP_NONE;
+    }
+
+    for (i = 0; i < MODEL_SWAP_SLOT_NUM; i++) {
+        if (slot_cas(swap, i, MODEL_SLOT_FREE, MODEL_SLOT_RECEIVING)) {
+            return i;
+        }
+    }
+
+    for (i = 0; i < MODEL_SWAP_SLOT_NUM; i++) {
+        if (slot_cas(swap, i, MODEL_SLOT_PREVIOUS, MODEL_SLOT_RECEIVING)) {
+            return i;
+        }
+    }
+
+    return MODEL_SWAP_NONE;
+}
+
+static int verify_slot(ModelSwapSlot *slot, uint32_t blob_size)
+{
+    int ret = ALGO_NORMAL;
+
+    ret = model_blob_load(slot->data, blob_size, &slot->blob);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    // topology and shapes, the model points into the slot
+    return vad_model_from_blob(&slot->model, &slot->blob);
+}
+
+// the header is complete: check it and move it into a slot
+static int start_blob(ModelSwap *swap)
+{
+    int ret      = ALGO_NORMAL;
+    uint32_t len = sizeof(ModelBlobHeader);
+
+    swap->rx_pos = 0;
+
+    ret = check_header(&swap->rx_header);
+    if (ret == ALGO_NORMAL) {
+        swap->rx_slot = claim_slot(swap);
+        if (swap->rx_slot == MODEL_SWAP_NONE) {
+            ret = ALGO_ERR_GENERIC;
+        }
+    }
+
+    if (ret != ALGO_NORMAL) {
+        if (ret == ALGO_ERR_GENERIC) {
+            swap->stats.rx_busy++;
+        } else {
+            swap->stats.rx_reject++;
+        }
+        // drop the body of a refused blob instead of scanning it for a magic
+        if (swap->rx_header.blob_size >= len && swap->rx_header.blob_size <= MODEL_SWAP_SLOT_SIZE) {
+            swap->rx_skip = swap->rx_header.blob_size - len;
+        }
+        return ret;
+    }
+
+    memcpy(swap->slot[swap->rx_slot].data, &swap->rx_header, len);
+    swap->rx_pos = len;
+
+    return ALGO_NORMAL;
+}
+
+// the blob is complete: verify it and queue it for the next hop boundary
+static int finish_blob(ModelSwap *swap)
+{
+    int ret             = ALGO_NORMAL;
+    uint8_t idx         = swap->rx_slot;
+    ModelSwapSlot *slot = &swap->slot[idx];
+
+    swap->rx_slot = MODEL_SWAP_NONE;
+    swap->rx_pos  = 0;
+
+    ret = verify_slot(slot, swap->rx_header.blob_size);
+    if (ret != ALGO_NORMAL) {
+        swap->stats.rx_corrupt++;
+        __atomic_store_n(&slot->state, MODEL_SLOT_FREE, __ATOMIC_RELEASE);
+        return ret;
+    }
+
+    swap->stats.rx_ok++;
+    swap->ready_cycle = swap_cycle();
+    __atomic_store_n(&slot->state, MODEL_SLOT_READY, __ATOMIC_RELEASE);
+    __atomic_store_n(&swap->pending, idx, __ATOMIC_RELEASE);
+
+    return ALGO_NORMAL;
+}
+
+int model_swap_feed(ModelSwap *swap, const void *data, size_t size, bool *ready)
+{
+    int ret          = ALGO_NORMAL, err = ALGO_NORMAL;
+    const uint8_t *p = (const uint8_t *)data;
+    uint8_t *header  = NULL;
+    uint32_t n = 0, magic_byte = 0;
+    size_t i   = 0;
+
+    if (ready) {
+        *ready = false;
+    }
+
+    if (!swap || (!data && size)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    header = (uint8_t *)&swap->rx_header;
+    while (i < size) {
+        if (swap->rx_skip) {
+            n = size - i < swap->rx_skip ? (uint32_t)(size - i) : swap->rx_skip;
+            swap->rx_skip -= n;
+            i += n;
+            continue;
+        }
+
+        if (swap->rx_slot == MODEL_SWAP_NONE) {
+            // header: resynchronize on the little-endian magic byte by byte
+            if (swap->rx_pos < sizeof(uint32_t)) {
+                magic_byte = (MODEL_BLOB_MAGIC >> (8 * swap->rx_pos)) & 0xff;
+                if (p[i] != magic_byte) {
+                    swap->rx_pos = 0;
+                    if (p[i] != (MODEL_BLOB_MAGIC & 0xff)) {
+                        i++;
+                        continue;
+                    }
+                }
+            }
+
+            header[swap->rx_pos++] = p[i++];
+            if (swap->rx_pos == sizeof(ModelBlobHeader)) {
+                err = start_blob(swap);
+                ret = err != ALGO_NORMAL ? err : ret;
+            }
+            continue;
+        }
+
+        n = swap->rx_header.blob_size - swap->rx_pos;
+        n = size - i < n ? (uint32_t)(size - i) : n;
+        memcpy(swap->slot[swap->rx_slot].data + swap->rx_pos, p + i, n);
+        swap->rx_pos += n;
+        i += n;
+
+        if (swap->rx_pos == swap->rx_header.blob_size) {
+            err = finish_blob(swap);
+            if (err != ALGO_NORMAL) {
+                ret = err;
+            } else if (ready) {
+                *ready = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+void model_swap_rx_reset(ModelSwap *swap)
+{
+    if (swap->rx_slot != MODEL_SWAP_NONE) {
+        __atomic_store_n(SLOT_STATE(swap, swap->rx_slot), MODEL_SLOT_FREE, __ATOMIC_RELEASE);
+    }
+
+    swap->rx_slot = MODEL_SWAP_NONE;
+    swap->rx_pos  = 0;
+    swap->rx_skip = 0;
+}
+
+void model_swap_rollback(ModelSwap *swap)
+{
+    __atomic_store_n(&swap->rollback, 1, __ATOMIC_RELEASE);
+}
+
+static const VadModel *slot_model(const ModelSwap *swap, uint8_t idx)
+{
+    return idx == MODEL_SWAP_BUILTIN ? vad_model_default() : &swap->slot[idx].model;
+}
+
+// make target the model of the context, the active one becomes the rollback target
+static void switch_model(ModelSwap *swap, VadContext *ctx, uint8_t target)
+{
+    uint8_t old = swap->active;
+
+    // the slot was verified when it was received, this is a pointer store
+    vad_set_model(ctx, slot_model(swap, target));
+
+    if (old < MODEL_SWAP_SLOT_NUM) {
+        __atomic_store_n(SLOT_STATE(swap, old), MODEL_SLOT_PREVIOUS, __ATOMIC_RELEASE);
+    }
+    swap->previous = old;
+    swap->active   = target;
+}
+
+bool model_swap_apply(ModelSwap *swap, VadContext *ctx)
+{
+    bool changed   = false;
+    uint8_t idx    = MODEL_SWAP_NONE, prev = MODEL_SWAP_NONE;
+    uint64_t start = 0, cycle = 0;
+
+    idx = __atomic_exchange_n(&swap->pending, MODEL_SWAP_NONE, __ATOMIC_ACQUIRE);
+    if (idx != MODEL_SWAP_NONE) {
+        start = swap_cycle();
+        prev  = swap->previous;
+        __atomic_store_n(SLOT_STATE(swap, idx), MODEL_SLOT_ACTIVE, __ATOMIC_RELEASE);
+        switch_model(swap, ctx, idx);
+        // the rollback target moves to the model just replaced, its slot is free again
+        if (prev < MODEL_SWAP_SLOT_NUM) {
+            slot_cas(swap, prev, MODEL_SLOT_PREVIOUS, MODEL_SLOT_FREE);
+        }
+        cycle = swap_cycle() - start;
+
+        swap->stats.swap_cnt++;
+        swap->stats.wait_cycle   = start - swap->ready_cycle;
+        swap->stats.switch_cycle = cycle;
+        if (cycle > swap->stats.max_switch_cycle) {
+            swap->stats.max_switch_cycle = cycle;
+        }
+        changed = true;
+    }
+
+    if (__atomic_exchange_n(&swap->rollback, 0, __ATOMIC_ACQUIRE)) {
+        idx = swap->previous;
+        // the receiver may have taken the slot, the built-in model is always there
+        if (idx < MODEL_SWAP_SLOT_NUM && !slot_cas(swap, idx, MODEL_SLOT_PREVIOUS, MODEL_SLOT_ACTIVE)) {
+            idx = MODEL_SWAP_BUILTIN;
+        }
+        if (idx != MODEL_SWAP_NONE && idx != swap->active) {
+            switch_model(swap, ctx, idx);
+            swap->stats.rollback_cnt++;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+uint32_t model_swap_model_id(const ModelSwap *swap, uint8_t idx)
+{
+    if (idx == MODEL_SWAP_NONE) {
+        return 0;
+    }
+
+    return slot_model(swap, idx)->model_id;
+}
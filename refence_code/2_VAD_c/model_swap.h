@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MODEL_SWAP_H__
+#define __MODEL_SWAP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "vad.h"
+#include "model_blob.h"
+#include "algo_error_code.h"
+
+#define MODEL_SWAP_SLOT_NUM  (2)    // RAM slots, the built-in model is always available
+#define MODEL_SWAP_SLOT_SIZE (6144) // largest blob accepted, the built-in model is 4240 bytes
+#define MODEL_SWAP_BUILTIN   (MODEL_SWAP_SLOT_NUM) // slot index of the built-in model
+#define MODEL_SWAP_NONE      (0xff)
+
+/**
+ * owner of a RAM slot. The receiver only takes FREE or PREVIOUS slots, the
+ * VAD side only uses READY, ACTIVE and PREVIOUS ones. The contested
+ * PREVIOUS -> RECEIVING / PREVIOUS -> ACTIVE transitions are compare and
+ * swap, so no lock is needed between the two sides.
+ */
+typedef enum _ModelSlotState {
+    MODEL_SLOT_FREE = 0,  // unused
+    MODEL_SLOT_RECEIVING, // written by the receiver
+    MODEL_SLOT_READY,     // verified, waiting for the next hop boundary
+    MODEL_SLOT_ACTIVE,    // used by the VAD context
+    MODEL_SLOT_PREVIOUS,  // rollback target
+} ModelSlotState;
+
+typedef struct _ModelSwapSlot {
+    uint8_t data[MODEL_SWAP_SLOT_SIZE] __attribute__((aligned(MODEL_BLOB_ALIGN)));
+    ModelBlob blob;
+    VadModel model; // bound to data, valid from READY on
+    uint32_t state; // ModelSlotState
+} ModelSwapSlot;
+
+/**
+ * counters of the service, the rx_ fields are written by the receiver and
+ * the others at the hop boundary
+ */
+typedef struct _ModelSwapStats {
+    uint32_t rx_ok;        // blobs verified and queued
+    uint32_t rx_reject;    // headers refused: version or shape not compatible
+    uint32_t rx_corrupt;   // blobs refused: CRC, tables or layers
+    uint32_t rx_busy;      // blobs refused: no slot, a swap was still pending
+    uint32_t swap_cnt;     // models switched at a hop boundary
+    uint32_t rollback_cnt; // rollbacks applied
+    uint64_t wait_cycle;   // last swap: cycles from verification to the hop boundary
+    uint64_t switch_cycle; // last swap: cycles spent in the switch itself
+    uint64_t max_switch_cycle;
+} ModelSwapStats;
+
+/**
+ * Double-buffered model store of one VAD context. The receiver (UART task)
+ * fills an inactive slot and queues it, the VAD task calls model_swap_apply
+ * between two hops, which switches the model pointer of the context. Nothing
+ * is allocated, the slots live in the struct.
+ *
+ * With two slots the previous received model stays the rollback target until
+ * the next reception needs its slot, the rollback then goes to the built-in
+ * model.
+ */
+typedef struct _ModelSwap {
+    ModelSwapSlot slot[MODEL_SWAP_SLOT_NUM];
+    ModelBlobHeader rx_header; // header of the blob being received
+    uint32_t rx_pos;           // bytes of the blob received
+    uint32_t rx_skip;          // bytes of a refused blob still to be dropped
+    uint32_t pending;          // slot queued for the next hop boundary, MODEL_SWAP_NONE if none
+    uint32_t rollback;         // rollback requested
+    uint8_t rx_slot;           // slot being written, MODEL_SWAP_NONE while in the header
+    uint8_t active;            // slot used by the context, MODEL_SWAP_BUILTIN at start
+    uint8_t previous;          // rollback target, MODEL_SWAP_NONE at start
+    uint64_t ready_cycle;      // cycle counter when pending was queued
+    ModelSwapStats stats;
+} ModelSwap;
+
+/**
+ * @brief initialize the model store, the built-in model is active
+ *
+ * @param[out] swap: model store
+ */
+void model_swap_init(ModelSwap *swap);
+
+/**
+ * @brief feed bytes received from the host. A transfer is one model blob,
+ * bytes before a blob magic are skipped. The header is checked for version and
+ * shape as soon as it is complete, the whole blob is verified (CRC, tables,
+ * topology, shapes) in the slot, then queued for the next hop boundary.
+ *
+ * @param[in] swap: model store
+ * @param[in] data: received bytes
+ * @param[in] size: number of bytes
+ * @param[out] ready: set to true when a blob was queued, may be NULL
+ * @return ALGO_NORMAL, or the error of the last transfer refused in these
+ * bytes, the receiver is then waiting for the next blob
+ */
+int model_swap_feed(ModelSwap *swap, const void *data, size_t size, bool *ready);
+
+/**
+ * @brief drop a partially received blob, e.g. after an idle timeout
+ *
+ * @param[in] swap: model store
+ */
+void model_swap_rx_reset(ModelSwap *swap);
+
+/**
+ * @brief request a rollback to the previous model at the next hop boundary
+ *
+ * @param[in] swap: model store
+ */
+void model_swap_rollback(ModelSwap *swap);
+
+/**
+ * @brief apply the queued model or rollback, to be called by the VAD task
+ * between two hops. O(1), no allocation, the hop in flight always completes
+ * with the model it started with.
+ *
+ * @param[in] swap: model store
+ * @param[in] ctx: VAD context using the store
+ * @return true if the model of the context changed
+ */
+bool model_swap_apply(ModelSwap *swap, VadContext *ctx);
+
+/**
+ * @brief get the model id of a slot
+ *
+ * @param[in] swap: model store
+ * @param[in] idx: slot index or MODEL_SWAP_BUILTIN
+ * @return model id, 0 for the built-in model
+ */
+uint32_t model_swap_model_id(const ModelSwap *swap, uint8_t idx);
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+
+#include "preroll.h"
+
+// positions are modulo 2^32, a - b is the signed distance
+#define POS_DIFF(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+int preroll_init(PreRoll *pr, int16_t *buf, uint32_t size, const PreRollConfig *config)
+{
+    if (!pr || !buf || !config) {
+        return ALGO_POINTER_NULL;
+    }
+
+    // power of 2 up to 2^30, so that distances stay positive int32_t
+    if (!size || (size & (size - 1)) || size > (1u << 30) || config->lookback >= size) {
+        return ALGO_DATA_INVALID;
+    }
+
+    memset(pr, 0, sizeof(PreRoll));
+    pr->buf    = buf;
+    pr->size   = size;
+    pr->config = *config;
+
+    return ALGO_NORMAL;
+}
+
+/*
+ * samples of a referenced segment in [lo, lo + len), the open end of a
+ * segment is the head the writer is about to reach
+ */
+static uint32_t seg_overlap(const PreRollSeg *seg, uint32_t lo, uint32_t len, uint32_t head)
+{
+    int32_t from = POS_DIFF(seg->start + __atomic_load_n(&seg->floor, __ATOMIC_ACQUIRE), lo);
+    int32_t to   = POS_DIFF(seg->closed ? seg->end : head, lo);
+
+    from = from < 0 ? 0 : from;
+    to   = to > (int32_t)len ? (int32_t)len : to;
+
+    return to > from ? (uint32_t)(to - from) : 0;
+}
+
+static uint32_t write_chunk(PreRoll *pr, const int16_t *pcm, uint32_t len)
+{
+    uint32_t mask = pr->size - 1, head = pr->head;
+    uint32_t room = 0, held = 0, lo = 0, over = 0, lost = 0, n = 0, i;
+    PreRollSeg *seg = NULL;
+
+    // the oldest samples referenced and not released bound what may be overwritten
+    room = pr->size;
+    for (i = 0; i < PREROLL_SEG_NUM; i++) {
+        seg = &pr->seg[i];
+        if (!__atomic_load_n(&seg->ref, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        lo = seg->start + __atomic_load_n(&seg->floor, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&seg->closed, __ATOMIC_ACQUIRE) && POS_DIFF(seg->end, lo) <= 0) {
+            continue; // all released
+        }
+        held = POS_DIFF(head, lo) < 0 ? 0 : (uint32_t)POS_DIFF(head, lo);
+        held = held < pr->size ? held : pr->size;
+        if (held > pr->stats.peak_held) {
+            pr->stats.peak_held = held;
+        }
+        room = pr->size - held < room ? pr->size - held : room;
+    }
+
+    if (pr->config.policy == PREROLL_KEEP_SEGMENTS && len > room) {
+        pr->stats.dropped += len - room;
+        len = room;
+    }
+
+    // samples pushed out of the ring: [tail, tail + over)
+    over = (uint32_t)POS_DIFF(head + len, pr->tail);
+    over = over > pr->size ? over - pr->size : 0;
+    if (over) {
+        for (i = 0; i < PREROLL_SEG_NUM; i++) {
+            seg = &pr->seg[i];
+            if (!__atomic_load_n(&seg->ref, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            n = seg_overlap(seg, pr->tail, over, head + len);
+            if (n && !seg->overrun) {
+                seg->overrun = true;
+                pr->stats.seg_overrun++;
+            }
+            lost = n > lost ? n : lost;
+        }
+        pr->stats.overwritten += lost;
+
+        // readers check the tail after reading, it moves before the samples change
+        __atomic_store_n(&pr->tail, pr->tail + over, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    n = pr->size - (head & mask);
+    n = n < len ? n : len;
+    memcpy(pr->buf + (head & mask), pcm, sizeof(int16_t) * n);
+    memcpy(pr->buf, pcm + n, sizeof(int16_t) * (len - n));
+
+    __atomic_store_n(&pr->head, head + len, __ATOMIC_RELEASE);
+    pr->stats.written += len;
+
+    return len;
+}
+
+uint32_t preroll_write(PreRoll *pr, const int16_t *pcm, uint32_t len)
+{
+    uint32_t stored = 0, chunk = 0, n = 0;
+
+    // a chunk never wraps over itself
+    while (len) {
+        chunk = len < pr->size ? len : pr->size;
+        n     = write_chunk(pr, pcm, chunk);
+        stored += n;
+        if (n < chunk) {
+            pr->stats.dropped += len - chunk;
+            break;
+        }
+        pcm += chunk;
+        len -= chunk;
+    }
+
+    return stored;
+}
+
+PreRollSeg *preroll_seg_open(PreRoll *pr, uint64_t onset)
+{
+    uint32_t pos = (uint32_t)(onset - pr->stats.dropped), start = 0, used = 1, i;
+    PreRollSeg *seg = NULL, *free_seg = NULL;
+
+    // an onset not captured yet starts at the head
+    if (POS_DIFF(pr->head, pos) < 0) {
+        pos = pr->head;
+    }
+    start = pos - pr->config.lookback;
+    if (POS_DIFF(start, pr->tail) < 0) {
+        start = pr->tail;
+    }
+
+    for (i = 0; i < PREROLL_SEG_NUM; i++) {
+        seg = &pr->seg[i];
+        if (__atomic_load_n(&seg->ref, __ATOMIC_ACQUIRE)) {
+            used++;
+        } else if (!free_seg) {
+            free_seg = seg;
+        }
+    }
+    if (!free_seg) {
+        pr->stats.seg_fail++;
+        return NULL;
+    }
+
+    seg          = free_seg;
+    seg->start   = start;
+    seg->end     = start;
+    seg->closed  = 0;
+    seg->floor   = 0;
+    seg->overrun = false;
+    __atomic_store_n(&seg->ref, 1, __ATOMIC_RELEASE);
+    pr->stats.seg_open++;
+    if (used > pr->stats.peak_seg) {
+        pr->stats.peak_seg = used;
+    }
+
+    return seg;
+}
+
+void preroll_seg_close(PreRoll *pr, PreRollSeg *seg, uint64_t end)
+{
+    uint32_t pos = (uint32_t)(end - pr->stats.dropped);
+
+    seg->end = POS_DIFF(pos, seg->start) < 0 ? seg->start : pos;
+    __atomic_store_n(&seg->closed, 1, __ATOMIC_RELEASE);
+}
+
+void preroll_seg_ref(PreRollSeg *seg)
+{
+    __atomic_add_fetch(&seg->ref, 1, __ATOMIC_RELAXED);
+}
+
+void preroll_seg_unref(PreRollSeg *seg)
+{
+    // the reads of the consumer happen before the writer reuses the samples
+    __atomic_sub_fetch(&seg->ref, 1, __ATOMIC_RELEASE);
+}
+
+void preroll_seg_release(PreRollSeg *seg, uint32_t offset)
+{
+    uint32_t floor = __atomic_load_n(&seg->floor, __ATOMIC_RELAXED);
+
+    // the reads before offset happen before the writer reuses the samples
+    while (offset > floor && !__atomic_compare_exchange_n(&seg->floor, &floor, offset, false,
+                                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+int preroll_seg_peek(const PreRoll *pr, const PreRollSeg *seg, uint32_t offset,
+                     const int16_t **data, uint32_t *len)
+{
+    uint32_t pos = seg->start + offset, end = 0, n = 0;
+
+    *data = NULL;
+    *len  = 0;
+
+    end = __atomic_load_n(&pr->head, __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&seg->closed, __ATOMIC_ACQUIRE) && POS_DIFF(seg->end, end) < 0) {
+        end = seg->end;
+    }
+
+    if (POS_DIFF(pos, __atomic_load_n(&pr->tail, __ATOMIC_ACQUIRE)) < 0) {
+        return ALGO_DATA_EXCEPTION;
+    }
+    if (POS_DIFF(end, pos) <= 0) {
+        return ALGO_NORMAL;
+    }
+
+    n     = pr->size - (pos & (pr->size - 1));
+    *data = pr->buf + (pos & (pr->size - 1));
+    *len  = (uint32_t)POS_DIFF(end, pos) < n ? (uint32_t)POS_DIFF(end, pos) : n;
+
+    return ALGO_NORMAL;
+}
+
+bool preroll_seg_intact(const PreRoll *pr, const PreRollSeg *seg, uint32_t offset)
+{
+    // the reads of the samples happen before the tail is loaded
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return POS_DIFF(seg->start + offset, __atomic_load_n(&pr->tail, __ATOMIC_RELAXED)) >= 0;
+}
+
+bool preroll_seg_done(const PreRollSeg *seg, uint32_t offset)
+{
+    return __atomic_load_n(&seg->closed, __ATOMIC_ACQUIRE) &&
+           POS_DIFF(seg->start + offset, seg->end) >= 0;
+}
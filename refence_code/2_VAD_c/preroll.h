@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PREROLL_H__
+#define __PREROLL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "algo_error_code.h"
+
+/**
+ * segment handles of a ring. A handle is busy from the onset until the
+ * consumer has read the segment and its look-back. Smoothed decisions need
+ * few: with 300 ms of look-back and a consumer reading two hops per hop, at
+ * most 1 is busy at 5,4,8,0.5,0.2 and 4 at 1,1,4 on 3_data_set. Unsmoothed
+ * decisions open segments of one hop one hop apart, each read with its whole
+ * look-back, faster than the consumer reads them: no number of handles is
+ * enough and the ring fills, so onsets fail while the consumer catches up.
+ */
+#define PREROLL_SEG_NUM (4)
+
+/**
+ * what preroll_write does when the ring is full of audio still referenced by
+ * a segment handle
+ */
+typedef enum _PreRollPolicy {
+    PREROLL_KEEP_SEGMENTS = 0, // drop the new samples, the segments stay intact
+    PREROLL_OVERWRITE,         // overwrite the oldest samples, capture never stalls
+} PreRollPolicy;
+
+typedef struct _PreRollConfig {
+    uint32_t lookback;    // samples kept before the onset of a segment, < ring size
+    PreRollPolicy policy; // overrun policy
+} PreRollConfig;
+
+/**
+ * counters of a ring, written by the capture side only
+ */
+typedef struct _PreRollStats {
+    uint64_t written;     // samples stored
+    uint64_t dropped;     // samples dropped by PREROLL_KEEP_SEGMENTS
+    uint64_t overwritten; // referenced samples overwritten by PREROLL_OVERWRITE
+    uint32_t seg_open;    // segments opened
+    uint32_t seg_fail;    // onsets without a free handle
+    uint32_t seg_overrun; // segments that lost samples to PREROLL_OVERWRITE
+    uint32_t peak_held;   // most samples held by segments at once
+    uint32_t peak_seg;    // most handles in use at once
+} PreRollStats;
+
+/**
+ * slice of the ring from the look-back before an onset to the end of the
+ * speech, read in place by any number of consumers. Positions are modulo
+ * 2^32 samples, about 6 days at OBJ_FS.
+ */
+typedef struct _PreRollSeg {
+    uint32_t ref;    // references, the handle is free at 0
+    uint32_t start;  // first sample
+    uint32_t end;    // first sample after the segment, valid once closed
+    uint32_t closed; // 1 once end is set
+    uint32_t floor;  // samples from start released by the consumers, see preroll_seg_release
+    bool overrun;    // samples of the segment were overwritten
+} PreRollSeg;
+
+/**
+ * circular PCM buffer keeping the last samples of the capture. The capture
+ * side writes, opens and closes segments; consumers only take references and
+ * read, from any task, without a lock.
+ */
+typedef struct _PreRoll {
+    int16_t *buf;  // size samples
+    uint32_t size; // power of 2
+    uint32_t head; // ring position of the next sample written
+    uint32_t tail; // ring position of the oldest sample kept, moved before it is overwritten
+    PreRollConfig config;
+    PreRollSeg seg[PREROLL_SEG_NUM];
+    PreRollStats stats;
+} PreRoll;
+
+/**
+ * @brief initialize a ring on caller storage
+ *
+ * @param[out] pr: ring
+ * @param[in] buf: storage of size samples
+ * @param[in] size: samples, a power of 2
+ * @param[in] config: look-back and overrun policy
+ * @return error code
+ */
+int preroll_init(PreRoll *pr, int16_t *buf, uint32_t size, const PreRollConfig *config);
+
+/**
+ * @brief store captured samples. The samples of the segments still referenced
+ * and not released are kept or overwritten as the policy says, either way the
+ * counters record it.
+ *
+ * @param[in] pr: ring
+ * @param[in] pcm: samples
+ * @param[in] len: number of samples
+ * @return number of samples stored
+ */
+uint32_t preroll_write(PreRoll *pr, const int16_t *pcm, uint32_t len);
+
+/**
+ * @brief open a segment at a voice onset, capture side only. The segment
+ * starts config.lookback samples before the onset or at the oldest sample
+ * kept, and grows with the capture until preroll_seg_close.
+ *
+ * @param[in] pr: ring
+ * @param[in] onset: capture position of the onset, counting the dropped samples
+ * @return handle holding one reference for the caller, NULL if all are in use
+ */
+PreRollSeg *preroll_seg_open(PreRoll *pr, uint64_t onset);
+
+/**
+ * @brief close a segment at the end of the speech, capture side only
+ *
+ * @param[in] pr: ring
+ * @param[in] seg: open segment
+ * @param[in] end: capture position of the first sample after the speech
+ */
+void preroll_seg_close(PreRoll *pr, PreRollSeg *seg, uint64_t end);
+
+/**
+ * @brief take a reference for a consumer, the caller must hold one already
+ *
+ * @param[in] seg: segment
+ */
+void preroll_seg_ref(PreRollSeg *seg);
+
+/**
+ * @brief drop a reference, the samples of the segment may be reused at 0
+ *
+ * @param[in] seg: segment
+ */
+void preroll_seg_unref(PreRollSeg *seg);
+
+/**
+ * @brief let the ring reuse the samples of a segment before offset while the
+ * segment is still referenced, so a speech longer than the ring can be read
+ * as it is captured. Consumers sharing a handle release the offset all of
+ * them have read; a single consumer releases its read position.
+ *
+ * @param[in] seg: referenced segment
+ * @param[in] offset: samples from the start of the segment, only moves forward
+ */
+void preroll_seg_release(PreRollSeg *seg, uint32_t offset);
+
+/**
+ * @brief get the samples of a segment from offset on, in place. The slice
+ * ends at the end of the segment, at the last sample captured or where the
+ * ring wraps, whichever is first; read on at offset + len.
+ *
+ * @param[in] pr: ring
+ * @param[in] seg: referenced segment
+ * @param[in] offset: samples from the start of the segment
+ * @param[out] data: first sample
+ * @param[out] len: number of samples, 0: none captured yet or past the end
+ * @return ALGO_NORMAL, ALGO_DATA_EXCEPTION if the samples were overwritten
+ */
+int preroll_seg_peek(const PreRoll *pr, const PreRollSeg *seg, uint32_t offset,
+                     const int16_t **data, uint32_t *len);
+
+/**
+ * @brief check after reading that the samples from offset on were not
+ * overwritten meanwhile, always true with PREROLL_KEEP_SEGMENTS
+ *
+ * @param[in] pr: ring
+ * @param[in] seg: referenced segment
+ * @param[in] offset: samples from the start of the segment
+ * @return true if intact
+ */
+bool preroll_seg_intact(const PreRoll *pr, const PreRollSeg *seg, uint32_t offset);
+
+/**
+ * @brief check whether all samples of a segment can be read
+ *
+ * @param[in] seg: referenced segment
+ * @param[in] offset: samples from the start of the segment read so far
+ * @return true if the segment is closed and offset is at its end
+ */
+bool preroll_seg_done(const PreRollSeg *seg, uint32_t offset);
+
+#endif
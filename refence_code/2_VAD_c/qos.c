@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "qos.h"
+#include "vad_section.h"
+
+void vad_qos_default_config(VadQosConfig *config, uint32_t budget)
+{
+    config->budget        = budget;
+    config->degrade_slack = 0.2; // 3 ms of a 15 ms hop
+    config->recover_slack = 0.4;
+    config->degrade_hops  = 2;   // 30 ms, a single late hop is tolerated
+    config->recover_hops  = 33;  // 0.5 s
+}
+
+int vad_qos_init(VadQos *qos, const VadQosConfig *config, const VadGateConfig *gate)
+{
+    if (!qos || !config) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (config->budget == 0 || config->degrade_slack > config->recover_slack) {
+        return ALGO_DATA_INVALID;
+    }
+
+    memset(qos, 0, sizeof(VadQos));
+    qos->config = *config;
+    qos->level  = VAD_QOS_FULL;
+
+    return vad_gate_init(&qos->gate, gate);
+}
+
+VAD_RAM_TEXT int vad_qos_process(VadQos *qos, VadContext *ctx, Conv2dData *inp_data,
+                                 bool *is_voice)
+{
+    bool active = true;
+
+    if (!qos || !ctx || !inp_data || !inp_data->data || !is_voice) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (inp_data->col >= FRAME_STEP) {
+        active = vad_gate_update(&qos->gate, inp_data->data + inp_data->col - FRAME_STEP,
+                                 FRAME_STEP);
+    }
+
+    // the margin of the last decided hop is still in the context; the hops
+    // decided here still go through the statistics of the context
+    qos->phase ^= 1;
+    if (qos->level >= VAD_QOS_HALF && qos->phase) {
+        qos->hold_cnt++;
+        return vad_hold(ctx, inp_data, ctx->margin, is_voice);
+    }
+
+    if (qos->level >= VAD_QOS_GATE && !active) {
+        qos->skip_cnt++;
+        return vad_hold(ctx, inp_data, -INFINITY, is_voice);
+    }
+
+    return vad_process(ctx, inp_data, is_voice);
+}
+
+VAD_RAM_TEXT void vad_qos_update(VadQos *qos, uint32_t elapsed, uint32_t busy)
+{
+    const VadQosConfig *cfg = &qos->config;
+    VadQosLevel level       = qos->level;
+    uint32_t other          = elapsed > busy ? elapsed - busy : 0;
+    double slack            = (double)cfg->budget - elapsed;
+    double need             = 0.0;
+
+    if (qos->hop_cnt[level]) {
+        qos->cost[level] += VAD_QOS_COST_WEIGHT * ((double)busy - qos->cost[level]);
+    } else {
+        qos->cost[level] = busy;
+    }
+    qos->hop_cnt[level]++;
+    qos->busy_cycle[level] += busy;
+    qos->miss_cnt += elapsed > cfg->budget;
+    if (elapsed > qos->max_elapsed) {
+        qos->max_elapsed = elapsed;
+    }
+
+    if (slack < cfg->budget * cfg->degrade_slack) {
+        qos->fit = 0;
+        if (++qos->late >= cfg->degrade_hops && level + 1 < VAD_QOS_LEVEL_NUM) {
+            qos->level = (VadQosLevel)(level + 1);
+            qos->late  = 0;
+            qos->degrade_cnt++;
+        }
+        return;
+    }
+    qos->late = 0;
+
+    if (level == VAD_QOS_FULL) {
+        return;
+    }
+
+    // the lower level is judged by its own cost, not by the slack of the cheaper current one:
+    // the other load either adds a fixed time or stretches the hop by elapsed / busy, the
+    // larger of the two is taken
+    need = qos->cost[level - 1] + other;
+    if (busy && qos->cost[level - 1] * elapsed / busy > need) {
+        need = qos->cost[level - 1] * elapsed / busy;
+    }
+    if ((double)cfg->budget - need < cfg->budget * cfg->recover_slack) {
+        qos->fit = 0;
+        return;
+    }
+
+    if (++qos->fit >= cfg->recover_hops) {
+        qos->level = (VadQosLevel)(level - 1);
+        qos->fit   = 0;
+        qos->recover_cnt++;
+    }
+}
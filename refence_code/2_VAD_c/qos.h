@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QOS_H__
+#define __QOS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vad.h"
+#include "gate.h"
+#include "algo_error_code.h"
+
+#define VAD_QOS_COST_WEIGHT (0.0625) // weight of a new hop in the cost estimate of a level
+
+/**
+ * degradation levels, each one adds to the previous one
+ */
+typedef enum _VadQosLevel {
+    VAD_QOS_FULL = 0, // every hop is decided
+    VAD_QOS_GATE,     // the CNN is skipped on the hops the energy/ZCR gate finds silent
+    VAD_QOS_HALF,     // only every other hop is decided, the last decision is held in between
+    VAD_QOS_LEVEL_NUM,
+} VadQosLevel;
+
+/**
+ * configuration of the QoS controller, slack is the part of the hop budget
+ * left when the decision of a hop is done
+ */
+typedef struct _VadQosConfig {
+    uint32_t budget;       // cycles from the hop being ready to its deadline, one hop period
+    double degrade_slack;  // a hop below budget * degrade_slack of slack is late
+    double recover_slack;  // the next lower level must keep budget * recover_slack of slack
+    uint32_t degrade_hops; // consecutive late hops before going one level up
+    uint32_t recover_hops; // consecutive hops the lower level would fit before going down
+} VadQosConfig;
+
+/**
+ * state and counters of the QoS controller of one stream, the hops at a
+ * level times FRAME_STEP / OBJ_FS is the time spent at it
+ */
+typedef struct _VadQos {
+    VadQosConfig config;
+    VadGate gate;        // energy/ZCR statistics of every hop, used from VAD_QOS_GATE on
+    VadQosLevel level;   // current level
+    double cost[VAD_QOS_LEVEL_NUM]; // estimated busy cycles per hop at each level
+    uint32_t phase;      // hop parity of VAD_QOS_HALF
+    uint32_t late;       // consecutive late hops
+    uint32_t fit;        // consecutive hops the lower level would have fitted
+    uint64_t hop_cnt[VAD_QOS_LEVEL_NUM];   // hops decided at each level
+    uint64_t busy_cycle[VAD_QOS_LEVEL_NUM]; // cycles of vad_qos_process at each level
+    uint64_t skip_cnt;   // hops where the CNN was skipped by the gate
+    uint64_t hold_cnt;   // hops holding the last decision
+    uint64_t miss_cnt;   // hops done after their deadline
+    uint64_t degrade_cnt; // level increases
+    uint64_t recover_cnt; // level decreases
+    uint32_t max_elapsed; // longest hop, ready to done
+} VadQos;
+
+/**
+ * @brief get the default configuration of the QoS controller
+ *
+ * @param[out] config: default configuration
+ * @param[in] budget: cycles of one hop period
+ */
+void vad_qos_default_config(VadQosConfig *config, uint32_t budget);
+
+/**
+ * @brief initialize the QoS controller of a stream at VAD_QOS_FULL
+ *
+ * @param[out] qos: controller to be initialized
+ * @param[in] config: configuration, budget must not be 0
+ * @param[in] gate: configuration of the gate, NULL for the default one
+ * @return error code
+ */
+int vad_qos_init(VadQos *qos, const VadQosConfig *config, const VadGateConfig *gate);
+
+/**
+ * @brief decide a hop at the current level, at VAD_QOS_FULL the same as
+ * vad_process. The gate sees every hop, so it is settled when it is needed.
+ * The hops held or skipped go through vad_hold, so the gate and decimation
+ * statistics of the context see them too.
+ *
+ * @param[in] qos: initialized controller
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples, consecutive hops
+ * @param[out] is_voice: the result of voice detection
+ * @return error code
+ */
+int vad_qos_process(VadQos *qos, VadContext *ctx, Conv2dData *inp_data, bool *is_voice);
+
+/**
+ * @brief account a hop once its decision is passed on and choose the level
+ * of the next hop: a level up after degrade_hops late hops, a level down
+ * after recover_hops hops where the other load plus the estimated cost of
+ * the lower level leave enough slack
+ *
+ * @param[in] qos: initialized controller
+ * @param[in] elapsed: cycles from the hop being ready to its decision being passed on
+ * @param[in] busy: cycles of vad_qos_process for the hop, the rest of elapsed is other load
+ */
+void vad_qos_update(VadQos *qos, uint32_t elapsed, uint32_t busy);
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "qos.h"
+#include "wav.h"
+#include "runner.h"
+#include "qos_tool.h"
+
+static const char *g_level_name[VAD_QOS_LEVEL_NUM] = {"full", "gate", "half"};
+
+/**
+ * result of one loaded run
+ */
+typedef struct _QosRun {
+    uint64_t miss_cnt;     // hops done after their deadline
+    uint64_t diff_cnt;     // decisions differing from the unloaded run
+    uint64_t busy_cycle;   // cycles of the VAD
+    uint64_t max_elapsed;  // longest hop, ready to done
+} QosRun;
+
+/**
+ * median cycles of the parts of a hop, measured once so that the preemption
+ * of the host process does not show up as load in the simulation
+ */
+typedef struct _QosCost {
+    uint32_t vad;  // vad_process at full rate
+    uint32_t gate; // vad_gate_update
+} QosCost;
+
+static int cmp_cycle(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// unloaded full rate run: reference decisions and median costs
+static int qos_calibrate(const WavFile *wav, bool *ref, QosCost *cost)
+{
+    int ret          = ALGO_NORMAL;
+    uint64_t i       = 0, n = cal_frame_num(wav->frames), start = 0;
+    uint32_t *vad    = NULL, *gate = NULL;
+    double frame[FRAME_LEN];
+    VadGate probe;
+    VadContext ctx;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    vad  = (uint32_t *)malloc(sizeof(uint32_t) * n);
+    gate = (uint32_t *)malloc(sizeof(uint32_t) * n);
+    if (!vad || !gate) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    vad_init(&ctx);
+    vad_gate_init(&probe, NULL);
+    for (i = 0; i < n; i++) {
+        load_frame(wav, i * FRAME_STEP, i == 0, frame);
+
+        start = get_cycle();
+        ret   = vad_process(&ctx, &vad_inp, &ref[i]);
+        vad[i] = (uint32_t)(get_cycle() - start);
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+
+        start   = get_cycle();
+        vad_gate_update(&probe, frame + FRAME_LEN - FRAME_STEP, FRAME_STEP);
+        gate[i] = (uint32_t)(get_cycle() - start);
+    }
+
+    qsort(vad, n, sizeof(uint32_t), cmp_cycle);
+    qsort(gate, n, sizeof(uint32_t), cmp_cycle);
+    cost->vad  = vad[n / 2];
+    cost->gate = gate[n / 2];
+
+exit:
+    free(vad);
+    free(gate);
+
+    return ret;
+}
+
+// share of the CPU left to the VAD during a hop
+static double burst_share(uint64_t hop, uint32_t load_pct)
+{
+    return hop % QOS_BURST_PERIOD >= QOS_BURST_PERIOD - QOS_BURST_HOPS ? 1.0 - load_pct / 100.0
+                                                                       : 1.0;
+}
+
+// qos NULL: plain vad_process
+static int qos_run(const WavFile *wav, VadQos *qos, const QosCost *cost, uint32_t budget,
+                   uint32_t load_pct, const bool *ref, QosRun *run)
+{
+    int ret          = ALGO_NORMAL;
+    uint64_t i       = 0, n = cal_frame_num(wav->frames), skip = 0, hold = 0;
+    uint32_t busy    = 0, elapsed = 0;
+    bool vad_out     = false;
+    double ready = 0.0, finish = 0.0;
+    double frame[FRAME_LEN];
+    VadContext ctx;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    memset(run, 0, sizeof(QosRun));
+    vad_init(&ctx);
+    for (i = 0; i < n; i++) {
+        load_frame(wav, i * FRAME_STEP, i == 0, frame);
+
+        if (qos) {
+            skip = qos->skip_cnt;
+            hold = qos->hold_cnt;
+            ret  = vad_qos_process(qos, &ctx, &vad_inp, &vad_out);
+            busy = cost->gate + (qos->skip_cnt == skip && qos->hold_cnt == hold ? cost->vad : 0);
+        } else {
+            ret  = vad_process(&ctx, &vad_inp, &vad_out);
+            busy = cost->vad;
+        }
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+
+        // hop i is ready at i * budget, the VAD task takes the hops in order on the CPU share
+        // the burst leaves to it, so a task falling behind also delays the following hops
+        ready   = (double)i * budget;
+        finish  = (finish > ready ? finish : ready) + busy / burst_share(i, load_pct);
+        elapsed = finish - ready < UINT32_MAX ? (uint32_t)(finish - ready) : UINT32_MAX;
+        if (qos) {
+            vad_qos_update(qos, elapsed, busy);
+        }
+
+        run->busy_cycle += busy;
+        run->miss_cnt += elapsed > budget;
+        run->diff_cnt += vad_out != ref[i];
+        if (elapsed > run->max_elapsed) {
+            run->max_elapsed = elapsed;
+        }
+    }
+
+    return ret;
+}
+
+static void qos_run_print(const char *name, const QosRun *run, uint64_t n, uint32_t budget)
+{
+    printf("%-6s %8" PRIu64 " %8.2f %9.2f %10.0f %9.1f\n", name, run->miss_cnt,
+           100.0 * run->miss_cnt / n, 100.0 * run->diff_cnt / n, (double)run->busy_cycle / n,
+           100.0 * run->max_elapsed / budget);
+}
+
+int run_qos_sim(const char *wav_dir, uint32_t cpu_pct, uint32_t load_pct)
+{
+    int ret      = ALGO_NORMAL, l = 0;
+    uint64_t n   = 0;
+    uint32_t budget = 0;
+    bool *ref    = NULL;
+    QosRun plain, ctrl;
+    QosCost cost;
+    VadQosConfig config;
+    VadQos qos;
+    WavFile wav;
+
+    if (cpu_pct == 0 || cpu_pct > 100 || load_pct >= 100) {
+        return ALGO_DATA_INVALID;
+    }
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    n = cal_frame_num(wav.frames);
+    if (n == 0) {
+        ret = ALGO_DATA_NULL;
+        goto exit;
+    }
+    ref = (bool *)malloc(sizeof(bool) * n);
+    if (!ref) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    ret = qos_calibrate(&wav, ref, &cost);
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+    budget = cost.vad * 100 / cpu_pct;
+
+    vad_qos_default_config(&config, budget);
+    ret = vad_qos_init(&qos, &config, NULL);
+    if (ret == ALGO_NORMAL) {
+        ret = qos_run(&wav, NULL, &cost, budget, load_pct, ref, &plain);
+    }
+    if (ret == ALGO_NORMAL) {
+        ret = qos_run(&wav, &qos, &cost, budget, load_pct, ref, &ctrl);
+    }
+    if (ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    printf("hops: %" PRIu64 ", cost: vad_process %u, gate %u cycles\n", n, cost.vad, cost.gate);
+    printf("budget: %u cycles per hop (VAD %u %%), bursts: %d of every %d hops "
+           "take %u %% of the CPU\n",
+           budget, cpu_pct, QOS_BURST_HOPS, QOS_BURST_PERIOD, load_pct);
+    printf("%-6s %8s %8s %9s %10s %9s\n", "run", "misses", "miss(%)", "diff(%)", "busy/hop",
+           "worst(%)");
+    qos_run_print("plain", &plain, n, budget);
+    qos_run_print("qos", &ctrl, n, budget);
+
+    printf("\n%-6s %8s %10s %10s\n", "level", "time(s)", "busy/hop", "cost");
+    for (l = 0; l < VAD_QOS_LEVEL_NUM; l++) {
+        printf("%-6s %8.2f %10.0f %10.0f\n", g_level_name[l],
+               (double)qos.hop_cnt[l] * FRAME_STEP / OBJ_FS,
+               qos.hop_cnt[l] ? (double)qos.busy_cycle[l] / qos.hop_cnt[l] : 0.0, qos.cost[l]);
+    }
+    printf("level changes: %" PRIu64 " up, %" PRIu64 " down; gate skips: %" PRIu64
+           ", held hops: %" PRIu64 "\n",
+           qos.degrade_cnt, qos.recover_cnt, qos.skip_cnt, qos.hold_cnt);
+
+exit:
+    free(ref);
+    wav_close(&wav);
+
+    return ret;
+}
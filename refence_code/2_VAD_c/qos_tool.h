@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QOS_TOOL_H__
+#define __QOS_TOOL_H__
+
+#include <stdint.h>
+
+#include "algo_error_code.h"
+
+#define QOS_BURST_HOPS   (67)  // hops of a load burst, 1 s
+#define QOS_BURST_PERIOD (267) // hops from one burst to the next, 4 s
+
+/**
+ * @brief process a wav file under simulated load bursts, once with the plain
+ * VAD and once with the QoS controller, and print the deadline misses, the
+ * time spent at each QoS level and the decisions differing from an unloaded
+ * run. The hop budget is the measured full rate cost over cpu_pct percent.
+ * A burst takes load_pct percent of the CPU, the VAD task runs on the rest
+ * and its hops queue up when it falls behind.
+ *
+ * @param[in] wav_dir: wav file
+ * @param[in] cpu_pct: share of the hop budget the full rate VAD takes, 1..100
+ * @param[in] load_pct: share of the CPU taken by the bursts, 0..99
+ * @return error code
+ */
+int run_qos_sim(const char *wav_dir, uint32_t cpu_pct, uint32_t load_pct);
+
+#endif
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "resample.h"
+
+#ifndef M_PI
+#define M_PI (3.14159265358979323846)
+#endif
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    uint32_t t = 0;
+
+    while (b) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+// zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    int k      = 0;
+
+    for (k = 1; k < 64 && term > sum * 1e-12; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+void resample_ratio(uint32_t in_fs, uint32_t out_fs, uint32_t *up, uint32_t *down)
+{
+    uint32_t g = in_fs && out_fs ? gcd(in_fs, out_fs) : 1;
+
+    *up   = out_fs / g;
+    *down = in_fs / g;
+}
+
+int resample_filter_init(ResampleFilter *filter, uint32_t in_fs, uint32_t out_fs)
+{
+    uint32_t k = 0, proto = 0, max_factor = 0;
+    double fc = 0.0, x = 0.0, r = 0.0, sum = 0.0, scale = 0.0;
+    double *h = NULL;
+
+    memset(filter, 0, sizeof(ResampleFilter));
+
+    if (in_fs == 0 || out_fs == 0) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    resample_ratio(in_fs, out_fs, &filter->up, &filter->down);
+    if (filter->up > RESAMPLE_MAX_FACTOR || filter->down > RESAMPLE_MAX_FACTOR) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    max_factor = filter->up > filter->down ? filter->up : filter->down;
+    if (max_factor == 1) {
+        proto = 1;
+    } else {
+        proto         = 2 * RESAMPLE_ZERO_CROSS * max_factor + 1;
+        filter->delay = RESAMPLE_ZERO_CROSS * max_factor;
+    }
+
+    // the prototype is zero padded to a whole number of polyphase branches
+    filter->phase_taps = (proto + filter->up - 1) / filter->up;
+    filter->num_taps   = filter->phase_taps * filter->up;
+
+    filter->coef = (float *)calloc(filter->num_taps, sizeof(float));
+    h            = (double *)malloc(sizeof(double) * proto);
+    if (!filter->coef || !h) {
+        free(h);
+        resample_filter_deinit(filter);
+        return ALGO_MALLOC_FAIL;
+    }
+
+    // cutoff in cycles per sample at the rate in_fs * L
+    fc = RESAMPLE_CUTOFF * 0.5 / max_factor;
+    for (k = 0; k < proto; k++) {
+        x    = (double)k - filter->delay;
+        h[k] = x == 0.0 ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+        if (filter->delay) {
+            r = x / filter->delay;
+            h[k] *= bessel_i0(RESAMPLE_KAISER_BETA * sqrt(1.0 - r * r)) /
+                    bessel_i0(RESAMPLE_KAISER_BETA);
+        }
+        sum += h[k];
+    }
+
+    // every polyphase branch has a DC gain of about 1
+    scale = filter->up / sum;
+    for (k = 0; k < proto; k++) {
+        filter->coef[k] = (float)(h[k] * scale);
+    }
+    free(h);
+
+    return ALGO_NORMAL;
+}
+
+void resample_filter_deinit(ResampleFilter *filter)
+{
+    free(filter->coef);
+    memset(filter, 0, sizeof(ResampleFilter));
+}
+
+uint64_t resample_out_num(const ResampleFilter *filter, uint64_t in_num)
+{
+    return (in_num * filter->up + filter->down - 1) / filter->down;
+}
+
+float resample_phase_dot(const ResampleFilter *filter, uint32_t phase, const float *newest)
+{
+    const float *c = filter->coef + phase;
+    uint32_t step  = filter->up, j = 0;
+    float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+
+    // four independent sums hide the latency of the floating point adds
+    for (; j + 4 <= filter->phase_taps; j += 4, c += 4 * step, newest -= 4) {
+        acc0 += c[0] * newest[0];
+        acc1 += c[step] * newest[-1];
+        acc2 += c[2 * step] * newest[-2];
+        acc3 += c[3 * step] * newest[-3];
+    }
+    for (; j < filter->phase_taps; j++, c += step, newest--) {
+        acc0 += *c * newest[0];
+    }
+
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+#if VAD_USE_NMSIS
+static int nmsis_init(Resampler *rs)
+{
+    ResampleFilter *f   = &rs->filter;
+    uint32_t state_size = 0, k = 0;
+    float *rev          = NULL;
+    riscv_status status = RISCV_MATH_SUCCESS;
+
+    rs->use_nmsis = (f->up == 1 && f->down > 1 && f->down <= UINT8_MAX &&
+                     rs->block_size % f->down == 0) ||
+                    (f->down == 1 && f->up > 1 && f->up <= UINT8_MAX);
+    if (!rs->use_nmsis || f->num_taps > UINT16_MAX) {
+        rs->use_nmsis = false;
+        return ALGO_NORMAL;
+    }
+
+    state_size = f->up == 1 ? f->num_taps + rs->block_size - 1 : f->phase_taps + rs->block_size - 1;
+    rs->stage  = (float *)calloc(rs->block_size + state_size + f->num_taps, sizeof(float));
+    if (!rs->stage) {
+        return ALGO_MALLOC_FAIL;
+    }
+    rs->state = rs->stage + rs->block_size;
+
+    // the NMSIS-DSP FIR takes the coefficients in time reversed order
+    rev = rs->state + state_size;
+    for (k = 0; k < f->num_taps; k++) {
+        rev[k] = f->coef[f->num_taps - 1 - k];
+    }
+
+    if (f->up == 1) {
+        status = riscv_fir_decimate_init_f32(&rs->dec, (uint16_t)f->num_taps, (uint8_t)f->down,
+                                             rev, rs->state, rs->block_size);
+    } else {
+        status = riscv_fir_interpolate_init_f32(&rs->interp, (uint8_t)f->up,
+                                                (uint16_t)f->num_taps, rev, rs->state,
+                                                rs->block_size);
+    }
+    if (status != RISCV_MATH_SUCCESS) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    // the causal filter lags by delay samples at the rate in_fs * L
+    rs->skip = f->delay / f->down;
+
+    // the decimator ends every output on the last of its M input samples,
+    // M - 1 leading zeros move it onto the first one like the generic path
+    rs->stage_len = f->down - 1;
+
+    return ALGO_NORMAL;
+}
+
+static uint32_t nmsis_run(Resampler *rs, float *out)
+{
+    uint32_t out_num = rs->block_size * rs->filter.up / rs->filter.down, drop = 0;
+
+    if (rs->filter.up == 1) {
+        riscv_fir_decimate_f32(&rs->dec, rs->stage, out, rs->block_size);
+    } else {
+        riscv_fir_interpolate_f32(&rs->interp, rs->stage, out, rs->block_size);
+    }
+    rs->stage_len = 0;
+
+    drop = rs->skip < out_num ? rs->skip : out_num;
+    rs->skip -= drop;
+    out_num -= drop;
+    memmove(out, out + drop, sizeof(float) * out_num);
+
+    return out_num;
+}
+#endif
+
+int resample_init(Resampler *rs, uint32_t in_fs, uint32_t out_fs, uint32_t block_size)
+{
+    int ret = ALGO_NORMAL;
+
+    memset(rs, 0, sizeof(Resampler));
+
+    if (block_size == 0) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    ret = resample_filter_init(&rs->filter, in_fs, out_fs);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    rs->block_size = block_size;
+    rs->pos        = rs->filter.delay;
+
+#if VAD_USE_NMSIS
+    ret = nmsis_init(rs);
+    if (ret != ALGO_NORMAL) {
+        resample_deinit(rs);
+        return ret;
+    }
+    if (rs->use_nmsis) {
+        return ALGO_NORMAL;
+    }
+#endif
+
+    rs->buf = (float *)calloc(rs->filter.phase_taps - 1 + block_size, sizeof(float));
+    if (!rs->buf) {
+        resample_deinit(rs);
+        return ALGO_MALLOC_FAIL;
+    }
+
+    return ALGO_NORMAL;
+}
+
+uint32_t resample_max_out(const Resampler *rs)
+{
+    return (uint32_t)resample_out_num(&rs->filter, rs->block_size) + 1;
+}
+
+// the block is already behind the history in buf
+static uint32_t process_block(Resampler *rs, uint32_t in_num, float *out)
+{
+    const ResampleFilter *f = &rs->filter;
+    const float *cur        = rs->buf + f->phase_taps - 1;
+    uint64_t limit          = (uint64_t)in_num * f->up;
+    uint32_t out_num        = 0;
+
+    for (; rs->pos < limit; rs->pos += f->down) {
+        out[out_num++] = resample_phase_dot(f, (uint32_t)(rs->pos % f->up), cur + rs->pos / f->up);
+    }
+    rs->pos -= limit;
+
+    memmove(rs->buf, rs->buf + in_num, sizeof(float) * (f->phase_taps - 1));
+
+    return out_num;
+}
+
+uint32_t resample_process(Resampler *rs, const float *in, uint32_t in_num, float *out)
+{
+    uint32_t out_num = 0;
+
+#if VAD_USE_NMSIS
+    uint32_t n = 0;
+
+    if (rs->use_nmsis) {
+        n = rs->block_size - rs->stage_len < in_num ? rs->block_size - rs->stage_len : in_num;
+        memcpy(rs->stage + rs->stage_len, in, sizeof(float) * n);
+        rs->stage_len += n;
+        if (rs->stage_len == rs->block_size) {
+            out_num = nmsis_run(rs, out);
+            memcpy(rs->stage, in + n, sizeof(float) * (in_num - n));
+            rs->stage_len = in_num - n;
+        }
+        rs->in_cnt += in_num;
+        rs->out_cnt += out_num;
+        return out_num;
+    }
+#endif
+
+    memcpy(rs->buf + rs->filter.phase_taps - 1, in, sizeof(float) * in_num);
+    out_num = process_block(rs, in_num, out);
+    rs->in_cnt += in_num;
+    rs->out_cnt += out_num;
+
+    return out_num;
+}
+
+uint32_t resample_flush(Resampler *rs, float *out)
+{
+    uint64_t total   = resample_out_num(&rs->filter, rs->in_cnt);
+    uint32_t out_num = 0;
+
+    if (rs->out_cnt >= total) {
+        return 0;
+    }
+
+    // push zeros until every output of the real input is complete
+#if VAD_USE_NMSIS
+    if (rs->use_nmsis) {
+        memset(rs->stage + rs->stage_len, 0, sizeof(float) * (rs->block_size - rs->stage_len));
+        out_num = nmsis_run(rs, out);
+    } else
+#endif
+    {
+        memset(rs->buf + rs->filter.phase_taps - 1, 0, sizeof(float) * rs->block_size);
+        out_num = process_block(rs, rs->block_size, out);
+    }
+
+    if (out_num > total - rs->out_cnt) {
+        out_num = (uint32_t)(total - rs->out_cnt);
+    }
+    rs->out_cnt += out_num;
+
+    return out_num;
+}
+
+void resample_deinit(Resampler *rs)
+{
+    resample_filter_deinit(&rs->filter);
+    free(rs->buf);
+#if VAD_USE_NMSIS
+    free(rs->stage);
+#endif
+    memset(rs, 0, sizeof(Resampler));
+}
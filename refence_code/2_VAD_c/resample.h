@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __RESAMPLE_H__
+#define __RESAMPLE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "vad_dsp.h"
+#include "algo_error_code.h"
+
+#define RESAMPLE_ZERO_CROSS  (16)   // sinc zero crossings kept on each side of the center
+#define RESAMPLE_CUTOFF      (0.9)  // cutoff frequency relative to the lower Nyquist frequency
+#define RESAMPLE_KAISER_BETA (7.0)  // Kaiser window shape, about 70 dB stop band
+#define RESAMPLE_MAX_FACTOR  (2047) // largest L or M, keeps the filter length within uint16_t
+
+/**
+ * Anti-aliasing low pass filter of a rational L/M resampler, linear phase,
+ * split into L polyphase branches of phase_taps coefficients.
+ * Tap k of the prototype filter is coef[k], the gain L is included.
+ */
+typedef struct _ResampleFilter {
+    uint32_t up;         // interpolation factor L
+    uint32_t down;       // decimation factor M
+    uint32_t phase_taps; // coefficients of every polyphase branch
+    uint32_t num_taps;   // up * phase_taps, zero padded after the prototype filter
+    uint32_t delay;      // group delay of the prototype filter at the rate in_fs * L
+    float *coef;         // num_taps coefficients
+} ResampleFilter;
+
+/**
+ * Streaming resampler, the input is pushed block by block and the filter
+ * state is kept between calls. The output is aligned with the input:
+ * output sample m is centered on the input time m * M / L.
+ */
+typedef struct _Resampler {
+    ResampleFilter filter;
+    uint32_t block_size; // maximum number of input samples per call
+    uint64_t in_cnt;     // input samples pushed, flush padding excluded
+    uint64_t out_cnt;    // output samples returned
+    uint64_t pos;        // next output position at the rate in_fs * L, relative to the current block
+    float *buf;          // phase_taps - 1 samples of history followed by the current block
+#if VAD_USE_NMSIS
+    bool use_nmsis;      // L == 1 or M == 1, the NMSIS-DSP FIR is used
+    uint32_t stage_len;  // samples waiting in stage
+    uint32_t skip;       // outputs of the causal filter still to be dropped
+    float *stage;        // block_size input samples of one NMSIS-DSP call
+    float *state;        // NMSIS-DSP filter state
+    riscv_fir_decimate_instance_f32 dec;
+    riscv_fir_interpolate_instance_f32 interp;
+#endif
+} Resampler;
+
+/**
+ * @brief reduce the ratio out_fs / in_fs to L / M
+ *
+ * @param[in] in_fs: input sample rate
+ * @param[in] out_fs: output sample rate
+ * @param[out] up: interpolation factor L
+ * @param[out] down: decimation factor M
+ */
+void resample_ratio(uint32_t in_fs, uint32_t out_fs, uint32_t *up, uint32_t *down);
+
+/**
+ * @brief design the anti-aliasing filter converting in_fs to out_fs, a
+ * Kaiser windowed sinc. in_fs == out_fs gives a single unit tap.
+ *
+ * @param[out] filter: designed filter, released by resample_filter_deinit
+ * @param[in] in_fs: input sample rate
+ * @param[in] out_fs: output sample rate
+ * @return error code
+ */
+int resample_filter_init(ResampleFilter *filter, uint32_t in_fs, uint32_t out_fs);
+
+/**
+ * @brief release the coefficients of a filter
+ *
+ * @param[in] filter: designed filter
+ */
+void resample_filter_deinit(ResampleFilter *filter);
+
+/**
+ * @brief number of output samples of in_num input samples
+ *
+ * @param[in] filter: designed filter
+ * @param[in] in_num: number of input samples
+ * @return ceil(in_num * L / M)
+ */
+uint64_t resample_out_num(const ResampleFilter *filter, uint64_t in_num);
+
+/**
+ * @brief compute one output sample of a polyphase branch
+ *
+ * @param[in] filter: designed filter
+ * @param[in] phase: polyphase branch, 0..L-1
+ * @param[in] newest: newest input sample, newest[-phase_taps + 1] is the oldest one used
+ * @return output sample
+ */
+float resample_phase_dot(const ResampleFilter *filter, uint32_t phase, const float *newest);
+
+/**
+ * @brief initialize a streaming resampler
+ *
+ * @param[out] rs: resampler to be initialized
+ * @param[in] in_fs: input sample rate
+ * @param[in] out_fs: output sample rate
+ * @param[in] block_size: maximum number of input samples of every resample_process call
+ * @return error code
+ */
+int resample_init(Resampler *rs, uint32_t in_fs, uint32_t out_fs, uint32_t block_size);
+
+/**
+ * @brief maximum number of output samples of one resample_process or
+ * resample_flush call, the size of the output buffer
+ *
+ * @param[in] rs: initialized resampler
+ * @return number of samples
+ */
+uint32_t resample_max_out(const Resampler *rs);
+
+/**
+ * @brief resample one block of input samples
+ *
+ * @param[in] rs: initialized resampler
+ * @param[in] in: input samples
+ * @param[in] in_num: number of input samples, <= block_size
+ * @param[out] out: output samples, resample_max_out(rs) samples at most
+ * @return number of output samples
+ */
+uint32_t resample_process(Resampler *rs, const float *in, uint32_t in_num, float *out);
+
+/**
+ * @brief get the output samples delayed by the filter after the end of the
+ * input, to be called until it returns 0. The total output is
+ * resample_out_num(&rs->filter, input samples).
+ *
+ * @param[in] rs: initialized resampler
+ * @param[out] out: output samples, resample_max_out(rs) samples at most
+ * @return number of output samples
+ */
+uint32_t resample_flush(Resampler *rs, float *out);
+
+/**
+ * @brief release a streaming resampler
+ *
+ * @param[in] rs: initialized resampler
+ */
+void resample_deinit(Resampler *rs);
+
+#endif
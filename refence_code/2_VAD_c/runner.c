@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "runner.h"
+#include "segment.h"
+#include "evaluate.h"
+
+#define PATH_LEN (1024)
+
+typedef struct _RunnerJob {
+    char name[256];     // file name without extension
+    int ret;            // error code of the job
+    uint64_t data_size; // number of samples
+    uint64_t seg_num;   // number of voice segments
+    double cost;        // processing time in seconds
+    bool has_label;     // whether the label file exists
+    EvalCount cnt;      // sample level counters
+    // pre-gate audit, see RunnerConfig.gate
+    uint64_t hop_num;      // hops processed
+    uint64_t skip_num;     // hops skipped by the gate
+    uint64_t disagree_num; // skipped hops the CNN classifies as voice
+    uint64_t gate_cycle;   // cycles spent in the gate
+    uint64_t run_cycle;    // cycles of the CNN on the hops passed by the gate
+    uint64_t cnn_cycle;    // cycles of the CNN on every hop
+    EvalCount cnn_cnt;     // sample level counters of the CNN alone
+} RunnerJob;
+
+typedef struct _SegmentArray {
+    uint64_t *data;
+    uint64_t size;
+} SegmentArray;
+
+typedef struct _RunnerPool {
+    const RunnerConfig *config;
+    RunnerJob *jobs;
+    uint64_t job_num;
+    uint64_t next_job; // next job to be taken, protected by lock
+    pthread_mutex_t lock;
+} RunnerPool;
+
+int get_core_num(void)
+{
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return num > 0 ? (int)num : 1;
+}
+
+double get_time_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+uint64_t get_cycle(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__riscv) && __riscv_xlen == 64
+    uint64_t cycle = 0;
+
+    __asm__ volatile("rdcycle %0" : "=r"(cycle));
+
+    return cycle;
+#else
+    return (uint64_t)(get_time_sec() * 1e9);
+#endif
+}
+
+uint64_t cal_frame_num(uint64_t data_size)
+{
+    // same condition as the frame loop of main.c: i + FRAME_LEN - 1 <= data_size
+    if (data_size < FRAME_LEN - 1) {
+        return 0;
+    }
+
+    return (data_size - (FRAME_LEN - 1)) / FRAME_STEP + 1;
+}
+
+void load_frame(const WavFile *wav, uint64_t offset, bool is_first, double *frame)
+{
+    if (is_first) {
+        wav_read(wav, offset, FRAME_LEN, frame);
+        return;
+    }
+
+    // only the new hop is converted, the overlap is kept from the previous frame
+    memmove(frame, frame + FRAME_STEP, sizeof(double) * (FRAME_LEN - FRAME_STEP));
+    wav_read(wav, offset + FRAME_LEN - FRAME_STEP, FRAME_STEP, frame + FRAME_LEN - FRAME_STEP);
+}
+
+static void segment_append(void *param, uint64_t start, uint64_t end)
+{
+    SegmentArray *arr = (SegmentArray *)param;
+
+    arr->data[arr->size++] = start;
+    arr->data[arr->size++] = end;
+}
+
+int detect_voice_segment(VadContext *ctx, const WavFile *wav, const VadSmoothConfig *smooth,
+                         uint64_t **voice_segment, uint64_t *voice_segment_size)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t i = 0, pred_cnt = 0, frame_num = 0;
+    bool vad_out       = false;
+    double frame[FRAME_LEN];
+    SegmentArray arr   = {NULL, 0};
+    VadSmoothSegment sink = {segment_append, &arr, 0};
+    VadSmoother smoother;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    *voice_segment      = NULL;
+    *voice_segment_size = 0;
+
+    ret = vad_smooth_init(&smoother, smooth, vad_smooth_segment, &sink);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    frame_num = cal_frame_num(wav->frames);
+
+    // at most one segment per two hops, plus the one open at the end
+    arr.data = (uint64_t *)malloc(sizeof(uint64_t) * (frame_num + 2));
+    if (!arr.data) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    // streaming audio data, frame by frame, segments are closed on the fly
+    for (i = 0; pred_cnt < frame_num; i += FRAME_STEP, pred_cnt++) {
+        load_frame(wav, i, pred_cnt == 0, frame);
+
+        ret = vad_process(ctx, &vad_inp, &vad_out);
+        if (ret != ALGO_NORMAL) {
+            free(arr.data);
+            return ret;
+        }
+
+        vad_smooth_push(&smoother, ctx->margin, i);
+    }
+    vad_smooth_finish(&smoother, wav->frames);
+
+    *voice_segment      = arr.data;
+    *voice_segment_size = arr.size;
+
+    return ret;
+}
+
+int detect_voice_margin(VadContext *ctx, const WavFile *wav, LogitCache *cache)
+{
+    int ret      = ALGO_NORMAL;
+    uint64_t i   = 0;
+    bool vad_out = false;
+    double frame[FRAME_LEN];
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    cache->data_size = wav->frames;
+    cache->hop_num   = cal_frame_num(wav->frames);
+    cache->margin    = (float *)malloc(sizeof(float) * (cache->hop_num ? cache->hop_num : 1));
+    if (!cache->margin) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < cache->hop_num; i++) {
+        load_frame(wav, i * FRAME_STEP, i == 0, frame);
+
+        ret = vad_process(ctx, &vad_inp, &vad_out);
+        if (ret != ALGO_NORMAL) {
+            logit_cache_free(cache);
+            return ret;
+        }
+
+        cache->margin[i] = (float)ctx->margin;
+    }
+
+    return ret;
+}
+
+// the gate and the CNN both run on every hop, the gated decisions are the
+// result and the CNN alone is kept as the reference
+static int detect_voice_segment_audit(VadContext *ctx, const RunnerConfig *config,
+                                      const WavFile *wav, RunnerJob *job, SegmentArray *gated,
+                                      SegmentArray *cnn)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t i         = 0, pred_cnt = 0, frame_num = 0, c0 = 0, c1 = 0, c2 = 0;
+    bool vad_out       = false, run = false;
+    double frame[FRAME_LEN];
+    VadGate gate;
+    VadSmoothSegment gated_sink = {segment_append, gated, 0}, cnn_sink = {segment_append, cnn, 0};
+    VadSmoother gated_smoother, cnn_smoother;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    frame_num   = cal_frame_num(wav->frames);
+    gated->data = (uint64_t *)malloc(sizeof(uint64_t) * (frame_num + 2));
+    cnn->data   = (uint64_t *)malloc(sizeof(uint64_t) * (frame_num + 2));
+    if (!gated->data || !cnn->data) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    vad_gate_init(&gate, config->gate);
+    ret = vad_smooth_init(&gated_smoother, config->smooth, vad_smooth_segment, &gated_sink);
+    if (ret == ALGO_NORMAL) {
+        ret = vad_smooth_init(&cnn_smoother, config->smooth, vad_smooth_segment, &cnn_sink);
+    }
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    for (i = 0; pred_cnt < frame_num; i += FRAME_STEP, pred_cnt++) {
+        load_frame(wav, i, pred_cnt == 0, frame);
+
+        c0  = get_cycle();
+        run = vad_gate_update(&gate, frame + FRAME_LEN - FRAME_STEP, FRAME_STEP);
+        c1  = get_cycle();
+        ret = vad_process(ctx, &vad_inp, &vad_out);
+        c2  = get_cycle();
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+
+        job->gate_cycle += c1 - c0;
+        job->cnn_cycle += c2 - c1;
+        if (run) {
+            job->run_cycle += c2 - c1;
+        } else if (vad_out) {
+            job->disagree_num++;
+        }
+
+        vad_smooth_push(&gated_smoother, run ? ctx->margin : -INFINITY, i);
+        vad_smooth_push(&cnn_smoother, ctx->margin, i);
+    }
+
+    vad_smooth_finish(&gated_smoother, wav->frames);
+    vad_smooth_finish(&cnn_smoother, wav->frames);
+    job->hop_num  = gate.hop_cnt;
+    job->skip_num = gate.skip_cnt;
+
+    return ret;
+}
+
+static int file_exists(const char *file_dir)
+{
+    return access(file_dir, R_OK) == 0;
+}
+
+static void run_job(VadContext *ctx, const RunnerConfig *config, RunnerJob *job)
+{
+    char path[PATH_LEN];
+    double start             = get_time_sec();
+    uint64_t *seg            = NULL, *label = NULL;
+    uint64_t seg_size        = 0, label_size = 0;
+    SegmentArray gated       = {NULL, 0}, cnn = {NULL, 0};
+    LogitCache cache         = {0, 0, NULL};
+    WavFile wav;
+
+    snprintf(path, sizeof(path), "%s/%s.wav", config->wav_dir, job->name);
+    job->ret = wav_open(path, &wav);
+    if (job->ret != ALGO_NORMAL) {
+        return;
+    }
+
+    job->ret = wav_set_resample(&wav, OBJ_FS);
+    if (job->ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    job->data_size = wav.frames;
+    if (config->gate) {
+        job->ret = detect_voice_segment_audit(ctx, config, &wav, job, &gated, &cnn);
+        seg      = gated.data;
+        seg_size = gated.size;
+    } else if (config->cache_dir) {
+        job->ret = detect_voice_margin(ctx, &wav, &cache);
+        if (job->ret == ALGO_NORMAL) {
+            snprintf(path, sizeof(path), "%s/%s.bin", config->cache_dir, job->name);
+            job->ret = logit_cache_save(path, &cache);
+        }
+        if (job->ret == ALGO_NORMAL) {
+            seg      = (uint64_t *)malloc(sizeof(uint64_t) * (cache.hop_num + 2));
+            job->ret = seg ? logit_cache_replay(&cache, config->smooth, seg, &seg_size)
+                           : ALGO_MALLOC_FAIL;
+        }
+    } else {
+        job->ret = detect_voice_segment(ctx, &wav, config->smooth, &seg, &seg_size);
+    }
+    if (job->ret != ALGO_NORMAL) {
+        goto exit;
+    }
+    job->seg_num = seg_size / 2;
+
+    snprintf(path, sizeof(path), "%s/%s.txt", config->pred_dir, job->name);
+    job->ret = save_voice_segment(path, seg, seg_size);
+    if (job->ret != ALGO_NORMAL) {
+        goto exit;
+    }
+
+    if (config->label_dir) {
+        snprintf(path, sizeof(path), "%s/%s.txt", config->label_dir, job->name);
+        if (file_exists(path)) {
+            job->ret = load_voice_segment(path, &label, &label_size);
+            if (job->ret == ALGO_NORMAL) {
+                job->ret = eval_count(wav.frames, label, label_size, seg, seg_size, &job->cnt);
+            }
+            if (job->ret == ALGO_NORMAL && config->gate) {
+                job->ret = eval_count(wav.frames, label, label_size, cnn.data, cnn.size,
+                                      &job->cnn_cnt);
+            }
+            job->has_label = (job->ret == ALGO_NORMAL);
+        }
+    }
+
+exit:
+    job->cost = get_time_sec() - start;
+    if (seg != gated.data) {
+        free(seg);
+    }
+    free(gated.data);
+    free(cnn.data);
+    free(label);
+    logit_cache_free(&cache);
+    wav_close(&wav);
+}
+
+static void *runner_worker(void *param)
+{
+    RunnerPool *pool = (RunnerPool *)param;
+    VadContext ctx;
+    uint64_t idx = 0;
+
+    vad_init(&ctx);
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        idx = pool->next_job++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (idx >= pool->job_num) {
+            break;
+        }
+
+        run_job(&ctx, pool->config, &pool->jobs[idx]);
+    }
+
+    return NULL;
+}
+
+static int cmp_job(const void *a, const void *b)
+{
+    return strcmp(((const RunnerJob *)a)->name, ((const RunnerJob *)b)->name);
+}
+
+static int list_jobs(const char *wav_dir, RunnerJob **jobs, uint64_t *job_num)
+{
+    DIR *dir             = opendir(wav_dir);
+    struct dirent *entry = NULL;
+    RunnerJob *list = NULL, *tmp = NULL;
+    uint64_t cnt = 0, cap = 0;
+    size_t len   = 0;
+
+    *jobs    = NULL;
+    *job_num = 0;
+
+    if (!dir) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        len = strlen(entry->d_name);
+        if (len <= 4 || len - 4 >= sizeof(list->name) ||
+            strcmp(entry->d_name + len - 4, ".wav")) {
+            continue;
+        }
+
+        if (cnt == cap) {
+            cap = cap ? cap * 2 : 64;
+            tmp = (RunnerJob *)realloc(list, sizeof(RunnerJob) * cap);
+            if (!tmp) {
+                free(list);
+                closedir(dir);
+                return ALGO_MALLOC_FAIL;
+            }
+            list = tmp;
+        }
+
+        memset(&list[cnt], 0, sizeof(RunnerJob));
+        memcpy(list[cnt].name, entry->d_name, len - 4);
+        cnt++;
+    }
+    closedir(dir);
+
+    if (cnt) {
+        qsort(list, cnt, sizeof(RunnerJob), cmp_job);
+    }
+
+    *jobs    = list;
+    *job_num = cnt;
+
+    return ALGO_NORMAL;
+}
+
+static void print_report(const RunnerPool *pool, int thread_num, double wall)
+{
+    uint64_t i = 0, fail = 0, scored = 0, samples = 0;
+    double busy = 0.0, audio_sec = 0.0;
+    EvalCount total;
+    EvalMetrics metrics;
+    const RunnerJob *job = NULL;
+
+    memset(&total, 0, sizeof(EvalCount));
+
+    printf("%-24s %10s %6s %8s %8s %8s %8s %9s\n", "file", "samples", "segs", "f1", "acc",
+           "recall", "prec", "time(ms)");
+    for (i = 0; i < pool->job_num; i++) {
+        job = &pool->jobs[i];
+        busy += job->cost;
+
+        if (job->ret != ALGO_NORMAL) {
+            fail++;
+            printf("%-24s error %d\n", job->name, job->ret);
+            continue;
+        }
+
+        samples += job->data_size;
+        if (job->has_label) {
+            scored++;
+            eval_merge(&total, &job->cnt);
+            eval_metrics(&job->cnt, &metrics);
+            printf("%-24s %10" PRIu64 " %6" PRIu64 " %8.4f %8.4f %8.4f %8.4f %9.2f\n", job->name,
+                   job->data_size, job->seg_num, metrics.f1_score, metrics.accuracy,
+                   metrics.recall, metrics.precision, job->cost * 1e3);
+        } else {
+            printf("%-24s %10" PRIu64 " %6" PRIu64 " %8s %8s %8s %8s %9.2f\n", job->name,
+                   job->data_size, job->seg_num, "-", "-", "-", "-", job->cost * 1e3);
+        }
+    }
+
+    audio_sec = (double)samples / OBJ_FS;
+
+    printf("\nfiles: %" PRIu64 ", failed: %" PRIu64 ", scored: %" PRIu64 ", threads: %d\n",
+           pool->job_num, fail, scored, thread_num);
+    if (scored) {
+        eval_metrics(&total, &metrics);
+        printf("total f1_score: %.4f, accuracy: %.4f, recall: %.4f, precision: %.4f\n",
+               metrics.f1_score, metrics.accuracy, metrics.recall, metrics.precision);
+    }
+    printf("audio: %.1f s, wall: %.3f s, busy: %.3f s, parallel speedup: %.2f, %.1fx realtime\n",
+           audio_sec, wall, busy, wall > 0 ? busy / wall : 0.0,
+           wall > 0 ? audio_sec / wall : 0.0);
+}
+
+static void print_gate_report(const RunnerPool *pool)
+{
+    uint64_t i = 0, hops = 0, skips = 0, disagrees = 0, gate_cycle = 0, run_cycle = 0,
+             cnn_cycle = 0;
+    EvalCount total;
+    EvalMetrics metrics, cnn_metrics;
+    const RunnerJob *job = NULL;
+
+    memset(&total, 0, sizeof(EvalCount));
+
+    printf("\n%-24s %8s %8s %9s %8s %8s %8s\n", "file", "hops", "skip(%)", "disag(%)", "f1_cnn",
+           "f1_gate", "cpu(%)");
+    for (i = 0; i < pool->job_num; i++) {
+        job = &pool->jobs[i];
+        if (job->ret != ALGO_NORMAL || job->hop_num == 0) {
+            continue;
+        }
+
+        hops += job->hop_num;
+        skips += job->skip_num;
+        disagrees += job->disagree_num;
+        gate_cycle += job->gate_cycle;
+        run_cycle += job->run_cycle;
+        cnn_cycle += job->cnn_cycle;
+
+        printf("%-24s %8" PRIu64 " %8.2f %9.2f ", job->name, job->hop_num,
+               100.0 * job->skip_num / job->hop_num, 100.0 * job->disagree_num / job->hop_num);
+        if (job->has_label) {
+            eval_merge(&total, &job->cnn_cnt);
+            eval_metrics(&job->cnn_cnt, &cnn_metrics);
+            eval_metrics(&job->cnt, &metrics);
+            printf("%8.4f %8.4f ", cnn_metrics.f1_score, metrics.f1_score);
+        } else {
+            printf("%8s %8s ", "-", "-");
+        }
+        printf("%8.2f\n", job->cnn_cycle ? 100.0 * (job->gate_cycle + job->run_cycle) /
+                                                 job->cnn_cycle
+                                           : 0.0);
+    }
+
+    if (hops == 0) {
+        return;
+    }
+
+    // cpu: cycles of the gate and of the CNN on the passed hops, relative to the CNN on every hop
+    printf("\nhops: %" PRIu64 ", skipped: %.2f %%, skipped but voice for the CNN: %.2f %% of hops, "
+           "%.2f %% of skipped\n",
+           hops, 100.0 * skips / hops, 100.0 * disagrees / hops,
+           skips ? 100.0 * disagrees / skips : 0.0);
+    printf("cpu of the gated VAD: %.2f %% of the CNN on every hop, gate alone: %.2f %%\n",
+           cnn_cycle ? 100.0 * (gate_cycle + run_cycle) / cnn_cycle : 0.0,
+           cnn_cycle ? 100.0 * gate_cycle / cnn_cycle : 0.0);
+    if (total.data_length) {
+        eval_metrics(&total, &cnn_metrics);
+        printf("cnn alone f1_score: %.4f, accuracy: %.4f, recall: %.4f, precision: %.4f\n",
+               cnn_metrics.f1_score, cnn_metrics.accuracy, cnn_metrics.recall,
+               cnn_metrics.precision);
+    }
+}
+
+int run_dataset(const RunnerConfig *config)
+{
+    int ret = ALGO_NORMAL, thread_num = 0, i = 0, started = 0;
+    double start         = 0.0;
+    pthread_t *threads   = NULL;
+    RunnerPool pool;
+
+    if (!config || !config->wav_dir || !config->pred_dir) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(&pool, 0, sizeof(RunnerPool));
+    pool.config = config;
+
+    ret = list_jobs(config->wav_dir, &pool.jobs, &pool.job_num);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    if (pool.job_num == 0) {
+        printf("no wav file in %s\n", config->wav_dir);
+        return ALGO_DATA_NULL;
+    }
+
+    thread_num = config->thread_num > 0 ? config->thread_num : get_core_num();
+    if ((uint64_t)thread_num > pool.job_num) {
+        thread_num = (int)pool.job_num;
+    }
+
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * thread_num);
+    if (!threads) {
+        free(pool.jobs);
+        return ALGO_MALLOC_FAIL;
+    }
+
+    pthread_mutex_init(&pool.lock, NULL);
+
+    start = get_time_sec();
+    for (i = 0; i < thread_num; i++) {
+        if (pthread_create(&threads[i], NULL, runner_worker, &pool)) {
+            break;
+        }
+        started++;
+    }
+
+    // the calling thread takes part in the work if no worker could be started
+    if (started == 0) {
+        runner_worker(&pool);
+    }
+
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    print_report(&pool, started ? started : 1, get_time_sec() - start);
+    if (config->gate) {
+        print_gate_report(&pool);
+    }
+
+    pthread_mutex_destroy(&pool.lock);
+    free(threads);
+    free(pool.jobs);
+
+    return ret;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __RUNNER_H__
+#define __RUNNER_H__
+
+#include <stdint.h>
+
+#include "vad.h"
+#include "wav.h"
+#include "smooth.h"
+#include "logit_cache.h"
+#include "algo_error_code.h"
+
+/**
+ * configuration of the dataset runner
+ */
+typedef struct _RunnerConfig {
+    const char *wav_dir;   // directory of the wav files
+    const char *label_dir; // directory of the label files, NULL to skip scoring
+    const char *pred_dir;  // directory where the prediction files are written
+    int thread_num;        // number of worker threads, <= 0: all online cores
+    const VadGateConfig *gate; // pre-gate audited against the CNN on every hop, NULL: no gate
+    const VadSmoothConfig *smooth; // decision smoothing, NULL: pass-through
+    const char *cache_dir;         // directory where the per-hop margins are cached, NULL: none
+} RunnerConfig;
+
+/**
+ * @brief calculate the number of frames of the data
+ *
+ * @param[in] data_size: number of samples
+ * @return number of frames
+ */
+uint64_t cal_frame_num(uint64_t data_size);
+
+/**
+ * @brief load the frame starting at offset
+ *
+ * @param[in] wav: opened wav file
+ * @param[in] offset: index of the first sample of the frame
+ * @param[in] is_first: true if frame doesn't hold the previous frame, which
+ *            starts at offset - FRAME_STEP
+ * @param[in,out] frame: FRAME_LEN samples
+ */
+void load_frame(const WavFile *wav, uint64_t offset, bool is_first, double *frame);
+
+/**
+ * @brief run the VAD over a whole wav file and calculate the voice segments
+ *
+ * @param[in] ctx: VAD context owned by the calling thread
+ * @param[in] wav: opened wav file
+ * @param[in] smooth: decision smoothing, NULL: pass-through
+ * @param[out] voice_segment: allocated array, 2n: start index, 2n+1: end index.
+ *             Must be released with free()
+ * @param[out] voice_segment_size: number of indices in voice_segment
+ * @return error code
+ */
+int detect_voice_segment(VadContext *ctx, const WavFile *wav, const VadSmoothConfig *smooth,
+                         uint64_t **voice_segment, uint64_t *voice_segment_size);
+
+/**
+ * @brief run the VAD over a whole wav file and keep the margin of every hop
+ *
+ * @param[in] ctx: VAD context owned by the calling thread
+ * @param[in] wav: opened wav file
+ * @param[out] cache: margins of the file, release with logit_cache_free
+ * @return error code
+ */
+int detect_voice_margin(VadContext *ctx, const WavFile *wav, LogitCache *cache);
+
+/**
+ * @brief process every wav file of a directory on a pool of worker threads,
+ * write "<pred_dir>/<name>.txt" for each "<wav_dir>/<name>.wav" and print the
+ * metrics against "<label_dir>/<name>.txt". With config->gate the gated
+ * result is written, and the skip ratio, the disagreement with the CNN, the
+ * metrics of the CNN alone and the CPU share of the gated run are reported.
+ * With config->cache_dir the margins are also written to
+ * "<cache_dir>/<name>.bin" and the segments are replayed from them.
+ *
+ * @param[in] config: runner configuration
+ * @return error code
+ */
+int run_dataset(const RunnerConfig *config);
+
+/**
+ * @brief get the number of online cores of the host
+ *
+ * @return number of cores, at least 1
+ */
+int get_core_num(void);
+
+/**
+ * @brief get a monotonic timestamp
+ *
+ * @return time in seconds
+ */
+double get_time_sec(void);
+
+/**
+ * @brief read the cycle counter: TSC on x86, cycle CSR on 64-bit RISC-V,
+ * nanoseconds on other hosts
+ *
+ * @return counter value
+ */
+uint64_t get_cycle(void);
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "segment.h"
+
+void cal_voice_segment(int8_t *pred_class, const uint64_t *pred_idx_in_data,
+                       uint64_t pred_class_size, uint64_t raw_data_size, uint64_t *voice_segment,
+                       uint64_t *voice_segment_size)
+{
+    uint64_t i = 0, voice_segment_cnt = 0;
+    int8_t diff_vaule = 0;
+    bool is_start     = true;
+
+    *voice_segment_size = 0;
+
+    for (i = 1; i < pred_class_size; i++) {
+        diff_vaule = pred_class[i] - pred_class[i - 1];
+
+        if (diff_vaule == 1) {
+            voice_segment[voice_segment_cnt++] = pred_idx_in_data[i];
+            is_start                           = false;
+        }
+
+        if (diff_vaule == -1) {
+            if (is_start) {
+                voice_segment[voice_segment_cnt++] = 0;
+            }
+            voice_segment[voice_segment_cnt++] = pred_idx_in_data[i];
+            is_start                           = true;
+        }
+    }
+
+    if (!is_start) {
+        voice_segment[voice_segment_cnt++] = raw_data_size - 1;
+    }
+
+    *voice_segment_size = voice_segment_cnt;
+}
+
+void segment_emitter_init(SegmentEmitter *emitter, SegmentCallback callback, void *param)
+{
+    memset(emitter, 0, sizeof(SegmentEmitter));
+    emitter->callback = callback;
+    emitter->param    = param;
+    emitter->is_start = true;
+}
+
+void segment_emitter_push(SegmentEmitter *emitter, int8_t pred_class, uint64_t pred_idx_in_data)
+{
+    int8_t diff_vaule = pred_class - emitter->last_pred;
+
+    // same rules as cal_voice_segment()
+    if (emitter->pred_cnt++ == 0) {
+        diff_vaule = 0;
+    }
+    emitter->last_pred = pred_class;
+
+    if (diff_vaule == 1) {
+        emitter->start    = pred_idx_in_data;
+        emitter->is_start = false;
+    }
+
+    if (diff_vaule == -1) {
+        if (emitter->is_start) {
+            emitter->start = 0;
+        }
+        emitter->callback(emitter->param, emitter->start, pred_idx_in_data);
+        emitter->seg_num++;
+        emitter->is_start = true;
+    }
+}
+
+void segment_emitter_finish(SegmentEmitter *emitter, uint64_t raw_data_size)
+{
+    if (!emitter->is_start) {
+        emitter->callback(emitter->param, emitter->start, raw_data_size - 1);
+        emitter->seg_num++;
+        emitter->is_start = true;
+    }
+}
+
+void segment_write_file(void *param, uint64_t start, uint64_t end)
+{
+    fprintf((FILE *)param, "%" PRIu64 ", %" PRIu64 "\n", start, end);
+}
+
+int save_voice_segment(const char *file_dir, const uint64_t *voice_segment,
+                       uint64_t voice_segment_size)
+{
+    uint64_t i = 0;
+    FILE *file = fopen(file_dir, "w");
+
+    if (!file) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    for (i = 0; i + 1 < voice_segment_size; i += 2) {
+        fprintf(file, "%" PRIu64 ", %" PRIu64 "\n", voice_segment[i], voice_segment[i + 1]);
+    }
+    fclose(file);
+
+    return ALGO_NORMAL;
+}
+
+int load_voice_segment(const char *file_dir, uint64_t **voice_segment,
+                       uint64_t *voice_segment_size)
+{
+    char line[1024];
+    uint64_t start = 0, end = 0, cnt = 0, cap = 0;
+    uint64_t *seg = NULL, *tmp = NULL;
+    FILE *stream  = fopen(file_dir, "r");
+
+    *voice_segment      = NULL;
+    *voice_segment_size = 0;
+
+    if (!stream) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    while (fgets(line, sizeof(line), stream)) {
+        if (sscanf(line, " %" SCNu64 " , %" SCNu64, &start, &end) != 2) {
+            continue;
+        }
+
+        if (cnt + 2 > cap) {
+            cap = cap ? cap * 2 : 64;
+            tmp = (uint64_t *)realloc(seg, sizeof(uint64_t) * cap);
+            if (!tmp) {
+                free(seg);
+                fclose(stream);
+                return ALGO_MALLOC_FAIL;
+            }
+            seg = tmp;
+        }
+
+        seg[cnt++] = start;
+        seg[cnt++] = end;
+    }
+    fclose(stream);
+
+    *voice_segment      = seg;
+    *voice_segment_size = cnt;
+
+    return ALGO_NORMAL;
+}
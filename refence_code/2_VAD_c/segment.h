@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SEGMENT_H__
+#define __SEGMENT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "algo_error_code.h"
+
+/**
+ * @brief callback of a closed voice segment
+ *
+ * @param[in] param: user parameter of the emitter
+ * @param[in] start: start index of the segment
+ * @param[in] end: end index of the segment
+ */
+typedef void (*SegmentCallback)(void *param, uint64_t start, uint64_t end);
+
+/**
+ * streaming version of cal_voice_segment(), frame predictions are pushed one
+ * by one and every segment is reported as soon as it is closed
+ */
+typedef struct _SegmentEmitter {
+    SegmentCallback callback; // called for every closed segment
+    void *param;              // user parameter of callback
+    uint64_t pred_cnt;        // number of frames pushed
+    uint64_t start;           // start index of the open segment
+    uint64_t seg_num;         // number of segments reported
+    int8_t last_pred;         // prediction of the previous frame
+    bool is_start;            // true: no segment is open
+} SegmentEmitter;
+
+/**
+ * @brief calculate voice segments from the per-frame predictions
+ *
+ * @param[in] pred_class: predicted class of every frame, 0: unvoice, 1: voice
+ * @param[in] pred_idx_in_data: start index of every frame in the raw data
+ * @param[in] pred_class_size: number of frames
+ * @param[in] raw_data_size: length of the raw data
+ * @param[out] voice_segment: 2n: start index, 2n+1: end index
+ * @param[out] voice_segment_size: number of indices written to voice_segment
+ */
+void cal_voice_segment(int8_t *pred_class, const uint64_t *pred_idx_in_data,
+                       uint64_t pred_class_size, uint64_t raw_data_size, uint64_t *voice_segment,
+                       uint64_t *voice_segment_size);
+
+/**
+ * @brief initialize a segment emitter
+ *
+ * @param[out] emitter: emitter to be initialized
+ * @param[in] callback: called for every closed segment
+ * @param[in] param: user parameter of callback
+ */
+void segment_emitter_init(SegmentEmitter *emitter, SegmentCallback callback, void *param);
+
+/**
+ * @brief push the prediction of the next frame
+ *
+ * @param[in] emitter: segment emitter
+ * @param[in] pred_class: predicted class of the frame, 0: unvoice, 1: voice
+ * @param[in] pred_idx_in_data: start index of the frame in the raw data
+ */
+void segment_emitter_push(SegmentEmitter *emitter, int8_t pred_class, uint64_t pred_idx_in_data);
+
+/**
+ * @brief close the segment still open at the end of data
+ *
+ * @param[in] emitter: segment emitter
+ * @param[in] raw_data_size: length of the raw data
+ */
+void segment_emitter_finish(SegmentEmitter *emitter, uint64_t raw_data_size);
+
+/**
+ * @brief SegmentCallback writing "start, end" lines, param is a FILE *
+ */
+void segment_write_file(void *param, uint64_t start, uint64_t end);
+
+/**
+ * @brief save voice segments to a file, one "start, end" pair per line
+ *
+ * @param[in] file_dir: output file
+ * @param[in] voice_segment: 2n: start index, 2n+1: end index
+ * @param[in] voice_segment_size: number of indices in voice_segment
+ * @return error code
+ */
+int save_voice_segment(const char *file_dir, const uint64_t *voice_segment,
+                       uint64_t voice_segment_size);
+
+/**
+ * @brief load voice segments from a label or prediction file
+ *
+ * @param[in] file_dir: input file, one "start, end" pair per line
+ * @param[out] voice_segment: allocated array, 2n: start index, 2n+1: end index.
+ *             Must be released with free()
+ * @param[out] voice_segment_size: number of indices in voice_segment
+ * @return error code
+ */
+int load_voice_segment(const char *file_dir, uint64_t **voice_segment,
+                       uint64_t *voice_segment_size);
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "smooth.h"
+
+static bool smooth_config_valid(const VadSmoothConfig *config)
+{
+    return config->filter_len % 2 == 1 && config->filter_len <= VAD_SMOOTH_MAX_FILTER &&
+           config->min_speech > 0 && config->min_gap > 0 &&
+           config->off_margin <= config->on_margin;
+}
+
+void vad_smooth_default_config(VadSmoothConfig *config)
+{
+    config->on_margin  = 0.0;
+    config->off_margin = 0.0;
+    config->filter_len = 1;
+    config->min_speech = 1;
+    config->min_gap    = 1;
+}
+
+int vad_smooth_parse(const char *spec, VadSmoothConfig *config)
+{
+    int num = 0;
+
+    if (!spec || !config) {
+        return ALGO_POINTER_NULL;
+    }
+
+    vad_smooth_default_config(config);
+    num = sscanf(spec, "%u,%u,%u,%lf,%lf", &config->filter_len, &config->min_speech,
+                 &config->min_gap, &config->on_margin, &config->off_margin);
+    if (num < 3) {
+        return ALGO_DATA_EXCEPTION;
+    }
+    if (num == 4) {
+        config->off_margin = config->on_margin;
+    }
+
+    return smooth_config_valid(config) ? ALGO_NORMAL : ALGO_DATA_EXCEPTION;
+}
+
+uint32_t vad_smooth_latency(const VadSmoothConfig *config)
+{
+    uint32_t hold = config->min_speech > config->min_gap ? config->min_speech : config->min_gap;
+
+    return (config->filter_len - 1) / 2 + hold - 1;
+}
+
+int vad_smooth_init(VadSmoother *sm, const VadSmoothConfig *config, VadSmoothCallback callback,
+                    void *param)
+{
+    if (!sm || !callback) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(sm, 0, sizeof(VadSmoother));
+    if (config) {
+        sm->config = *config;
+    } else {
+        vad_smooth_default_config(&sm->config);
+    }
+
+    if (!smooth_config_valid(&sm->config)) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    sm->callback = callback;
+    sm->param    = param;
+
+    return ALGO_NORMAL;
+}
+
+// duration rules on the filtered decision of the hop at offset
+static void smooth_update(VadSmoother *sm, bool voice, uint64_t offset)
+{
+    switch (sm->state) {
+    case VAD_SMOOTH_SILENCE:
+        if (voice) {
+            sm->boundary = offset;
+            sm->run      = 1;
+            sm->state    = VAD_SMOOTH_ONSET;
+        }
+        break;
+    case VAD_SMOOTH_ONSET:
+        if (voice) {
+            sm->run++;
+        } else {
+            sm->state = VAD_SMOOTH_SILENCE;
+        }
+        break;
+    case VAD_SMOOTH_SPEECH:
+        if (!voice) {
+            sm->boundary = offset;
+            sm->run      = 1;
+            sm->state    = VAD_SMOOTH_OFFSET;
+        }
+        break;
+    case VAD_SMOOTH_OFFSET:
+        if (voice) {
+            sm->state = VAD_SMOOTH_SPEECH;
+        } else {
+            sm->run++;
+        }
+        break;
+    }
+
+    // a run is final as soon as it is long enough
+    if (sm->state == VAD_SMOOTH_ONSET && sm->run >= sm->config.min_speech) {
+        sm->callback(sm->param, VAD_SMOOTH_START, sm->boundary);
+        sm->state = VAD_SMOOTH_SPEECH;
+    } else if (sm->state == VAD_SMOOTH_OFFSET && sm->run >= sm->config.min_gap) {
+        sm->callback(sm->param, VAD_SMOOTH_END, sm->boundary);
+        sm->seg_num++;
+        sm->state = VAD_SMOOTH_SILENCE;
+    }
+}
+
+// shift one hysteresis decision into the filter, the majority refers to the
+// hop in the middle of the window
+static void smooth_filter(VadSmoother *sm, bool voice)
+{
+    uint32_t len   = sm->config.filter_len;
+    uint32_t delay = (len - 1) / 2;
+
+    sm->voice_cnt -= (sm->window >> (len - 1)) & 1;
+    sm->window = (sm->window << 1 | voice) & (uint32_t)((1ULL << len) - 1);
+    sm->voice_cnt += voice;
+    sm->hop_cnt++;
+
+    if (sm->hop_cnt > delay) {
+        smooth_update(sm, sm->voice_cnt * 2 > len,
+                      sm->offset[(sm->hop_cnt - 1 - delay) % VAD_SMOOTH_MAX_FILTER]);
+    }
+}
+
+void vad_smooth_push(VadSmoother *sm, double margin, uint64_t offset)
+{
+    sm->is_voice = margin > (sm->is_voice ? sm->config.off_margin : sm->config.on_margin);
+    sm->offset[sm->hop_cnt % VAD_SMOOTH_MAX_FILTER] = offset;
+    smooth_filter(sm, sm->is_voice);
+}
+
+void vad_smooth_finish(VadSmoother *sm, uint64_t data_size)
+{
+    uint32_t delay = (sm->config.filter_len - 1) / 2;
+    uint32_t i     = 0;
+
+    // the window is padded with non-voice past the end, as before the start
+    for (i = 0; i < delay; i++) {
+        smooth_filter(sm, false);
+    }
+
+    if (sm->state == VAD_SMOOTH_SPEECH) {
+        sm->callback(sm->param, VAD_SMOOTH_END, data_size - 1);
+        sm->seg_num++;
+    } else if (sm->state == VAD_SMOOTH_OFFSET) {
+        sm->callback(sm->param, VAD_SMOOTH_END, sm->boundary);
+        sm->seg_num++;
+    }
+    sm->state = VAD_SMOOTH_SILENCE;
+}
+
+void vad_smooth_segment(void *param, VadSmoothEvent event, uint64_t offset)
+{
+    VadSmoothSegment *seg = (VadSmoothSegment *)param;
+
+    if (event == VAD_SMOOTH_START) {
+        seg->start = offset;
+    } else {
+        seg->callback(seg->param, seg->start, offset);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMOOTH_H__
+#define __SMOOTH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "segment.h"
+#include "algo_error_code.h"
+
+#define VAD_SMOOTH_MAX_FILTER (31) // longest majority filter, the window is kept in a uint32_t
+
+/**
+ * configuration of the decision smoother, durations are in hops. The default
+ * one (filter_len, min_speech and min_gap 1, both margins 0) passes the
+ * decisions through and gives the same segments as cal_voice_segment().
+ *
+ * Worst-case added latency, on top of the frame itself:
+ *   start event: (filter_len - 1) / 2 + min_speech - 1 hops after the first voice hop
+ *   end event:   (filter_len - 1) / 2 + min_gap - 1 hops after the first non-voice hop
+ * see vad_smooth_latency
+ */
+typedef struct _VadSmoothConfig {
+    double on_margin;    // a hop becomes voice when its margin is above on_margin
+    double off_margin;   // and stays voice while its margin is above off_margin
+    uint32_t filter_len; // odd length of the majority (median) filter, 1: off
+    uint32_t min_speech; // voice runs shorter than this are dropped
+    uint32_t min_gap;    // non-voice runs shorter than this are bridged
+} VadSmoothConfig;
+
+typedef enum _VadSmoothEvent {
+    VAD_SMOOTH_START = 0, // a segment starts at offset
+    VAD_SMOOTH_END,       // the open segment ends at offset
+} VadSmoothEvent;
+
+/**
+ * @brief callback of a final segment boundary
+ *
+ * @param[in] param: user parameter of the smoother
+ * @param[in] event: start or end of a segment
+ * @param[in] offset: sample offset of the boundary
+ */
+typedef void (*VadSmoothCallback)(void *param, VadSmoothEvent event, uint64_t offset);
+
+typedef enum _VadSmoothState {
+    VAD_SMOOTH_SILENCE = 0, // no segment open
+    VAD_SMOOTH_ONSET,       // voice run shorter than min_speech
+    VAD_SMOOTH_SPEECH,      // segment open, start reported
+    VAD_SMOOTH_OFFSET,      // non-voice run shorter than min_gap inside a segment
+} VadSmoothState;
+
+/**
+ * streaming post-processor of the per-hop margins: hysteresis, majority
+ * filter and minimum speech/gap durations, with O(1) state per stream
+ */
+typedef struct _VadSmoother {
+    VadSmoothConfig config;
+    VadSmoothCallback callback; // called for every final boundary
+    void *param;                // user parameter of callback
+    uint64_t offset[VAD_SMOOTH_MAX_FILTER]; // offsets of the hops in the filter window
+    uint64_t hop_cnt;    // hops pushed
+    uint64_t boundary;   // offset of the pending start or end
+    uint64_t seg_num;    // segments closed
+    uint32_t window;     // hysteresis decisions of the last filter_len hops, bit 0 is the newest
+    uint32_t voice_cnt;  // voice decisions in window
+    uint32_t run;        // length of the pending onset or offset run
+    VadSmoothState state;
+    bool is_voice;       // hysteresis state
+} VadSmoother;
+
+/**
+ * adapter turning the events back into closed segments, see vad_smooth_segment
+ */
+typedef struct _VadSmoothSegment {
+    SegmentCallback callback; // called for every closed segment
+    void *param;              // user parameter of callback
+    uint64_t start;           // start of the open segment
+} VadSmoothSegment;
+
+/**
+ * @brief get the pass-through configuration of the smoother
+ *
+ * @param[out] config: default configuration
+ */
+void vad_smooth_default_config(VadSmoothConfig *config);
+
+/**
+ * @brief parse "filter_len,min_speech,min_gap[,on_margin[,off_margin]]",
+ * a single margin is used for both thresholds
+ *
+ * @param[in] spec: configuration string
+ * @param[out] config: parsed configuration
+ * @return error code
+ */
+int vad_smooth_parse(const char *spec, VadSmoothConfig *config);
+
+/**
+ * @brief get the worst-case latency added by the smoother
+ *
+ * @param[in] config: smoother configuration
+ * @return latency in hops
+ */
+uint32_t vad_smooth_latency(const VadSmoothConfig *config);
+
+/**
+ * @brief initialize the smoother of a stream
+ *
+ * @param[out] sm: smoother to be initialized
+ * @param[in] config: configuration, NULL for the default one
+ * @param[in] callback: called for every final boundary
+ * @param[in] param: user parameter of callback
+ * @return error code
+ */
+int vad_smooth_init(VadSmoother *sm, const VadSmoothConfig *config, VadSmoothCallback callback,
+                    void *param);
+
+/**
+ * @brief push the margin of the next hop, boundaries become final and are
+ * reported up to vad_smooth_latency hops later
+ *
+ * @param[in] sm: smoother
+ * @param[in] margin: margin of the hop, > 0 for voice, see VadContext.margin
+ * @param[in] offset: start index of the hop in the data
+ */
+void vad_smooth_push(VadSmoother *sm, double margin, uint64_t offset);
+
+/**
+ * @brief report the boundaries still pending at the end of data
+ *
+ * @param[in] sm: smoother
+ * @param[in] data_size: length of the data, an open segment ends at data_size - 1
+ */
+void vad_smooth_finish(VadSmoother *sm, uint64_t data_size);
+
+/**
+ * @brief VadSmoothCallback calling a SegmentCallback on every end event,
+ * param is a VadSmoothSegment
+ */
+void vad_smooth_segment(void *param, VadSmoothEvent event, uint64_t offset);
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __STAGE1_PARAMETERS_H__
+#define __STAGE1_PARAMETERS_H__
+
+#include "vad_section.h"
+
+// generated by ./vad_c cascade, fitted to the CNN margin
+VAD_STAGE1_WEIGHT const double stage1_weight[] = {
+    0.2012347394813645, 0.17422044671667397, 0.039708751950028827, 0.0949684406997683,
+    0.15423763227973572, 0.10563397852888896, 0.19167320610930624, 0.16298884338634223,
+    0.19896101184260309, 0.11366360537899727, 0.17701342090582864, 0.025362143495270252,
+    0.054437287725975163, 0.26726945237298066, 0.13487224762994984, 0.02431278661871061,
+    0.241150079167086, 0.20534816190263, 0.22230140811325033, 0.14714200172988384,
+    0.21576713753588206, 0.21872209205935453, 0.22643517746841277, 0.046051099244656966,
+    0.22328159446416704, 0.048826235925231762, 0.17029257283481747, 0.16034260417522922,
+    0.056418683142597716, 0.055261123662860824,
+};
+VAD_STAGE1_WEIGHT const double stage1_bias[] = {-0.04568041944306625};
+
+#endif
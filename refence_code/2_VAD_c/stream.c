@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/resource.h>
+
+#include "stream.h"
+#include "runner.h"
+
+int detect_voice_segment_stream(VadContext *ctx, WavStream *ws, VadSmoother *smoother,
+                                uint64_t *data_size)
+{
+    int ret      = ALGO_NORMAL;
+    uint64_t i   = 0, valid = 0;
+    bool vad_out = false;
+    double frame[FRAME_LEN];
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    // valid: real samples in the frame, the rest is zero padding past the end
+    valid      = wav_stream_read(ws, FRAME_LEN, frame);
+    *data_size = valid;
+
+    // same condition as the frame loop of the file mode: i + FRAME_LEN - 1 <= data_size
+    while (valid >= FRAME_LEN - 1) {
+        ret = vad_process(ctx, &vad_inp, &vad_out);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+        vad_smooth_push(smoother, ctx->margin, i);
+
+        if (valid < FRAME_LEN) {
+            break;
+        }
+
+        memmove(frame, frame + FRAME_STEP, sizeof(double) * (FRAME_LEN - FRAME_STEP));
+        valid = wav_stream_read(ws, FRAME_STEP, frame + FRAME_LEN - FRAME_STEP);
+        *data_size += valid;
+        valid += FRAME_LEN - FRAME_STEP;
+        i += FRAME_STEP;
+    }
+
+    // every exit of the loop follows a short read, the stream is exhausted
+    vad_smooth_finish(smoother, *data_size);
+
+    return ret;
+}
+
+int run_stream_file(const char *wav_dir, const char *pred_dir, const VadSmoothConfig *smooth)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t data_size = 0;
+    double start = 0.0, cost = 0.0;
+    FILE *fp     = NULL;
+    struct rusage usage;
+    VadSmoothSegment sink = {segment_write_file, NULL, 0};
+    VadSmoother smoother;
+    VadContext vad_ctx;
+    WavStream ws;
+
+    ret = wav_stream_open(wav_dir, &ws);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        return ret;
+    }
+
+    ret = wav_stream_set_resample(&ws, OBJ_FS, FRAME_STEP);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", ws.info.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    fp = fopen(pred_dir, "w");
+    if (!fp) {
+        printf("open %s fail\n", pred_dir);
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+
+    // every line is flushed to the file when the segment closes
+    setvbuf(fp, NULL, _IOLBF, 0);
+    sink.param = fp;
+    ret        = vad_smooth_init(&smoother, smooth, vad_smooth_segment, &sink);
+    if (ret != ALGO_NORMAL) {
+        printf("invalid smoothing configuration\n");
+        goto exit;
+    }
+    vad_init(&vad_ctx);
+
+    start = get_time_sec();
+    ret   = detect_voice_segment_stream(&vad_ctx, &ws, &smoother, &data_size);
+    cost  = get_time_sec() - start;
+    if (ret != ALGO_NORMAL) {
+        printf("ret = %d\n", ret);
+        goto exit;
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf("down_size = %" PRIu64 ", segments = %" PRIu64 ", smoothing latency = %u hops (%.0f ms)\n",
+           data_size, smoother.seg_num, vad_smooth_latency(&smoother.config),
+           vad_smooth_latency(&smoother.config) * FRAME_STEP * 1e3 / OBJ_FS);
+    printf("process = %.3f ms, peak RSS = %ld KB\n", cost * 1e3, usage.ru_maxrss);
+
+exit:
+    if (fp) {
+        fclose(fp);
+    }
+    wav_stream_close(&ws);
+
+    return ret;
+}
+
+#define PREROLL_READ_HOPS (2) // samples the consumer reads per hop captured, in hops
+
+/**
+ * capture side and consumer of run_preroll_file, in one thread
+ */
+typedef struct _PreRollRun {
+    PreRoll pr;
+    PreRollSeg *open;                   // segment held by the capture side
+    PreRollSeg *queue[PREROLL_SEG_NUM]; // segments held by the consumer, oldest first
+    uint32_t offset[PREROLL_SEG_NUM];   // samples of each segment read so far
+    uint32_t queue_len;
+    int16_t *capture;      // every sample stored in the ring, to check the reads
+    uint64_t capture_len;  // samples in capture
+    uint64_t read;         // samples read in place
+    uint64_t mismatch;     // samples read different from the capture
+    uint32_t seg_done;     // segments read to the end
+    uint32_t seg_lost;     // segments overwritten before they were read
+} PreRollRun;
+
+static void preroll_event(void *param, VadSmoothEvent event, uint64_t offset)
+{
+    PreRollRun *run = (PreRollRun *)param;
+    PreRollSeg *seg = NULL;
+
+    if (event == VAD_SMOOTH_START) {
+        seg = preroll_seg_open(&run->pr, offset);
+        if (seg) {
+            // the consumer takes its own reference, the capture side keeps one until the end
+            preroll_seg_ref(seg);
+            run->queue[run->queue_len++] = seg;
+        }
+        run->open = seg;
+        return;
+    }
+
+    if (run->open) {
+        preroll_seg_close(&run->pr, run->open, offset);
+        preroll_seg_unref(run->open);
+        run->open = NULL;
+    }
+}
+
+static void preroll_pop(PreRollRun *run)
+{
+    preroll_seg_unref(run->queue[0]);
+    run->queue_len--;
+    memmove(run->queue, run->queue + 1, sizeof(PreRollSeg *) * run->queue_len);
+    memmove(run->offset, run->offset + 1, sizeof(uint32_t) * run->queue_len);
+    run->offset[run->queue_len] = 0;
+}
+
+// read up to budget samples of the segments in place, oldest segment first
+static void preroll_consume(PreRollRun *run, uint64_t budget)
+{
+    const int16_t *data = NULL;
+    uint32_t len        = 0, i;
+    PreRollSeg *seg     = NULL;
+
+    while (budget && run->queue_len) {
+        seg = run->queue[0];
+        if (preroll_seg_peek(&run->pr, seg, run->offset[0], &data, &len) != ALGO_NORMAL) {
+            run->seg_lost++;
+            preroll_pop(run);
+            continue;
+        }
+
+        if (!len) {
+            if (!preroll_seg_done(seg, run->offset[0])) {
+                break; // waiting for the capture
+            }
+            run->seg_done++;
+            preroll_pop(run);
+            continue;
+        }
+
+        len = len < budget ? len : (uint32_t)budget;
+        for (i = 0; i < len; i++) {
+            run->mismatch += data[i] != run->capture[seg->start + run->offset[0] + i];
+        }
+        if (!preroll_seg_intact(&run->pr, seg, run->offset[0])) {
+            run->seg_lost++;
+            preroll_pop(run);
+            continue;
+        }
+
+        run->offset[0] += len;
+        run->read += len;
+        preroll_seg_release(seg, run->offset[0]);
+        budget -= len;
+    }
+}
+
+static void preroll_capture(PreRollRun *run, const double *frame, uint64_t len)
+{
+    int16_t pcm[FRAME_LEN];
+    double v   = 0.0;
+    uint32_t n = 0, i;
+
+    for (i = 0; i < len; i++) {
+        v      = frame[i] < 0 ? frame[i] - 0.5 : frame[i] + 0.5;
+        v      = v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v);
+        pcm[i] = (int16_t)v;
+    }
+
+    n = preroll_write(&run->pr, pcm, (uint32_t)len);
+    memcpy(run->capture + run->capture_len, pcm, sizeof(int16_t) * n);
+    run->capture_len += n;
+}
+
+int run_preroll_file(const char *wav_dir, const VadSmoothConfig *smooth, uint32_t lookback_ms,
+                     uint32_t ring_ms, PreRollPolicy policy)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t i         = 0, valid = 0, n = 0, data_size = 0;
+    uint32_t size      = 1;
+    bool vad_out       = false;
+    int16_t *ring      = NULL;
+    double frame[FRAME_LEN];
+    PreRollConfig config = {(uint32_t)((uint64_t)lookback_ms * OBJ_FS / 1000), policy};
+    const PreRollStats *stats = NULL;
+    PreRollRun run;
+    VadSmoother smoother;
+    VadContext vad_ctx;
+    WavStream ws;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    memset(&run, 0, sizeof(PreRollRun));
+    while (size < (uint64_t)ring_ms * OBJ_FS / 1000) {
+        size <<= 1;
+    }
+
+    ret = wav_stream_open(wav_dir, &ws);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        return ret;
+    }
+
+    ret = wav_stream_set_resample(&ws, OBJ_FS, FRAME_STEP);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", ws.info.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    ring        = (int16_t *)malloc(sizeof(int16_t) * size);
+    run.capture = (int16_t *)malloc(sizeof(int16_t) * (ws.info.frames + FRAME_LEN));
+    if (!ring || !run.capture) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    ret = preroll_init(&run.pr, ring, size, &config);
+    if (ret != ALGO_NORMAL) {
+        printf("invalid ring: %u samples, look-back %u samples\n", size, config.lookback);
+        goto exit;
+    }
+    ret = vad_smooth_init(&smoother, smooth, preroll_event, &run);
+    if (ret != ALGO_NORMAL) {
+        printf("invalid smoothing configuration\n");
+        goto exit;
+    }
+    vad_init(&vad_ctx);
+
+    // same frame loop as detect_voice_segment_stream, the new samples of every hop go to the ring
+    valid     = wav_stream_read(&ws, FRAME_LEN, frame);
+    data_size = valid;
+    preroll_capture(&run, frame, valid);
+    while (valid >= FRAME_LEN - 1) {
+        ret = vad_process(&vad_ctx, &vad_inp, &vad_out);
+        if (ret != ALGO_NORMAL) {
+            goto exit;
+        }
+        vad_smooth_push(&smoother, vad_ctx.margin, i);
+        preroll_consume(&run, PREROLL_READ_HOPS * FRAME_STEP);
+
+        if (valid < FRAME_LEN) {
+            break;
+        }
+
+        memmove(frame, frame + FRAME_STEP, sizeof(double) * (FRAME_LEN - FRAME_STEP));
+        n = wav_stream_read(&ws, FRAME_STEP, frame + FRAME_LEN - FRAME_STEP);
+        preroll_capture(&run, frame + FRAME_LEN - FRAME_STEP, n);
+        data_size += n;
+        valid = n + FRAME_LEN - FRAME_STEP;
+        i += FRAME_STEP;
+    }
+    vad_smooth_finish(&smoother, data_size);
+    preroll_consume(&run, UINT64_MAX);
+
+    stats = &run.pr.stats;
+    printf("ring = %u samples (%.0f ms), look-back = %u ms, smoothing latency = %.0f ms, %s\n", size,
+           size * 1e3 / OBJ_FS, lookback_ms,
+           vad_smooth_latency(&smoother.config) * FRAME_STEP * 1e3 / OBJ_FS,
+           policy == PREROLL_OVERWRITE ? "overwrite" : "keep segments");
+    printf("segments: %u opened, %u read, %u lost, %u without a handle\n", stats->seg_open,
+           run.seg_done, run.seg_lost, stats->seg_fail);
+    printf("samples: %" PRIu64 " written, %" PRIu64 " dropped, %" PRIu64 " overwritten in %u "
+           "segments, %" PRIu64 " read in place, %" PRIu64 " mismatches\n",
+           stats->written, stats->dropped, stats->overwritten, stats->seg_overrun, run.read,
+           run.mismatch);
+    printf("peak held by segments = %u samples (%.0f ms), peak handles = %u of %d\n",
+           stats->peak_held, stats->peak_held * 1e3 / OBJ_FS, stats->peak_seg, PREROLL_SEG_NUM);
+    ret = run.mismatch ? ALGO_DATA_EXCEPTION : ALGO_NORMAL;
+
+exit:
+    free(run.capture);
+    free(ring);
+    wav_stream_close(&ws);
+
+    return ret;
+}
+
+int run_resample_bench(const char *wav_dir)
+{
+    int ret          = ALGO_NORMAL;
+    uint32_t up      = 0, down = 0, in_block = 0, i = 0, n = 0;
+    uint64_t offset  = 0, out_cnt = 0, cycle = 0, start_cycle = 0;
+    double start     = 0.0, cost = 0.0;
+    double *raw      = NULL;
+    float *in        = NULL, *out = NULL;
+    Resampler rs;
+    WavFile wav;
+
+    memset(&rs, 0, sizeof(Resampler));
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        return ret;
+    }
+
+    // one VAD hop of output per block, as in the stream mode
+    resample_ratio(wav.sample_rate, OBJ_FS, &up, &down);
+    in_block = (FRAME_STEP * down + up - 1) / up;
+
+    ret = resample_init(&rs, wav.sample_rate, OBJ_FS, in_block);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    raw = (double *)malloc(sizeof(double) * in_block);
+    in  = (float *)malloc(sizeof(float) * in_block);
+    out = (float *)malloc(sizeof(float) * resample_max_out(&rs));
+    if (!raw || !in || !out) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    for (offset = 0; offset < wav.raw_frames; offset += n) {
+        n = (uint32_t)wav_read(&wav, offset, in_block, raw);
+        for (i = 0; i < n; i++) {
+            in[i] = (float)raw[i];
+        }
+
+        start       = get_time_sec();
+        start_cycle = get_cycle();
+        out_cnt += resample_process(&rs, in, n, out);
+        cycle += get_cycle() - start_cycle;
+        cost += get_time_sec() - start;
+    }
+
+    do {
+        start       = get_time_sec();
+        start_cycle = get_cycle();
+        n           = resample_flush(&rs, out);
+        cycle += get_cycle() - start_cycle;
+        cost += get_time_sec() - start;
+        out_cnt += n;
+    } while (n);
+
+    printf("%u Hz -> %d Hz, L/M = %u/%u, taps = %u, taps per phase = %u, block = %u\n",
+           wav.sample_rate, OBJ_FS, up, down, rs.filter.num_taps, rs.filter.phase_taps, in_block);
+    printf("input = %" PRIu64 ", output = %" PRIu64 ", expected = %" PRIu64 "\n", wav.raw_frames,
+           out_cnt, resample_out_num(&rs.filter, wav.raw_frames));
+    if (out_cnt) {
+        printf("cycles per output sample = %.1f, ns per output sample = %.1f, %.1fx realtime\n",
+               (double)cycle / out_cnt, cost * 1e9 / out_cnt, out_cnt / (double)OBJ_FS / cost);
+    }
+
+exit:
+    free(raw);
+    free(in);
+    free(out);
+    resample_deinit(&rs);
+    wav_close(&wav);
+
+    return ret;
+}
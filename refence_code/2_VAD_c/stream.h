@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdint.h>
+
+#include "vad.h"
+#include "wav.h"
+#include "smooth.h"
+#include "preroll.h"
+#include "algo_error_code.h"
+
+#define PREROLL_DEMO_SMOOTH "5,4,8,0.5,0.2" // smoothing of ./vad_c preroll by default, see PREROLL_SEG_NUM
+
+/**
+ * @brief run the VAD over a wav stream with one frame of history, every
+ * segment boundary is reported through the smoother as soon as it is final.
+ * The length of the data is not needed in advance, the memory used is constant.
+ *
+ * @param[in] ctx: VAD context
+ * @param[in] ws: opened wav stream, decimation already set
+ * @param[in] smoother: initialized smoother, finished on return
+ * @param[out] data_size: number of samples read from the stream
+ * @return error code
+ */
+int detect_voice_segment_stream(VadContext *ctx, WavStream *ws, VadSmoother *smoother,
+                                uint64_t *data_size);
+
+/**
+ * @brief process one wav file in bounded memory and write the voice segments
+ * to pred_dir while processing, the result is the same as the file mode
+ *
+ * @param[in] wav_dir: wav file
+ * @param[in] pred_dir: prediction file
+ * @param[in] smooth: decision smoothing, NULL: pass-through
+ * @return error code
+ */
+int run_stream_file(const char *wav_dir, const char *pred_dir, const VadSmoothConfig *smooth);
+
+/**
+ * @brief stream one wav file into a pre-roll ring while the VAD runs, open a
+ * segment handle at every smoothed onset and read each segment in place with
+ * a consumer taking two hops of samples per hop. Every sample read is checked
+ * against the capture, the ring counters are printed.
+ *
+ * @param[in] wav_dir: wav file
+ * @param[in] smooth: decision smoothing, NULL: pass-through
+ * @param[in] lookback_ms: audio kept before the onset
+ * @param[in] ring_ms: ring length, rounded up to a power of 2 samples
+ * @param[in] policy: overrun policy of the ring
+ * @return error code
+ */
+int run_preroll_file(const char *wav_dir, const VadSmoothConfig *smooth, uint32_t lookback_ms,
+                     uint32_t ring_ms, PreRollPolicy policy);
+
+/**
+ * @brief push the first channel of a wav file through the streaming
+ * Resampler to OBJ_FS in hop sized blocks and report the cost per output
+ * sample, the file is converted to float outside of the measurement
+ *
+ * @param[in] wav_dir: wav file
+ * @return error code
+ */
+int run_resample_bench(const char *wav_dir);
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <dirent.h>
+
+#include "sweep.h"
+#include "logit_cache.h"
+#include "segment.h"
+#include "evaluate.h"
+#include "runner.h"
+
+#define SWEEP_PATH_LEN (1024)
+#define SWEEP_TOP_NUM  (10)
+
+// the grid, every combination is evaluated, the first one is the pass-through
+static const uint32_t g_filter_len[] = {1, 3, 5, 7, 9};
+static const uint32_t g_min_speech[] = {1, 2, 4, 6, 8, 12};
+static const uint32_t g_min_gap[]    = {1, 2, 4, 8, 12, 16, 24};
+static const double g_on_margin[]    = {0.0, 0.25, 0.5, 0.75, 1.0, 1.5};
+static const double g_hysteresis[]   = {0.0, 0.15, 0.3, 0.5}; // on_margin - off_margin
+
+#define GRID_NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct _SweepFile {
+    char name[256];
+    LogitCache cache;
+    uint64_t *label;
+    uint64_t label_size;
+} SweepFile;
+
+typedef struct _SweepResult {
+    VadSmoothConfig config;
+    EvalEventCount event;
+    EvalCount sample;
+    int ret;
+} SweepResult;
+
+typedef struct _SweepPool {
+    const SweepFile *files;
+    uint64_t file_num;
+    uint64_t max_hop;      // longest recording, sizes the segment buffers
+    SweepResult *results;
+    uint64_t result_num;
+    uint64_t next_result;  // next configuration to be taken, protected by lock
+    pthread_mutex_t lock;
+} SweepPool;
+
+static void grid_config(uint64_t idx, VadSmoothConfig *config)
+{
+    double hysteresis = g_hysteresis[idx % GRID_NUM(g_hysteresis)];
+
+    idx /= GRID_NUM(g_hysteresis);
+    config->on_margin = g_on_margin[idx % GRID_NUM(g_on_margin)];
+    idx /= GRID_NUM(g_on_margin);
+    config->min_gap = g_min_gap[idx % GRID_NUM(g_min_gap)];
+    idx /= GRID_NUM(g_min_gap);
+    config->min_speech = g_min_speech[idx % GRID_NUM(g_min_speech)];
+    idx /= GRID_NUM(g_min_speech);
+    config->filter_len = g_filter_len[idx];
+    config->off_margin = config->on_margin - hysteresis;
+}
+
+static void run_result(const SweepPool *pool, SweepResult *result, uint64_t *seg)
+{
+    uint64_t f = 0, seg_size = 0;
+    const SweepFile *file = NULL;
+    EvalEventCount event;
+    EvalCount sample;
+
+    for (f = 0; f < pool->file_num; f++) {
+        file        = &pool->files[f];
+        result->ret = logit_cache_replay(&file->cache, &result->config, seg, &seg_size);
+        if (result->ret == ALGO_NORMAL) {
+            result->ret = eval_count_sorted(file->cache.data_size, file->label, file->label_size,
+                                            seg, seg_size, &sample);
+        }
+        if (result->ret != ALGO_NORMAL) {
+            return;
+        }
+
+        eval_event_count(file->label, file->label_size, seg, seg_size, &event);
+        result->event.label_num += event.label_num;
+        result->event.pred_num += event.pred_num;
+        result->event.hit += event.hit;
+        eval_merge(&result->sample, &sample);
+    }
+}
+
+static void *sweep_worker(void *param)
+{
+    SweepPool *pool = (SweepPool *)param;
+    uint64_t idx    = 0;
+    uint64_t *seg   = (uint64_t *)malloc(sizeof(uint64_t) * (pool->max_hop + 2));
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        idx = pool->next_result++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (idx >= pool->result_num) {
+            break;
+        }
+
+        if (!seg) {
+            pool->results[idx].ret = ALGO_MALLOC_FAIL;
+            continue;
+        }
+        run_result(pool, &pool->results[idx], seg);
+    }
+
+    free(seg);
+
+    return NULL;
+}
+
+static int cmp_file(const void *a, const void *b)
+{
+    return strcmp(((const SweepFile *)a)->name, ((const SweepFile *)b)->name);
+}
+
+static int load_files(const char *cache_dir, const char *label_dir, SweepFile **files,
+                      uint64_t *file_num)
+{
+    char path[SWEEP_PATH_LEN];
+    int ret              = ALGO_NORMAL;
+    DIR *dir             = opendir(cache_dir);
+    struct dirent *entry = NULL;
+    SweepFile *list = NULL, *tmp = NULL, *file = NULL;
+    uint64_t cnt = 0, cap = 0;
+    size_t len   = 0;
+
+    *files    = NULL;
+    *file_num = 0;
+
+    if (!dir) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        len = strlen(entry->d_name);
+        if (len <= 4 || len - 4 >= sizeof(list->name) ||
+            strcmp(entry->d_name + len - 4, ".bin")) {
+            continue;
+        }
+
+        if (cnt == cap) {
+            cap = cap ? cap * 2 : 64;
+            tmp = (SweepFile *)realloc(list, sizeof(SweepFile) * cap);
+            if (!tmp) {
+                ret = ALGO_MALLOC_FAIL;
+                break;
+            }
+            list = tmp;
+        }
+
+        file = &list[cnt];
+        memset(file, 0, sizeof(SweepFile));
+        memcpy(file->name, entry->d_name, len - 4);
+
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, entry->d_name);
+        ret = logit_cache_load(path, &file->cache);
+        if (ret == ALGO_NORMAL) {
+            snprintf(path, sizeof(path), "%s/%s.txt", label_dir, file->name);
+            ret = load_voice_segment(path, &file->label, &file->label_size);
+        }
+        if (ret != ALGO_NORMAL) {
+            printf("%s: error %d\n", file->name, ret);
+            logit_cache_free(&file->cache);
+            free(file->label);
+            break;
+        }
+        cnt++;
+    }
+    closedir(dir);
+
+    if (cnt) {
+        qsort(list, cnt, sizeof(SweepFile), cmp_file);
+    }
+
+    *files    = list;
+    *file_num = cnt;
+
+    return ret;
+}
+
+// best segment level F1 first, ties broken by the sample level F1, then by the latency
+static int cmp_result(const void *a, const void *b)
+{
+    const SweepResult *ra = (const SweepResult *)a, *rb = (const SweepResult *)b;
+    EvalMetrics ma, mb, sa, sb;
+
+    eval_event_metrics(&ra->event, &ma);
+    eval_event_metrics(&rb->event, &mb);
+    if (ma.f1_score != mb.f1_score) {
+        return ma.f1_score < mb.f1_score ? 1 : -1;
+    }
+
+    eval_metrics(&ra->sample, &sa);
+    eval_metrics(&rb->sample, &sb);
+    if (sa.f1_score != sb.f1_score) {
+        return sa.f1_score < sb.f1_score ? 1 : -1;
+    }
+
+    return (int)vad_smooth_latency(&ra->config) - (int)vad_smooth_latency(&rb->config);
+}
+
+static void print_result(const SweepResult *result)
+{
+    EvalMetrics event, sample;
+
+    eval_event_metrics(&result->event, &event);
+    eval_metrics(&result->sample, &sample);
+
+    printf("%6u %6u %6u %6.2f %6.2f %6" PRIu64 " %8.4f %8.4f %8.4f %8.4f %6u\n",
+           result->config.filter_len, result->config.min_speech, result->config.min_gap,
+           result->config.on_margin, result->config.off_margin, result->event.pred_num,
+           event.f1_score, event.recall, event.precision, sample.f1_score,
+           vad_smooth_latency(&result->config));
+}
+
+static int save_results(const char *result_dir, const SweepResult *results, uint64_t result_num)
+{
+    uint64_t i = 0;
+    FILE *fp   = fopen(result_dir, "w");
+    EvalMetrics event, sample;
+
+    if (!fp) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    fprintf(fp, "filter_len,min_speech,min_gap,on_margin,off_margin,segments,seg_f1,seg_recall,"
+                "seg_precision,f1,recall,precision,latency_hops\n");
+    for (i = 0; i < result_num; i++) {
+        eval_event_metrics(&results[i].event, &event);
+        eval_metrics(&results[i].sample, &sample);
+        fprintf(fp, "%u,%u,%u,%g,%g,%" PRIu64 ",%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%u\n",
+                results[i].config.filter_len, results[i].config.min_speech,
+                results[i].config.min_gap, results[i].config.on_margin,
+                results[i].config.off_margin, results[i].event.pred_num, event.f1_score,
+                event.recall, event.precision, sample.f1_score, sample.recall, sample.precision,
+                vad_smooth_latency(&results[i].config));
+    }
+
+    return fclose(fp) ? ALGO_IO_EXCEPTION : ALGO_NORMAL;
+}
+
+int run_smooth_sweep(const char *cache_dir, const char *label_dir, int thread_num,
+                     const char *result_dir)
+{
+    int ret             = ALGO_NORMAL;
+    int i               = 0;
+    uint64_t f          = 0, r = 0, hop_num = 0;
+    double start        = 0.0, load = 0.0, cost = 0.0;
+    SweepFile *files    = NULL;
+    pthread_t *threads  = NULL;
+    SweepResult base;
+    SweepPool pool;
+
+    memset(&pool, 0, sizeof(SweepPool));
+
+    start = get_time_sec();
+    ret   = load_files(cache_dir, label_dir, &files, &pool.file_num);
+    load  = get_time_sec() - start;
+    if (ret != ALGO_NORMAL || pool.file_num == 0) {
+        printf("no usable cache in %s, ret = %d\n", cache_dir, ret);
+        ret = ret != ALGO_NORMAL ? ret : ALGO_DATA_NULL;
+        goto exit;
+    }
+
+    pool.files = files;
+    for (f = 0; f < pool.file_num; f++) {
+        hop_num += files[f].cache.hop_num;
+        if (files[f].cache.hop_num > pool.max_hop) {
+            pool.max_hop = files[f].cache.hop_num;
+        }
+    }
+
+    pool.result_num = GRID_NUM(g_filter_len) * GRID_NUM(g_min_speech) * GRID_NUM(g_min_gap) *
+                      GRID_NUM(g_on_margin) * GRID_NUM(g_hysteresis);
+    pool.results = (SweepResult *)calloc(pool.result_num, sizeof(SweepResult));
+    if (thread_num <= 0) {
+        thread_num = get_core_num();
+    }
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * thread_num);
+    if (!pool.results || !threads) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+
+    for (r = 0; r < pool.result_num; r++) {
+        grid_config(r, &pool.results[r].config);
+    }
+
+    pthread_mutex_init(&pool.lock, NULL);
+    start = get_time_sec();
+    for (i = 0; i < thread_num; i++) {
+        if (pthread_create(&threads[i], NULL, sweep_worker, &pool) != 0) {
+            thread_num = i;
+            break;
+        }
+    }
+    for (i = 0; i < thread_num; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    cost = get_time_sec() - start;
+    pthread_mutex_destroy(&pool.lock);
+
+    if (thread_num == 0) {
+        ret = ALGO_ERR_GENERIC;
+        goto exit;
+    }
+
+    for (r = 0; r < pool.result_num; r++) {
+        if (pool.results[r].ret != ALGO_NORMAL) {
+            ret = pool.results[r].ret;
+            printf("configuration %" PRIu64 " fail, ret = %d\n", r, ret);
+            goto exit;
+        }
+    }
+
+    if (result_dir) {
+        ret = save_results(result_dir, pool.results, pool.result_num);
+        if (ret != ALGO_NORMAL) {
+            printf("save %s fail\n", result_dir);
+            goto exit;
+        }
+    }
+
+    // the first grid point is the pass-through configuration
+    base = pool.results[0];
+    qsort(pool.results, pool.result_num, sizeof(SweepResult), cmp_result);
+
+    printf("%6s %6s %6s %6s %6s %6s %8s %8s %8s %8s %6s\n", "filter", "speech", "gap", "on",
+           "off", "segs", "seg_f1", "seg_rec", "seg_prec", "f1", "delay");
+    print_result(&base);
+    for (r = 0; r < pool.result_num && r < SWEEP_TOP_NUM; r++) {
+        print_result(&pool.results[r]);
+    }
+
+    printf("files: %" PRIu64 ", hops: %" PRIu64 ", configurations: %" PRIu64 ", threads: %d\n",
+           pool.file_num, hop_num, pool.result_num, thread_num);
+    printf("load = %.3f ms, sweep = %.3f ms, %.1f us per configuration\n", load * 1e3, cost * 1e3,
+           cost * 1e6 / pool.result_num);
+
+exit:
+    for (f = 0; f < pool.file_num; f++) {
+        logit_cache_free(&files[f].cache);
+        free(files[f].label);
+    }
+    free(files);
+    free(pool.results);
+    free(threads);
+
+    return ret;
+}
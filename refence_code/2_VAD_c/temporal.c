@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "temporal.h"
+
+// steps kept by the ring of a conv layer, the newest one included
+static uint16_t ring_len(const CausalConv1d *layer)
+{
+    return (uint16_t)((layer->kernel - 1) * layer->dilation + 1);
+}
+
+int temporal_net_check(const TemporalNet *net)
+{
+    uint16_t i = 0, channel = 0;
+    uint32_t history = 0;
+    const CausalConv1d *layer = NULL;
+
+    if (!net || (net->conv_num && !net->conv)) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (net->conv_num > TEMPORAL_MAX_LAYER) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    for (i = 0; i < net->conv_num; i++) {
+        layer = &net->conv[i];
+        if (!layer->weight) {
+            return ALGO_POINTER_NULL;
+        }
+        if (!layer->inp_channel || !layer->out_channel || !layer->kernel || !layer->dilation ||
+            (i && layer->inp_channel != channel)) {
+            return ALGO_DATA_INVALID;
+        }
+        if (layer->inp_channel > TEMPORAL_MAX_CHANNEL || layer->out_channel > TEMPORAL_MAX_CHANNEL ||
+            (uint32_t)(layer->kernel - 1) * layer->dilation + 1 > UINT16_MAX) {
+            return ALGO_DATA_TOO_MANY;
+        }
+        channel = layer->out_channel;
+        history += (uint32_t)ring_len(layer) * layer->inp_channel;
+    }
+
+    if (history > TEMPORAL_HISTORY_SIZE) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    if (net->gru) {
+        if (!net->gru->weight_ih || !net->gru->weight_hh || !net->gru->bias_ih ||
+            !net->gru->bias_hh) {
+            return ALGO_POINTER_NULL;
+        }
+        if (!net->gru->inp_size || !net->gru->hidden_size ||
+            (net->conv_num && net->gru->inp_size != channel)) {
+            return ALGO_DATA_INVALID;
+        }
+        if (net->gru->inp_size > TEMPORAL_MAX_CHANNEL ||
+            net->gru->hidden_size > TEMPORAL_MAX_CHANNEL) {
+            return ALGO_DATA_TOO_MANY;
+        }
+    } else if (!net->conv_num) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+uint32_t temporal_receptive_field(const TemporalNet *net)
+{
+    uint16_t i     = 0;
+    uint32_t steps = 1;
+
+    for (i = 0; i < net->conv_num; i++) {
+        steps += ring_len(&net->conv[i]) - 1;
+    }
+
+    return steps;
+}
+
+uint32_t temporal_history_size(const TemporalNet *net)
+{
+    uint16_t i    = 0;
+    uint32_t size = 0;
+
+    for (i = 0; i < net->conv_num; i++) {
+        size += (uint32_t)ring_len(&net->conv[i]) * net->conv[i].inp_channel;
+    }
+
+    return size;
+}
+
+void temporal_net_size(const TemporalNet *net, uint16_t *inp_size, uint16_t *out_size)
+{
+    *inp_size = net->conv_num ? net->conv[0].inp_channel : net->gru->inp_size;
+    *out_size = net->gru ? net->gru->hidden_size : net->conv[net->conv_num - 1].out_channel;
+}
+
+int temporal_reset(const TemporalNet *net, TemporalState *state)
+{
+    int ret         = ALGO_NORMAL;
+    uint16_t i      = 0;
+    uint32_t offset = 0;
+
+    if (!state) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = temporal_net_check(net);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    memset(state, 0, sizeof(TemporalState));
+    for (i = 0; i < net->conv_num; i++) {
+        state->offset[i] = offset;
+        offset += (uint32_t)ring_len(&net->conv[i]) * net->conv[i].inp_channel;
+    }
+
+    return ALGO_NORMAL;
+}
+
+int causal_conv1d_step(const CausalConv1d *layer, double *ring, uint16_t *head, const double *inp,
+                       double *out)
+{
+    uint16_t len = 0, o = 0, c = 0, k = 0, slot = 0;
+    const double *w = NULL;
+    double acc = 0.0;
+
+    if (!layer || !ring || !head || !inp || !out) {
+        return ALGO_POINTER_NULL;
+    }
+
+    len   = ring_len(layer);
+    *head = (uint16_t)(*head + 1 == len ? 0 : *head + 1);
+    memcpy(ring + (uint32_t)*head * layer->inp_channel, inp, sizeof(double) * layer->inp_channel);
+
+    for (o = 0; o < layer->out_channel; o++) {
+        acc = layer->bias ? layer->bias[o] : 0.0;
+        for (c = 0; c < layer->inp_channel; c++) {
+            w = layer->weight + ((uint32_t)o * layer->inp_channel + c) * layer->kernel;
+
+            // tap k reads the step (kernel - 1 - k) * dilation before the newest one
+            slot = *head;
+            for (k = layer->kernel; k-- > 0;) {
+                acc += w[k] * ring[(uint32_t)slot * layer->inp_channel + c];
+                slot = (uint16_t)(slot >= layer->dilation ? slot - layer->dilation
+                                                          : slot + len - layer->dilation);
+            }
+        }
+        out[o] = acc < 0.0 ? layer->neg_slope * acc : acc;
+    }
+
+    return ALGO_NORMAL;
+}
+
+static double sigmoid(double x)
+{
+    return 1.0 / (1.0 + exp(-x));
+}
+
+// row of a weight matrix times a vector
+static double dot(const double *w, const double *x, uint16_t size)
+{
+    uint16_t i = 0;
+    double acc = 0.0;
+
+    for (i = 0; i < size; i++) {
+        acc += w[i] * x[i];
+    }
+
+    return acc;
+}
+
+int gru_cell_step(const GruCell *cell, double *hidden, const double *inp)
+{
+    uint16_t j = 0, h = 0, in = 0;
+    double r = 0.0, z = 0.0, n = 0.0;
+    double next[TEMPORAL_MAX_CHANNEL];
+
+    if (!cell || !hidden || !inp) {
+        return ALGO_POINTER_NULL;
+    }
+
+    h  = cell->hidden_size;
+    in = cell->inp_size;
+    if (h > TEMPORAL_MAX_CHANNEL) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    for (j = 0; j < h; j++) {
+        r = sigmoid(dot(cell->weight_ih + (uint32_t)j * in, inp, in) + cell->bias_ih[j] +
+                    dot(cell->weight_hh + (uint32_t)j * h, hidden, h) + cell->bias_hh[j]);
+        z = sigmoid(dot(cell->weight_ih + (uint32_t)(h + j) * in, inp, in) + cell->bias_ih[h + j] +
+                    dot(cell->weight_hh + (uint32_t)(h + j) * h, hidden, h) +
+                    cell->bias_hh[h + j]);
+        n = tanh(dot(cell->weight_ih + (uint32_t)(2 * h + j) * in, inp, in) +
+                 cell->bias_ih[2 * h + j] +
+                 r * (dot(cell->weight_hh + (uint32_t)(2 * h + j) * h, hidden, h) +
+                      cell->bias_hh[2 * h + j]));
+        next[j] = (1.0 - z) * n + z * hidden[j];
+    }
+
+    // every gate reads the old state
+    memcpy(hidden, next, sizeof(double) * h);
+
+    return ALGO_NORMAL;
+}
+
+int temporal_step(const TemporalNet *net, TemporalState *state, const double *inp, double *out)
+{
+    int ret    = ALGO_NORMAL;
+    uint16_t i = 0, size = 0;
+    double buf[2][TEMPORAL_MAX_CHANNEL];
+    const double *x = inp;
+
+    if (!net || !state || !inp || !out) {
+        return ALGO_POINTER_NULL;
+    }
+
+    for (i = 0; i < net->conv_num; i++) {
+        ret = causal_conv1d_step(&net->conv[i], state->history + state->offset[i], &state->head[i],
+                                 x, buf[i & 1]);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+        x = buf[i & 1];
+    }
+
+    if (net->gru) {
+        ret = gru_cell_step(net->gru, state->hidden, x);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+        x = state->hidden;
+    }
+
+    size = net->gru ? net->gru->hidden_size : net->conv[net->conv_num - 1].out_channel;
+    memcpy(out, x, sizeof(double) * size);
+    state->step++;
+
+    return ALGO_NORMAL;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TEMPORAL_H__
+#define __TEMPORAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "algo_error_code.h"
+
+#define TEMPORAL_MAX_LAYER    (8)    // causal conv layers of a net
+#define TEMPORAL_MAX_CHANNEL  (32)   // values of a time step, also the GRU hidden size
+#define TEMPORAL_HISTORY_SIZE (1024) // doubles of the ring buffers of all layers of a stream
+
+/**
+ * causal dilated 1-D conv over time steps (hops), PyTorch Conv1d layout with
+ * (kernel - 1) * dilation zeros padded on the left, followed by a LeakyReLU
+ */
+typedef struct _CausalConv1d {
+    uint16_t inp_channel;
+    uint16_t out_channel;
+    uint16_t kernel;
+    uint16_t dilation;
+    const double *weight; // out_channel x inp_channel x kernel, tap kernel - 1 is the newest step
+    const double *bias;   // out_channel, NULL for none
+    double neg_slope;     // of the LeakyReLU, 1 for none
+} CausalConv1d;
+
+/**
+ * GRU cell, PyTorch nn.GRU layout: rows of the weights are the reset,
+ * update and new gates, h' = (1 - z) * n + z * h
+ */
+typedef struct _GruCell {
+    uint16_t inp_size;
+    uint16_t hidden_size;
+    const double *weight_ih; // 3 * hidden_size x inp_size
+    const double *weight_hh; // 3 * hidden_size x hidden_size
+    const double *bias_ih;   // 3 * hidden_size
+    const double *bias_hh;   // 3 * hidden_size
+} GruCell;
+
+/**
+ * stack of causal convs followed by an optional GRU, run one time step at
+ * a time. Every layer keeps its own past inputs, so a step costs the same
+ * however far the receptive field reaches.
+ */
+typedef struct _TemporalNet {
+    const CausalConv1d *conv;
+    uint16_t conv_num;
+    const GruCell *gru; // NULL for none
+} TemporalNet;
+
+/**
+ * per-stream state of a TemporalNet
+ */
+typedef struct _TemporalState {
+    double history[TEMPORAL_HISTORY_SIZE]; // ring buffers of the conv inputs, one after the other
+    uint32_t offset[TEMPORAL_MAX_LAYER];   // of the ring of each conv layer in history
+    uint16_t head[TEMPORAL_MAX_LAYER];     // slot of the newest step in each ring
+    double hidden[TEMPORAL_MAX_CHANNEL];   // GRU state
+    uint64_t step;                         // steps since the reset
+} TemporalState;
+
+/**
+ * @brief check that the layers chain and that the state of a stream fits
+ *
+ * @param[in] net: temporal net
+ * @return error code, ALGO_DATA_TOO_MANY if a limit of this header is exceeded
+ */
+int temporal_net_check(const TemporalNet *net);
+
+/**
+ * @brief time steps seen by the conv stack, the GRU adds unbounded context
+ *
+ * @param[in] net: checked temporal net
+ * @return steps, 1 without conv layers
+ */
+uint32_t temporal_receptive_field(const TemporalNet *net);
+
+/**
+ * @brief doubles of ring buffer used by a net
+ *
+ * @param[in] net: checked temporal net
+ * @return doubles
+ */
+uint32_t temporal_history_size(const TemporalNet *net);
+
+/**
+ * @brief values of the input and of the output of a time step
+ *
+ * @param[in] net: checked temporal net
+ * @param[out] inp_size: input values
+ * @param[out] out_size: output values
+ */
+void temporal_net_size(const TemporalNet *net, uint16_t *inp_size, uint16_t *out_size);
+
+/**
+ * @brief clear the state, the past is zero like the padding of PyTorch
+ *
+ * @param[in] net: temporal net
+ * @param[out] state: state of one stream
+ * @return error code
+ */
+int temporal_reset(const TemporalNet *net, TemporalState *state);
+
+/**
+ * @brief one step of a causal conv: push the input into the ring and
+ * compute the output of the newest step
+ *
+ * @param[in] layer: conv layer
+ * @param[in,out] ring: (kernel - 1) * dilation + 1 steps of inp_channel values
+ * @param[in,out] head: slot of the newest step
+ * @param[in] inp: inp_channel values of the new step
+ * @param[out] out: out_channel values
+ * @return error code
+ */
+int causal_conv1d_step(const CausalConv1d *layer, double *ring, uint16_t *head, const double *inp,
+                       double *out);
+
+/**
+ * @brief one step of a GRU cell
+ *
+ * @param[in] cell: GRU cell
+ * @param[in,out] hidden: hidden_size values of the state, updated
+ * @param[in] inp: inp_size values
+ * @return error code
+ */
+int gru_cell_step(const GruCell *cell, double *hidden, const double *inp);
+
+/**
+ * @brief run one time step through the net
+ *
+ * @param[in] net: checked temporal net
+ * @param[in,out] state: state of the stream
+ * @param[in] inp: input values of the step
+ * @param[out] out: output values, the GRU state or the last conv output
+ * @return error code
+ */
+int temporal_step(const TemporalNet *net, TemporalState *state, const double *inp, double *out);
+
+#endif
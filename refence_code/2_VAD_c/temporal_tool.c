@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "temporal_tool.h"
+#include "vad_temporal.h"
+#include "runner.h"
+#include "segment.h"
+#include "smooth.h"
+#include "wav.h"
+
+#define BENCH_FEAT_NUM (8)    // values of a time step
+#define BENCH_KERNEL   (3)
+#define BENCH_STEP_NUM (2000) // hops streamed per configuration
+#define BENCH_MAX_CONV (5)
+
+static uint32_t g_seed = 1;
+
+// uniform in [-1, 1)
+static double bench_rand(void)
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+
+    return (double)(g_seed >> 8) / (1 << 23) - 1.0;
+}
+
+static void fill_rand(double *data, uint32_t size, double scale)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < size; i++) {
+        data[i] = bench_rand() * scale;
+    }
+}
+
+/**
+ * offline causal conv over a whole sequence like PyTorch: steps before the
+ * first one are zero. inp and out are step major, num x channel.
+ */
+static void conv_sequence(const CausalConv1d *layer, const double *inp, uint32_t num, double *out)
+{
+    uint32_t t = 0;
+    uint16_t o = 0, c = 0, k = 0;
+    int64_t src = 0;
+    double acc = 0.0;
+
+    for (t = 0; t < num; t++) {
+        for (o = 0; o < layer->out_channel; o++) {
+            acc = layer->bias ? layer->bias[o] : 0.0;
+            for (c = 0; c < layer->inp_channel; c++) {
+                for (k = layer->kernel; k-- > 0;) {
+                    src = (int64_t)t - (int64_t)(layer->kernel - 1 - k) * layer->dilation;
+                    if (src >= 0) {
+                        acc += layer->weight[((uint32_t)o * layer->inp_channel + c) * layer->kernel +
+                                             k] *
+                               inp[src * layer->inp_channel + c];
+                    }
+                }
+            }
+            out[t * layer->out_channel + o] = acc < 0.0 ? layer->neg_slope * acc : acc;
+        }
+    }
+}
+
+// the conv stack of a net over a sequence, the result is left in buf[conv_num & 1]
+static const double *net_sequence(const TemporalNet *net, const double *inp, uint32_t num,
+                                  double *buf[2])
+{
+    uint16_t i      = 0;
+    const double *x = inp;
+
+    for (i = 0; i < net->conv_num; i++) {
+        conv_sequence(&net->conv[i], x, num, buf[i & 1]);
+        x = buf[i & 1];
+    }
+
+    return x;
+}
+
+static int bench_net(uint16_t conv_num, const double *inp, double *buf[2])
+{
+    int ret = ALGO_NORMAL;
+    uint16_t i = 0, inp_size = 0, out_size = 0;
+    uint32_t t = 0, field = 0;
+    uint64_t start = 0, stream_cycle = 0, window_cycle = 0;
+    double err = 0.0, out[TEMPORAL_MAX_CHANNEL];
+    double weight[BENCH_MAX_CONV][BENCH_FEAT_NUM * BENCH_FEAT_NUM * BENCH_KERNEL];
+    double bias[BENCH_MAX_CONV][BENCH_FEAT_NUM];
+    double gru_w[2][3 * BENCH_FEAT_NUM * BENCH_FEAT_NUM], gru_b[2][3 * BENCH_FEAT_NUM];
+    double hidden[TEMPORAL_MAX_CHANNEL];
+    const double *ref = NULL;
+    CausalConv1d conv[BENCH_MAX_CONV];
+    GruCell gru;
+    TemporalNet net;
+    static TemporalState state;
+
+    for (i = 0; i < conv_num; i++) {
+        fill_rand(weight[i], BENCH_FEAT_NUM * BENCH_FEAT_NUM * BENCH_KERNEL,
+                  1.0 / sqrt(BENCH_FEAT_NUM * BENCH_KERNEL));
+        fill_rand(bias[i], BENCH_FEAT_NUM, 0.1);
+        conv[i] = (CausalConv1d){.inp_channel = BENCH_FEAT_NUM, .out_channel = BENCH_FEAT_NUM,
+                                 .kernel = BENCH_KERNEL, .dilation = (uint16_t)(1 << i),
+                                 .weight = weight[i], .bias = bias[i], .neg_slope = 0.01};
+    }
+    fill_rand(gru_w[0], 3 * BENCH_FEAT_NUM * BENCH_FEAT_NUM, 1.0 / sqrt(BENCH_FEAT_NUM));
+    fill_rand(gru_w[1], 3 * BENCH_FEAT_NUM * BENCH_FEAT_NUM, 1.0 / sqrt(BENCH_FEAT_NUM));
+    fill_rand(gru_b[0], 3 * BENCH_FEAT_NUM, 0.1);
+    fill_rand(gru_b[1], 3 * BENCH_FEAT_NUM, 0.1);
+    gru = (GruCell){.inp_size = BENCH_FEAT_NUM, .hidden_size = BENCH_FEAT_NUM,
+                    .weight_ih = gru_w[0], .weight_hh = gru_w[1], .bias_ih = gru_b[0],
+                    .bias_hh = gru_b[1]};
+    net = (TemporalNet){.conv = conv, .conv_num = conv_num, .gru = &gru};
+
+    ret = temporal_reset(&net, &state);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    temporal_net_size(&net, &inp_size, &out_size);
+    field = temporal_receptive_field(&net);
+
+    // the offline conv stack and GRU give the reference of every step
+    ref = net_sequence(&net, inp, BENCH_STEP_NUM, buf);
+    memset(hidden, 0, sizeof(hidden));
+    for (t = 0; t < BENCH_STEP_NUM; t++) {
+        start = get_cycle();
+        ret   = temporal_step(&net, &state, inp + t * inp_size, out);
+        stream_cycle += get_cycle() - start;
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+
+        gru_cell_step(&gru, hidden, ref + t * BENCH_FEAT_NUM);
+        for (i = 0; i < out_size; i++) {
+            err = fabs(out[i] - hidden[i]) > err ? fabs(out[i] - hidden[i]) : err;
+        }
+    }
+
+    // a stateless model sees the same context by recomputing the whole window every hop
+    for (t = field; t < BENCH_STEP_NUM; t++) {
+        start = get_cycle();
+        net_sequence(&net, inp + (t - field) * inp_size, field, buf);
+        window_cycle += get_cycle() - start;
+    }
+
+    printf("%6u  %4u %6u ms %7zu %10.0f %10.0f  %.1e\n", conv_num, field,
+           ((field - 1) * FRAME_STEP + FRAME_LEN) * 1000 / OBJ_FS,
+           sizeof(double) * (temporal_history_size(&net) + out_size),
+           (double)stream_cycle / BENCH_STEP_NUM,
+           (double)window_cycle / (BENCH_STEP_NUM - field), err);
+
+    return ALGO_NORMAL;
+}
+
+static int run_temporal_bench(void)
+{
+    int ret    = ALGO_NORMAL;
+    uint16_t i = 0;
+    uint64_t start = 0, cnn_cycle = 0;
+    double margin = 0.0, frame[FRAME_LEN];
+    double *inp = NULL, *buf[2] = {NULL, NULL};
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+    VadContext ctx;
+
+    inp    = (double *)malloc(sizeof(double) * BENCH_STEP_NUM * BENCH_FEAT_NUM);
+    buf[0] = (double *)malloc(sizeof(double) * BENCH_STEP_NUM * BENCH_FEAT_NUM);
+    buf[1] = (double *)malloc(sizeof(double) * BENCH_STEP_NUM * BENCH_FEAT_NUM);
+    if (!inp || !buf[0] || !buf[1]) {
+        ret = ALGO_MALLOC_FAIL;
+        goto exit;
+    }
+    fill_rand(inp, BENCH_STEP_NUM * BENCH_FEAT_NUM, 1.0);
+
+    // the CNN of one hop, for scale
+    vad_init(&ctx);
+    fill_rand(frame, FRAME_LEN, 1000.0);
+    for (i = 0; i < 1000; i++) {
+        start = get_cycle();
+        vad_margin(&ctx, &vad_inp, &margin);
+        cnn_cycle += get_cycle() - start;
+    }
+
+    printf("causal convs of %u channels, kernel %u, dilation 1, 2, 4.., then a GRU of %u, %u hops\n",
+           BENCH_FEAT_NUM, BENCH_KERNEL, BENCH_FEAT_NUM, BENCH_STEP_NUM);
+    printf("CNN of the built-in model: %.0f cycles/hop; stream: cycles/hop of the convs and GRU;\n"
+           "recompute: cycles/hop of the conv stack over the whole receptive field, without state\n",
+           (double)cnn_cycle / 1000);
+    printf("%6s  %4s %9s %7s %10s %10s  %s\n", "convs", "hops", "context", "state", "stream",
+           "recompute", "err");
+    for (i = 0; i <= BENCH_MAX_CONV; i++) {
+        ret = bench_net(i, inp, buf);
+        if (ret != ALGO_NORMAL) {
+            printf("%u convs fail, ret = %d\n", i, ret);
+            break;
+        }
+    }
+
+exit:
+    free(inp);
+    free(buf[0]);
+    free(buf[1]);
+
+    return ret;
+}
+
+#if VAD_TEMPORAL_MODEL
+static int run_temporal_file(const char *wav_dir, const char *pred_dir, const char *margin_dir)
+{
+    int ret            = ALGO_NORMAL;
+    uint64_t hop = 0, frame_num = 0, offset = 0, compared = 0, start = 0, cycle = 0;
+    double margin = 0.0, ref = 0.0, err = 0.0;
+    double frame[FRAME_LEN];
+    FILE *fp = NULL, *ref_fp = NULL;
+    VadSmoothSegment sink = {segment_write_file, NULL, 0};
+    VadSmoother smoother;
+    static VadTemporalContext ctx;
+    WavFile wav;
+
+    Conv2dData vad_inp = {.channel = 1, .row = 1, .col = FRAME_LEN, .data = frame};
+
+    ret = vad_temporal_init(&ctx, vad_temporal_default());
+    if (ret != ALGO_NORMAL) {
+        printf("invalid temporal model, ret = %d\n", ret);
+        return ret;
+    }
+
+    ret = wav_open(wav_dir, &wav);
+    if (ret != ALGO_NORMAL) {
+        printf("open %s fail, ret = %d\n", wav_dir, ret);
+        return ret;
+    }
+
+    ret = wav_set_resample(&wav, OBJ_FS);
+    if (ret != ALGO_NORMAL) {
+        printf("cannot resample %u Hz to %d Hz\n", wav.sample_rate, OBJ_FS);
+        goto exit;
+    }
+
+    fp = fopen(pred_dir, "w");
+    if (!fp || (margin_dir && !(ref_fp = fopen(margin_dir, "r")))) {
+        ret = ALGO_IO_EXCEPTION;
+        goto exit;
+    }
+
+    sink.param = fp;
+    vad_smooth_init(&smoother, NULL, vad_smooth_segment, &sink);
+    frame_num = cal_frame_num(wav.frames);
+
+    for (hop = 0; hop < frame_num; hop++, offset += FRAME_STEP) {
+        load_frame(&wav, offset, hop == 0, frame);
+
+        start = get_cycle();
+        ret   = vad_temporal_margin(&ctx, &vad_inp, &margin);
+        cycle += get_cycle() - start;
+        if (ret != ALGO_NORMAL) {
+            printf("ret = %d\n", ret);
+            goto exit;
+        }
+
+        if (ref_fp && fscanf(ref_fp, "%lf", &ref) == 1) {
+            err = fabs(margin - ref) > err ? fabs(margin - ref) : err;
+            compared++;
+        }
+        vad_smooth_push(&smoother, margin, offset);
+    }
+    vad_smooth_finish(&smoother, wav.frames);
+
+    printf("hops = %" PRIu64 ", segments = %" PRIu64 ", %.0f cycles/hop, receptive field = %u hops\n",
+           frame_num, smoother.seg_num, frame_num ? (double)cycle / frame_num : 0.0,
+           temporal_receptive_field(&ctx.model->net));
+    if (ref_fp) {
+        printf("margins compared with PyTorch = %" PRIu64 ", max difference = %.3e\n", compared,
+               err);
+    }
+
+exit:
+    if (fp) {
+        fclose(fp);
+    }
+    if (ref_fp) {
+        fclose(ref_fp);
+    }
+    wav_close(&wav);
+
+    return ret;
+}
+#endif
+
+int run_temporal_tool(const char *cmd, const char *arg0, const char *arg1, const char *arg2)
+{
+    if (!strcmp(cmd, "bench")) {
+        return run_temporal_bench();
+    }
+
+    if (!strcmp(cmd, "run") && arg0 && arg1) {
+#if VAD_TEMPORAL_MODEL
+        return run_temporal_file(arg0, arg1, arg2);
+#else
+        (void)arg2;
+        printf("built without a temporal model: export one with 1_VAD_python/export.py to\n"
+               "temporal_parameters.h and rebuild with -DVAD_TEMPORAL_MODEL=1\n");
+        return ALGO_DATA_INVALID;
+#endif
+    }
+
+    printf("unknown temporal command %s\n", cmd);
+
+    return ALGO_DATA_INVALID;
+}
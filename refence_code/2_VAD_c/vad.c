@@ -27,61 +27,481 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <math.h>
+
 #include "vad.h"
 #include "model_parameters.h"
+#include "stage1_parameters.h"
 
-int vad(Conv2dData *inp_data, bool *is_voice)
+_Static_assert(VAD_GRAPH_ARENA_BYTES <= VAD_GRAPH_ARENA_BUDGET,
+               "vad_graph_plan.h: the arena of the built-in graph is over VAD_GRAPH_ARENA_BUDGET");
+
+// tensors are numbered in layer order, the last one is the output:
+// 0 frame, 1 conv, 2 BN, 3 LeakyReLU, 4 logits
+static const GraphLayer g_vad_graph_layers[] = {
+    {.type = GRAPH_OP_CONV2D, .inp = 0, .out = 1, .param = {VAD_FILTER_NUM, 1, 2, 2, 0, 0},
+     .tensor = {model_0_weight, NULL}},
+    {.type = GRAPH_OP_BATCHNORM, .inp = 1, .out = 2,
+     .tensor = {model_1_weight, model_1_bias, model_1_running_mean, model_1_running_var}},
+    {.type = GRAPH_OP_LEAKY_RELU, .inp = 2, .out = 3, .alpha = 0.01},
+    {.type = GRAPH_OP_LINEAR, .inp = 3, .out = 4, .param = {2},
+     .tensor = {output_weight, output_bias}},
+};
+
+static const GraphTensor g_vad_graph_tensors[VAD_GRAPH_TENSOR_NUM] = VAD_GRAPH_TENSORS;
+
+int vad_init(VadContext *ctx)
+{
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    memset(ctx, 0, sizeof(VadContext));
+    ctx->model = vad_model_default();
+
+    return ALGO_NORMAL;
+}
+
+const VadModel *vad_model_default(void)
 {
-    int ret               = ALGO_NORMAL;
-    uint16_t conv_out_len = 0;
-    double linear_out[2]  = {0};
-
-    Conv2dFilter filter = {
-        .channel = 1, .col = 2, .row = 1, .filter_num = 2, .data = model_0_weight};
-    BatchNorm2d bn            = {.beta  = model_1_bias,
-                                 .gamma = model_1_weight,
-                                 .mean  = model_1_running_mean,
-                                 .var   = model_1_running_var,
-                                 .size  = 2};
-    Conv2dConfig conv_config  = {.pad = 0, .stride = 2, .bn = &bn, .filter = &filter};
-    LinearParam linear_config = {
-        .inp_size = 240, .fea_size = 2, .weight = output_weight, .bias = output_bias};
+    static const VadModel model = {
+        .filter    = {.channel = 1, .col = 2, .row = 1, .filter_num = VAD_FILTER_NUM,
+                      .data = (double *)model_0_weight},
+        .bn        = {.beta  = (double *)model_1_bias,
+                      .gamma = (double *)model_1_weight,
+                      .mean  = (double *)model_1_running_mean,
+                      .var   = (double *)model_1_running_var,
+                      .size  = VAD_FILTER_NUM},
+        .conv      = {.pad = 0, .stride = 2, .bn = (BatchNorm2d *)&model.bn,
+                      .filter = (Conv2dFilter *)&model.filter},
+        .linear    = {.inp_size = VAD_CONV_OUT_LEN * VAD_FILTER_NUM, .fea_size = 2,
+                      .weight = (double *)output_weight, .bias = (double *)output_bias},
+        .neg_slope = 0.01,
+        .frame_len = FRAME_LEN,
+        .model_id  = 0,
+    };
+
+    return &model;
+}
+
+int vad_model_check(const VadModel *model)
+{
+    const Conv2dFilter *filter = NULL;
+    uint32_t out_len = 0;
+
+    if (!model || model->conv.filter != &model->filter || model->conv.bn != &model->bn ||
+        !model->filter.data || !model->bn.mean || !model->bn.var || !model->bn.gamma ||
+        !model->bn.beta || !model->linear.weight || !model->linear.bias) {
+        return ALGO_POINTER_NULL;
+    }
+
+    filter = &model->filter;
+    if (filter->channel != 1 || filter->row != 1 || filter->col == 0 || model->conv.stride == 0 ||
+        model->frame_len + 2 * model->conv.pad < filter->col) {
+        return ALGO_DATA_INVALID;
+    }
+
+    // the whole conv output lives in VadContext.conv_out
+    out_len = cal_conv_out_len(model->frame_len, model->conv.pad, filter->col, model->conv.stride);
+    if ((uint32_t)out_len * filter->filter_num > VAD_CONV_OUT_LEN * VAD_FILTER_NUM) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    if (model->bn.size != filter->filter_num ||
+        model->linear.inp_size != out_len * filter->filter_num || model->linear.fea_size != 2) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+int vad_set_model(VadContext *ctx, const VadModel *model)
+{
+    int ret = ALGO_NORMAL;
+
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (!model) {
+        model = vad_model_default();
+    }
+
+    ret = vad_model_check(model);
+    if (ret == ALGO_NORMAL) {
+        ctx->model = model;
+    }
+
+    return ret;
+}
+
+int vad_enable_gate(VadContext *ctx, const VadGateConfig *config)
+{
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ctx->use_gate = true;
+
+    return vad_gate_init(&ctx->gate, config);
+}
+
+int vad_enable_cascade(VadContext *ctx, const VadCascadeConfig *config)
+{
+    static const VadCascadeConfig default_config = {-VAD_CASCADE_BAND, VAD_CASCADE_BAND, NULL};
+
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (config->band_lo > 0 || config->band_hi < 0) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    memset(&ctx->cascade, 0, sizeof(VadCascade));
+    ctx->cascade.config = *config;
+    if (!ctx->cascade.config.model) {
+        ctx->cascade.config.model = vad_stage1_default();
+    }
+    ctx->use_cascade = true;
+
+    return ALGO_NORMAL;
+}
+
+int vad_enable_decimate(VadContext *ctx, const VadDecimateConfig *config)
+{
+    static const VadDecimateConfig default_config = {VAD_DECIMATE_SILENCE, VAD_DECIMATE_STRIDE};
+    VadGateConfig rise;
+
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (!config) {
+        config = &default_config;
+    }
+
+    if (config->silence_hops == 0 || config->max_stride == 0) {
+        return ALGO_DATA_INVALID;
+    }
+
+    memset(&ctx->decimate, 0, sizeof(VadDecimate));
+    ctx->decimate.config = *config;
+    ctx->decimate.stride = 1;
+    ctx->decimate.margin = -INFINITY;
+
+    // any active hop of the pre-gate is a rise, the hangover would only delay the next widening
+    vad_gate_default_config(&rise);
+    rise.hangover = 0;
+    ctx->use_decimate = true;
+
+    return vad_gate_init(&ctx->decimate.rise, &rise);
+}
+
+const VadStage1Model *vad_stage1_default(void)
+{
+    static const VadStage1Model model = {.weight = stage1_weight, .bias = stage1_bias};
+
+    return &model;
+}
+
+VAD_RAM_TEXT int vad_stage1_feature(const Conv2dData *inp_data, double *fea)
+{
+    uint16_t i = 0, k = 0;
+    double scale = 0.0, tmp = 0.0;
+    const double *x = NULL;
+
+    if (!inp_data || !inp_data->data || !fea) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (inp_data->col < FRAME_LEN) {
+        return ALGO_DATA_NOT_ENOUGH;
+    }
+
+    // same conv + BN + LeakyReLU as the CNN, only at every VAD_STAGE1_STEP-th output
+    for (i = 0; i < VAD_FILTER_NUM; i++) {
+        scale = model_1_weight[i] / sqrt(model_1_running_var[i] + BN_EPS);
+        for (k = 0; k < VAD_STAGE1_POS_NUM; k++) {
+            x   = inp_data->data + 2 * k * VAD_STAGE1_STEP;
+            tmp = model_0_weight[2 * i] * x[0] + model_0_weight[2 * i + 1] * x[1];
+            tmp = scale * (tmp - model_1_running_mean[i]) + model_1_bias[i];
+
+            fea[i * VAD_STAGE1_POS_NUM + k] = tmp < 0 ? 0.01 * tmp : tmp;
+        }
+    }
+
+    return ALGO_NORMAL;
+}
+
+VAD_RAM_TEXT double vad_stage1_margin(const VadStage1Model *model, const double *fea)
+{
+    double margin = model->bias[0];
+    uint16_t i    = 0;
+
+    for (i = 0; i < VAD_STAGE1_FEA_NUM; i++) {
+        margin += model->weight[i] * fea[i];
+    }
 
+    return margin;
+}
+
+VAD_RAM_TEXT int vad_margin(VadContext *ctx, Conv2dData *inp_data, double *margin)
+{
+    int ret              = ALGO_NORMAL;
+    double linear_out[2] = {0};
+    const VadModel *model = NULL;
+    Conv2dConfig conv_config;
+    LinearParam linear_config;
     Conv2dData conv_out;
 
-    *is_voice = false;
+    if (!ctx || !inp_data || !margin) {
+        return ALGO_POINTER_NULL;
+    }
 
-    memset(&conv_out, 0, sizeof(Conv2dData));
-    conv_out_len  = cal_conv_out_len(inp_data->col, 0, 2, 2);
-    conv_out.data = (double *)malloc(sizeof(double) * conv_out_len * 2);
-    if (!conv_out.data) {
-        return ALGO_MALLOC_FAIL;
+    *margin = 0.0;
+    model   = ctx->model ? ctx->model : vad_model_default();
+
+    if (inp_data->col != model->frame_len) {
+        return inp_data->col < model->frame_len ? ALGO_DATA_NOT_ENOUGH : ALGO_DATA_TOO_MANY;
     }
 
+    conv_config   = model->conv;
+    linear_config = model->linear;
+
+    memset(&conv_out, 0, sizeof(Conv2dData));
+    conv_out.data = ctx->conv_out;
+
     ret = conv2d_bn_no_bias(inp_data, &conv_config, &conv_out);
     if (ret != ALGO_NORMAL) {
-        goto func_exit;
+        return ret;
     }
 
-    ret = leaky_relu(0.01, conv_out.data, conv_out.channel * conv_out.col * conv_out.row,
-                     conv_out.data);
+    ret = leaky_relu(model->neg_slope, conv_out.data,
+                     conv_out.channel * conv_out.col * conv_out.row, conv_out.data);
     if (ret != ALGO_NORMAL) {
-        goto func_exit;
+        return ret;
     }
 
     ret = linear_layer(conv_out.data, &linear_config, linear_out);
     if (ret != ALGO_NORMAL) {
-        goto func_exit;
+        return ret;
+    }
+
+    *margin = linear_out[1] - linear_out[0];
+
+    return ret;
+}
+
+const GraphLayer *vad_graph_layers(uint16_t *layer_num, uint16_t *tensor_num)
+{
+    uint16_t i = 0;
+
+    *layer_num  = sizeof(g_vad_graph_layers) / sizeof(GraphLayer);
+    *tensor_num = 0;
+    for (i = 0; i < *layer_num; i++) {
+        if (g_vad_graph_layers[i].out >= *tensor_num) {
+            *tensor_num = g_vad_graph_layers[i].out + 1;
+        }
+    }
+
+    return g_vad_graph_layers;
+}
+
+const Graph *vad_graph_default(void)
+{
+    static const Graph graph = {
+        .layers     = g_vad_graph_layers,
+        .tensors    = g_vad_graph_tensors,
+        .layer_num  = sizeof(g_vad_graph_layers) / sizeof(GraphLayer),
+        .tensor_num = VAD_GRAPH_TENSOR_NUM,
+        .input      = 0,
+        .output     = VAD_GRAPH_TENSOR_NUM - 1,
+        .arena_size = VAD_GRAPH_ARENA_SIZE,
+    };
+
+    return &graph;
+}
+
+int vad_graph_margin(const Graph *graph, double *arena, const Conv2dData *inp_data,
+                     double *margin)
+{
+    int ret             = ALGO_NORMAL;
+    const double *logit = NULL;
+    const GraphTensor *inp = NULL;
+
+    if (!graph || !arena || !inp_data || !inp_data->data || !margin) {
+        return ALGO_POINTER_NULL;
+    }
+
+    inp = &graph->tensors[graph->input];
+    if (inp_data->channel != inp->channel || inp_data->row != inp->row ||
+        inp_data->col != inp->col) {
+        return ALGO_DATA_INVALID;
+    }
+
+    ret = graph_run(graph, arena, inp_data->data, &logit);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    *margin = logit[1] - logit[0];
+
+    return ALGO_NORMAL;
+}
+
+// stage 1 and/or the CNN, the margin is > 0 iff the hop is voice
+VAD_RAM_TEXT static int vad_decide(VadContext *ctx, Conv2dData *inp_data, double *margin)
+{
+    int ret = ALGO_NORMAL;
+    double fea[VAD_STAGE1_FEA_NUM];
+    VadCascade *cascade = NULL;
+
+    // stage 1 is fitted to the front end and the margins of the built-in CNN
+    if (ctx->use_cascade && ctx->model != vad_model_default()) {
+        ctx->cascade.bypass_cnt++;
+    } else if (ctx->use_cascade) {
+        cascade = &ctx->cascade;
+        ret     = vad_stage1_feature(inp_data, fea);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
+
+        cascade->stage1_cnt++;
+        *margin = vad_stage1_margin(cascade->config.model, fea);
+        if (*margin < cascade->config.band_lo || *margin > cascade->config.band_hi) {
+            return ALGO_NORMAL;
+        }
+        cascade->stage2_cnt++;
+    }
+
+    // same as comparing the two logits
+    return vad_margin(ctx, inp_data, margin);
+}
+
+// update the energy statistics with a hop, true when the decision runs on it
+VAD_RAM_TEXT static bool vad_decimate_run(VadDecimate *dec, const double *hop, uint32_t len)
+{
+    dec->hop_cnt++;
+    if (vad_gate_update(&dec->rise, hop, len)) {
+        dec->snap_cnt += dec->stride > 1;
+        dec->stride = 1;
+        dec->run    = 0;
+    }
+
+    if (dec->stride == 1 || ++dec->phase >= dec->stride) {
+        dec->phase = 0;
+        return true;
+    }
+
+    dec->skip_cnt++;
+
+    return false;
+}
+
+// count the silence after a decision and widen the stride
+VAD_RAM_TEXT static void vad_decimate_decided(VadDecimate *dec, double margin)
+{
+    if (margin > 0) {
+        dec->snap_cnt += dec->stride > 1;
+        dec->stride = 1;
+        dec->run    = 0;
+        return;
+    }
+
+    if (++dec->run >= dec->config.silence_hops && dec->stride < dec->config.max_stride) {
+        dec->stride = dec->stride * 2 < dec->config.max_stride ? dec->stride * 2
+                                                                : dec->config.max_stride;
+        dec->phase  = 0;
+        dec->run    = 0;
+    }
+}
+
+// both statistics see every hop, also the ones the other one skips. Returns
+// false when the gate finds the hop silent, held is set when the decimation
+// keeps the last decision.
+VAD_RAM_TEXT static bool vad_hop_stats(VadContext *ctx, const Conv2dData *inp_data, bool *held)
+{
+    const double *hop = NULL;
+    bool run          = true;
+
+    if (inp_data->col >= FRAME_STEP) {
+        hop = inp_data->data + inp_data->col - FRAME_STEP;
+        if (ctx->use_gate) {
+            run = vad_gate_update(&ctx->gate, hop, FRAME_STEP);
+        }
+        if (ctx->use_decimate) {
+            *held = !vad_decimate_run(&ctx->decimate, hop, FRAME_STEP);
+        }
+    }
+
+    return run;
+}
+
+// record the margin given to a hop
+VAD_RAM_TEXT static void vad_hop_done(VadContext *ctx, double margin, bool *is_voice)
+{
+    ctx->margin = margin;
+    *is_voice   = margin > 0;
+
+    if (ctx->use_decimate) {
+        ctx->decimate.margin = margin;
+        vad_decimate_decided(&ctx->decimate, margin);
     }
+}
+
+VAD_RAM_TEXT int vad_process(VadContext *ctx, Conv2dData *inp_data, bool *is_voice)
+{
+    int ret       = ALGO_NORMAL;
+    double margin = -INFINITY;
+    bool run = true, held = false;
 
-    if (linear_out[1] > linear_out[0]) {
-        *is_voice = true;
+    if (!ctx || !inp_data || !inp_data->data || !is_voice) {
+        return ALGO_POINTER_NULL;
     }
 
-func_exit:
-    if (conv_out.data) {
-        free(conv_out.data);
+    *is_voice   = false;
+    ctx->margin = -INFINITY;
+
+    run = vad_hop_stats(ctx, inp_data, &held);
+    if (run && held) {
+        margin = ctx->decimate.margin;
+    } else if (run) {
+        ret = vad_decide(ctx, inp_data, &margin);
+        if (ret != ALGO_NORMAL) {
+            return ret;
+        }
     }
 
+    vad_hop_done(ctx, margin, is_voice);
+
     return ret;
 }
+
+VAD_RAM_TEXT int vad_hold(VadContext *ctx, Conv2dData *inp_data, double margin, bool *is_voice)
+{
+    bool held = false;
+
+    if (!ctx || !inp_data || !inp_data->data || !is_voice) {
+        return ALGO_POINTER_NULL;
+    }
+
+    vad_hop_stats(ctx, inp_data, &held);
+    ctx->hold_cnt++;
+    vad_hop_done(ctx, margin, is_voice);
+
+    return ALGO_NORMAL;
+}
+
+int vad(Conv2dData *inp_data, bool *is_voice)
+{
+    VadContext ctx;
+
+    vad_init(&ctx);
+
+    return vad_process(&ctx, inp_data, is_voice);
+}
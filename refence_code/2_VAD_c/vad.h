@@ -35,8 +35,280 @@
 #include <stdlib.h>
 
 #include "conv.h"
+#include "gate.h"
+#include "graph.h"
+#include "vad_graph_plan.h"
 #include "algo_error_code.h"
 
+#define OBJ_FS     (8000)
+#define FRAME_STEP (120) // 0.015 * 8000
+#define FRAME_LEN  (240) // 0.03 * 8000
+
+#define VAD_FILTER_NUM   (2)
+#define VAD_CONV_OUT_LEN ((FRAME_LEN - 2) / 2 + 1)
+
+#define VAD_STAGE1_STEP    (8) // stride between the conv outputs used by the stage 1 model
+#define VAD_STAGE1_POS_NUM (VAD_CONV_OUT_LEN / VAD_STAGE1_STEP)
+#define VAD_STAGE1_FEA_NUM (VAD_STAGE1_POS_NUM * VAD_FILTER_NUM)
+#define VAD_CASCADE_BAND   (0.05) // default half width of the band, about half of the hops run the CNN
+#define VAD_DECIMATE_SILENCE (5)  // default non-voice hops before the stride doubles, 75 ms
+#define VAD_DECIMATE_STRIDE  (4)  // default widest stride, the CNN runs every 60 ms
+#define VAD_GRAPH_ARENA_BUDGET (2048) // arena bytes the built-in graph may plan, checked when vad.c is built
+
+/**
+ * CNN of the VAD: conv + BN + LeakyReLU + linear. The conv and BN configs
+ * point into the struct itself, so a model must not be copied.
+ */
+typedef struct _VadModel {
+    Conv2dFilter filter;
+    BatchNorm2d bn;
+    Conv2dConfig conv;  // conv.filter = &filter, conv.bn = &bn
+    LinearParam linear; // fea_size 2: non-voice and voice logits
+    double neg_slope;   // of the LeakyReLU
+    uint16_t frame_len; // samples per frame
+    uint32_t model_id;  // version of the weights, 0 for the built-in model
+} VadModel;
+
+/**
+ * stage 1 model of the cascade: the conv + BN + LeakyReLU outputs at every
+ * VAD_STAGE1_STEP-th position followed by a linear layer giving the margin
+ * logit(voice) - logit(non-voice) directly
+ */
+typedef struct _VadStage1Model {
+    const double *weight; // VAD_STAGE1_FEA_NUM weights, channel major like the conv output
+    const double *bias;   // 1 bias
+} VadStage1Model;
+
+/**
+ * configuration of the two stage cascade
+ */
+typedef struct _VadCascadeConfig {
+    double band_lo;              // stage 1 margins in [band_lo, band_hi] run the CNN,
+    double band_hi;              // below: non-voice, above: voice, band_lo <= 0 <= band_hi
+    const VadStage1Model *model; // stage 1 model, NULL for the built-in one
+} VadCascadeConfig;
+
+/**
+ * state of the cascade of one stream
+ */
+typedef struct _VadCascade {
+    VadCascadeConfig config;
+    uint64_t stage1_cnt; // stage 1 invocations
+    uint64_t stage2_cnt; // CNN invocations
+    uint64_t bypass_cnt; // CNN invocations without stage 1, another model being active
+} VadCascade;
+
+/**
+ * configuration of the adaptive hop rate
+ */
+typedef struct _VadDecimateConfig {
+    uint32_t silence_hops; // the stride doubles after every silence_hops non-voice hops
+    uint32_t max_stride;   // widest stride, 1: always full rate
+} VadDecimateConfig;
+
+/**
+ * state of the adaptive hop rate of one stream: during long silence the
+ * decision only runs every stride-th hop and is held in between, the energy
+ * statistics run on every hop and an energy rise or a voice decision brings
+ * the stride back to 1
+ */
+typedef struct _VadDecimate {
+    VadDecimateConfig config;
+    VadGate rise;       // energy/ZCR statistics of every hop, the pre-gate without hangover
+    double margin;      // last decided margin, held on the skipped hops
+    uint32_t stride;    // decisions run every stride-th hop
+    uint32_t phase;     // hops since the last decision
+    uint32_t run;       // non-voice hops since the last change of the stride
+    uint64_t hop_cnt;   // hops seen
+    uint64_t skip_cnt;  // hops where the decision was held
+    uint64_t snap_cnt;  // returns to full rate
+} VadDecimate;
+
+/**
+ * Per-stream working memory of the VAD, so that several streams can be
+ * processed concurrently without touching the heap on every hop
+ */
+typedef struct _VadContext {
+    const VadModel *model; // CNN, see vad_set_model
+    double conv_out[VAD_CONV_OUT_LEN * VAD_FILTER_NUM];
+    double margin;      // margin of the last hop from the stage that decided it, > 0 iff
+                        // voice, -INFINITY when the gate skipped the hop, the held one
+                        // when the decimation skipped it, the given one for vad_hold
+    VadGate gate;       // energy/ZCR pre-gate, see vad_enable_gate
+    VadCascade cascade; // two stage cascade, see vad_enable_cascade
+    VadDecimate decimate; // adaptive hop rate, see vad_enable_decimate
+    bool use_gate;      // skip the CNN on the hops rejected by the gate
+    bool use_cascade;   // run the CNN only when stage 1 is uncertain
+    bool use_decimate;  // widen the hop during long silence
+    uint64_t hold_cnt;  // hops decided by the caller, see vad_hold
+} VadContext;
+
+/**
+ * @brief initialize a VAD context
+ *
+ * @param[out] ctx: the context to be initialized
+ * @return error code
+ */
+int vad_init(VadContext *ctx);
+
+/**
+ * @brief get the built-in model, see model_parameters.h
+ *
+ * @return built-in model
+ */
+const VadModel *vad_model_default(void);
+
+/**
+ * @brief check that the shapes of a model are consistent and that its conv
+ * output fits the VAD context
+ *
+ * @param[in] model: model to be checked
+ * @return error code
+ */
+int vad_model_check(const VadModel *model);
+
+/**
+ * @brief run the CNN of a context with another model, the previous one is
+ * kept on error. The stage 1 model of the cascade is tied to the built-in one,
+ * the cascade is bypassed while another model is active.
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] model: checked model, must outlive its use, NULL for the built-in one
+ * @return error code
+ */
+int vad_set_model(VadContext *ctx, const VadModel *model);
+
+/**
+ * @brief enable the energy/ZCR pre-gate, the CNN is skipped on the silent
+ * hops and they are reported as non-voice. The gate looks at the last
+ * FRAME_STEP samples of every frame, frames must be consecutive hops.
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] config: gate configuration, NULL for the default one
+ * @return error code
+ */
+int vad_enable_gate(VadContext *ctx, const VadGateConfig *config);
+
+/**
+ * @brief enable the two stage cascade, the stage 1 model runs on every hop
+ * and the CNN only when the stage 1 margin is inside the uncertainty band.
+ * Stage 1 computes the conv, BN and LeakyReLU of the built-in model: while
+ * vad_set_model has another model active, the CNN runs on every hop instead
+ * and the hop is counted in bypass_cnt.
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] config: cascade configuration, NULL for the built-in model
+ * with the band [-VAD_CASCADE_BAND, VAD_CASCADE_BAND]
+ * @return error code
+ */
+int vad_enable_cascade(VadContext *ctx, const VadCascadeConfig *config);
+
+/**
+ * @brief enable the adaptive hop rate: after config->silence_hops non-voice
+ * hops the decision (cascade and CNN) runs every 2nd hop, then every 4th and
+ * so on up to config->max_stride, the skipped hops keep the last decision.
+ * The energy/ZCR statistics of the pre-gate run on every hop, a hop they
+ * find active or a voice decision return to full rate at once. Frames must
+ * be consecutive hops.
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] config: configuration, NULL for VAD_DECIMATE_SILENCE and VAD_DECIMATE_STRIDE
+ * @return error code
+ */
+int vad_enable_decimate(VadContext *ctx, const VadDecimateConfig *config);
+
+/**
+ * @brief get the built-in stage 1 model, see stage1_parameters.h
+ *
+ * @return stage 1 model
+ */
+const VadStage1Model *vad_stage1_default(void);
+
+/**
+ * @brief compute the stage 1 features of a frame
+ *
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples
+ * @param[out] fea: VAD_STAGE1_FEA_NUM features
+ * @return error code
+ */
+int vad_stage1_feature(const Conv2dData *inp_data, double *fea);
+
+/**
+ * @brief compute the stage 1 margin from the features
+ *
+ * @param[in] model: stage 1 model
+ * @param[in] fea: VAD_STAGE1_FEA_NUM features
+ * @return logit(voice) - logit(non-voice)
+ */
+double vad_stage1_margin(const VadStage1Model *model, const double *fea);
+
+/**
+ * @brief run the CNN and get its margin, is_voice of vad_process is margin > 0
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples
+ * @param[out] margin: logit(voice) - logit(non-voice)
+ * @return error code
+ */
+int vad_margin(VadContext *ctx, Conv2dData *inp_data, double *margin);
+
+/**
+ * @brief get the layer table of the built-in CNN, the input of the graph is
+ * tensor 0, a 1 x 1 x FRAME_LEN frame, the output is the last tensor. The
+ * planner of ./vad_c graph plan writes the shapes and arena offsets of all
+ * tensors to vad_graph_plan.h
+ *
+ * @param[out] layer_num: number of layers
+ * @param[out] tensor_num: number of tensors
+ * @return layer table
+ */
+const GraphLayer *vad_graph_layers(uint16_t *layer_num, uint16_t *tensor_num);
+
+/**
+ * @brief get the built-in CNN as a planned graph, it needs an arena of
+ * VAD_GRAPH_ARENA_SIZE doubles
+ *
+ * @return graph
+ */
+const Graph *vad_graph_default(void);
+
+/**
+ * @brief run a VAD graph and get its margin, equal to the one of vad_margin
+ * for the built-in graph
+ *
+ * @param[in] graph: checked graph with 2 output logits
+ * @param[in] arena: graph->arena_size doubles
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples
+ * @param[out] margin: logit(voice) - logit(non-voice)
+ * @return error code
+ */
+int vad_graph_margin(const Graph *graph, double *arena, const Conv2dData *inp_data,
+                     double *margin);
+
+/**
+ * @brief voice detection function working on a caller owned context
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples
+ * @param[out] is_voice: the result of voice detection
+ * @return error code
+ */
+int vad_process(VadContext *ctx, Conv2dData *inp_data, bool *is_voice);
+
+/**
+ * @brief give a hop a decision made by the caller, e.g. the held or skipped
+ * hops of a load controller. Neither stage 1 nor the CNN runs; the gate and
+ * decimation statistics see the hop as in vad_process, and it is counted in
+ * ctx->hold_cnt.
+ *
+ * @param[in] ctx: VAD context, see vad_init
+ * @param[in] inp_data: raw audio data, FRAME_LEN samples
+ * @param[in] margin: margin of the hop, ctx->margin holds the last one
+ * @param[out] is_voice: margin > 0
+ * @return error code
+ */
+int vad_hold(VadContext *ctx, Conv2dData *inp_data, double margin, bool *is_voice);
+
 /**
  * @brief voice detection function
  *
@@ -46,4 +318,4 @@
  */
 int vad(Conv2dData *inp_data, bool *is_voice);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VAD_SECTION_H__
+#define __VAD_SECTION_H__
+
+// code and weight placement, see n309_iot_qemu.ld; no-ops on the host
+#if defined(__riscv) && !defined(VAD_PLACEMENT)
+#define VAD_PLACEMENT (1)
+#endif
+
+#if VAD_PLACEMENT
+// per-hop kernels: linked into flash, copied to RAM with .data by the startup
+// code and executed from there, so a hop does not stall on XIP fetches
+#define VAD_RAM_TEXT  __attribute__((section(".itext.vad")))
+// const tables that are copied to RAM with .data
+#define VAD_RAM_CONST __attribute__((section(".vad_ram_const")))
+#else
+#define VAD_RAM_TEXT
+#define VAD_RAM_CONST
+#endif
+
+// const tables that stay in .rodata and are read in place from flash
+#define VAD_FLASH_CONST
+
+// per table placement, 1 copies the table to RAM, 0 reads it from flash
+#ifndef VAD_CONV_WEIGHT_IN_RAM
+#define VAD_CONV_WEIGHT_IN_RAM (1) // 4 doubles, read once per output sample
+#endif
+
+#ifndef VAD_BN_WEIGHT_IN_RAM
+#define VAD_BN_WEIGHT_IN_RAM (1) // 8 doubles, read once per filter
+#endif
+
+#ifndef VAD_LINEAR_WEIGHT_IN_RAM
+#define VAD_LINEAR_WEIGHT_IN_RAM (0) // 3.8 KB, one sequential pass per hop
+#endif
+
+#ifndef VAD_STAGE1_WEIGHT_IN_RAM
+#define VAD_STAGE1_WEIGHT_IN_RAM (1) // read on every hop by the cascade
+#endif
+
+#if VAD_CONV_WEIGHT_IN_RAM
+#define VAD_CONV_WEIGHT VAD_RAM_CONST
+#else
+#define VAD_CONV_WEIGHT VAD_FLASH_CONST
+#endif
+
+#if VAD_BN_WEIGHT_IN_RAM
+#define VAD_BN_WEIGHT VAD_RAM_CONST
+#else
+#define VAD_BN_WEIGHT VAD_FLASH_CONST
+#endif
+
+#if VAD_LINEAR_WEIGHT_IN_RAM
+#define VAD_LINEAR_WEIGHT VAD_RAM_CONST
+#else
+#define VAD_LINEAR_WEIGHT VAD_FLASH_CONST
+#endif
+
+#if VAD_STAGE1_WEIGHT_IN_RAM
+#define VAD_STAGE1_WEIGHT VAD_RAM_CONST
+#else
+#define VAD_STAGE1_WEIGHT VAD_FLASH_CONST
+#endif
+
+#endif
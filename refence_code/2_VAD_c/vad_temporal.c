@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+
+#include "vad_temporal.h"
+
+#if VAD_TEMPORAL_MODEL
+#include "temporal_parameters.h"
+
+static const CausalConv1d g_temporal_conv[TEMPORAL_CONV_NUM] = TEMPORAL_CONV_LAYERS;
+
+static const GruCell g_temporal_gru = {
+    .inp_size    = TEMPORAL_FEAT_NUM,
+    .hidden_size = TEMPORAL_HIDDEN_SIZE,
+    .weight_ih   = temporal_gru_weight_ih_l0,
+    .weight_hh   = temporal_gru_weight_hh_l0,
+    .bias_ih     = temporal_gru_bias_ih_l0,
+    .bias_hh     = temporal_gru_bias_hh_l0,
+};
+
+const VadTemporalModel *vad_temporal_default(void)
+{
+    static const VadTemporalModel model = {
+        .filter    = {.channel = 1, .col = 2, .row = 1, .filter_num = VAD_FILTER_NUM,
+                      .data = (double *)temporal_model_0_weight},
+        .bn        = {.beta  = (double *)temporal_model_1_bias,
+                      .gamma = (double *)temporal_model_1_weight,
+                      .mean  = (double *)temporal_model_1_running_mean,
+                      .var   = (double *)temporal_model_1_running_var,
+                      .size  = VAD_FILTER_NUM},
+        .conv      = {.pad = 0, .stride = 2, .bn = (BatchNorm2d *)&model.bn,
+                      .filter = (Conv2dFilter *)&model.filter},
+        .neg_slope = TEMPORAL_NEG_SLOPE,
+        .proj      = {.inp_size = VAD_CONV_OUT_LEN * VAD_FILTER_NUM, .fea_size = TEMPORAL_FEAT_NUM,
+                      .weight = (double *)temporal_proj_weight, .bias = (double *)temporal_proj_bias},
+        .net       = {.conv = g_temporal_conv, .conv_num = TEMPORAL_CONV_NUM, .gru = &g_temporal_gru},
+        .output    = {.inp_size = TEMPORAL_HIDDEN_SIZE, .fea_size = 2,
+                      .weight = (double *)temporal_output_weight,
+                      .bias = (double *)temporal_output_bias},
+    };
+
+    return &model;
+}
+#endif
+
+int vad_temporal_check(const VadTemporalModel *model)
+{
+    int ret = ALGO_NORMAL;
+    uint16_t inp_size = 0, out_size = 0;
+    uint32_t out_len = 0;
+
+    if (!model || model->conv.filter != &model->filter || model->conv.bn != &model->bn ||
+        !model->filter.data || !model->bn.mean || !model->bn.var || !model->bn.gamma ||
+        !model->bn.beta || !model->proj.weight || !model->proj.bias || !model->output.weight ||
+        !model->output.bias) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = temporal_net_check(&model->net);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    if (model->filter.channel != 1 || model->filter.row != 1 || model->filter.col == 0 ||
+        model->conv.stride == 0 || FRAME_LEN + 2 * model->conv.pad < model->filter.col ||
+        model->bn.size != model->filter.filter_num) {
+        return ALGO_DATA_INVALID;
+    }
+
+    out_len = cal_conv_out_len(FRAME_LEN, model->conv.pad, model->filter.col, model->conv.stride);
+    if (out_len * model->filter.filter_num > VAD_CONV_OUT_LEN * VAD_FILTER_NUM) {
+        return ALGO_DATA_TOO_MANY;
+    }
+
+    temporal_net_size(&model->net, &inp_size, &out_size);
+    if (model->proj.inp_size != out_len * model->filter.filter_num ||
+        model->proj.fea_size != inp_size || model->output.inp_size != out_size ||
+        model->output.fea_size != 2) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+int vad_temporal_init(VadTemporalContext *ctx, const VadTemporalModel *model)
+{
+    int ret = ALGO_NORMAL;
+
+    if (!ctx) {
+        return ALGO_POINTER_NULL;
+    }
+
+    ret = vad_temporal_check(model);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    memset(ctx, 0, sizeof(VadTemporalContext));
+    ctx->model = model;
+
+    return temporal_reset(&model->net, &ctx->state);
+}
+
+int vad_temporal_margin(VadTemporalContext *ctx, Conv2dData *inp_data, double *margin)
+{
+    int ret = ALGO_NORMAL;
+    const VadTemporalModel *model = NULL;
+    Conv2dConfig conv_config;
+    LinearParam linear_config;
+    Conv2dData conv_out;
+    double step[TEMPORAL_MAX_CHANNEL], feature[TEMPORAL_MAX_CHANNEL];
+    double logit[2];
+
+    if (!ctx || !ctx->model || !inp_data || !inp_data->data || !margin) {
+        return ALGO_POINTER_NULL;
+    }
+
+    if (inp_data->col != FRAME_LEN) {
+        return inp_data->col < FRAME_LEN ? ALGO_DATA_NOT_ENOUGH : ALGO_DATA_TOO_MANY;
+    }
+
+    model       = ctx->model;
+    conv_config = model->conv;
+    memset(&conv_out, 0, sizeof(Conv2dData));
+    conv_out.data = ctx->conv_out;
+
+    ret = conv2d_bn_no_bias(inp_data, &conv_config, &conv_out);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    ret = leaky_relu(model->neg_slope, conv_out.data,
+                     conv_out.channel * conv_out.col * conv_out.row, conv_out.data);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    // the projection is the time step of this hop
+    linear_config = model->proj;
+    ret           = linear_layer(conv_out.data, &linear_config, step);
+    if (ret == ALGO_NORMAL) {
+        ret = leaky_relu(model->neg_slope, step, linear_config.fea_size, step);
+    }
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    ret = temporal_step(&model->net, &ctx->state, step, feature);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    linear_config = model->output;
+    ret           = linear_layer(feature, &linear_config, logit);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    *margin = logit[1] - logit[0];
+
+    return ALGO_NORMAL;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __VAD_TEMPORAL_H__
+#define __VAD_TEMPORAL_H__
+
+#include <stdint.h>
+
+#include "vad.h"
+#include "temporal.h"
+#include "algo_error_code.h"
+
+// 1 to build the model exported by 1_VAD_python/export.py into temporal_parameters.h
+#ifndef VAD_TEMPORAL_MODEL
+#define VAD_TEMPORAL_MODEL (0)
+#endif
+
+/**
+ * streaming VAD model: the conv + BN + LeakyReLU front end of the CNN on
+ * each frame, a linear projection of its output to one time step, the
+ * temporal net over the hops and a linear layer giving the two logits.
+ * The conv and BN configs point into the struct itself, so a model must
+ * not be copied.
+ */
+typedef struct _VadTemporalModel {
+    Conv2dFilter filter;
+    BatchNorm2d bn;
+    Conv2dConfig conv;   // conv.filter = &filter, conv.bn = &bn
+    double neg_slope;    // of the LeakyReLU after the conv and after the projection
+    LinearParam proj;    // conv output to the input of a time step
+    TemporalNet net;     // causal convs and GRU over the hops
+    LinearParam output;  // fea_size 2: non-voice and voice logits
+} VadTemporalModel;
+
+/**
+ * per-stream working memory of the streaming model
+ */
+typedef struct _VadTemporalContext {
+    const VadTemporalModel *model;
+    TemporalState state;
+    double conv_out[VAD_CONV_OUT_LEN * VAD_FILTER_NUM];
+} VadTemporalContext;
+
+/**
+ * @brief check a streaming model
+ *
+ * @param[in] model: model
+ * @return error code
+ */
+int vad_temporal_check(const VadTemporalModel *model);
+
+/**
+ * @brief check the model and start a stream with zero history
+ *
+ * @param[out] ctx: context of the stream
+ * @param[in] model: model, kept by the context
+ * @return error code
+ */
+int vad_temporal_init(VadTemporalContext *ctx, const VadTemporalModel *model);
+
+/**
+ * @brief process the frame of the next hop, only the new time step of every
+ * temporal layer is computed
+ *
+ * @param[in,out] ctx: context of the stream
+ * @param[in] inp_data: frame of FRAME_LEN samples
+ * @param[out] margin: logit(voice) - logit(non-voice), > 0 iff voice
+ * @return error code
+ */
+int vad_temporal_margin(VadTemporalContext *ctx, Conv2dData *inp_data, double *margin);
+
+#if VAD_TEMPORAL_MODEL
+/**
+ * @brief get the model of temporal_parameters.h
+ *
+ * @return model
+ */
+const VadTemporalModel *vad_temporal_default(void);
+#endif
+
+#endif
@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "wav.h"
+
+#define WAV_FMT_SIZE            (16) // size of the PCM fmt chunk
+#define WAV_FMT_EXTENSIBLE_SIZE (40) // size of the WAVE_FORMAT_EXTENSIBLE fmt chunk
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int parse_fmt(WavFile *wav, const uint8_t *p, uint32_t chunk_size)
+{
+    if (chunk_size < WAV_FMT_SIZE) {
+        return ALGO_DATA_INVALID;
+    }
+
+    wav->format      = get_le16(p);
+    wav->channels    = get_le16(p + 2);
+    wav->sample_rate = get_le32(p + 4);
+    wav->block_align = get_le16(p + 12);
+    wav->bits        = get_le16(p + 14);
+
+    // the sub format GUID starts with the format code
+    if (wav->format == WAV_FORMAT_EXTENSIBLE) {
+        if (chunk_size < WAV_FMT_EXTENSIBLE_SIZE) {
+            return ALGO_DATA_INVALID;
+        }
+        wav->format = get_le16(p + 24);
+    }
+
+    if (!((wav->format == WAV_FORMAT_PCM && wav->bits == 16) ||
+          (wav->format == WAV_FORMAT_IEEE_FLOAT && wav->bits == 32))) {
+        return ALGO_DATA_INVALID;
+    }
+
+    if (wav->channels < 1 || wav->channels > 2 || wav->sample_rate == 0 ||
+        wav->block_align != wav->channels * wav->bits / 8) {
+        return ALGO_DATA_INVALID;
+    }
+
+    return ALGO_NORMAL;
+}
+
+static int parse_header(WavFile *wav)
+{
+    const uint8_t *base = (const uint8_t *)wav->map;
+    size_t pos = 12, size = wav->map_size;
+    uint32_t chunk_size = 0;
+    bool has_fmt        = false;
+    int ret             = ALGO_NORMAL;
+
+    if (size < 12 || memcmp(base, "RIFF", 4) || memcmp(base + 8, "WAVE", 4)) {
+        return ALGO_DATA_INVALID;
+    }
+
+    // a RIFF size beyond the end of file means a truncated file, parse what exists
+    if ((uint64_t)get_le32(base + 4) + 8 < size) {
+        size = (size_t)get_le32(base + 4) + 8;
+    }
+
+    while (pos + 8 <= size) {
+        chunk_size = get_le32(base + pos + 4);
+
+        if (!memcmp(base + pos, "fmt ", 4)) {
+            if (chunk_size > size - pos - 8) {
+                return ALGO_DATA_INVALID;
+            }
+            ret = parse_fmt(wav, base + pos + 8, chunk_size);
+            if (ret != ALGO_NORMAL) {
+                return ret;
+            }
+            has_fmt = true;
+        } else if (!memcmp(base + pos, "data", 4)) {
+            if (!has_fmt) {
+                return ALGO_DATA_INVALID;
+            }
+
+            // streaming writers may leave the size unset, clamp it to the file
+            if (chunk_size > size - pos - 8) {
+                chunk_size = (uint32_t)(size - pos - 8);
+            }
+
+            wav->data       = base + pos + 8;
+            wav->raw_frames = chunk_size / wav->block_align;
+            wav->frames     = wav->raw_frames;
+
+            return ALGO_NORMAL;
+        }
+
+        // chunks are word aligned
+        pos += 8 + (size_t)chunk_size + (chunk_size & 1);
+    }
+
+    return ALGO_DATA_INVALID;
+}
+
+int wav_open(const char *file_dir, WavFile *wav)
+{
+    int ret = ALGO_NORMAL, fd = -1;
+    struct stat st;
+
+    memset(wav, 0, sizeof(WavFile));
+
+    fd = open(file_dir, O_RDONLY);
+    if (fd < 0) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return ALGO_IO_EXCEPTION;
+    }
+
+    wav->map_size = (size_t)st.st_size;
+    wav->map      = mmap(NULL, wav->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (wav->map == MAP_FAILED) {
+        wav->map = NULL;
+        return ALGO_IO_EXCEPTION;
+    }
+
+    // the samples are read front to back, let the kernel read ahead
+    madvise(wav->map, wav->map_size, MADV_SEQUENTIAL);
+
+    ret = parse_header(wav);
+    if (ret != ALGO_NORMAL) {
+        wav_close(wav);
+    }
+
+    return ret;
+}
+
+int wav_set_resample(WavFile *wav, uint32_t obj_fs)
+{
+    int ret = ALGO_NORMAL;
+
+    resample_filter_deinit(&wav->filter);
+    wav->frames = wav->raw_frames;
+
+    ret = resample_filter_init(&wav->filter, wav->sample_rate, obj_fs);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+
+    if (wav->filter.phase_taps > WAV_MAX_PHASE_TAPS) {
+        resample_filter_deinit(&wav->filter);
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    wav->frames = resample_out_num(&wav->filter, wav->raw_frames);
+
+    return ALGO_NORMAL;
+}
+
+static float get_sample(const WavFile *wav, uint64_t idx)
+{
+    const uint8_t *p = wav->data + idx * wav->block_align;
+    float fval       = 0.0f;
+
+    if (wav->format == WAV_FORMAT_PCM) {
+        return (float)(int16_t)get_le16(p);
+    }
+
+    memcpy(&fval, p, sizeof(float));
+
+    return fval;
+}
+
+// same arithmetic as the streaming Resampler, so both give identical samples
+static void resample_read(const WavFile *wav, uint64_t offset, uint64_t count, double *out)
+{
+    const ResampleFilter *f = &wav->filter;
+    uint64_t pos = 0, last = 0, num = 0, i = 0;
+    int64_t first = 0, n = 0;
+    float win[WAV_RESAMPLE_WIN];
+
+    while (count) {
+        // input window of as many outputs as fit, including the filter history
+        pos   = offset * f->down + f->delay;
+        first = (int64_t)(pos / f->up) - (int64_t)(f->phase_taps - 1);
+        num   = ((uint64_t)(first + WAV_RESAMPLE_WIN) * f->up - 1 - pos) / f->down + 1;
+        num   = num < count ? num : count;
+        last  = (pos + (num - 1) * f->down) / f->up;
+
+        for (n = first; n <= (int64_t)last; n++) {
+            win[n - first] = n >= 0 && (uint64_t)n < wav->raw_frames ? get_sample(wav, (uint64_t)n)
+                                                                      : 0.0f;
+        }
+
+        for (i = 0; i < num; i++, pos += f->down) {
+            out[i] = (double)resample_phase_dot(f, (uint32_t)(pos % f->up),
+                                                win + (pos / f->up - first));
+        }
+
+        offset += num;
+        count -= num;
+        out += num;
+    }
+}
+
+uint64_t wav_read(const WavFile *wav, uint64_t offset, uint64_t count, double *out)
+{
+    uint64_t i = 0, valid = 0;
+    const uint8_t *p = NULL;
+    float fval       = 0.0f;
+
+    if (offset < wav->frames) {
+        valid = wav->frames - offset < count ? wav->frames - offset : count;
+    }
+
+    if (wav->filter.num_taps > 1) {
+        resample_read(wav, offset, valid, out);
+        i = valid;
+    } else if (wav->format == WAV_FORMAT_PCM) {
+        p = wav->data + offset * wav->block_align;
+        for (i = 0; i < valid; i++, p += wav->block_align) {
+            out[i] = (double)(int16_t)get_le16(p);
+        }
+    } else {
+        p = wav->data + offset * wav->block_align;
+        for (i = 0; i < valid; i++, p += wav->block_align) {
+            memcpy(&fval, p, sizeof(float));
+            out[i] = (double)fval;
+        }
+    }
+
+    for (; i < count; i++) {
+        out[i] = 0.0;
+    }
+
+    return valid;
+}
+
+int wav_stream_open(const char *file_dir, WavStream *ws)
+{
+    uint8_t head[WAV_FMT_EXTENSIBLE_SIZE];
+    uint32_t chunk_size = 0, read_size = 0;
+    uint64_t pos = 12, size = 0;
+    bool has_fmt = false;
+    int ret      = ALGO_DATA_INVALID;
+    struct stat st;
+
+    memset(ws, 0, offsetof(WavStream, buf));
+
+    ws->file = fopen(file_dir, "rb");
+    if (!ws->file) {
+        return ALGO_IO_EXCEPTION;
+    }
+
+    if (fstat(fileno(ws->file), &st) || st.st_size <= 0) {
+        ret = ALGO_IO_EXCEPTION;
+        goto fail;
+    }
+    size = (uint64_t)st.st_size;
+
+    if (fread(head, 1, 12, ws->file) != 12 || memcmp(head, "RIFF", 4) ||
+        memcmp(head + 8, "WAVE", 4)) {
+        goto fail;
+    }
+
+    while (pos + 8 <= size && fread(head, 1, 8, ws->file) == 8) {
+        chunk_size = get_le32(head + 4);
+        pos += 8;
+
+        if (!memcmp(head, "data", 4)) {
+            if (!has_fmt) {
+                goto fail;
+            }
+
+            ws->remain = chunk_size < size - pos ? chunk_size : size - pos;
+            ws->remain -= ws->remain % ws->info.block_align;
+            ws->info.raw_frames = ws->remain / ws->info.block_align;
+            ws->info.frames     = ws->info.raw_frames;
+
+            return ALGO_NORMAL;
+        }
+
+        if (!memcmp(head, "fmt ", 4)) {
+            read_size = chunk_size < sizeof(head) ? chunk_size : sizeof(head);
+            if (chunk_size > size - pos || fread(head, 1, read_size, ws->file) != read_size) {
+                goto fail;
+            }
+            ret = parse_fmt(&ws->info, head, chunk_size);
+            if (ret != ALGO_NORMAL) {
+                goto fail;
+            }
+            ret     = ALGO_DATA_INVALID;
+            has_fmt = true;
+        } else {
+            read_size = 0;
+        }
+
+        // chunks are word aligned
+        pos += (uint64_t)chunk_size + (chunk_size & 1);
+        if (fseek(ws->file, (long)((uint64_t)chunk_size + (chunk_size & 1) - read_size),
+                  SEEK_CUR)) {
+            goto fail;
+        }
+    }
+
+fail:
+    wav_stream_close(ws);
+
+    return ret;
+}
+
+static const uint8_t *stream_next_frame(WavStream *ws)
+{
+    size_t keep = 0, want = 0, got = 0;
+    const uint8_t *p = NULL;
+
+    if (ws->buf_len - ws->buf_pos < ws->info.block_align) {
+        if (ws->remain == 0) {
+            return NULL;
+        }
+
+        keep = ws->buf_len - ws->buf_pos;
+        memmove(ws->buf, ws->buf + ws->buf_pos, keep);
+
+        want = sizeof(ws->buf) - keep;
+        want -= want % ws->info.block_align;
+        if (want > ws->remain) {
+            want = (size_t)ws->remain;
+        }
+
+        got = fread(ws->buf + keep, 1, want, ws->file);
+        ws->remain = got == want ? ws->remain - got : 0;
+        ws->buf_len = keep + got;
+        ws->buf_pos = 0;
+
+        if (ws->buf_len < ws->info.block_align) {
+            return NULL;
+        }
+    }
+
+    p = ws->buf + ws->buf_pos;
+    ws->buf_pos += ws->info.block_align;
+
+    return p;
+}
+
+int wav_stream_set_resample(WavStream *ws, uint32_t obj_fs, uint32_t block_size)
+{
+    int ret = ALGO_NORMAL;
+    uint32_t up = 0, down = 0, in_block = 0;
+
+    if (ws->rs.block_size || block_size == 0) {
+        return ALGO_DATA_EXCEPTION;
+    }
+
+    // input samples giving about block_size output samples
+    resample_ratio(ws->info.sample_rate, obj_fs, &up, &down);
+    if (up == 0 || down > RESAMPLE_MAX_FACTOR) {
+        return ALGO_DATA_EXCEPTION;
+    }
+    in_block = (uint32_t)(((uint64_t)block_size * down + up - 1) / up);
+
+    ret = resample_init(&ws->rs, ws->info.sample_rate, obj_fs, in_block);
+    if (ret != ALGO_NORMAL) {
+        return ret;
+    }
+    ws->info.frames = resample_out_num(&ws->rs.filter, ws->info.raw_frames);
+
+    ws->rs_in  = (float *)malloc(sizeof(float) * in_block);
+    ws->rs_out = (float *)malloc(sizeof(float) * resample_max_out(&ws->rs));
+    if (!ws->rs_in || !ws->rs_out) {
+        return ALGO_MALLOC_FAIL;
+    }
+
+    return ALGO_NORMAL;
+}
+
+static float stream_sample(const WavStream *ws, const uint8_t *p)
+{
+    float fval = 0.0f;
+
+    if (ws->info.format == WAV_FORMAT_PCM) {
+        return (float)(int16_t)get_le16(p);
+    }
+
+    memcpy(&fval, p, sizeof(float));
+
+    return fval;
+}
+
+// run the next block of the file through the resampler, false once all output is read
+static bool stream_refill(WavStream *ws)
+{
+    uint32_t got = 0;
+    const uint8_t *p = NULL;
+
+    ws->out_pos = 0;
+
+    if (ws->eof) {
+        ws->out_len = resample_flush(&ws->rs, ws->rs_out);
+        return ws->out_len > 0;
+    }
+
+    for (got = 0; got < ws->rs.block_size; got++) {
+        p = stream_next_frame(ws);
+        if (!p) {
+            ws->eof = true;
+            break;
+        }
+        ws->rs_in[got] = stream_sample(ws, p);
+    }
+
+    ws->out_len = resample_process(&ws->rs, ws->rs_in, got, ws->rs_out);
+
+    return true;
+}
+
+uint64_t wav_stream_read(WavStream *ws, uint64_t count, double *out)
+{
+    uint64_t i = 0;
+    const uint8_t *p = NULL;
+
+    if (!ws->rs.block_size) {
+        for (i = 0; i < count; i++) {
+            p = stream_next_frame(ws);
+            if (!p) {
+                break;
+            }
+            out[i] = (double)stream_sample(ws, p);
+        }
+    } else {
+        while (i < count) {
+            if (ws->out_pos < ws->out_len) {
+                out[i++] = (double)ws->rs_out[ws->out_pos++];
+            } else if (!stream_refill(ws)) {
+                break;
+            }
+        }
+    }
+
+    count -= i;
+    memset(out + i, 0, sizeof(double) * count);
+
+    return i;
+}
+
+void wav_stream_close(WavStream *ws)
+{
+    if (ws->file) {
+        fclose(ws->file);
+    }
+    resample_deinit(&ws->rs);
+    free(ws->rs_in);
+    free(ws->rs_out);
+    memset(ws, 0, offsetof(WavStream, buf));
+}
+
+void wav_close(WavFile *wav)
+{
+    if (wav->map) {
+        munmap(wav->map, wav->map_size);
+    }
+    resample_filter_deinit(&wav->filter);
+    memset(wav, 0, sizeof(WavFile));
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024, VeriSilicon Holdings Co., Ltd. All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __WAV_H__
+#define __WAV_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "resample.h"
+#include "algo_error_code.h"
+
+#define WAV_FORMAT_PCM        (1)
+#define WAV_FORMAT_IEEE_FLOAT (3)
+#define WAV_FORMAT_EXTENSIBLE (0xFFFE)
+
+#define WAV_MAX_PHASE_TAPS (1024) // longest polyphase branch accepted by wav_set_resample
+#define WAV_RESAMPLE_WIN   (4096) // input samples converted at a time by wav_read when resampling
+
+/**
+ * PCM wav file mapped into memory, int16 or float32 samples, mono or stereo.
+ * Samples are converted on demand, the file is never parsed or copied as a whole.
+ */
+typedef struct _WavFile {
+    uint16_t format;       // WAV_FORMAT_PCM or WAV_FORMAT_IEEE_FLOAT
+    uint16_t channels;     // number of interleaved channels
+    uint32_t sample_rate;  // sample rate in Hz
+    uint16_t bits;         // bits per sample
+    uint16_t block_align;  // bytes per frame (all channels)
+    uint64_t raw_frames;   // number of samples per channel in the file
+    uint64_t frames;       // number of samples per channel after resampling
+    ResampleFilter filter; // anti-aliasing filter, see wav_set_resample
+    const uint8_t *data;   // first byte of the data chunk
+    void *map;             // mapped file
+    size_t map_size;       // size of the mapping in bytes
+} WavFile;
+
+#define WAV_STREAM_BUF_SIZE (16384) // bytes read from the file at a time
+
+/**
+ * wav file read front to back in fixed size chunks, the memory used does not
+ * depend on the file length
+ */
+typedef struct _WavStream {
+    WavFile info;        // header, data, map and filter are unused
+    FILE *file;          // file positioned inside the data chunk
+    uint64_t remain;     // bytes of the data chunk not read from the file yet
+    size_t buf_len;      // valid bytes in buf
+    size_t buf_pos;      // next byte to be consumed in buf
+    Resampler rs;        // streaming resampler, see wav_stream_set_resample
+    float *rs_in;        // one input block of the resampler
+    float *rs_out;       // output of the resampler not read yet
+    uint32_t out_len;    // valid samples in rs_out
+    uint32_t out_pos;    // next sample to be read in rs_out
+    bool eof;            // all samples of the file went through the resampler
+    uint8_t buf[WAV_STREAM_BUF_SIZE];
+} WavStream;
+
+/**
+ * @brief map a wav file into memory and validate its header
+ *
+ * @param[in] file_dir: wav file
+ * @param[out] wav: opened wav file
+ * @return error code
+ */
+int wav_open(const char *file_dir, WavFile *wav);
+
+/**
+ * @brief resample the file to obj_fs through a polyphase anti-aliasing
+ * filter, any rational ratio sample_rate / obj_fs is supported.
+ * wav_read and frames refer to the resampled data afterwards, every output
+ * sample is computed from the mapped file so random access is kept.
+ *
+ * @param[in,out] wav: opened wav file
+ * @param[in] obj_fs: target sample rate
+ * @return error code
+ */
+int wav_set_resample(WavFile *wav, uint32_t obj_fs);
+
+/**
+ * @brief read samples of the first channel, converted to double
+ *
+ * @param[in] wav: opened wav file
+ * @param[in] offset: index of the first sample, after decimation
+ * @param[in] count: number of samples to read
+ * @param[out] out: output samples, positions past the end of file are zero
+ * @return number of samples actually read from the file
+ */
+uint64_t wav_read(const WavFile *wav, uint64_t offset, uint64_t count, double *out);
+
+/**
+ * @brief unmap a wav file and release its filter
+ *
+ * @param[in] wav: opened wav file
+ */
+void wav_close(WavFile *wav);
+
+/**
+ * @brief open a wav file for sequential reading and validate its header
+ *
+ * @param[in] file_dir: wav file
+ * @param[out] ws: opened stream
+ * @return error code
+ */
+int wav_stream_open(const char *file_dir, WavStream *ws);
+
+/**
+ * @brief resample the stream to obj_fs, the file is pushed through a
+ * streaming Resampler in blocks of about block_size output samples
+ *
+ * @param[in] ws: opened stream
+ * @param[in] obj_fs: target sample rate
+ * @param[in] block_size: output samples per resampler block, the VAD hop
+ * @return error code
+ */
+int wav_stream_set_resample(WavStream *ws, uint32_t obj_fs, uint32_t block_size);
+
+/**
+ * @brief read the next samples of the first channel, converted to double,
+ * resampled when wav_stream_set_resample was called
+ *
+ * @param[in] ws: opened stream
+ * @param[in] count: number of samples to read
+ * @param[out] out: output samples, positions past the end of file are zero
+ * @return number of samples actually read from the file
+ */
+uint64_t wav_stream_read(WavStream *ws, uint64_t count, double *out);
+
+/**
+ * @brief close a wav stream and release its resampler
+ *
+ * @param[in] ws: opened stream
+ */
+void wav_stream_close(WavStream *ws);
+
+#endif